@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace villain::bench {
+
+struct BenchOptions {
+    double secondsPerConfig = 10.0;
+    std::string outputPath = "bench_output.txt";
+};
+
+// One row of the report. Suites fill in whichever columns are meaningful for them.
+struct BenchResult {
+    std::string suite;
+    std::string config;
+    double nsPerSample = 0.0;
+    double realtimeCpuPercent = 0.0;
+    double worstBlockMicros = 0.0;
+    double worstBlockBudgetPercent = 0.0;
+    // One-off operations (construction, prepare) report their mean cost here instead, with
+    // the slowest single run in worstBlockMicros.
+    double microsPerOp = 0.0;
+};
+
+class BenchReport {
+public:
+    void add(BenchResult result);
+    const std::vector<BenchResult>& results() const noexcept { return results_; }
+
+    // Writes a fixed-width table; returns false if the file could not be written.
+    bool write(const std::string& path, const BenchOptions& options) const;
+
+private:
+    std::vector<BenchResult> results_;
+};
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsedNanos(Clock::time_point start, Clock::time_point end) noexcept
+{
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// Deterministic test material: a log sine sweep under a bed of white noise, so every run
+// drives the saturator and filters through the same range.
+void fillTestSignal(std::vector<float>& out, double sampleRate, std::uint32_t seed);
+
+// Each suite appends its rows to the report.
+void runProcessBench(BenchReport& report, const BenchOptions& options);
+void runStartupBench(BenchReport& report, const BenchOptions& options);
+
+} // namespace villain::bench
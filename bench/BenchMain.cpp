@@ -0,0 +1,48 @@
+#include "Bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+void printUsage(const char* argv0)
+{
+    std::printf("usage: %s [--seconds N] [--quick] [--output PATH]\n", argv0);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    villain::bench::BenchOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            options.secondsPerConfig = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--quick") == 0) {
+            options.secondsPerConfig = 1.0;
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            options.outputPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (options.secondsPerConfig <= 0.0) {
+        std::fprintf(stderr, "--seconds must be positive\n");
+        return 2;
+    }
+
+    villain::bench::BenchReport report;
+    villain::bench::runStartupBench(report, options);
+    villain::bench::runProcessBench(report, options);
+
+    if (!report.write(options.outputPath, options)) {
+        std::fprintf(stderr, "failed to write %s\n", options.outputPath.c_str());
+        return 1;
+    }
+    std::printf("wrote %s\n", options.outputPath.c_str());
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include "Bench.h"
+
+#include "dsp/simd/Kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace villain::bench {
+
+void BenchReport::add(BenchResult result)
+{
+    if (result.microsPerOp > 0.0) {
+        std::printf("%-10s %-40s %10.3f us/op                  worst %9.2f us\n", result.suite.c_str(),
+                    result.config.c_str(), result.microsPerOp, result.worstBlockMicros);
+    } else {
+        std::printf("%-10s %-40s %10.2f ns/sample %8.3f %% RT  worst %9.2f us (%6.2f %% of block)\n",
+                    result.suite.c_str(), result.config.c_str(), result.nsPerSample, result.realtimeCpuPercent,
+                    result.worstBlockMicros, result.worstBlockBudgetPercent);
+    }
+    results_.push_back(std::move(result));
+}
+
+bool BenchReport::write(const std::string& path, const BenchOptions& options) const
+{
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr)
+        return false;
+
+    std::fprintf(file, "# villain-vst benchmark\n");
+    std::fprintf(file, "# seconds_per_config=%.2f\n", options.secondsPerConfig);
+    std::fprintf(file, "# isa=%s\n", simd::toString(simd::activeKernels().isa));
+    std::fprintf(file, "%-10s %-40s %14s %12s %16s %14s %12s\n", "suite", "config", "ns_per_sample", "cpu_rt_pct",
+                 "worst_block_us", "worst_block_pct", "us_per_op");
+    for (const BenchResult& r : results_) {
+        std::fprintf(file, "%-10s %-40s %14.3f %12.4f %16.3f %14.3f %12.3f\n", r.suite.c_str(), r.config.c_str(),
+                     r.nsPerSample, r.realtimeCpuPercent, r.worstBlockMicros, r.worstBlockBudgetPercent,
+                     r.microsPerOp);
+    }
+    return std::fclose(file) == 0;
+}
+
+void fillTestSignal(std::vector<float>& out, double sampleRate, std::uint32_t seed)
+{
+    constexpr double kPi = 3.14159265358979323846;
+    const double length = static_cast<double>(out.size());
+    const double f0 = 20.0;
+    const double f1 = std::min(20000.0, sampleRate * 0.45);
+    const double k = std::log(f1 / f0);
+    const double duration = length / sampleRate;
+
+    std::uint32_t state = seed;
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        const double t = static_cast<double>(i) / sampleRate;
+        const double phase = 2.0 * kPi * f0 * duration / k * (std::exp(t / duration * k) - 1.0);
+        state = state * 1664525u + 1013904223u;
+        const double noise = static_cast<double>(state >> 8) / 8388608.0 - 1.0;
+        out[i] = static_cast<float>(0.5 * std::sin(phase) + 0.05 * noise);
+    }
+}
+
+} // namespace villain::bench
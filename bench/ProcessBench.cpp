@@ -0,0 +1,301 @@
+#include "Bench.h"
+
+#include "core/AudioBlock.h"
+#include "plugin/ParameterEvents.h"
+#include "plugin/VillainProcessor.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace villain::bench {
+
+namespace {
+
+struct ProcessConfig {
+    double sampleRate;
+    int blockSize;
+    int numChannels;
+    int eventsPerBlock = 0;
+    // Input is cut to digital silence after this many seconds; negative keeps it running.
+    double silenceAfterSeconds = -1.0;
+    int workerThreads = 0;
+    bool offline = false;
+    // Length of a synthetic cabinet impulse response; 0 leaves the stage out.
+    double impulseSeconds = 0.0;
+    // Channels of a sidechain bus, handed over in place like a host's; 0 sends none.
+    int sidechainChannels = 0;
+};
+
+constexpr int kMaxBenchEvents = 16;
+
+Parameters defaultBenchParameters()
+{
+    Parameters params;
+    params.driveDb = 18.0f;
+    params.toneHz = 6000.0f;
+    params.mix = 0.8f;
+    params.outputGainDb = -6.0f;
+    return params;
+}
+
+// Decaying noise, about 60 dB down by the end: the cost of convolution depends only on the
+// length, but a realistic shape keeps the output level sane.
+dsp::ImpulseResponse benchImpulseResponse(double sampleRate, double seconds)
+{
+    dsp::ImpulseResponse ir;
+    ir.sampleRate = sampleRate;
+    ir.channels.assign(2, std::vector<float>(static_cast<std::size_t>(sampleRate * seconds)));
+    for (std::size_t ch = 0; ch < 2; ++ch) {
+        std::vector<float>& taps = ir.channels[ch];
+        fillTestSignal(taps, sampleRate, 0x1bu + static_cast<std::uint32_t>(ch));
+        for (std::size_t i = 0; i < taps.size(); ++i)
+            taps[i] *= 0.05f * std::exp(-6.9f * static_cast<float>(i) / static_cast<float>(taps.size()));
+    }
+    return ir;
+}
+
+BenchResult runConfig(const ProcessConfig& config, const Parameters& params, const char* suite,
+                      const char* variant, const BenchOptions& options)
+{
+    const auto totalSamples = static_cast<std::size_t>(config.sampleRate * options.secondsPerConfig);
+    const auto blockSize = static_cast<std::size_t>(config.blockSize);
+
+    // Source material is rendered once; each block is copied into the I/O buffers before
+    // processing so the processor always sees fresh input, as it would from a host.
+    std::vector<std::vector<float>> source(static_cast<std::size_t>(config.numChannels),
+                                           std::vector<float>(totalSamples));
+    for (int ch = 0; ch < config.numChannels; ++ch)
+        fillTestSignal(source[static_cast<std::size_t>(ch)], config.sampleRate, 0x5eedu + static_cast<std::uint32_t>(ch));
+    if (config.silenceAfterSeconds >= 0.0) {
+        const auto cut = std::min(totalSamples, static_cast<std::size_t>(config.sampleRate * config.silenceAfterSeconds));
+        for (auto& channel : source)
+            std::fill(channel.begin() + static_cast<std::ptrdiff_t>(cut), channel.end(), 0.0f);
+    }
+
+    std::vector<std::vector<float>> key(static_cast<std::size_t>(config.sidechainChannels), std::vector<float>(totalSamples));
+    for (int ch = 0; ch < config.sidechainChannels; ++ch)
+        fillTestSignal(key[static_cast<std::size_t>(ch)], config.sampleRate, 0x5c00u + static_cast<std::uint32_t>(ch));
+    std::array<float*, kMaxChannels> keyPointers{};
+
+    std::vector<std::vector<float>> io(static_cast<std::size_t>(config.numChannels), std::vector<float>(blockSize));
+    std::array<float*, kMaxChannels> pointers{};
+    for (int ch = 0; ch < config.numChannels; ++ch)
+        pointers[static_cast<std::size_t>(ch)] = io[static_cast<std::size_t>(ch)].data();
+
+    VillainProcessor processor;
+    processor.prepare({config.sampleRate, config.blockSize, config.numChannels, config.workerThreads, config.offline});
+    processor.setParameters(params);
+    if (config.impulseSeconds > 0.0)
+        processor.setImpulseResponse(benchImpulseResponse(config.sampleRate, config.impulseSeconds));
+    processor.reset();
+
+    // Drive automation spread evenly over the block, alternating between two settings.
+    std::array<ParameterEvent, kMaxBenchEvents> events{};
+    const int numEvents = std::min(config.eventsPerBlock, kMaxBenchEvents);
+    for (int e = 0; e < numEvents; ++e) {
+        events[static_cast<std::size_t>(e)] = {e * config.blockSize / numEvents, ParamId::Drive,
+                                               e % 2 == 0 ? 6.0f : 24.0f};
+    }
+
+    double totalNanos = 0.0;
+    double worstNanos = 0.0;
+    for (std::size_t pos = 0; pos + blockSize <= totalSamples; pos += blockSize) {
+        for (int ch = 0; ch < config.numChannels; ++ch) {
+            const float* src = source[static_cast<std::size_t>(ch)].data() + pos;
+            std::copy(src, src + blockSize, io[static_cast<std::size_t>(ch)].begin());
+        }
+
+        for (int ch = 0; ch < config.sidechainChannels; ++ch)
+            keyPointers[static_cast<std::size_t>(ch)] = key[static_cast<std::size_t>(ch)].data() + pos;
+
+        const AudioBlock block(pointers.data(), config.numChannels, config.blockSize);
+        const AudioBlock sidechain(keyPointers.data(), config.sidechainChannels, config.blockSize);
+        const auto start = Clock::now();
+        processor.process(block, sidechain, {events.data(), numEvents});
+        const auto end = Clock::now();
+
+        const double nanos = elapsedNanos(start, end);
+        totalNanos += nanos;
+        worstNanos = std::max(worstNanos, nanos);
+    }
+
+    const double processedSamples = static_cast<double>(totalSamples - totalSamples % blockSize);
+    const double blockBudgetNanos = static_cast<double>(config.blockSize) / config.sampleRate * 1e9;
+    const double audioNanos = processedSamples / config.sampleRate * 1e9;
+
+    char label[96];
+    std::snprintf(label, sizeof(label), "sr=%d bs=%d ch=%d%s%s", static_cast<int>(config.sampleRate),
+                  config.blockSize, config.numChannels, variant[0] != '\0' ? " " : "", variant);
+
+    BenchResult result;
+    result.suite = suite;
+    result.config = label;
+    result.nsPerSample = totalNanos / (processedSamples * config.numChannels);
+    result.realtimeCpuPercent = totalNanos / audioNanos * 100.0;
+    result.worstBlockMicros = worstNanos / 1000.0;
+    result.worstBlockBudgetPercent = worstNanos / blockBudgetNanos * 100.0;
+    return result;
+}
+
+} // namespace
+
+void runProcessBench(BenchReport& report, const BenchOptions& options)
+{
+    constexpr double kSampleRates[] = {44100.0, 48000.0, 96000.0};
+    constexpr int kBlockSizes[] = {32, 64, 128, 512, 2048};
+    constexpr int kChannelCounts[] = {1, 2, 6};
+
+    const Parameters defaults = defaultBenchParameters();
+    for (double sampleRate : kSampleRates)
+        for (int blockSize : kBlockSizes)
+            for (int channels : kChannelCounts)
+                report.add(runConfig({sampleRate, blockSize, channels}, defaults, "process", "", options));
+
+    // Every oversampling factor in both filter modes, at a typical session setting.
+    for (int mode = 0; mode < 2; ++mode) {
+        for (int stages = 0; stages <= dsp::Oversampler::kMaxStages; ++stages) {
+            Parameters params = defaults;
+            params.oversamplingStages = stages;
+            params.oversamplingMode = mode == 0 ? dsp::OversamplingMode::MinimumPhase : dsp::OversamplingMode::LinearPhase;
+
+            char variant[32];
+            std::snprintf(variant, sizeof(variant), "os=%dx %s", 1 << stages, mode == 0 ? "min" : "lin");
+            report.add(runConfig({48000.0, 256, 2}, params, "oversample", variant, options));
+        }
+    }
+
+    // Sample-accurate automation: event-free blocks must cost the same as before.
+    for (int eventsPerBlock : {0, 1, 4, 16}) {
+        char variant[32];
+        std::snprintf(variant, sizeof(variant), "events=%d", eventsPerBlock);
+        report.add(runConfig({48000.0, 512, 2, eventsPerBlock}, defaults, "automation", variant, options));
+    }
+
+    // Multiband saturation at 2x. Bands share vector lanes, so cost follows the longest
+    // band chain (2 * bands - 2 sections) rather than the sum of every band's filters.
+    for (int bands = 1; bands <= dsp::kMaxBands; ++bands) {
+        Parameters params = defaults;
+        params.oversamplingStages = 1;
+        params.numBands = bands;
+        for (int band = 0; band < bands; ++band)
+            params.bandDriveDb[static_cast<std::size_t>(band)] = 3.0f * band;
+
+        char variant[32];
+        std::snprintf(variant, sizeof(variant), "bands=%d", bands);
+        report.add(runConfig({48000.0, 256, 2}, params, "multiband", variant, options));
+    }
+
+    // The dynamics stage on top of the default chain. Detection and the gain curve are
+    // vector passes; lookahead adds the sliding maximum and the moving average.
+    const struct {
+        dsp::DynamicsMode mode;
+        float lookaheadMs;
+        const char* name;
+    } kDynamicsVariants[] = {
+        {dsp::DynamicsMode::Off, 0.0f, "dynamics=off"},
+        {dsp::DynamicsMode::Compressor, 0.0f, "dynamics=compressor"},
+        {dsp::DynamicsMode::Compressor, 5.0f, "dynamics=compressor la=5ms"},
+        {dsp::DynamicsMode::Limiter, 0.0f, "dynamics=limiter"},
+        {dsp::DynamicsMode::Limiter, 5.0f, "dynamics=limiter la=5ms"},
+    };
+    for (const auto& variant : kDynamicsVariants) {
+        Parameters params = defaults;
+        params.dynamicsMode = variant.mode;
+        params.dynamicsThresholdDb = -12.0f;
+        params.dynamicsLookaheadMs = variant.lookaheadMs;
+        for (int channels : {2, 6})
+            report.add(runConfig({48000.0, 256, channels}, params, "dynamics", variant.name, options));
+    }
+
+    // Antiderivative anti-aliasing at 1x and 2x, against the oversampling it stands in for.
+    for (int stages = 0; stages <= 1; ++stages) {
+        for (int mode = 0; mode < dsp::kNumAntialiasingModes; ++mode) {
+            Parameters params = defaults;
+            params.oversamplingStages = stages;
+            params.antialiasing = static_cast<dsp::Antialiasing>(mode);
+
+            char variant[32];
+            std::snprintf(variant, sizeof(variant), "os=%dx adaa=%d", 1 << stages, mode);
+            report.add(runConfig({48000.0, 256, 2}, params, "adaa", variant, options));
+        }
+    }
+
+    // A stereo sidechain keying the drive and the compressor, read from the source buffers
+    // in place; the first row is the same chain with no bus attached.
+    for (int variant = 0; variant < 3; ++variant) {
+        Parameters params = defaults;
+        params.sidechain = variant > 0;
+        params.sidechainDuckDb = 12.0f;
+        params.dynamicsMode = variant == 2 ? dsp::DynamicsMode::Compressor : dsp::DynamicsMode::Off;
+        params.dynamicsThresholdDb = -12.0f;
+        ProcessConfig config{48000.0, 256, 2};
+        config.sidechainChannels = variant > 0 ? 2 : 0;
+        const char* names[] = {"sc=none", "sc=duck", "sc=duck+compressor"};
+        report.add(runConfig(config, params, "sidechain", names[variant], options));
+    }
+
+    // Modulation: control-rate sources on tone and mix, then an LFO on drive, which renders
+    // it per sample, then all four slots routed at once.
+    for (int variant = 0; variant < 4; ++variant) {
+        Parameters params = defaults;
+        if (variant == 1 || variant == 3) {
+            params.modulation[0] = {dsp::ModSource::Lfo, dsp::ModTarget::Tone, 0.5f};
+            params.modulation[1] = {dsp::ModSource::Envelope, dsp::ModTarget::Mix, 0.3f};
+        }
+        if (variant >= 2)
+            params.modulation[2] = {dsp::ModSource::Lfo, dsp::ModTarget::Drive, 0.25f};
+        if (variant == 3)
+            params.modulation[3] = {dsp::ModSource::Random, dsp::ModTarget::Drive, 0.25f};
+        const char* names[] = {"mod=none", "mod=tone+mix", "mod=drive", "mod=all"};
+        report.add(runConfig({48000.0, 256, 2}, params, "modulation", names[variant], options));
+    }
+
+    // Cabinet convolution after the default chain. Real-time rows time the audio thread: the
+    // head and 64-sample body partitions, plus handing 1024-sample tail blocks to the
+    // convolver's own thread. Offline, the tail is computed inline and timed too.
+    for (double seconds : {0.05, 0.5, 3.0}) {
+        char name[48];
+        std::snprintf(name, sizeof(name), "ir=%gs", seconds);
+        report.add(runConfig({48000.0, 256, 2, 0, -1.0, 0, false, seconds}, defaults, "cabinet", name, options));
+        std::snprintf(name, sizeof(name), "ir=%gs offline", seconds);
+        report.add(runConfig({48000.0, 4096, 2, 0, -1.0, 0, true, seconds}, defaults, "cabinet", name, options));
+    }
+
+    // Tail handling: a short burst followed by silence rings out and then idles.
+    report.add(runConfig({48000.0, 512, 2}, defaults, "tail", "input=signal", options));
+    report.add(runConfig({48000.0, 512, 2, 0, 0.5}, defaults, "tail", "input=burst+silence", options));
+    report.add(runConfig({48000.0, 512, 2, 0, 0.0}, defaults, "tail", "input=silence", options));
+
+    // Bounce path against the realtime path on the same session. Offline adds an
+    // oversampling stage, so the interesting figure is how much of that cost the longer
+    // blocks and extra threads win back.
+    for (int channels : {2, 6}) {
+        for (bool offline : {false, true}) {
+            ProcessConfig config{48000.0, 4096, channels};
+            config.offline = offline;
+            report.add(runConfig(config, defaults, "offline", offline ? "mode=offline" : "mode=realtime", options));
+        }
+    }
+
+    // Wide layouts spread over the worker pool. The variant shows the workers actually
+    // started, which prepare() caps at the machine's spare cores.
+    for (int channels : {12, 16}) {
+        for (int workers : {0, 1, 3, 7}) {
+            ProcessConfig config{48000.0, 512, channels};
+            config.workerThreads = workers;
+            VillainProcessor probe;
+            probe.prepare({config.sampleRate, config.blockSize, channels, workers});
+            if (workers > 0 && probe.numWorkerThreads() < workers)
+                continue;
+
+            char variant[32];
+            std::snprintf(variant, sizeof(variant), "workers=%d", workers);
+            report.add(runConfig(config, defaults, "parallel", variant, options));
+        }
+    }
+}
+
+} // namespace villain::bench
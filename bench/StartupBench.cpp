@@ -0,0 +1,113 @@
+#include "Bench.h"
+
+#include "plugin/StateFormat.h"
+#include "plugin/VillainProcessor.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace villain::bench {
+
+namespace {
+
+constexpr ProcessSpec kStartupSpec{48000.0, 512, 2};
+
+// A template session's worth of instances per round.
+constexpr int kInstancesPerRound = 128;
+
+// Host state calls per round; each one is far cheaper than an instance.
+constexpr int kStateCallsPerRound = 1024;
+
+struct Timing {
+    double totalNanos = 0.0;
+    double worstNanos = 0.0;
+    int count = 0;
+
+    void add(double nanos) noexcept
+    {
+        totalNanos += nanos;
+        worstNanos = std::max(worstNanos, nanos);
+        ++count;
+    }
+};
+
+BenchResult makeResult(const char* config, const Timing& timing)
+{
+    BenchResult result;
+    result.suite = "startup";
+    result.config = config;
+    result.microsPerOp = timing.totalNanos / std::max(timing.count, 1) / 1000.0;
+    result.worstBlockMicros = timing.worstNanos / 1000.0;
+    return result;
+}
+
+} // namespace
+
+void runStartupBench(BenchReport& report, const BenchOptions& options)
+{
+    const int rounds = std::max(1, static_cast<int>(options.secondsPerConfig * 4.0));
+
+    Timing construct;
+    Timing coldPrepare;
+    Timing warmPrepare;
+    Timing destroy;
+    Timing stateSave;
+    Timing stateLoad;
+
+    std::vector<std::unique_ptr<VillainProcessor>> instances;
+    instances.reserve(kInstancesPerRound);
+
+    for (int round = 0; round < rounds; ++round) {
+        // Construction alone: what a host pays per instance while scanning or loading.
+        for (int i = 0; i < kInstancesPerRound; ++i) {
+            const auto start = Clock::now();
+            instances.push_back(std::make_unique<VillainProcessor>());
+            construct.add(elapsedNanos(start, Clock::now()));
+        }
+
+        // The first prepare in the process builds the shared tables; the rest reuse them.
+        for (int i = 0; i < kInstancesPerRound; ++i) {
+            const auto start = Clock::now();
+            instances[static_cast<std::size_t>(i)]->prepare(kStartupSpec);
+            (i == 0 ? coldPrepare : warmPrepare).add(elapsedNanos(start, Clock::now()));
+        }
+
+        for (auto& instance : instances) {
+            const auto start = Clock::now();
+            instance.reset();
+            destroy.add(elapsedNanos(start, Clock::now()));
+        }
+        instances.clear();
+
+        // Session save/recall as the host's state thread sees it, into a preallocated blob.
+        ParameterStore store;
+        std::array<std::uint8_t, stateSize()> blob{};
+        for (int i = 0; i < kStateCallsPerRound; ++i) {
+            const auto start = Clock::now();
+            writeState(store, blob.data(), blob.size());
+            stateSave.add(elapsedNanos(start, Clock::now()));
+        }
+        for (int i = 0; i < kStateCallsPerRound; ++i) {
+            const auto start = Clock::now();
+            loadState(store, blob.data(), blob.size());
+            stateLoad.add(elapsedNanos(start, Clock::now()));
+        }
+    }
+
+    char label[64];
+    report.add(makeResult("construct", construct));
+    std::snprintf(label, sizeof(label), "prepare cold bs=%d ch=%d", kStartupSpec.maxBlockSize, kStartupSpec.numChannels);
+    report.add(makeResult(label, coldPrepare));
+    std::snprintf(label, sizeof(label), "prepare shared bs=%d ch=%d", kStartupSpec.maxBlockSize, kStartupSpec.numChannels);
+    report.add(makeResult(label, warmPrepare));
+    report.add(makeResult("release+destroy", destroy));
+    std::snprintf(label, sizeof(label), "state save %zu bytes", stateSize());
+    report.add(makeResult(label, stateSave));
+    std::snprintf(label, sizeof(label), "state load %zu bytes", stateSize());
+    report.add(makeResult(label, stateLoad));
+}
+
+} // namespace villain::bench
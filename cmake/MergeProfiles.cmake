@@ -0,0 +1,13 @@
+# Merges Clang's raw PGO profiles into the default.profdata that -fprofile-use=<dir> reads.
+# Run in script mode with PROFDATA (llvm-profdata) and PROFILE_DIR set.
+file(GLOB raw_profiles "${PROFILE_DIR}/*.profraw")
+if(NOT raw_profiles)
+  message(FATAL_ERROR "no .profraw files in ${PROFILE_DIR}")
+endif()
+execute_process(
+  COMMAND ${PROFDATA} merge -output=${PROFILE_DIR}/default.profdata ${raw_profiles}
+  RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "llvm-profdata merge failed")
+endif()
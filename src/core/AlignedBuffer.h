@@ -0,0 +1,82 @@
+#pragma once
+
+#include "core/Platform.h"
+
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace villain {
+
+// Owning, SIMD-aligned array of trivially copyable values. Allocation only happens in
+// allocate(), which must never be called from the audio thread.
+template <typename T>
+class AlignedBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "AlignedBuffer holds plain data only");
+
+public:
+    AlignedBuffer() = default;
+    explicit AlignedBuffer(std::size_t count) { allocate(count); }
+    ~AlignedBuffer() { release(); }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    AlignedBuffer(AlignedBuffer&& other) noexcept : data_(other.data_), size_(other.size_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    AlignedBuffer& operator=(AlignedBuffer&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            data_ = other.data_;
+            size_ = other.size_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    // Reallocates to hold exactly `count` zeroed elements.
+    void allocate(std::size_t count)
+    {
+        release();
+        if (count == 0)
+            return;
+        const std::size_t bytes = alignUp(count * sizeof(T), kSimdAlignment);
+        data_ = static_cast<T*>(::operator new(bytes, std::align_val_t{kSimdAlignment}));
+        size_ = count;
+        clear();
+    }
+
+    void release() noexcept
+    {
+        if (data_ != nullptr)
+            ::operator delete(data_, std::align_val_t{kSimdAlignment});
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    void clear() noexcept
+    {
+        if (data_ != nullptr)
+            std::memset(static_cast<void*>(data_), 0, size_ * sizeof(T));
+    }
+
+    T* data() noexcept { return data_; }
+    const T* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    T& operator[](std::size_t i) noexcept { return data_[i]; }
+    const T& operator[](std::size_t i) const noexcept { return data_[i]; }
+
+private:
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace villain
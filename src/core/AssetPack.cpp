@@ -0,0 +1,334 @@
+#include "core/AssetPack.h"
+
+#include "core/Platform.h"
+#include "core/SharedTable.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace villain {
+
+namespace {
+
+// Byte-wise, like the state format, so the index reads the same at any alignment.
+void putU16(std::uint8_t* p, std::uint16_t v) noexcept
+{
+    p[0] = static_cast<std::uint8_t>(v);
+    p[1] = static_cast<std::uint8_t>(v >> 8);
+}
+
+void putU32(std::uint8_t* p, std::uint32_t v) noexcept
+{
+    for (int i = 0; i < 4; ++i)
+        p[i] = static_cast<std::uint8_t>(v >> (8 * i));
+}
+
+void putU64(std::uint8_t* p, std::uint64_t v) noexcept
+{
+    for (int i = 0; i < 8; ++i)
+        p[i] = static_cast<std::uint8_t>(v >> (8 * i));
+}
+
+std::uint16_t getU16(const std::uint8_t* p) noexcept
+{
+    return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+
+std::uint32_t getU32(const std::uint8_t* p) noexcept
+{
+    std::uint32_t v = 0;
+    for (int i = 0; i < 4; ++i)
+        v |= static_cast<std::uint32_t>(p[i]) << (8 * i);
+    return v;
+}
+
+std::uint64_t getU64(const std::uint8_t* p) noexcept
+{
+    std::uint64_t v = 0;
+    for (int i = 0; i < 8; ++i)
+        v |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+    return v;
+}
+
+template <typename Bits, typename Value>
+Bits toBits(Value value) noexcept
+{
+    static_assert(sizeof(Bits) == sizeof(Value), "bit copy needs equal sizes");
+    Bits bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+template <typename Value, typename Bits>
+Value fromBits(Bits bits) noexcept
+{
+    Value value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::uint32_t checksum(const std::uint8_t* data, std::size_t size) noexcept
+{
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i)
+        hash = (hash ^ data[i]) * 16777619u;
+    return hash;
+}
+
+std::uint64_t pathKey(const std::string& path) noexcept
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const char c : path)
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    return hash;
+}
+
+// Payloads are mapped as floats, so the pack's byte order must be the host's.
+bool hostIsLittleEndian() noexcept
+{
+    const std::uint32_t probe = 1;
+    std::uint8_t first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+bool isKnownKind(std::uint32_t kind) noexcept
+{
+    return kind == static_cast<std::uint32_t>(AssetKind::ImpulseResponse) ||
+           kind == static_cast<std::uint32_t>(AssetKind::ShaperCurve);
+}
+
+// Index entry fields.
+constexpr std::size_t kNameField = 0;
+constexpr std::size_t kKindField = 56;
+constexpr std::size_t kChannelsField = 60;
+constexpr std::size_t kFramesField = 64;
+constexpr std::size_t kLowerField = 68;
+constexpr std::size_t kUpperField = 72;
+constexpr std::size_t kSampleRateField = 80;
+constexpr std::size_t kOffsetField = 88;
+
+} // namespace
+
+// Reads requested ranges in on one background thread: an madvise to start the I/O, then a
+// touch of every page so they are mapped by the time a builder gets there.
+class AssetPack::Prefetcher {
+public:
+    ~Prefetcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    void request(const std::uint8_t* begin, std::size_t length)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_back({begin, length});
+            if (!thread_.joinable())
+                thread_ = std::thread([this] { run(); });
+        }
+        wake_.notify_all();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return pending_.empty() && !busy_; });
+    }
+
+private:
+    struct Range {
+        const std::uint8_t* begin;
+        std::size_t length;
+    };
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+            if (stopping_)
+                return;
+            const Range range = pending_.front();
+            pending_.erase(pending_.begin());
+            busy_ = true;
+            lock.unlock();
+
+            MappedFile::prefetchRange(range.begin, range.length);
+            std::uint8_t sum = 0;
+            for (std::size_t i = 0; i < range.length; i += kPayloadAlignment)
+                sum = static_cast<std::uint8_t>(sum + *static_cast<const volatile std::uint8_t*>(range.begin + i));
+            sink_ = sum;
+
+            lock.lock();
+            busy_ = false;
+            if (pending_.empty())
+                idle_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::vector<Range> pending_;
+    bool busy_ = false;
+    bool stopping_ = false;
+    volatile std::uint8_t sink_ = 0;
+    std::thread thread_;
+};
+
+AssetPack::AssetPack() : prefetcher_(std::make_unique<Prefetcher>()) {}
+
+AssetPack::~AssetPack() = default;
+AssetPack::AssetPack(AssetPack&&) noexcept = default;
+AssetPack& AssetPack::operator=(AssetPack&&) noexcept = default;
+
+bool AssetPack::open(const std::string& path)
+{
+    file_.close();
+    entries_.clear();
+    if (!hostIsLittleEndian() || !file_.open(path, MappedFile::Access::Random))
+        return false;
+
+    const std::uint8_t* in = file_.data();
+    const std::size_t size = file_.size();
+    const auto fail = [this] {
+        file_.close();
+        entries_.clear();
+        return false;
+    };
+    if (size < kHeaderSize || getU32(in) != kMagic || getU16(in + 4) != kVersion)
+        return fail();
+
+    const std::size_t headerSize = getU16(in + 6);
+    const std::size_t entrySize = getU16(in + 8);
+    const std::uint64_t count = getU32(in + 12);
+    if (headerSize < kHeaderSize || entrySize < kEntrySize || headerSize > size ||
+        count * entrySize > size - headerSize || checksum(in + headerSize, count * entrySize) != getU32(in + 16))
+        return fail();
+
+    entries_.reserve(static_cast<std::size_t>(count));
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint8_t* field = in + headerSize + i * entrySize;
+        const auto* name = reinterpret_cast<const char*>(field + kNameField);
+        const auto nameLength = static_cast<std::size_t>(std::find(name, name + kMaxNameLength + 1, '\0') - name);
+        const std::uint32_t kind = getU32(field + kKindField);
+        const std::uint32_t channels = getU32(field + kChannelsField);
+        const std::uint32_t frames = getU32(field + kFramesField);
+        const std::uint64_t offset = getU64(field + kOffsetField);
+        const std::uint64_t bytes = sizeof(float) * static_cast<std::uint64_t>(channels) * frames;
+        if (nameLength == 0 || nameLength > kMaxNameLength || !isKnownKind(kind) || channels == 0 ||
+            channels > static_cast<std::uint32_t>(kMaxChannels) || frames == 0 || frames > 0x7fffffffu ||
+            offset % kPayloadAlignment != 0 || offset > size || bytes > size - offset)
+            return fail();
+
+        AssetEntry entry;
+        entry.name = std::string_view(name, nameLength);
+        entry.kind = static_cast<AssetKind>(kind);
+        entry.numChannels = static_cast<int>(channels);
+        entry.numFrames = static_cast<int>(frames);
+        entry.lower = fromBits<float>(getU32(field + kLowerField));
+        entry.upper = fromBits<float>(getU32(field + kUpperField));
+        entry.sampleRate = fromBits<double>(getU64(field + kSampleRateField));
+        entry.offset = static_cast<std::size_t>(offset);
+        entry.data = reinterpret_cast<const float*>(in + offset);
+        if (entry.kind == AssetKind::ImpulseResponse && !(entry.sampleRate > 0.0))
+            return fail();
+        entries_.push_back(entry);
+    }
+    return true;
+}
+
+std::shared_ptr<const AssetPack> AssetPack::acquire(const std::string& path)
+{
+    std::shared_ptr<const AssetPack> pack = SharedTable<AssetPack>::acquire(pathKey(path), [&path] {
+        AssetPack opened;
+        opened.open(path);
+        return opened;
+    });
+    return pack->isOpen() ? pack : nullptr;
+}
+
+const AssetEntry* AssetPack::find(std::string_view name, AssetKind kind) const noexcept
+{
+    for (const AssetEntry& entry : entries_)
+        if (entry.kind == kind && entry.name == name)
+            return &entry;
+    return nullptr;
+}
+
+void AssetPack::prefetch(const AssetEntry& asset) const
+{
+    prefetcher_->request(reinterpret_cast<const std::uint8_t*>(asset.data), asset.byteSize());
+}
+
+void AssetPack::waitForPrefetches() const
+{
+    prefetcher_->wait();
+}
+
+bool writeAssetPack(const std::string& path, const std::vector<PackedAsset>& assets)
+{
+    if (!hostIsLittleEndian())
+        return false;
+    const std::size_t indexEnd = AssetPack::kHeaderSize + AssetPack::kEntrySize * assets.size();
+    std::vector<std::uint8_t> head(alignUp(indexEnd, AssetPack::kPayloadAlignment));
+    std::size_t offset = head.size();
+
+    for (std::size_t i = 0; i < assets.size(); ++i) {
+        const PackedAsset& asset = assets[i];
+        const std::size_t frames = asset.channels.empty() ? 0 : asset.channels[0].size();
+        if (asset.name.empty() || asset.name.size() > AssetPack::kMaxNameLength || frames == 0 ||
+            asset.channels.size() > static_cast<std::size_t>(kMaxChannels))
+            return false;
+        for (const std::vector<float>& channel : asset.channels)
+            if (channel.size() != frames)
+                return false;
+
+        std::uint8_t* field = head.data() + AssetPack::kHeaderSize + i * AssetPack::kEntrySize;
+        std::memcpy(field + kNameField, asset.name.data(), asset.name.size());
+        putU32(field + kKindField, static_cast<std::uint32_t>(asset.kind));
+        putU32(field + kChannelsField, static_cast<std::uint32_t>(asset.channels.size()));
+        putU32(field + kFramesField, static_cast<std::uint32_t>(frames));
+        putU32(field + kLowerField, toBits<std::uint32_t>(asset.lower));
+        putU32(field + kUpperField, toBits<std::uint32_t>(asset.upper));
+        putU64(field + kSampleRateField, toBits<std::uint64_t>(asset.sampleRate));
+        putU64(field + kOffsetField, offset);
+        offset = alignUp(offset + sizeof(float) * asset.channels.size() * frames, AssetPack::kPayloadAlignment);
+    }
+
+    putU32(head.data(), AssetPack::kMagic);
+    putU16(head.data() + 4, AssetPack::kVersion);
+    putU16(head.data() + 6, static_cast<std::uint16_t>(AssetPack::kHeaderSize));
+    putU16(head.data() + 8, static_cast<std::uint16_t>(AssetPack::kEntrySize));
+    putU32(head.data() + 12, static_cast<std::uint32_t>(assets.size()));
+    putU32(head.data() + 16, checksum(head.data() + AssetPack::kHeaderSize, AssetPack::kEntrySize * assets.size()));
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+    bool ok = std::fwrite(head.data(), 1, head.size(), file) == head.size();
+    const std::vector<std::uint8_t> padding(AssetPack::kPayloadAlignment);
+    for (const PackedAsset& asset : assets) {
+        std::size_t written = 0;
+        for (const std::vector<float>& channel : asset.channels) {
+            ok = ok && std::fwrite(channel.data(), sizeof(float), channel.size(), file) == channel.size();
+            written += sizeof(float) * channel.size();
+        }
+        const std::size_t pad = alignUp(written, AssetPack::kPayloadAlignment) - written;
+        ok = ok && std::fwrite(padding.data(), 1, pad, file) == pad;
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+} // namespace villain
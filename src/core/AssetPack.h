@@ -0,0 +1,108 @@
+#pragma once
+
+#include "core/MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace villain {
+
+enum class AssetKind : std::uint32_t {
+    ImpulseResponse = 1,   // cabinet taps at `sampleRate`
+    ShaperCurve = 2,       // a measured transfer curve: nodes evenly spaced over [lower, upper]
+};
+
+// One asset of a pack. `data` points into the mapping: planar float samples, channel by
+// channel, read where they lie. Nothing is copied and no page is read until it is touched.
+struct AssetEntry {
+    std::string_view name;
+    AssetKind kind = AssetKind::ImpulseResponse;
+    int numChannels = 0;
+    int numFrames = 0;
+    double sampleRate = 0.0;
+    float lower = 0.0f;
+    float upper = 0.0f;
+    std::size_t offset = 0;   // of the payload in the file, on a page boundary
+    const float* data = nullptr;
+
+    const float* channel(int ch) const noexcept { return data + static_cast<std::size_t>(ch) * numFrames; }
+    std::size_t byteSize() const noexcept
+    {
+        return sizeof(float) * static_cast<std::size_t>(numChannels) * static_cast<std::size_t>(numFrames);
+    }
+};
+
+// A pack of large factory assets (cabinet responses, measured curves) in one file, memory
+// mapped for random access. acquire() maps each pack once per process, and every instance
+// reads the same page-cache pages: a thousand instances cost one copy of the assets, and
+// only of those a preset actually touched.
+//
+// Layout (little-endian): a 32-byte header, then one 96-byte index entry per asset, then the
+// payloads as 32-bit floats, each starting on a kPayloadAlignment boundary so that faulting
+// in one asset never reads its neighbours. The index is checksummed and every entry is
+// bounds-checked on open, so a damaged pack is rejected rather than read out of bounds.
+// Packs are installed read-only and replaced by rename, never rewritten in place.
+//
+// Non-realtime: open, lookup and prefetch run on setup or message threads.
+class AssetPack {
+public:
+    static constexpr std::uint32_t kMagic = 0x4b415056;   // "VPAK"
+    static constexpr std::uint16_t kVersion = 1;
+    static constexpr std::size_t kHeaderSize = 32;
+    static constexpr std::size_t kEntrySize = 96;
+    static constexpr std::size_t kMaxNameLength = 55;
+    static constexpr std::size_t kPayloadAlignment = 4096;
+
+    AssetPack();
+    ~AssetPack();
+    AssetPack(AssetPack&&) noexcept;
+    AssetPack& operator=(AssetPack&&) noexcept;
+
+    // Returns false, leaving the pack closed, if the file is missing or not a valid pack.
+    bool open(const std::string& path);
+    bool isOpen() const noexcept { return file_.isOpen(); }
+
+    // The process-wide mapping of `path`, shared with every other caller; null if the pack
+    // cannot be opened.
+    static std::shared_ptr<const AssetPack> acquire(const std::string& path);
+
+    int numAssets() const noexcept { return static_cast<int>(entries_.size()); }
+    const AssetEntry& asset(int index) const noexcept { return entries_[static_cast<std::size_t>(index)]; }
+    // Null if the pack holds no asset of that name and kind.
+    const AssetEntry* find(std::string_view name, AssetKind kind) const noexcept;
+
+    // Starts reading `asset`'s pages on a background thread and returns at once; by the time
+    // a builder walks the samples they are (or are on their way to being) resident. One
+    // thread per pack serves every instance, started on the first request.
+    void prefetch(const AssetEntry& asset) const;
+    // Blocks until every prefetch requested so far has finished.
+    void waitForPrefetches() const;
+
+private:
+    class Prefetcher;
+
+    MappedFile file_;
+    std::vector<AssetEntry> entries_;
+    // Declared last, so its thread is joined before the mapping goes away.
+    std::unique_ptr<Prefetcher> prefetcher_;
+};
+
+// An asset as written into a pack; channels must all have the same length.
+struct PackedAsset {
+    std::string name;
+    AssetKind kind = AssetKind::ImpulseResponse;
+    double sampleRate = 0.0;
+    float lower = 0.0f;
+    float upper = 0.0f;
+    std::vector<std::vector<float>> channels;
+};
+
+// Builds a pack file, as the factory content build does. Returns false if an asset is
+// malformed (empty, ragged, unnamed or over-long name) or the file cannot be written.
+bool writeAssetPack(const std::string& path, const std::vector<PackedAsset>& assets);
+
+} // namespace villain
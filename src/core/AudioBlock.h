@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core/Platform.h"
+
+#include <array>
+#include <cassert>
+
+namespace villain {
+
+// Non-owning view of a planar multichannel buffer. Copies are cheap and never allocate, so
+// sub-blocks can be carved out freely on the audio thread.
+class AudioBlock {
+public:
+    AudioBlock() = default;
+
+    AudioBlock(float* const* channels, int numChannels, int numSamples) noexcept
+        : numChannels_(numChannels), numSamples_(numSamples)
+    {
+        assert(numChannels >= 0 && numChannels <= kMaxChannels);
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels_[ch] = channels[ch];
+    }
+
+    int numChannels() const noexcept { return numChannels_; }
+    int numSamples() const noexcept { return numSamples_; }
+
+    float* channel(int ch) const noexcept
+    {
+        assert(ch >= 0 && ch < numChannels_);
+        return channels_[ch];
+    }
+
+    float* const* channels() const noexcept { return channels_.data(); }
+
+    // View of samples [start, start + length) on every channel.
+    AudioBlock subBlock(int start, int length) const noexcept
+    {
+        assert(start >= 0 && length >= 0 && start + length <= numSamples_);
+        AudioBlock sub;
+        sub.numChannels_ = numChannels_;
+        sub.numSamples_ = length;
+        for (int ch = 0; ch < numChannels_; ++ch)
+            sub.channels_[ch] = channels_[ch] + start;
+        return sub;
+    }
+
+private:
+    std::array<float*, kMaxChannels> channels_{};
+    int numChannels_ = 0;
+    int numSamples_ = 0;
+};
+
+} // namespace villain
@@ -0,0 +1,80 @@
+#include "core/BuildWorker.h"
+
+#include "core/Futex.h"
+
+#include <climits>
+#include <new>
+
+namespace villain {
+
+void BuildWorker::start(Job job, void* context)
+{
+    stop();
+    job_ = job;
+    context_ = context;
+    // Requests made while stopped are dropped: whoever starts the worker has just built
+    // from the current settings.
+    served_.store(requested_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    stopping_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread([this] { run(); });
+}
+
+void BuildWorker::stop()
+{
+    if (!thread_.joinable())
+        return;
+    stopping_.store(true, std::memory_order_release);
+    requested_.fetch_add(1, std::memory_order_release);
+    futexWake(requested_, 1);
+    thread_.join();
+    served_.store(requested_.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+void BuildWorker::request() noexcept
+{
+    requested_.fetch_add(1);
+    if (sleepers_.load() > 0)
+        futexWake(requested_, 1);
+}
+
+void BuildWorker::wait() noexcept
+{
+    const std::uint32_t target = requested_.load();
+    waiters_.fetch_add(1);
+    for (;;) {
+        const std::uint32_t served = served_.load();
+        if (static_cast<std::int32_t>(served - target) >= 0 || !isRunning())
+            break;
+        futexWait(served_, served);
+    }
+    waiters_.fetch_sub(1);
+}
+
+void BuildWorker::run() noexcept
+{
+    std::uint32_t served = served_.load(std::memory_order_relaxed);
+    while (!stopping_.load(std::memory_order_acquire)) {
+        const std::uint32_t requested = requested_.load();
+        if (requested == served) {
+            // Registered before the re-check, so a request either sees the sleeper or
+            // changes the word futexWait() compares against.
+            sleepers_.fetch_add(1);
+            if (requested_.load() == requested && !stopping_.load())
+                futexWait(requested_, requested);
+            sleepers_.fetch_sub(1);
+            continue;
+        }
+
+        try {
+            job_(context_);
+        } catch (const std::bad_alloc&) {
+            // Out of memory: keep running on the state we have.
+        }
+        served = requested;
+        served_.store(served);
+        if (waiters_.load() > 0)
+            futexWake(served_, INT_MAX);
+    }
+}
+
+} // namespace villain
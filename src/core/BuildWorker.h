@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace villain {
+
+// One background thread that runs a build job on request, for state too expensive to
+// rebuild on the audio thread. Requests made while the job runs fold into a single further
+// run, so the job builds from the latest settings rather than from any one request.
+//
+// request() is audio-thread safe: an atomic increment, plus a futex wake only when the
+// thread is asleep. Off Linux the idle thread yields instead of sleeping.
+class BuildWorker {
+public:
+    using Job = void (*)(void* context);
+
+    BuildWorker() = default;
+    ~BuildWorker() { stop(); }
+
+    BuildWorker(const BuildWorker&) = delete;
+    BuildWorker& operator=(const BuildWorker&) = delete;
+
+    // Non-realtime. Starts the thread, dropping any request made while it was stopped; `job`
+    // runs on it once per batch of requests. A job that throws std::bad_alloc counts as
+    // served and leaves the current state in place.
+    void start(Job job, void* context);
+    // Non-realtime. Finishes the job in progress, drops pending requests and joins.
+    void stop();
+    bool isRunning() const noexcept { return thread_.joinable(); }
+
+    // Any thread.
+    void request() noexcept;
+    bool isPending() const noexcept
+    {
+        return served_.load(std::memory_order_acquire) != requested_.load(std::memory_order_acquire);
+    }
+    // Non-realtime (or an offline render). Blocks until every request made before the call
+    // has been served; returns at once if the thread is not running.
+    void wait() noexcept;
+
+private:
+    void run() noexcept;
+
+    Job job_ = nullptr;
+    void* context_ = nullptr;
+    std::thread thread_;
+
+    // Futex words: requested_ for the worker, served_ for wait().
+    std::atomic<std::uint32_t> requested_{0};
+    std::atomic<std::uint32_t> served_{0};
+    std::atomic<int> sleepers_{0};
+    std::atomic<int> waiters_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace villain
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace villain {
+
+// Sleeps while `word` still holds `expected`. May return spuriously; callers re-check.
+// Off Linux this yields instead of sleeping.
+inline void futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected) noexcept
+{
+#if defined(__linux__)
+    // std::atomic<uint32_t> is a plain 32-bit word on every platform we build for.
+    syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAIT_PRIVATE, static_cast<int>(expected), nullptr, nullptr, 0);
+#else
+    (void)word;
+    (void)expected;
+    std::this_thread::yield();
+#endif
+}
+
+// Wakes up to `count` threads sleeping in futexWait() on `word`. The one system call the
+// audio thread is allowed, and only when someone is known to be asleep.
+inline void futexWake(std::atomic<std::uint32_t>& word, int count) noexcept
+{
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<int*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+    (void)word;
+    (void)count;
+#endif
+}
+
+} // namespace villain
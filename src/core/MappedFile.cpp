@@ -0,0 +1,144 @@
+#include "core/MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <utility>
+
+namespace villain {
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#if defined(_WIN32)
+        file_ = std::exchange(other.file_, nullptr);
+        mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::prefetch(std::size_t offset, std::size_t length) const noexcept
+{
+    if (offset < size_)
+        prefetchRange(data_ + offset, std::min(length, size_ - offset));
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::open(const std::string& path, Access access)
+{
+    close();
+    const DWORD hint = access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | hint, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr) {
+        if (mapping != nullptr)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    file_ = file;
+    mapping_ = mapping;
+    data_ = static_cast<const std::uint8_t*>(view);
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::prefetchRange(const std::uint8_t* begin, std::size_t length) noexcept
+{
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<std::uint8_t*>(begin);
+    range.NumberOfBytes = length;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+void MappedFile::close() noexcept
+{
+    if (data_ != nullptr)
+        UnmapViewOfFile(data_);
+    if (mapping_ != nullptr)
+        CloseHandle(static_cast<HANDLE>(mapping_));
+    if (file_ != nullptr)
+        CloseHandle(static_cast<HANDLE>(file_));
+    data_ = nullptr;
+    size_ = 0;
+    file_ = nullptr;
+    mapping_ = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path, Access access)
+{
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    const std::size_t size = static_cast<std::size_t>(info.st_size);
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+    if (view == MAP_FAILED)
+        return false;
+
+    ::madvise(view, size, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    data_ = static_cast<const std::uint8_t*>(view);
+    size_ = size;
+    return true;
+}
+
+void MappedFile::prefetchRange(const std::uint8_t* begin, std::size_t length) noexcept
+{
+    // madvise wants a page-aligned start.
+    const auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+    const auto address = reinterpret_cast<std::uintptr_t>(begin);
+    const std::uintptr_t start = address - address % page;
+    ::madvise(reinterpret_cast<void*>(start), length + (address - start), MADV_WILLNEED);
+}
+
+void MappedFile::close() noexcept
+{
+    if (data_ != nullptr)
+        ::munmap(const_cast<std::uint8_t*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif
+
+} // namespace villain
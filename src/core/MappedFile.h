@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace villain {
+
+// Read-only memory map of a whole file. Opening costs a few system calls however large the
+// file is; pages are faulted in from the page cache as they are first read, and several
+// instances mapping the same file share those pages.
+//
+// Non-realtime. The mapping stays valid until close() or destruction; moving the object
+// moves the mapping without changing its address.
+class MappedFile {
+public:
+    // How the file will be read, as a hint for the kernel's read-ahead.
+    enum class Access {
+        Sequential,   // front to back, once: read well ahead
+        Random,       // scattered parts on demand: fault in only the pages touched
+    };
+
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Returns false (leaving the object closed) if the file is missing, empty or unmappable.
+    bool open(const std::string& path, Access access = Access::Sequential);
+    void close() noexcept;
+
+    bool isOpen() const noexcept { return data_ != nullptr; }
+    const std::uint8_t* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+
+    // Asks the kernel to start reading [offset, offset + length) in, without waiting for it.
+    // The range is clipped to the file.
+    void prefetch(std::size_t offset, std::size_t length) const noexcept;
+    // Same, for a range of any live mapping.
+    static void prefetchRange(const std::uint8_t* begin, std::size_t length) noexcept;
+
+private:
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+#if defined(_WIN32)
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+} // namespace villain
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#define VILLAIN_FORCE_INLINE __forceinline
+#define VILLAIN_RESTRICT __restrict
+#else
+#define VILLAIN_FORCE_INLINE inline __attribute__((always_inline))
+#define VILLAIN_RESTRICT __restrict__
+#endif
+
+namespace villain {
+
+// Every buffer handed to a DSP kernel is aligned for the widest vector unit we target.
+constexpr std::size_t kSimdAlignment = 64;
+
+// Upper bound on channels per bus; covers 7.1.4 and third-order ambisonics.
+constexpr int kMaxChannels = 16;
+
+constexpr std::size_t alignUp(std::size_t value, std::size_t alignment) noexcept
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace villain
@@ -0,0 +1,18 @@
+#pragma once
+
+namespace villain {
+
+// Everything the processor needs to know to size its pools before audio starts.
+struct ProcessSpec {
+    double sampleRate = 48000.0;
+    int maxBlockSize = 512;
+    int numChannels = 2;
+    // Helper threads the processor may start for wide layouts. 0 keeps all work on the
+    // host's audio thread, which suits hosts that already spread instances across cores.
+    int maxWorkerThreads = 0;
+    // The host renders faster than real time (bounce, export). The processor trades latency
+    // and per-block deadline for throughput and quality until the next prepare().
+    bool offline = false;
+};
+
+} // namespace villain
@@ -0,0 +1,49 @@
+#pragma once
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define VILLAIN_HAS_MXCSR 1
+#endif
+
+#include <cstdint>
+
+namespace villain {
+
+// Enables flush-to-zero and denormals-are-zero for the current thread and restores the
+// caller's mode on destruction. Only touches a control register: no system call, safe on the
+// audio thread. On targets without such a register it does nothing.
+class ScopedNoDenormals {
+public:
+    ScopedNoDenormals() noexcept
+    {
+#if defined(VILLAIN_HAS_MXCSR)
+        // FTZ (bit 15) and DAZ (bit 6).
+        saved_ = _mm_getcsr();
+        _mm_setcsr(saved_ | 0x8040u);
+#elif defined(__aarch64__)
+        std::uint64_t fpcr;
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+        saved_ = fpcr;
+        fpcr |= (1ull << 24); // FZ
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#endif
+    }
+
+    ~ScopedNoDenormals()
+    {
+#if defined(VILLAIN_HAS_MXCSR)
+        _mm_setcsr(static_cast<unsigned int>(saved_));
+#elif defined(__aarch64__)
+        const std::uint64_t fpcr = saved_;
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#endif
+    }
+
+    ScopedNoDenormals(const ScopedNoDenormals&) = delete;
+    ScopedNoDenormals& operator=(const ScopedNoDenormals&) = delete;
+
+private:
+    [[maybe_unused]] std::uint64_t saved_ = 0;
+};
+
+} // namespace villain
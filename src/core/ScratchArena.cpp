@@ -0,0 +1,28 @@
+#include "core/ScratchArena.h"
+
+#include <cassert>
+
+namespace villain {
+
+void ScratchArena::reserve(std::size_t bytes)
+{
+    storage_.allocate(alignUp(bytes, kSimdAlignment));
+    used_ = 0;
+    highWater_ = 0;
+}
+
+void* ScratchArena::allocate(std::size_t bytes) noexcept
+{
+    const std::size_t footprint = alignUp(bytes, kSimdAlignment);
+    if (used_ + footprint > storage_.size()) {
+        assert(false && "ScratchArena exhausted: prepare() under-sized the pool");
+        return nullptr;
+    }
+    void* ptr = storage_.data() + used_;
+    used_ += footprint;
+    if (used_ > highWater_)
+        highWater_ = used_;
+    return ptr;
+}
+
+} // namespace villain
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/AlignedBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace villain {
+
+// Bump allocator over a block of memory reserved in prepare(). The audio thread carves
+// per-block temporaries out of it and rewinds with a Frame; nothing here touches the heap
+// after reserve().
+class ScratchArena {
+public:
+    // Restores the arena to the position it had when the frame was opened.
+    class Frame {
+    public:
+        explicit Frame(ScratchArena& arena) noexcept : arena_(arena), mark_(arena.used_) {}
+        ~Frame() { arena_.used_ = mark_; }
+
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+
+    private:
+        ScratchArena& arena_;
+        std::size_t mark_;
+    };
+
+    // Non-realtime. Discards any previous storage.
+    void reserve(std::size_t bytes);
+
+    // Returns kSimdAlignment-aligned, uninitialised storage, or nullptr when the request does
+    // not fit. Running out means prepare() under-sized the pool; it is a bug, not a fallback.
+    void* allocate(std::size_t bytes) noexcept;
+
+    float* allocateFloats(std::size_t count) noexcept
+    {
+        return static_cast<float*>(allocate(count * sizeof(float)));
+    }
+
+    void reset() noexcept { used_ = 0; }
+
+    std::size_t capacity() const noexcept { return storage_.size(); }
+    std::size_t used() const noexcept { return used_; }
+    std::size_t highWaterMark() const noexcept { return highWater_; }
+
+    // Bytes a single float array of `count` elements consumes inside the arena.
+    static constexpr std::size_t floatFootprint(std::size_t count) noexcept
+    {
+        return alignUp(count * sizeof(float), kSimdAlignment);
+    }
+
+private:
+    AlignedBuffer<std::uint8_t> storage_;
+    std::size_t used_ = 0;
+    std::size_t highWater_ = 0;
+};
+
+} // namespace villain
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace villain {
+
+// Process-wide home for immutable tables (shaper curves, filter designs, oversampling
+// kernels). The first acquire() for a key builds the table; every later caller, in any
+// plugin instance, shares the same read-only copy until the last holder lets go.
+//
+// Non-realtime: takes a mutex and may allocate. Call from prepare(), keep the returned
+// pointer, and read through it on the audio thread.
+template <typename T>
+class SharedTable {
+public:
+    template <typename Build>
+    static std::shared_ptr<const T> acquire(std::uint64_t key, Build&& build)
+    {
+        Registry& registry = instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        for (auto it = registry.entries.begin(); it != registry.entries.end();) {
+            if (std::shared_ptr<const T> table = it->second.lock()) {
+                if (it->first == key)
+                    return table;
+                ++it;
+            } else {
+                it = registry.entries.erase(it);
+            }
+        }
+
+        std::shared_ptr<const T> table = std::make_shared<const T>(build());
+        registry.entries.emplace_back(key, table);
+        return table;
+    }
+
+    template <typename Build>
+    static std::shared_ptr<const T> acquire(Build&& build)
+    {
+        return acquire(0, std::forward<Build>(build));
+    }
+
+    // Number of distinct tables of this type currently alive.
+    static int liveCount()
+    {
+        Registry& registry = instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        int count = 0;
+        for (const auto& entry : registry.entries)
+            count += entry.second.expired() ? 0 : 1;
+        return count;
+    }
+
+private:
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::pair<std::uint64_t, std::weak_ptr<const T>>> entries;
+    };
+
+    static Registry& instance()
+    {
+        static Registry registry;
+        return registry;
+    }
+};
+
+} // namespace villain
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace villain {
+
+// Hands objects built on a non-realtime thread to the audio thread, and takes back the ones
+// they replace so they are destroyed off the audio thread. The audio thread never allocates,
+// frees or waits here: update() is an exchange, plus a push onto a lock-free list of
+// retired objects.
+//
+// One publishing thread and one audio thread. An empty object (nullptr) can be published
+// too, to switch a stage off. A stage that crossfades can hold on to the object it replaced
+// (updateKeepingPrevious()) until the fade is over.
+template <typename T>
+class SwapSlot {
+public:
+    SwapSlot() = default;
+    ~SwapSlot()
+    {
+        collect();
+        delete pending_.load(std::memory_order_acquire);
+        delete previous_;
+        delete current_;
+    }
+
+    SwapSlot(const SwapSlot&) = delete;
+    SwapSlot& operator=(const SwapSlot&) = delete;
+
+    // Non-realtime. Queues `value` for the audio thread's next update(). A value published
+    // earlier and not yet picked up is dropped; anything retired since the last call is freed.
+    void publish(std::unique_ptr<T> value)
+    {
+        Node* node = new Node{std::move(value), nullptr};
+        collect();
+        delete pending_.exchange(node, std::memory_order_acq_rel);
+    }
+
+    // Non-realtime. Frees everything the audio thread has let go of.
+    void collect()
+    {
+        Node* node = retired_.exchange(nullptr, std::memory_order_acquire);
+        while (node != nullptr) {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    // Non-realtime, with the audio thread stopped: installs `value` at once.
+    void replace(std::unique_ptr<T> value)
+    {
+        delete pending_.exchange(nullptr, std::memory_order_acq_rel);
+        delete previous_;
+        previous_ = nullptr;
+        delete current_;
+        current_ = new Node{std::move(value), nullptr};
+        collect();
+    }
+
+    // Audio thread. Adopts the latest published value, if there is one; true if it did.
+    bool update() noexcept
+    {
+        if (pending_.load(std::memory_order_relaxed) == nullptr)
+            return false;
+        Node* next = pending_.exchange(nullptr, std::memory_order_acquire);
+        if (next == nullptr)
+            return false;
+        if (current_ != nullptr)
+            retire(current_);
+        current_ = next;
+        return true;
+    }
+
+    // Audio thread. Like update(), but the value replaced stays alive as previous() until
+    // releasePrevious(). Nothing new is adopted while a previous value is still held.
+    bool updateKeepingPrevious() noexcept
+    {
+        if (previous_ != nullptr || pending_.load(std::memory_order_relaxed) == nullptr)
+            return false;
+        Node* next = pending_.exchange(nullptr, std::memory_order_acquire);
+        if (next == nullptr)
+            return false;
+        previous_ = current_;
+        current_ = next;
+        return true;
+    }
+
+    // Audio thread. Hands the previous value back for collect() to free.
+    void releasePrevious() noexcept
+    {
+        if (previous_ != nullptr)
+            retire(previous_);
+        previous_ = nullptr;
+    }
+
+    // Audio thread (or any thread while it is stopped).
+    T* get() const noexcept { return current_ != nullptr ? current_->value.get() : nullptr; }
+    T* previous() const noexcept { return previous_ != nullptr ? previous_->value.get() : nullptr; }
+
+private:
+    struct Node {
+        std::unique_ptr<T> value;
+        Node* next;
+    };
+
+    void retire(Node* node) noexcept
+    {
+        // Only collect() competes, and it only ever takes the whole list.
+        Node* head = retired_.load(std::memory_order_relaxed);
+        do {
+            node->next = head;
+        } while (!retired_.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    Node* current_ = nullptr;    // audio thread
+    Node* previous_ = nullptr;   // audio thread
+    std::atomic<Node*> pending_{nullptr};
+    std::atomic<Node*> retired_{nullptr};
+};
+
+} // namespace villain
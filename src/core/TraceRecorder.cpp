@@ -0,0 +1,81 @@
+#include "core/TraceRecorder.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace villain {
+
+void TraceRecorder::start(TraceRing& ring, std::chrono::milliseconds pollInterval)
+{
+    stop();
+    ring_ = &ring;
+    events_.clear();
+    dropped_ = ring.dropped();
+    stopping_.store(false, std::memory_order_relaxed);
+
+    startTime_ = std::chrono::steady_clock::now();
+    startTicks_ = traceTimestamp();
+
+    thread_ = std::thread([this, pollInterval] {
+        while (!stopping_.load(std::memory_order_acquire)) {
+            drain();
+            std::this_thread::sleep_for(pollInterval);
+        }
+    });
+}
+
+void TraceRecorder::stop()
+{
+    if (!thread_.joinable())
+        return;
+    stopping_.store(true, std::memory_order_release);
+    thread_.join();
+    drain();
+
+    const std::uint64_t endTicks = traceTimestamp();
+    const double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime_).count();
+    if (micros > 0.0 && endTicks > startTicks_)
+        ticksPerMicrosecond_ = static_cast<double>(endTicks - startTicks_) / micros;
+
+    dropped_ = ring_->dropped() - dropped_;
+    // Producers on different threads interleave; viewers expect time order.
+    std::stable_sort(events_.begin(), events_.end(),
+                     [](const TraceEvent& a, const TraceEvent& b) { return a.begin < b.begin; });
+}
+
+void TraceRecorder::drain()
+{
+    TraceEvent event;
+    while (ring_->pop(event))
+        events_.push_back(event);
+}
+
+bool TraceRecorder::writeChromeTrace(const std::string& path, const TraceFormat& format) const
+{
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr)
+        return false;
+
+    const std::uint64_t origin = events_.empty() ? startTicks_ : std::min(startTicks_, events_.front().begin);
+    const auto toMicros = [&](std::uint64_t ticks) { return static_cast<double>(ticks - origin) / ticksPerMicrosecond_; };
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped\":%llu},\"traceEvents\":[\n",
+                 static_cast<unsigned long long>(dropped_));
+    for (std::size_t i = 0; i < events_.size(); ++i) {
+        const TraceEvent& e = events_[i];
+        const char* name = e.stage < format.numStages ? format.stageNames[e.stage] : "unknown";
+        const double duration = toMicros(e.end) - toMicros(e.begin);
+        const double budget = e.samples / format.sampleRate * 1e6;
+        const bool overrun = e.stage == format.blockStage && duration > budget;
+
+        std::fprintf(file,
+                     "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                     "\"args\":{\"samples\":%u,\"budget_us\":%.1f}}%s\n",
+                     name, overrun ? "overrun" : "dsp", e.track, toMicros(e.begin), duration, e.samples, budget,
+                     i + 1 < events_.size() ? "," : "");
+    }
+    std::fprintf(file, "]}\n");
+    return std::fclose(file) == 0;
+}
+
+} // namespace villain
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "core/TraceRing.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace villain {
+
+// How to label a capture when it is written out.
+struct TraceFormat {
+    const char* const* stageNames = nullptr;
+    int numStages = 0;
+    // Spans of this stage cover a whole block; they are checked against the block's
+    // real-time budget and tagged "overrun" when they exceed it. -1 disables the check.
+    int blockStage = -1;
+    double sampleRate = 48000.0;
+};
+
+// Non-realtime consumer for a TraceRing: a background thread drains the ring into memory
+// until stop(), and the capture can then be saved as Chrome trace JSON (chrome://tracing,
+// Perfetto). Also samples the steady clock at both ends of the capture to convert raw
+// timestamps into microseconds.
+class TraceRecorder {
+public:
+    TraceRecorder() = default;
+    ~TraceRecorder() { stop(); }
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    // Discards any previous capture. The ring must outlive the capture.
+    void start(TraceRing& ring, std::chrono::milliseconds pollInterval = std::chrono::milliseconds(10));
+    // Joins the drain thread after a final drain.
+    void stop();
+
+    bool isRecording() const noexcept { return thread_.joinable(); }
+
+    // Valid after stop().
+    const std::vector<TraceEvent>& events() const noexcept { return events_; }
+    std::uint64_t dropped() const noexcept { return dropped_; }
+    double ticksPerMicrosecond() const noexcept { return ticksPerMicrosecond_; }
+
+    bool writeChromeTrace(const std::string& path, const TraceFormat& format) const;
+
+private:
+    void drain();
+
+    TraceRing* ring_ = nullptr;
+    std::thread thread_;
+    std::atomic<bool> stopping_{false};
+    std::vector<TraceEvent> events_;
+    std::uint64_t dropped_ = 0;
+
+    std::uint64_t startTicks_ = 0;
+    std::chrono::steady_clock::time_point startTime_;
+    double ticksPerMicrosecond_ = 1.0;
+};
+
+} // namespace villain
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+// Hot-path instrumentation is compiled in only with -DVILLAIN_TRACE=ON; otherwise the
+// VILLAIN_TRACE_* macros below expand to nothing and no ring is ever allocated.
+#ifndef VILLAIN_TRACE
+#define VILLAIN_TRACE 0
+#endif
+
+namespace villain {
+
+// Raw timestamp: the TSC on x86, steady-clock nanoseconds elsewhere. TraceRecorder converts
+// to wall time by sampling both clocks around a capture.
+inline std::uint64_t traceTimestamp() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// One timed span. `stage` indexes the plugin's stage names, `track` is the row a viewer
+// shows it on (one per chain).
+struct TraceEvent {
+    std::uint64_t begin = 0;
+    std::uint64_t end = 0;
+    std::uint32_t samples = 0;
+    std::uint16_t stage = 0;
+    std::uint16_t track = 0;
+};
+
+// Bounded multi-producer, single-consumer queue of TraceEvents. push() is wait-free in
+// practice (one compare-exchange, retried only against another producer) and drops the
+// event when the consumer has fallen behind, so tracing can never stall the audio thread.
+class TraceRing {
+public:
+    // Non-realtime. Capacity is rounded up to a power of two; 0 disables the ring.
+    void allocate(std::size_t capacity)
+    {
+        std::size_t size = capacity > 0 ? 1 : 0;
+        while (size < capacity)
+            size <<= 1;
+        slots_.reset(size > 0 ? new Slot[size] : nullptr);
+        mask_ = size > 0 ? size - 1 : 0;
+        capacity_ = size;
+        for (std::size_t i = 0; i < size; ++i)
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        head_.store(0, std::memory_order_relaxed);
+        tail_ = 0;
+        dropped_.store(0, std::memory_order_relaxed);
+    }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    // Any thread. False if the ring is full or unallocated.
+    bool push(const TraceEvent& event) noexcept
+    {
+        if (capacity_ == 0)
+            return false;
+        std::uint64_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            const std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::int64_t>(sequence - pos);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.event = event;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only.
+    bool pop(TraceEvent& event) noexcept
+    {
+        if (capacity_ == 0)
+            return false;
+        Slot& slot = slots_[tail_ & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1)
+            return false;
+        event = slot.event;
+        slot.sequence.store(tail_ + capacity_, std::memory_order_release);
+        ++tail_;
+        return true;
+    }
+
+    // Events lost to a full ring since allocate().
+    std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        TraceEvent event;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t mask_ = 0;
+    std::size_t capacity_ = 0;
+    alignas(64) std::atomic<std::uint64_t> head_{0};
+    alignas(64) std::uint64_t tail_ = 0;
+    std::atomic<std::uint64_t> dropped_{0};
+};
+
+// Times consecutive stages of one pass: each mark() closes the span since the previous mark
+// (or construction) and pushes it. A null or unallocated ring makes it a no-op.
+class TraceLap {
+public:
+    TraceLap(TraceRing* ring, int track, int samples) noexcept
+        : ring_(ring != nullptr && ring->capacity() > 0 ? ring : nullptr),
+          last_(ring_ != nullptr ? traceTimestamp() : 0),
+          track_(static_cast<std::uint16_t>(track)),
+          samples_(static_cast<std::uint32_t>(samples))
+    {
+    }
+
+    void mark(int stage) noexcept
+    {
+        if (ring_ == nullptr)
+            return;
+        const std::uint64_t now = traceTimestamp();
+        ring_->push({last_, now, samples_, static_cast<std::uint16_t>(stage), track_});
+        last_ = now;
+    }
+
+private:
+    TraceRing* ring_;
+    std::uint64_t last_;
+    std::uint16_t track_;
+    std::uint32_t samples_;
+};
+
+} // namespace villain
+
+#if VILLAIN_TRACE
+#define VILLAIN_TRACE_LAP(name, ring, track, samples) ::villain::TraceLap name((ring), (track), (samples))
+#define VILLAIN_TRACE_MARK(name, stage) name.mark(static_cast<int>(stage))
+#else
+#define VILLAIN_TRACE_LAP(name, ring, track, samples) static_cast<void>(0)
+#define VILLAIN_TRACE_MARK(name, stage) static_cast<void>(0)
+#endif
@@ -0,0 +1,170 @@
+#include "core/WorkerPool.h"
+
+#include "core/Futex.h"
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace villain {
+
+namespace {
+
+// How long an idle worker keeps spinning before it sleeps. Long enough to catch the next
+// job of a busy multi-job block, short enough not to burn a core between callbacks.
+constexpr auto kSpinTime = std::chrono::microseconds(100);
+
+inline void cpuRelax() noexcept
+{
+#if defined(__SSE2__) || defined(_M_X64)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+#if defined(__linux__)
+void raiseToRealtimePriority() noexcept
+{
+    // Best effort: without the privilege the workers keep the default policy, which only
+    // costs them the head start the caller does not depend on anyway.
+    sched_param param{};
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 1;
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+}
+#endif
+
+constexpr std::uint64_t makeClaim(std::uint32_t generation, int numTasks) noexcept
+{
+    return (static_cast<std::uint64_t>(generation) << 32) | (static_cast<std::uint64_t>(numTasks) << 16);
+}
+
+constexpr std::uint32_t claimedIndex(std::uint64_t claim) noexcept
+{
+    return static_cast<std::uint32_t>(claim & 0xffff);
+}
+
+constexpr std::uint32_t claimTaskCount(std::uint64_t claim) noexcept
+{
+    return static_cast<std::uint32_t>((claim >> 16) & 0xffff);
+}
+
+} // namespace
+
+void WorkerPool::start(int numWorkers)
+{
+    stop();
+    stopping_.store(false, std::memory_order_relaxed);
+    for (int i = 0; i < numWorkers; ++i)
+        threads_.emplace_back([this] { workerLoop(); });
+}
+
+void WorkerPool::stop()
+{
+    if (threads_.empty())
+        return;
+    stopping_.store(true, std::memory_order_release);
+    signal_.fetch_add(1, std::memory_order_release);
+    futexWake(signal_, static_cast<int>(threads_.size()));
+    for (std::thread& thread : threads_)
+        thread.join();
+    threads_.clear();
+}
+
+void WorkerPool::run(int numTasks, Task task, void* context) noexcept
+{
+    if (numTasks <= 0)
+        return;
+    numTasks = std::min(numTasks, kMaxTasks);
+
+    if (threads_.empty() || numTasks == 1) {
+        for (int i = 0; i < numTasks; ++i)
+            task(context, i);
+        return;
+    }
+
+    // Every task of the previous job has completed, so no worker can still be using the
+    // task and context being replaced here.
+    const std::uint64_t claim = makeClaim(static_cast<std::uint32_t>(claim_.load(std::memory_order_relaxed) >> 32) + 1,
+                                          numTasks);
+    task_.store(task, std::memory_order_relaxed);
+    context_.store(context, std::memory_order_relaxed);
+    pending_.store(numTasks, std::memory_order_relaxed);
+    claim_.store(claim, std::memory_order_release);
+    signal_.fetch_add(1, std::memory_order_seq_cst);
+    wakeWorkers(numTasks - 1);
+
+    drain(claim, task, context);
+    while (pending_.load(std::memory_order_acquire) != 0)
+        cpuRelax();
+}
+
+void WorkerPool::drain(std::uint64_t claim, Task task, void* context) noexcept
+{
+    const std::uint64_t job = claim & ~std::uint64_t{0xffff};
+    for (;;) {
+        // A different generation or an exhausted count means this job has nothing left.
+        if ((claim & ~std::uint64_t{0xffff}) != job || claimedIndex(claim) >= claimTaskCount(claim))
+            return;
+        if (!claim_.compare_exchange_weak(claim, claim + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            continue;
+
+        task(context, static_cast<int>(claimedIndex(claim)));
+        pending_.fetch_sub(1, std::memory_order_release);
+        claim = claim_.load(std::memory_order_acquire);
+    }
+}
+
+void WorkerPool::wakeWorkers(int count) noexcept
+{
+    // Pairs with the sleeper's increment-then-recheck: either it sees the new signal or we
+    // see it asleep.
+    if (sleepers_.load(std::memory_order_seq_cst) == 0)
+        return;
+    futexWake(signal_, count);
+}
+
+void WorkerPool::waitForJob(std::uint32_t seen) noexcept
+{
+    const auto spinUntil = std::chrono::steady_clock::now() + kSpinTime;
+    int spins = 0;
+    while (signal_.load(std::memory_order_acquire) == seen) {
+        cpuRelax();
+        if (++spins % 64 == 0 && std::chrono::steady_clock::now() > spinUntil)
+            break;
+    }
+
+    while (signal_.load(std::memory_order_acquire) == seen) {
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        // Returns immediately if the word has already moved on.
+        futexWait(signal_, seen);
+        sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+void WorkerPool::workerLoop() noexcept
+{
+#if defined(__linux__)
+    raiseToRealtimePriority();
+#endif
+    // Checking for stop after reading the signal means a stop issued at any point, even
+    // before this thread first ran, either shows up here or moves the signal on.
+    std::uint32_t seen = signal_.load(std::memory_order_acquire);
+    while (!stopping_.load(std::memory_order_acquire)) {
+        waitForJob(seen);
+        seen = signal_.load(std::memory_order_acquire);
+
+        const std::uint64_t claim = claim_.load(std::memory_order_acquire);
+        drain(claim, task_.load(std::memory_order_relaxed), context_.load(std::memory_order_relaxed));
+    }
+}
+
+} // namespace villain
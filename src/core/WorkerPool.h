@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace villain {
+
+// Small pool of helper threads for splitting one audio callback across cores.
+//
+// run() is called from the audio thread and never waits on a task nobody has started: the
+// caller claims tasks itself alongside the workers, so if every worker is asleep or
+// descheduled the job simply runs serially. The only wait is for tasks a worker already
+// claimed, which bounds the call by the single-threaded cost plus one task.
+//
+// Idle workers spin briefly after each job, then sleep on a futex (Linux) or yield
+// elsewhere. Waking a sleeping worker is the one system call the audio thread may make,
+// and only when a worker is actually asleep.
+class WorkerPool {
+public:
+    using Task = void (*)(void* context, int taskIndex) noexcept;
+
+    static constexpr int kMaxTasks = 0xffff;
+
+    WorkerPool() = default;
+    ~WorkerPool() { stop(); }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Non-realtime. Restarts the pool with `numWorkers` helper threads (0 stops it).
+    void start(int numWorkers);
+    void stop();
+
+    int numWorkers() const noexcept { return static_cast<int>(threads_.size()); }
+
+    // Runs task(context, i) for every i in [0, numTasks) and returns once all have finished.
+    // One caller at a time; numTasks is capped at kMaxTasks.
+    void run(int numTasks, Task task, void* context) noexcept;
+
+private:
+    void workerLoop() noexcept;
+    void waitForJob(std::uint32_t seen) noexcept;
+    void wakeWorkers(int count) noexcept;
+    // Claims and runs tasks of the job published in `claim` until none are left.
+    void drain(std::uint64_t claim, Task task, void* context) noexcept;
+
+    std::vector<std::thread> threads_;
+
+    // Published before claim_ and stable until the job's last task completes.
+    std::atomic<Task> task_{nullptr};
+    std::atomic<void*> context_{nullptr};
+    // Generation (bits 32-63), task count (16-31) and next unclaimed index (0-15). Claiming
+    // with a compare-exchange on the whole word means a slow worker can never take a task
+    // from a later job than the one whose task and context it read.
+    std::atomic<std::uint64_t> claim_{0};
+    std::atomic<int> pending_{0};
+    // Futex word: bumped once per job and on stop.
+    std::atomic<std::uint32_t> signal_{0};
+    std::atomic<int> sleepers_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace villain
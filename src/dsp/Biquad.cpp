@@ -0,0 +1,103 @@
+#include "dsp/Biquad.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace villain::dsp {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+double clampFrequency(double sampleRate, double frequency) noexcept
+{
+    return std::clamp(frequency, 1.0, sampleRate * 0.49);
+}
+
+} // namespace
+
+BiquadCoefficients BiquadCoefficients::lowPass(double sampleRate, double frequency, double q) noexcept
+{
+    const double w0 = 2.0 * kPi * clampFrequency(sampleRate, frequency) / sampleRate;
+    const double cosW0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double a0 = 1.0 + alpha;
+
+    BiquadCoefficients c;
+    c.b0 = static_cast<float>((1.0 - cosW0) * 0.5 / a0);
+    c.b1 = static_cast<float>((1.0 - cosW0) / a0);
+    c.b2 = c.b0;
+    c.a1 = static_cast<float>(-2.0 * cosW0 / a0);
+    c.a2 = static_cast<float>((1.0 - alpha) / a0);
+    return c;
+}
+
+BiquadCoefficients BiquadCoefficients::highPass(double sampleRate, double frequency, double q) noexcept
+{
+    const double w0 = 2.0 * kPi * clampFrequency(sampleRate, frequency) / sampleRate;
+    const double cosW0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double a0 = 1.0 + alpha;
+
+    BiquadCoefficients c;
+    c.b0 = static_cast<float>((1.0 + cosW0) * 0.5 / a0);
+    c.b1 = static_cast<float>(-(1.0 + cosW0) / a0);
+    c.b2 = c.b0;
+    c.a1 = static_cast<float>(-2.0 * cosW0 / a0);
+    c.a2 = static_cast<float>((1.0 - alpha) / a0);
+    return c;
+}
+
+BiquadCoefficients BiquadCoefficients::allPass(double sampleRate, double frequency, double q) noexcept
+{
+    const double w0 = 2.0 * kPi * clampFrequency(sampleRate, frequency) / sampleRate;
+    const double cosW0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double a0 = 1.0 + alpha;
+
+    BiquadCoefficients c;
+    c.a1 = static_cast<float>(-2.0 * cosW0 / a0);
+    c.a2 = static_cast<float>((1.0 - alpha) / a0);
+    c.b0 = c.a2;
+    c.b1 = c.a1;
+    c.b2 = 1.0f;
+    return c;
+}
+
+BiquadCoefficients BiquadCoefficients::dcBlocker(double sampleRate, double frequency) noexcept
+{
+    const double k = std::tan(kPi * clampFrequency(sampleRate, frequency) / sampleRate);
+
+    BiquadCoefficients c;
+    c.b0 = static_cast<float>(1.0 / (1.0 + k));
+    c.b1 = -c.b0;
+    c.a1 = static_cast<float>((k - 1.0) / (1.0 + k));
+    return c;
+}
+
+simd::BiquadKernelCoefficients Biquad::makeIdentityKernel() noexcept
+{
+    simd::BiquadKernelCoefficients k;
+    k.compute(1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    return k;
+}
+
+void Biquad::setCoefficients(const BiquadCoefficients& coefficients) noexcept
+{
+    coeffs_ = coefficients;
+    kernelCoeffs_.compute(coefficients.b0, coefficients.b1, coefficients.b2, coefficients.a1, coefficients.a2);
+}
+
+void Biquad::process(const AudioBlock& block) noexcept
+{
+    const auto kernel = simd::activeKernels().biquad;
+    for (int ch = 0; ch < block.numChannels(); ++ch)
+        kernel(block.channel(ch), block.numSamples(), kernelCoeffs_, state_[ch].z1, state_[ch].z2);
+}
+
+void Biquad::processChannel(int channel, float* data, int numSamples) noexcept
+{
+    simd::activeKernels().biquad(data, numSamples, kernelCoeffs_, state_[channel].z1, state_[channel].z2);
+}
+
+} // namespace villain::dsp
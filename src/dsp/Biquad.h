@@ -0,0 +1,48 @@
+#pragma once
+
+#include "core/AudioBlock.h"
+#include "dsp/simd/Kernels.h"
+
+#include <array>
+
+namespace villain::dsp {
+
+// Normalised (a0 == 1) second-order section coefficients.
+struct BiquadCoefficients {
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;
+    float a1 = 0.0f, a2 = 0.0f;
+
+    static BiquadCoefficients lowPass(double sampleRate, double frequency, double q) noexcept;
+    static BiquadCoefficients highPass(double sampleRate, double frequency, double q) noexcept;
+    static BiquadCoefficients allPass(double sampleRate, double frequency, double q) noexcept;
+    // First-order (one-pole, one-zero) high-pass: a zero at DC, unity gain at Nyquist.
+    static BiquadCoefficients dcBlocker(double sampleRate, double frequency) noexcept;
+};
+
+// Transposed direct form II biquad with one state pair per channel. State lives inline, so
+// the filter is usable on the audio thread as soon as it is constructed. Setting coefficients
+// also re-derives the vector-unrolled form the SIMD kernels run.
+class Biquad {
+public:
+    void setCoefficients(const BiquadCoefficients& coefficients) noexcept;
+    const BiquadCoefficients& coefficients() const noexcept { return coeffs_; }
+
+    void reset() noexcept { state_ = {}; }
+
+    void process(const AudioBlock& block) noexcept;
+    void processChannel(int channel, float* data, int numSamples) noexcept;
+
+private:
+    static simd::BiquadKernelCoefficients makeIdentityKernel() noexcept;
+
+    struct State {
+        float z1 = 0.0f;
+        float z2 = 0.0f;
+    };
+
+    BiquadCoefficients coeffs_;
+    simd::BiquadKernelCoefficients kernelCoeffs_ = makeIdentityKernel();
+    std::array<State, kMaxChannels> state_{};
+};
+
+} // namespace villain::dsp
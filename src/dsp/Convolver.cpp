@@ -0,0 +1,326 @@
+#include "dsp/Convolver.h"
+
+#include "core/Futex.h"
+#include "core/Platform.h"
+#include "dsp/simd/Kernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace villain::dsp {
+
+namespace {
+
+void copySamples(float* dst, const float* src, int count) noexcept
+{
+    std::memcpy(dst, src, sizeof(float) * static_cast<std::size_t>(count));
+}
+
+void addSamples(float* dst, const float* src, int count) noexcept
+{
+    for (int i = 0; i < count; ++i)
+        dst[i] += src[i];
+}
+
+// Wrap-safe ordering of period counters.
+bool isBefore(std::uint32_t a, std::uint32_t b) noexcept
+{
+    return static_cast<std::int32_t>(a - b) < 0;
+}
+
+} // namespace
+
+void PartitionedFilter::prepare(const ImpulseResponseView& ir, int offset, int length, int partitionSize, int numInputs)
+{
+    partitionSize_ = partitionSize;
+    numIrChannels_ = std::max(ir.numChannels, 1);
+    numPartitions_ = length > 0 ? (length + partitionSize - 1) / partitionSize : 0;
+    if (numPartitions_ == 0)
+        return;
+
+    const int fftSize = 2 * partitionSize;
+    fft_.prepare(fftSize);
+    numBins_ = fft_.numBins();
+    binStride_ = static_cast<int>(alignUp(static_cast<std::size_t>(numBins_), kSimdAlignment / sizeof(float)));
+
+    const std::size_t filterSize = static_cast<std::size_t>(numIrChannels_) * numPartitions_ * binStride_;
+    filterRe_.allocate(filterSize);
+    filterIm_.allocate(filterSize);
+    AlignedBuffer<float> segment(static_cast<std::size_t>(fftSize));
+    const float scale = 1.0f / static_cast<float>(fftSize);
+    for (int ch = 0; ch < ir.numChannels; ++ch) {
+        const float* taps = ir.channel(ch);
+        for (int p = 0; p < numPartitions_; ++p) {
+            // Each partition sits in the first half of a zero-padded frame.
+            segment.clear();
+            const int first = offset + p * partitionSize;
+            const int last = std::min({first + partitionSize, offset + length, ir.numFrames});
+            for (int i = first; i < last; ++i)
+                segment[static_cast<std::size_t>(i - first)] = taps[i];
+
+            float* re = spectrum(filterRe_, ch, p);
+            float* im = spectrum(filterIm_, ch, p);
+            fft_.forward(segment.data(), re, im);
+            for (int k = 0; k < numBins_; ++k) {
+                re[k] *= scale;
+                im[k] *= scale;
+            }
+        }
+    }
+
+    const std::size_t delaySize = static_cast<std::size_t>(numInputs) * numPartitions_ * binStride_;
+    delayRe_.allocate(delaySize);
+    delayIm_.allocate(delaySize);
+    newest_.allocate(static_cast<std::size_t>(numInputs));
+    history_.allocate(static_cast<std::size_t>(numInputs) * fftSize);
+    accRe_.allocate(static_cast<std::size_t>(binStride_));
+    accIm_.allocate(static_cast<std::size_t>(binStride_));
+    time_.allocate(static_cast<std::size_t>(fftSize));
+}
+
+void PartitionedFilter::reset() noexcept
+{
+    delayRe_.clear();
+    delayIm_.clear();
+    newest_.clear();
+    history_.clear();
+}
+
+void PartitionedFilter::process(int input, const float* in, float* out) noexcept
+{
+    const simd::KernelTable& kernels = simd::activeKernels();
+    const int size = partitionSize_;
+
+    // Overlap-save: transform the last two partitions of input...
+    float* history = history_.data() + static_cast<std::size_t>(input) * 2 * size;
+    std::memmove(history, history + size, sizeof(float) * static_cast<std::size_t>(size));
+    copySamples(history + size, in, size);
+
+    int& newest = newest_[static_cast<std::size_t>(input)];
+    newest = newest == 0 ? numPartitions_ - 1 : newest - 1;
+    fft_.forward(history, spectrum(delayRe_, input, newest), spectrum(delayIm_, input, newest));
+
+    // ...multiply-accumulate the spectrum p partitions old with filter partition p...
+    accRe_.clear();
+    accIm_.clear();
+    const int irChannel = input % numIrChannels_;
+    for (int p = 0, slot = newest; p < numPartitions_; ++p) {
+        kernels.complexMultiplyAdd(accRe_.data(), accIm_.data(), spectrum(delayRe_, input, slot),
+                                   spectrum(delayIm_, input, slot), spectrum(filterRe_, irChannel, p),
+                                   spectrum(filterIm_, irChannel, p), numBins_);
+        slot = slot + 1 == numPartitions_ ? 0 : slot + 1;
+    }
+
+    // ...and keep the half of the inverse that circular wrap-around has not touched.
+    fft_.inverse(accRe_.data(), accIm_.data(), time_.data());
+    copySamples(out, time_.data() + size, size);
+}
+
+void Convolver::prepare(const ImpulseResponseView& ir, int numChannels, bool backgroundTail)
+{
+    stopWorker();
+
+    length_ = ir.numFrames;
+    numChannels_ = numChannels;
+    numIrChannels_ = std::max(ir.numChannels, 1);
+
+    headTaps_.allocate(static_cast<std::size_t>(numIrChannels_) * kHeadLength);
+    for (int ch = 0; ch < ir.numChannels; ++ch) {
+        const float* taps = ir.channel(ch);
+        for (int j = 0; j < kHeadLength; ++j) {
+            const int tap = kHeadLength - 1 - j;
+            if (tap < length_)
+                headTaps_[static_cast<std::size_t>(ch * kHeadLength + j)] = taps[tap];
+        }
+    }
+    headHistory_.allocate(static_cast<std::size_t>(numChannels) * (kHeadLength - 1 + kBodyPartition));
+    bodyOutput_.allocate(static_cast<std::size_t>(numChannels) * kBodyPartition);
+    wet_.allocate(kBodyPartition);
+
+    static_assert(kHeadLength == kBodyPartition, "the body starts where the head ends");
+    static_assert(kTailStart % kBodyPartition == 0 && kTailPartition % kBodyPartition == 0,
+                  "tail periods end on body partition boundaries");
+    body_.prepare(ir, kHeadLength, std::min(length_, kTailStart) - kHeadLength, kBodyPartition, numChannels);
+    tail_.prepare(ir, kTailStart, length_ - kTailStart, kTailPartition, numChannels);
+
+    if (tail_.isActive()) {
+        slotInput_.allocate(static_cast<std::size_t>(kTailSlots) * numChannels * kTailPartition);
+        slotOutput_.allocate(static_cast<std::size_t>(kTailSlots) * numChannels * kTailPartition);
+    }
+    for (std::atomic<std::uint32_t>& state : slotState_)
+        state.store(SlotFree, std::memory_order_relaxed);
+    period_ = 0;
+    firstPeriod_ = 0;
+    workerNext_ = 0;
+    tailFill_ = 0;
+    outputSlot_ = -1;
+    underruns_.store(0, std::memory_order_relaxed);
+    claimSlots();
+
+    bodyFill_ = 0;
+    if (backgroundTail && tail_.isActive()) {
+        stopping_.store(false, std::memory_order_relaxed);
+        worker_ = std::thread([this] { workerLoop(); });
+    }
+}
+
+void Convolver::reset() noexcept
+{
+    headHistory_.clear();
+    bodyOutput_.clear();
+    body_.reset();
+    bodyFill_ = 0;
+
+    if (!tail_.isActive())
+        return;
+    // The worker owns the tail filter, so rather than clearing it, skip a period: the gap in
+    // block numbers tells it to start over before the next block.
+    if (outputSlot_ >= 0)
+        slotState_[outputSlot_].store(SlotFree, std::memory_order_release);
+    outputSlot_ = -1;
+    period_ += 2;
+    firstPeriod_ = period_;
+    tailFill_ = 0;
+    claimSlots();
+}
+
+void Convolver::process(const AudioBlock& block) noexcept
+{
+    const simd::KernelTable& kernels = simd::activeKernels();
+    const int historyStride = kHeadLength - 1 + kBodyPartition;
+    const int channels = std::min(block.numChannels(), numChannels_);
+    const bool tail = tail_.isActive();
+    float* wet = wet_.data();
+
+    for (int pos = 0; pos < block.numSamples();) {
+        // Tail periods are whole body partitions, so one run never crosses either boundary.
+        const int len = std::min(block.numSamples() - pos, kBodyPartition - bodyFill_);
+        for (int ch = 0; ch < channels; ++ch) {
+            float* x = block.channel(ch) + pos;
+            float* history = headHistory_.data() + static_cast<std::size_t>(ch) * historyStride;
+            copySamples(history + kHeadLength - 1 + bodyFill_, x, len);
+            if (tail && inputSlot_ >= 0)
+                copySamples(slotInput(inputSlot_, ch) + tailFill_, x, len);
+
+            kernels.convolve(history + bodyFill_, headTaps_.data() + (ch % numIrChannels_) * kHeadLength,
+                             kHeadLength, wet, len);
+            if (body_.isActive())
+                addSamples(wet, bodyOutput_.data() + ch * kBodyPartition + bodyFill_, len);
+            if (outputSlot_ >= 0)
+                addSamples(wet, slotOutput(outputSlot_, ch) + tailFill_, len);
+            copySamples(x, wet, len);
+        }
+
+        pos += len;
+        bodyFill_ += len;
+        if (bodyFill_ == kBodyPartition) {
+            for (int ch = 0; ch < channels; ++ch) {
+                float* history = headHistory_.data() + static_cast<std::size_t>(ch) * historyStride;
+                if (body_.isActive())
+                    body_.process(ch, history + kHeadLength - 1, bodyOutput_.data() + ch * kBodyPartition);
+                std::memmove(history, history + kBodyPartition, sizeof(float) * (kHeadLength - 1));
+            }
+            bodyFill_ = 0;
+        }
+        if (tail) {
+            tailFill_ += len;
+            if (tailFill_ == kTailPartition)
+                advanceTailPeriod();
+        }
+    }
+}
+
+void Convolver::advanceTailPeriod() noexcept
+{
+    if (inputSlot_ >= 0) {
+        slotPeriod_[inputSlot_] = period_;
+        slotState_[inputSlot_].store(SlotSubmitted, std::memory_order_release);
+        if (!worker_.joinable()) {
+            runNextTailBlock();
+        } else {
+            // Pairs with the worker's increment-then-recheck, as in WorkerPool.
+            signal_.fetch_add(1, std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_seq_cst) != 0)
+                futexWake(signal_, 1);
+        }
+    }
+    if (outputSlot_ >= 0)
+        slotState_[outputSlot_].store(SlotFree, std::memory_order_release);
+
+    ++period_;
+    tailFill_ = 0;
+    claimSlots();
+}
+
+void Convolver::claimSlots() noexcept
+{
+    // This period plays the tail of the block submitted two periods ago...
+    outputSlot_ = -1;
+    if (!isBefore(period_ - 2, firstPeriod_)) {
+        const int slot = static_cast<int>((period_ - 2) % kTailSlots);
+        if (slotState_[slot].load(std::memory_order_acquire) == SlotDone && slotPeriod_[slot] == period_ - 2)
+            outputSlot_ = slot;
+        else
+            underruns_.store(underruns_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // ...and fills the slot that block used four periods ago, unless the worker still has it.
+    const int slot = static_cast<int>(period_ % kTailSlots);
+    std::uint32_t state = slotState_[slot].load(std::memory_order_acquire);
+    if (state == SlotDone) {
+        // Finished too late to be played.
+        slotState_[slot].store(SlotFree, std::memory_order_relaxed);
+        state = SlotFree;
+    }
+    inputSlot_ = state == SlotFree ? slot : -1;
+}
+
+bool Convolver::runNextTailBlock() noexcept
+{
+    // Oldest submitted block first, so the filter's delay line sees the periods in order.
+    int next = -1;
+    for (int slot = 0; slot < kTailSlots; ++slot) {
+        if (slotState_[slot].load(std::memory_order_acquire) == SlotSubmitted &&
+            (next < 0 || isBefore(slotPeriod_[slot], slotPeriod_[next])))
+            next = slot;
+    }
+    if (next < 0)
+        return false;
+
+    // A skipped period (dropped input or reset) means the history no longer lines up.
+    if (slotPeriod_[next] != workerNext_)
+        tail_.reset();
+    for (int ch = 0; ch < numChannels_; ++ch)
+        tail_.process(ch, slotInput(next, ch), slotOutput(next, ch));
+    workerNext_ = slotPeriod_[next] + 1;
+    slotState_[next].store(SlotDone, std::memory_order_release);
+    return true;
+}
+
+void Convolver::workerLoop() noexcept
+{
+    for (;;) {
+        const std::uint32_t seen = signal_.load(std::memory_order_acquire);
+        if (stopping_.load(std::memory_order_acquire))
+            return;
+        while (runNextTailBlock()) {
+        }
+        while (signal_.load(std::memory_order_acquire) == seen) {
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            futexWait(signal_, seen);
+            sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+}
+
+void Convolver::stopWorker()
+{
+    if (!worker_.joinable())
+        return;
+    stopping_.store(true, std::memory_order_release);
+    signal_.fetch_add(1, std::memory_order_seq_cst);
+    futexWake(signal_, 1);
+    worker_.join();
+}
+
+} // namespace villain::dsp
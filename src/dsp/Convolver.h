@@ -0,0 +1,148 @@
+#pragma once
+
+#include "core/AlignedBuffer.h"
+#include "core/AudioBlock.h"
+#include "dsp/Fft.h"
+#include "dsp/ImpulseResponse.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace villain::dsp {
+
+// Uniformly partitioned overlap-save convolution with a frequency-domain delay line. Each
+// call takes one partition of input and returns the next partition of output: the block
+// convolved with the filter, one partition late. Holds the filter spectra of every IR
+// channel and a delay line per input; input i uses IR channel i % numChannels.
+//
+// prepare() allocates; process() and reset() are audio-thread safe.
+class PartitionedFilter {
+public:
+    // Taps [offset, offset + length) of every IR channel, cut into partitions.
+    void prepare(const ImpulseResponseView& ir, int offset, int length, int partitionSize, int numInputs);
+    void reset() noexcept;
+
+    bool isActive() const noexcept { return numPartitions_ > 0; }
+    int partitionSize() const noexcept { return partitionSize_; }
+
+    // `in` and `out` hold partitionSize() samples each.
+    void process(int input, const float* in, float* out) noexcept;
+
+private:
+    float* spectrum(AlignedBuffer<float>& buffer, int row, int partition) noexcept
+    {
+        return buffer.data() + (static_cast<std::size_t>(row) * numPartitions_ + partition) * binStride_;
+    }
+
+    RealFft fft_;
+    int partitionSize_ = 0;
+    int numBins_ = 0;
+    int binStride_ = 0;
+    int numPartitions_ = 0;
+    int numIrChannels_ = 0;
+    AlignedBuffer<float> filterRe_;   // [irChannel][partition][bin], scaled by 1 / fftSize
+    AlignedBuffer<float> filterIm_;
+    AlignedBuffer<float> delayRe_;    // [input][partition][bin], ring of input spectra
+    AlignedBuffer<float> delayIm_;
+    AlignedBuffer<int> newest_;       // [input] ring slot of the latest spectrum
+    AlignedBuffer<float> history_;    // [input][2 * partitionSize] last two input partitions
+    AlignedBuffer<float> accRe_;
+    AlignedBuffer<float> accIm_;
+    AlignedBuffer<float> time_;
+};
+
+// Zero-latency convolution with an impulse response of any length, as a non-uniform
+// partition scheme:
+//   head  taps [0, 64)      direct-form FIR (the convolve kernel), so nothing is delayed;
+//   body  taps [64, 2048)   64-sample FFT partitions, run on the audio thread every 64 samples;
+//   tail  taps [2048, end)  1024-sample FFT partitions on a background thread.
+// Each tail block is handed over through a ring of kTailSlots slots when its 1024 input
+// samples are in and its output is not needed until one whole period later. The worker
+// therefore has a full period to finish. If it misses that, the period goes out without
+// the tail and the miss is counted in tailUnderruns(), but the audio thread never waits.
+// Inline mode (no thread) computes each tail block as soon as its input is complete: the
+// same result deterministically, for offline rendering and tests, at the cost of a CPU
+// spike every 1024 samples.
+//
+// prepare() allocates and starts the worker; process() and reset() are audio-thread safe
+// and make at most one system call (waking a sleeping worker) per 1024 samples.
+class Convolver {
+public:
+    static constexpr int kHeadLength = 64;
+    static constexpr int kBodyPartition = 64;
+    static constexpr int kTailPartition = 1024;
+    static constexpr int kTailStart = 2 * kTailPartition;
+    static constexpr int kTailSlots = 4;
+
+    Convolver() = default;
+    ~Convolver() { stopWorker(); }
+
+    Convolver(const Convolver&) = delete;
+    Convolver& operator=(const Convolver&) = delete;
+
+    // Non-realtime. `ir` must already be at the processing rate; its taps are only read here.
+    void prepare(const ImpulseResponseView& ir, int numChannels, bool backgroundTail);
+    void reset() noexcept;
+
+    int length() const noexcept { return length_; }
+    int numChannels() const noexcept { return numChannels_; }
+    bool hasBackgroundTail() const noexcept { return worker_.joinable(); }
+    // Tail periods that went out silent because the worker was late.
+    std::uint64_t tailUnderruns() const noexcept { return underruns_.load(std::memory_order_relaxed); }
+
+    // Replaces every channel with its convolution; the block carries numChannels() channels.
+    void process(const AudioBlock& block) noexcept;
+
+private:
+    enum SlotState : std::uint32_t { SlotFree, SlotSubmitted, SlotDone };
+
+    float* slotInput(int slot, int channel) noexcept
+    {
+        return slotInput_.data() + (static_cast<std::size_t>(slot) * numChannels_ + channel) * kTailPartition;
+    }
+    float* slotOutput(int slot, int channel) noexcept
+    {
+        return slotOutput_.data() + (static_cast<std::size_t>(slot) * numChannels_ + channel) * kTailPartition;
+    }
+
+    void advanceTailPeriod() noexcept;
+    void claimSlots() noexcept;
+    bool runNextTailBlock() noexcept;
+    void workerLoop() noexcept;
+    void stopWorker();
+
+    int length_ = 0;
+    int numChannels_ = 0;
+    int numIrChannels_ = 0;
+    AlignedBuffer<float> headTaps_;      // [irChannel][kHeadLength], reversed for the kernel
+    // [channel][kHeadLength - 1 + kBodyPartition]: the input samples the head needs, with the
+    // current body partition at offset kHeadLength - 1.
+    AlignedBuffer<float> headHistory_;
+    AlignedBuffer<float> bodyOutput_;    // [channel][kBodyPartition]
+    AlignedBuffer<float> wet_;
+    PartitionedFilter body_;
+    int bodyFill_ = 0;
+
+    // Tail: the worker owns tail_ and every slot it finds Submitted; the audio thread owns
+    // the rest. A slot's state is the hand-off.
+    PartitionedFilter tail_;
+    AlignedBuffer<float> slotInput_;     // [slot][channel][kTailPartition]
+    AlignedBuffer<float> slotOutput_;
+    std::atomic<std::uint32_t> slotState_[kTailSlots] = {};
+    std::uint32_t slotPeriod_[kTailSlots] = {};
+    std::uint32_t period_ = 0;           // tail period being filled
+    std::uint32_t firstPeriod_ = 0;      // first period with input since reset
+    int tailFill_ = 0;
+    int inputSlot_ = -1;                 // -1: the period's input is dropped
+    int outputSlot_ = -1;                // -1: the period has no tail output
+    std::uint32_t workerNext_ = 0;       // period the tail filter state expects next
+    std::atomic<std::uint64_t> underruns_{0};
+
+    std::thread worker_;
+    std::atomic<std::uint32_t> signal_{0};
+    std::atomic<int> sleepers_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace villain::dsp
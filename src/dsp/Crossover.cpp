@@ -0,0 +1,109 @@
+#include "dsp/Crossover.h"
+
+#include "dsp/Biquad.h"
+
+#include <algorithm>
+
+namespace villain::dsp {
+
+namespace {
+
+// Butterworth Q: two cascaded sections give the Linkwitz-Riley response.
+constexpr double kButterworthQ = 0.70710678118654752;
+
+void setSection(simd::CrossoverKernelCoefficients& c, int section, int lane, const BiquadCoefficients& biquad) noexcept
+{
+    c.b0[section][lane] = biquad.b0;
+    c.b1[section][lane] = biquad.b1;
+    c.b2[section][lane] = biquad.b2;
+    c.a1[section][lane] = biquad.a1;
+    c.a2[section][lane] = biquad.a2;
+}
+
+// Sections band `band` of `numBands` filters through before its identity padding: two per
+// high- or low-pass crossover, one per allpass; none for a lane beyond the bands.
+int bandSections(int band, int numBands) noexcept
+{
+    if (band >= numBands)
+        return 0;
+    const int numSplits = numBands - 1;
+    return band < numSplits ? 2 * band + 2 + (numSplits - band - 1) : 2 * numSplits;
+}
+
+} // namespace
+
+void Crossover::prepare(int numChannels)
+{
+    numChannels_ = numChannels;
+    state_.allocate(static_cast<std::size_t>(simd::kCrossoverStateSize) * static_cast<std::size_t>(numChannels));
+}
+
+void Crossover::reset() noexcept
+{
+    state_.clear();
+}
+
+void Crossover::setBands(double sampleRate, int numBands, const float* frequencies) noexcept
+{
+    numBands = std::clamp(numBands, 1, kMaxBands);
+    if (numBands != numBands_) {
+        clearStaleState(numBands_, numBands);
+        numBands_ = numBands;
+    }
+
+    // Every section starts as an identity in the used lanes and as silence in the rest.
+    simd::CrossoverKernelCoefficients& c = coefficients_;
+    c.numSections = std::max(1, 2 * numBands - 2);
+    BiquadCoefficients identity;
+    BiquadCoefficients silence;
+    silence.b0 = 0.0f;
+    for (int s = 0; s < simd::kMaxCrossoverSections; ++s)
+        for (int lane = 0; lane < simd::kCrossoverLanes; ++lane)
+            setSection(c, s, lane, lane < numBands ? identity : silence);
+
+    const int numSplits = numBands - 1;
+    for (int band = 0; band < numBands; ++band) {
+        int section = 0;
+        for (int split = 0; split < numSplits; ++split) {
+            const double f = frequencies[split];
+            if (split < band) {
+                const BiquadCoefficients hp = BiquadCoefficients::highPass(sampleRate, f, kButterworthQ);
+                setSection(c, section++, band, hp);
+                setSection(c, section++, band, hp);
+            } else if (split == band) {
+                const BiquadCoefficients lp = BiquadCoefficients::lowPass(sampleRate, f, kButterworthQ);
+                setSection(c, section++, band, lp);
+                setSection(c, section++, band, lp);
+            } else {
+                setSection(c, section++, band, BiquadCoefficients::allPass(sampleRate, f, kButterworthQ));
+            }
+        }
+    }
+}
+
+void Crossover::clearStaleState(int oldBands, int newBands) noexcept
+{
+    // A band keeps the memories of the leading sections it runs in both layouts; the rest
+    // either held an older layout's filters or pad the band out as identities and must not
+    // leak into it.
+    constexpr int L = simd::kCrossoverLanes;
+    constexpr int S = simd::kMaxCrossoverSections;
+    for (int ch = 0; ch < numChannels_; ++ch) {
+        float* state = state_.data() + static_cast<std::size_t>(ch) * simd::kCrossoverStateSize;
+        for (int lane = 0; lane < L; ++lane) {
+            const int kept = std::min(bandSections(lane, oldBands), bandSections(lane, newBands));
+            for (int s = kept; s < S; ++s) {
+                state[s * L + lane] = 0.0f;
+                state[(S + s) * L + lane] = 0.0f;
+            }
+        }
+    }
+}
+
+void Crossover::split(int channel, const float* in, float* lanes, int numFrames) noexcept
+{
+    float* state = state_.data() + static_cast<std::size_t>(channel) * simd::kCrossoverStateSize;
+    simd::activeKernels().crossoverSplit(in, lanes, numFrames, coefficients_, state);
+}
+
+} // namespace villain::dsp
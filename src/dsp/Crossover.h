@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/AlignedBuffer.h"
+#include "dsp/simd/Kernels.h"
+
+namespace villain::dsp {
+
+constexpr int kMaxBands = 6;
+static_assert(kMaxBands <= simd::kCrossoverLanes, "every band needs a lane");
+static_assert(2 * kMaxBands - 2 <= simd::kMaxCrossoverSections, "longest band chain must fit");
+
+// Linkwitz-Riley (24 dB/oct) band splitter for 1 to kMaxBands bands.
+//
+// Band k is HP(f_0) .. HP(f_k-1) . LP(f_k) . AP(f_k+1) .. AP(f_last). The allpasses are the
+// phase response of the crossovers the band does not pass through, so the bands sum to one
+// common allpass and stay phase-coherent whatever is done to each band's level. Each band's
+// chain lives in its own lane of a structure-of-arrays cascade, so one vector op advances
+// the same section of every band at once.
+class Crossover {
+public:
+    void prepare(int numChannels);
+    void reset() noexcept;
+
+    // `frequencies` holds numBands - 1 ascending split points. Moving them keeps all state.
+    // Changing the band count keeps the state of the bands that remain, so they carry on
+    // rather than restart from silence; bands and sections that come into use start from
+    // rest. Those still step, so the processor crossfades a count change instead of making
+    // it here.
+    void setBands(double sampleRate, int numBands, const float* frequencies) noexcept;
+    int numBands() const noexcept { return numBands_; }
+
+    // Writes numFrames frames of simd::kCrossoverLanes band samples; unused lanes are zero.
+    void split(int channel, const float* in, float* lanes, int numFrames) noexcept;
+
+private:
+    void clearStaleState(int oldBands, int newBands) noexcept;
+
+    simd::CrossoverKernelCoefficients coefficients_{};
+    AlignedBuffer<float> state_;
+    int numChannels_ = 0;
+    int numBands_ = 0;
+};
+
+} // namespace villain::dsp
@@ -0,0 +1,69 @@
+#include "dsp/DelayLine.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace villain::dsp {
+
+void DelayLine::prepare(int numChannels, int maxBlockSize, int maxDelay)
+{
+    maxDelay_ = std::max(maxDelay, 0);
+    capacity_ = 1;
+    while (capacity_ < maxDelay_ + maxBlockSize)
+        capacity_ <<= 1;
+    buffer_.allocate(static_cast<std::size_t>(capacity_) * static_cast<std::size_t>(std::max(numChannels, 1)));
+    reset();
+}
+
+void DelayLine::reset() noexcept
+{
+    buffer_.clear();
+    writePos_ = 0;
+}
+
+void DelayLine::setDelay(int delaySamples) noexcept
+{
+    delay_ = std::clamp(delaySamples, 0, maxDelay_);
+}
+
+void DelayLine::process(const AudioBlock& block) noexcept
+{
+    const int n = block.numSamples();
+    const int mask = capacity_ - 1;
+
+    for (int ch = 0; ch < block.numChannels(); ++ch) {
+        float* ring = buffer_.data() + static_cast<std::size_t>(ch) * static_cast<std::size_t>(capacity_);
+        float* data = block.channel(ch);
+
+        const int firstWrite = std::min(n, capacity_ - writePos_);
+        std::memcpy(ring + writePos_, data, sizeof(float) * static_cast<std::size_t>(firstWrite));
+        std::memcpy(ring, data + firstWrite, sizeof(float) * static_cast<std::size_t>(n - firstWrite));
+
+        if (delay_ == 0)
+            continue;
+
+        const int readPos = (writePos_ - delay_) & mask;
+        const int firstRead = std::min(n, capacity_ - readPos);
+        std::memcpy(data, ring + readPos, sizeof(float) * static_cast<std::size_t>(firstRead));
+        std::memcpy(data + firstRead, ring, sizeof(float) * static_cast<std::size_t>(n - firstRead));
+    }
+
+    writePos_ = (writePos_ + n) & mask;
+}
+
+void DelayLine::readLast(const AudioBlock& out, int delaySamples) const noexcept
+{
+    const int n = out.numSamples();
+    const int mask = capacity_ - 1;
+    const int readPos = (writePos_ - n - std::clamp(delaySamples, 0, maxDelay_)) & mask;
+    const int firstRead = std::min(n, capacity_ - readPos);
+
+    for (int ch = 0; ch < out.numChannels(); ++ch) {
+        const float* ring = buffer_.data() + static_cast<std::size_t>(ch) * static_cast<std::size_t>(capacity_);
+        float* data = out.channel(ch);
+        std::memcpy(data, ring + readPos, sizeof(float) * static_cast<std::size_t>(firstRead));
+        std::memcpy(data + firstRead, ring, sizeof(float) * static_cast<std::size_t>(n - firstRead));
+    }
+}
+
+} // namespace villain::dsp
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "core/AlignedBuffer.h"
+#include "core/AudioBlock.h"
+
+#include <array>
+
+namespace villain::dsp {
+
+// Integer multichannel delay for latency compensation. Storage is sized once for the largest
+// delay and block; changing the delay afterwards is allocation-free.
+class DelayLine {
+public:
+    void prepare(int numChannels, int maxBlockSize, int maxDelay);
+    void reset() noexcept;
+
+    // Clamped to the prepared maximum. Takes effect immediately; callers that care about the
+    // discontinuity reset() or crossfade around it.
+    void setDelay(int delaySamples) noexcept;
+    int delay() const noexcept { return delay_; }
+
+    // Delays the block in place. A zero delay still records the input so a later increase
+    // replays real history rather than silence.
+    void process(const AudioBlock& block) noexcept;
+    // Copies the block last passed to process() into `out` as it would have come out at
+    // `delaySamples` (clamped to the prepared maximum), for crossfading between two delays.
+    void readLast(const AudioBlock& out, int delaySamples) const noexcept;
+
+private:
+    AlignedBuffer<float> buffer_;
+    int capacity_ = 0;   // power of two, per channel
+    int maxDelay_ = 0;
+    int delay_ = 0;
+    int writePos_ = 0;
+};
+
+} // namespace villain::dsp
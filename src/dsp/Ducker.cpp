@@ -0,0 +1,46 @@
+#include "dsp/Ducker.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace villain::dsp {
+
+void Ducker::prepare(double sampleRate) noexcept
+{
+    attack_ = static_cast<float>(std::exp(-1.0 / (kAttackSeconds * sampleRate)));
+    release_ = static_cast<float>(std::exp(-1.0 / (kReleaseSeconds * sampleRate)));
+    setDepthDecibels(depthDb_);
+    reset();
+}
+
+void Ducker::setDepthDecibels(float decibels) noexcept
+{
+    depthDb_ = decibels > 0.0f ? decibels : 0.0f;
+    // A compressor curve from the floor up whose slope spends the whole depth by 0 dBFS.
+    curve_.thresholdDb = kFloorDb;
+    curve_.slope = depthDb_ / kFloorDb;
+    curve_.kneeDb = 6.0f;
+}
+
+void Ducker::computeGains(const AudioBlock& key, float* gains) noexcept
+{
+    const simd::KernelTable& kernels = simd::activeKernels();
+    const int n = key.numSamples();
+
+    std::memset(gains, 0, sizeof(float) * static_cast<std::size_t>(n));
+    for (int ch = 0; ch < key.numChannels(); ++ch)
+        kernels.maxAbs(gains, key.channel(ch), n);
+    kernels.gainComputer(gains, n, curve_);
+
+    float smoothed = smoothed_;
+    for (int i = 0; i < n; ++i) {
+        const float target = gains[i];
+        const float pole = target < smoothed ? attack_ : release_;
+        smoothed = target + pole * (smoothed - target);
+        gains[i] = smoothed;
+    }
+    // Snap the last trace of a release, so an idle ducker stops being active.
+    smoothed_ = smoothed > 0.99999f ? 1.0f : smoothed;
+}
+
+} // namespace villain::dsp
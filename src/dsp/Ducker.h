@@ -0,0 +1,42 @@
+#pragma once
+
+#include "core/AudioBlock.h"
+#include "dsp/simd/Kernels.h"
+
+namespace villain::dsp {
+
+// Turns a key signal (the sidechain bus) into a per-sample gain for the drive, so the
+// saturation backs off while the key is loud: bass distorts less under each kick.
+//
+// The drive falls by up to depth dB, in proportion to how far the key's peak level is above
+// kFloorDb, reaching the full depth at 0 dBFS. The key channels are read where they are,
+// never copied; the gain is smoothed with a fast attack and a slower release.
+//
+// prepare() allocates nothing; every other call is audio-thread safe.
+class Ducker {
+public:
+    static constexpr float kFloorDb = -36.0f;
+    static constexpr double kAttackSeconds = 0.002;
+    static constexpr double kReleaseSeconds = 0.08;
+
+    void prepare(double sampleRate) noexcept;
+    void reset() noexcept { smoothed_ = 1.0f; }
+
+    void setDepthDecibels(float decibels) noexcept;
+
+    // True while there is ducking to apply, including a release still settling after the
+    // depth went to 0.
+    bool isActive() const noexcept { return depthDb_ > 0.0f || smoothed_ < 1.0f; }
+
+    // Writes key.numSamples() gains. A key without channels reads as silence.
+    void computeGains(const AudioBlock& key, float* gains) noexcept;
+
+private:
+    float depthDb_ = 0.0f;
+    simd::GainCurve curve_;
+    float attack_ = 0.0f;
+    float release_ = 0.0f;
+    float smoothed_ = 1.0f;
+};
+
+} // namespace villain::dsp
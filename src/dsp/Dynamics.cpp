@@ -0,0 +1,250 @@
+#include "dsp/Dynamics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace villain::dsp {
+
+namespace {
+
+float onePole(double seconds, double sampleRate) noexcept
+{
+    return seconds <= 0.0 ? 0.0f : static_cast<float>(std::exp(-1.0 / (seconds * sampleRate)));
+}
+
+} // namespace
+
+void Dynamics::prepare(double sampleRate, int numChannels, int maxBlockSize)
+{
+    sampleRate_ = sampleRate;
+    maxLookahead_ = static_cast<int>(std::ceil(kMaxLookaheadSeconds * sampleRate));
+    fadeLength_ = static_cast<int>(std::lround(kLookaheadFadeSeconds * sampleRate));
+    numChannels_ = std::max(numChannels, 1);
+
+    std::uint32_t capacity = 1;
+    while (capacity < static_cast<std::uint32_t>(maxLookahead_ + 1))
+        capacity <<= 1;
+    windowMask_ = capacity - 1;
+
+    delay_.prepare(numChannels, std::min(maxBlockSize, kFramesPerPass), maxLookahead_);
+    gains_.allocate(kFramesPerPass);
+    fadeGains_.allocate(kFramesPerPass);
+    fadeAudio_.allocate(static_cast<std::size_t>(numChannels_) * kFramesPerPass);
+    for (Detector& detector : detectors_) {
+        detector.wedgeLevel.allocate(capacity);
+        detector.wedgeTime.allocate(capacity);
+        detector.boxHistory.allocate(capacity);
+    }
+
+    lookahead_ = std::min(lookahead_, maxLookahead_);
+    updateCurve();
+    updateCoefficients();
+    reset();
+}
+
+void Dynamics::reset() noexcept
+{
+    // Unity gain throughout the window, as if the stage had been idle forever.
+    Detector& detector = detectors_[static_cast<std::size_t>(current_)];
+    detector.lookahead = lookahead_;
+    detector.restart(1.0f);
+    delay_.setDelay(lookahead_);
+    delay_.reset();
+    fadeRemaining_ = 0;
+    running_ = false;
+    output_ = 1.0f;
+}
+
+void Dynamics::Detector::restart(float gain) noexcept
+{
+    wedgeHead = 0;
+    wedgeTail = 0;
+    time = 0;
+    for (std::size_t i = 0; i < boxHistory.size(); ++i)
+        boxHistory[i] = gain;
+    boxSum = static_cast<double>(gain) * (lookahead + 1);
+    boxPos = 0;
+    smoothed = gain;
+}
+
+void Dynamics::setMode(DynamicsMode mode) noexcept
+{
+    if (mode == mode_)
+        return;
+    mode_ = mode;
+    updateCurve();
+    updateCoefficients();
+}
+
+void Dynamics::setThresholdDecibels(float decibels) noexcept
+{
+    thresholdDb_ = decibels;
+    updateCurve();
+}
+
+void Dynamics::setRatio(float ratio) noexcept
+{
+    ratio_ = std::max(ratio, 1.0f);
+    updateCurve();
+}
+
+void Dynamics::setAttackSeconds(float seconds) noexcept
+{
+    attackSeconds_ = seconds;
+    updateCoefficients();
+}
+
+void Dynamics::setReleaseSeconds(float seconds) noexcept
+{
+    releaseSeconds_ = seconds;
+    updateCoefficients();
+}
+
+void Dynamics::setLookaheadSamples(int samples) noexcept
+{
+    lookahead_ = std::clamp(samples, 0, maxLookahead_);
+    Detector& detector = detectors_[static_cast<std::size_t>(current_)];
+    if (running_ || lookahead_ == detector.lookahead)
+        return;
+    // Nothing is playing through the old delay, so there is nothing to fade from. The old
+    // window's contents do not describe the new one: the detector starts empty and the
+    // average restarts from the current smoothed gain.
+    detector.lookahead = lookahead_;
+    detector.restart(detector.smoothed);
+    delay_.setDelay(lookahead_);
+}
+
+void Dynamics::startFade() noexcept
+{
+    // The new detector starts as an in-place change would; the outgoing one carries on
+    // with its window until the fade is over.
+    const Detector& outgoing = detectors_[static_cast<std::size_t>(current_)];
+    current_ ^= 1;
+    Detector& incoming = detectors_[static_cast<std::size_t>(current_)];
+    incoming.lookahead = lookahead_;
+    incoming.restart(outgoing.smoothed);
+    delay_.setDelay(lookahead_);
+    fadeRemaining_ = fadeLength_;
+}
+
+void Dynamics::updateCurve() noexcept
+{
+    const bool limiter = mode_ == DynamicsMode::Limiter;
+    curve_.thresholdDb = thresholdDb_;
+    curve_.slope = limiter ? -1.0f : 1.0f / ratio_ - 1.0f;
+    curve_.kneeDb = limiter ? 0.0f : kCompressorKneeDb;
+}
+
+void Dynamics::updateCoefficients() noexcept
+{
+    // The limiter clamps instantly; the lookahead average supplies its attack ramp.
+    attack_ = mode_ == DynamicsMode::Limiter ? 0.0f : onePole(attackSeconds_, sampleRate_);
+    release_ = onePole(releaseSeconds_, sampleRate_);
+}
+
+void Dynamics::computeGains(Detector& detector, float* gains, int n) noexcept
+{
+    const simd::KernelTable& kernels = simd::activeKernels();
+
+    if (detector.lookahead > 0) {
+        const std::uint32_t window = static_cast<std::uint32_t>(detector.lookahead) + 1;
+        for (int i = 0; i < n; ++i, ++detector.time) {
+            const float level = gains[i];
+            // At most one entry ages out per sample; dropping it first keeps the wedge within
+            // `window` entries.
+            if (detector.wedgeTail != detector.wedgeHead &&
+                detector.time - detector.wedgeTime[detector.wedgeHead & windowMask_] >= window)
+                ++detector.wedgeHead;
+            // Anything no louder than the newcomer can never be the maximum again.
+            while (detector.wedgeTail != detector.wedgeHead &&
+                   detector.wedgeLevel[(detector.wedgeTail - 1) & windowMask_] <= level)
+                --detector.wedgeTail;
+            detector.wedgeLevel[detector.wedgeTail & windowMask_] = level;
+            detector.wedgeTime[detector.wedgeTail & windowMask_] = detector.time;
+            ++detector.wedgeTail;
+            gains[i] = detector.wedgeLevel[detector.wedgeHead & windowMask_];
+        }
+    }
+
+    kernels.gainComputer(gains, n, curve_);
+
+    float smoothed = detector.smoothed;
+    for (int i = 0; i < n; ++i) {
+        const float target = gains[i];
+        const float pole = target < smoothed ? attack_ : release_;
+        smoothed = target + pole * (smoothed - target);
+        gains[i] = smoothed;
+    }
+    detector.smoothed = smoothed;
+
+    if (detector.lookahead > 0) {
+        const double scale = 1.0 / static_cast<double>(detector.lookahead + 1);
+        const std::uint32_t window = static_cast<std::uint32_t>(detector.lookahead) + 1;
+        for (int i = 0; i < n; ++i) {
+            detector.boxSum += static_cast<double>(gains[i]) - detector.boxHistory[detector.boxPos];
+            detector.boxHistory[detector.boxPos] = gains[i];
+            detector.boxPos = detector.boxPos + 1 == window ? 0 : detector.boxPos + 1;
+            gains[i] = static_cast<float>(detector.boxSum * scale);
+        }
+    }
+}
+
+void Dynamics::process(const AudioBlock& block, const AudioBlock& key) noexcept
+{
+    if (!isActive()) {
+        running_ = false;
+        return;
+    }
+
+    const simd::KernelTable& kernels = simd::activeKernels();
+    float* const gains = gains_.data();
+    for (int pos = 0; pos < block.numSamples(); pos += kFramesPerPass) {
+        const int length = std::min(kFramesPerPass, block.numSamples() - pos);
+        const AudioBlock pass = block.subBlock(pos, length);
+        if (fadeRemaining_ == 0 && lookahead_ != detectors_[static_cast<std::size_t>(current_)].lookahead)
+            startFade();
+
+        // The detector sees the input as it arrives; the audio it acts on comes out of the
+        // lookahead delay.
+        const AudioBlock levels = key.subBlock(pos, length);
+        std::memset(gains, 0, sizeof(float) * static_cast<std::size_t>(length));
+        for (int ch = 0; ch < levels.numChannels(); ++ch)
+            kernels.maxAbs(gains, levels.channel(ch), length);
+        if (fadeRemaining_ > 0)
+            std::memcpy(fadeGains_.data(), gains, sizeof(float) * static_cast<std::size_t>(length));
+        computeGains(detectors_[static_cast<std::size_t>(current_)], gains, length);
+
+        delay_.process(pass);
+        for (int ch = 0; ch < pass.numChannels(); ++ch)
+            kernels.applyGainCurve(pass.channel(ch), gains, length);
+        if (fadeRemaining_ > 0)
+            fadeFromOutgoing(pass);
+        output_ = gains[length - 1];
+    }
+    running_ = running_ || block.numSamples() > 0;
+}
+
+void Dynamics::fadeFromOutgoing(const AudioBlock& pass) noexcept
+{
+    // The outgoing path: the old delay's output under the old detector's gains.
+    const simd::KernelTable& kernels = simd::activeKernels();
+    const int length = pass.numSamples();
+    float* channels[kMaxChannels] = {};
+    for (int ch = 0; ch < pass.numChannels(); ++ch)
+        channels[ch] = fadeAudio_.data() + static_cast<std::size_t>(ch) * kFramesPerPass;
+    const AudioBlock outgoing(channels, pass.numChannels(), length);
+    delay_.readLast(outgoing, detectors_[static_cast<std::size_t>(current_ ^ 1)].lookahead);
+    computeGains(detectors_[static_cast<std::size_t>(current_ ^ 1)], fadeGains_.data(), length);
+
+    const int faded = std::min(length, fadeRemaining_);
+    const float step = 1.0f / static_cast<float>(fadeLength_);
+    const float start = static_cast<float>(fadeLength_ - fadeRemaining_ + 1) * step;
+    for (int ch = 0; ch < pass.numChannels(); ++ch) {
+        kernels.applyGainCurve(channels[ch], fadeGains_.data(), faded);
+        kernels.mixDryWet(pass.channel(ch), channels[ch], faded, start, step);
+    }
+    fadeRemaining_ -= faded;
+}
+
+} // namespace villain::dsp
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "core/AlignedBuffer.h"
+#include "core/AudioBlock.h"
+#include "dsp/DelayLine.h"
+#include "dsp/simd/Kernels.h"
+
+#include <array>
+#include <cstdint>
+
+namespace villain::dsp {
+
+enum class DynamicsMode {
+    Off,
+    Compressor,
+    Limiter,
+};
+
+constexpr int kNumDynamicsModes = 3;
+
+// Compressor / peak limiter with every channel linked to one detector, so the stereo (or
+// surround) image never shifts under gain reduction. The detector can listen to a separate
+// key (the sidechain bus) instead of the audio it acts on.
+//
+// Per pass the detector level and the static gain curve are computed by the vector kernels;
+// only the gain smoothing recursion runs per sample. With lookahead the audio is delayed by
+// L samples, the detector takes the running maximum over the last L + 1 samples (a monotonic
+// wedge, O(1) amortised per sample) and the smoothed gain is averaged over the same window.
+// Every gain in that average already covers the peak the output sample belongs to, so the
+// limiter's ceiling holds exactly while gain reduction fades in over the lookahead time.
+//
+// A lookahead change while audio runs keeps the old delay and detector going next to the
+// new ones and crossfades between their outputs, each under its own gain, so the audio
+// never jumps by the change in delay and the ceiling holds throughout.
+//
+// prepare() allocates; everything else is audio-thread safe.
+class Dynamics {
+public:
+    static constexpr double kMaxLookaheadSeconds = 0.01;
+    static constexpr double kLookaheadFadeSeconds = 0.01;
+
+    void prepare(double sampleRate, int numChannels, int maxBlockSize);
+    void reset() noexcept;
+
+    void setMode(DynamicsMode mode) noexcept;
+    void setThresholdDecibels(float decibels) noexcept;
+    // Ignored by the limiter, which holds peaks at the threshold.
+    void setRatio(float ratio) noexcept;
+    // Ignored by the limiter, whose attack is the lookahead window.
+    void setAttackSeconds(float seconds) noexcept;
+    void setReleaseSeconds(float seconds) noexcept;
+    // Clamped to the prepared maximum. Before any audio (or while off) the change is
+    // immediate; otherwise the next process() crossfades to it, and a further change waits
+    // for that fade to end.
+    void setLookaheadSamples(int samples) noexcept;
+
+    DynamicsMode mode() const noexcept { return mode_; }
+    bool isActive() const noexcept { return mode_ != DynamicsMode::Off; }
+    int maxLookaheadSamples() const noexcept { return maxLookahead_; }
+    // Delay the stage adds while active.
+    int latencySamples() const noexcept { return isActive() ? lookahead_ : 0; }
+    // Gain applied to the most recent sample.
+    float currentGain() const noexcept { return output_; }
+
+    // In place; the channel count must not exceed the prepared one.
+    void process(const AudioBlock& block) noexcept { process(block, block); }
+    // Detects on `key`, read in place and at least as long as `block`, with any number of
+    // channels.
+    void process(const AudioBlock& block, const AudioBlock& key) noexcept;
+
+private:
+    // Samples per detector pass; sizes the scratch buffer independently of block size.
+    static constexpr int kFramesPerPass = 256;
+    static constexpr float kCompressorKneeDb = 6.0f;
+
+    // Window maximum and gain average for one lookahead length.
+    struct Detector {
+        int lookahead = 0;
+        // Sliding maximum of the detector: levels decrease from head to tail, each tagged
+        // with the sample it arrived on. Ring of windowMask_ + 1 entries.
+        AlignedBuffer<float> wedgeLevel;
+        AlignedBuffer<std::uint32_t> wedgeTime;
+        std::uint32_t wedgeHead = 0;
+        std::uint32_t wedgeTail = 0;
+        std::uint32_t time = 0;
+        // Moving average of the smoothed gain over the same window.
+        AlignedBuffer<float> boxHistory;
+        double boxSum = 0.0;
+        std::uint32_t boxPos = 0;
+        float smoothed = 1.0f;
+
+        // Empty window, with the average starting from `gain` as if it had held forever.
+        void restart(float gain) noexcept;
+    };
+
+    void updateCurve() noexcept;
+    void updateCoefficients() noexcept;
+    void startFade() noexcept;
+    void fadeFromOutgoing(const AudioBlock& pass) noexcept;
+    // Levels in, gains out, in place.
+    void computeGains(Detector& detector, float* gains, int numSamples) noexcept;
+
+    double sampleRate_ = 48000.0;
+    DynamicsMode mode_ = DynamicsMode::Off;
+    float thresholdDb_ = 0.0f;
+    float ratio_ = 4.0f;
+    float attackSeconds_ = 0.005f;
+    float releaseSeconds_ = 0.1f;
+    simd::GainCurve curve_;
+    float attack_ = 0.0f;    // per-sample pole while gain falls
+    float release_ = 0.0f;   // per-sample pole while gain recovers
+
+    DelayLine delay_;
+    AlignedBuffer<float> gains_;
+    int lookahead_ = 0;   // requested; detector(current_) catches up with it
+    int maxLookahead_ = 0;
+    std::uint32_t windowMask_ = 0;
+
+    // detectors_[current_] drives the output; the other is the outgoing one during a fade.
+    std::array<Detector, 2> detectors_;
+    int current_ = 0;
+    int fadeLength_ = 0;
+    int fadeRemaining_ = 0;
+    AlignedBuffer<float> fadeGains_;
+    AlignedBuffer<float> fadeAudio_;   // [channel][kFramesPerPass], the old delay's output
+    int numChannels_ = 0;
+    bool running_ = false;   // processed audio since the last reset()
+
+    float output_ = 1.0f;
+};
+
+} // namespace villain::dsp
@@ -0,0 +1,176 @@
+#include "dsp/Fft.h"
+
+#include "core/SharedTable.h"
+#include "dsp/simd/Kernels.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace villain::dsp {
+
+// Tables for an N-point real transform, i.e. an M = N / 2 point complex one.
+struct FftTables {
+    int size = 0;
+    AlignedBuffer<std::uint32_t> bitReverse;   // M entries
+    // Butterfly twiddles, stage by stage: the stage combining pairs of half-length h reads
+    // exp(-2 pi i j / 2h), j < h, from offset h. Contiguous per stage so the inner loop
+    // vectorises.
+    AlignedBuffer<float> twiddleRe;
+    AlignedBuffer<float> twiddleIm;
+    // exp(-2 pi i k / N), k = 0 .. M, for the real/complex split.
+    AlignedBuffer<float> splitRe;
+    AlignedBuffer<float> splitIm;
+};
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+
+FftTables buildTables(int size)
+{
+    const int half = size / 2;
+    FftTables tables;
+    tables.size = size;
+
+    int bits = 0;
+    while ((1 << bits) < half)
+        ++bits;
+    tables.bitReverse.allocate(static_cast<std::size_t>(half));
+    for (int i = 0; i < half; ++i) {
+        std::uint32_t reversed = 0;
+        for (int b = 0; b < bits; ++b)
+            reversed |= static_cast<std::uint32_t>((i >> b) & 1) << (bits - 1 - b);
+        tables.bitReverse[static_cast<std::size_t>(i)] = reversed;
+    }
+
+    tables.twiddleRe.allocate(static_cast<std::size_t>(half));
+    tables.twiddleIm.allocate(static_cast<std::size_t>(half));
+    for (int h = 1; h < half; h <<= 1) {
+        for (int j = 0; j < h; ++j) {
+            const double angle = -kTwoPi * j / (2.0 * h);
+            tables.twiddleRe[static_cast<std::size_t>(h + j)] = static_cast<float>(std::cos(angle));
+            tables.twiddleIm[static_cast<std::size_t>(h + j)] = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    tables.splitRe.allocate(static_cast<std::size_t>(half) + 1);
+    tables.splitIm.allocate(static_cast<std::size_t>(half) + 1);
+    for (int k = 0; k <= half; ++k) {
+        const double angle = -kTwoPi * k / size;
+        tables.splitRe[static_cast<std::size_t>(k)] = static_cast<float>(std::cos(angle));
+        tables.splitIm[static_cast<std::size_t>(k)] = static_cast<float>(std::sin(angle));
+    }
+    return tables;
+}
+
+} // namespace
+
+void RealFft::prepare(int size)
+{
+    size_ = size;
+    tables_ = SharedTable<FftTables>::acquire(static_cast<std::uint64_t>(size), [size] { return buildTables(size); });
+    workRe_.allocate(static_cast<std::size_t>(size / 2));
+    workIm_.allocate(static_cast<std::size_t>(size / 2));
+}
+
+void RealFft::butterflies() noexcept
+{
+    const int half = size_ / 2;
+    float* re = workRe_.data();
+    float* im = workIm_.data();
+    const float* twRe = tables_->twiddleRe.data();
+    const float* twIm = tables_->twiddleIm.data();
+
+    int h = 1;
+    if (half >= 4) {
+        // The first two stages only ever rotate by 1 and -i: one radix-4 pass, no multiplies.
+        for (int start = 0; start < half; start += 4) {
+            float* r = re + start;
+            float* i = im + start;
+            const float r0 = r[0] + r[1], i0 = i[0] + i[1];
+            const float r1 = r[0] - r[1], i1 = i[0] - i[1];
+            const float r2 = r[2] + r[3], i2 = i[2] + i[3];
+            const float r3 = r[2] - r[3], i3 = i[2] - i[3];
+            r[0] = r0 + r2;
+            i[0] = i0 + i2;
+            r[2] = r0 - r2;
+            i[2] = i0 - i2;
+            // (r3, i3) * -i = (i3, -r3)
+            r[1] = r1 + i3;
+            i[1] = i1 - r3;
+            r[3] = r1 - i3;
+            i[3] = i1 + r3;
+        }
+        h = 4;
+    }
+
+    const auto fftStage = simd::activeKernels().fftStage;
+    for (; h < half; h <<= 1)
+        fftStage(re, im, twRe, twIm, half, h);
+}
+
+void RealFft::forward(const float* input, float* re, float* im) noexcept
+{
+    const int half = size_ / 2;
+    const std::uint32_t* order = tables_->bitReverse.data();
+    float* zRe = workRe_.data();
+    float* zIm = workIm_.data();
+
+    // Even samples as the real part, odd ones as the imaginary part.
+    for (int k = 0; k < half; ++k) {
+        zRe[order[k]] = input[2 * k];
+        zIm[order[k]] = input[2 * k + 1];
+    }
+    butterflies();
+
+    // Untangle the two interleaved half-length spectra:
+    // X[k] = E[k] + W^k O[k], E = (Z[k] + Z*[M-k]) / 2, O = (Z[k] - Z*[M-k]) / 2i.
+    const float* wRe = tables_->splitRe.data();
+    const float* wIm = tables_->splitIm.data();
+    re[0] = zRe[0] + zIm[0];
+    im[0] = 0.0f;
+    re[half] = zRe[0] - zIm[0];
+    im[half] = 0.0f;
+    for (int k = 1; k < half; ++k) {
+        const float eRe = 0.5f * (zRe[k] + zRe[half - k]);
+        const float eIm = 0.5f * (zIm[k] - zIm[half - k]);
+        const float oRe = 0.5f * (zIm[k] + zIm[half - k]);
+        const float oIm = -0.5f * (zRe[k] - zRe[half - k]);
+        re[k] = eRe + wRe[k] * oRe - wIm[k] * oIm;
+        im[k] = eIm + wRe[k] * oIm + wIm[k] * oRe;
+    }
+}
+
+void RealFft::inverse(const float* re, const float* im, float* output) noexcept
+{
+    const int half = size_ / 2;
+    const std::uint32_t* order = tables_->bitReverse.data();
+    const float* wRe = tables_->splitRe.data();
+    const float* wIm = tables_->splitIm.data();
+    float* zRe = workRe_.data();
+    float* zIm = workIm_.data();
+
+    // Rebuild Z = 2E + 2iO and run the forward butterflies on its conjugate; conjugating the
+    // result again gives the inverse transform.
+    for (int k = 0; k < half; ++k) {
+        const float bRe = re[half - k];
+        const float bIm = -im[half - k];
+        const float eRe = re[k] + bRe;
+        const float eIm = im[k] + bIm;
+        const float dRe = re[k] - bRe;
+        const float dIm = im[k] - bIm;
+        // O = D * W^-k
+        const float oRe = dRe * wRe[k] + dIm * wIm[k];
+        const float oIm = dIm * wRe[k] - dRe * wIm[k];
+        zRe[order[k]] = eRe - oIm;
+        zIm[order[k]] = -(eIm + oRe);
+    }
+    butterflies();
+
+    for (int k = 0; k < half; ++k) {
+        output[2 * k] = zRe[k];
+        output[2 * k + 1] = -zIm[k];
+    }
+}
+
+} // namespace villain::dsp
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "core/AlignedBuffer.h"
+
+#include <memory>
+
+namespace villain::dsp {
+
+struct FftTables;
+
+// Real FFT of a power-of-two size N >= 4, computed as a half-size complex FFT plus a split
+// pass. Spectra are split into real and imaginary arrays of N / 2 + 1 bins each, which is the
+// layout the complexMultiplyAdd kernel works on. Neither direction normalises:
+// inverse(forward(x)) == N * x.
+//
+// Twiddle and bit-reversal tables are shared between instances of the same size. prepare()
+// allocates; the transforms are audio-thread safe, one at a time per instance.
+class RealFft {
+public:
+    void prepare(int size);
+
+    int size() const noexcept { return size_; }
+    int numBins() const noexcept { return size_ / 2 + 1; }
+
+    // size() samples in; numBins() values out in each of re and im.
+    void forward(const float* input, float* re, float* im) noexcept;
+    // numBins() values in each of re and im; size() samples out.
+    void inverse(const float* re, const float* im, float* output) noexcept;
+
+private:
+    void butterflies() noexcept;
+
+    std::shared_ptr<const FftTables> tables_;
+    AlignedBuffer<float> workRe_;
+    AlignedBuffer<float> workIm_;
+    int size_ = 0;
+};
+
+} // namespace villain::dsp
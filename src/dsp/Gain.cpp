@@ -0,0 +1,25 @@
+#include "dsp/Gain.h"
+
+#include "dsp/simd/Kernels.h"
+
+namespace villain::dsp {
+
+void GainStage::process(const AudioBlock& block) noexcept
+{
+    const simd::KernelTable& kernels = simd::activeKernels();
+    const int n = block.numSamples();
+
+    for (int pos = 0; pos < n;) {
+        const SmoothedValue::Segment segment = smoother_.next(n - pos);
+        for (int ch = 0; ch < block.numChannels(); ++ch) {
+            float* data = block.channel(ch) + pos;
+            if (segment.step != 0.0f)
+                kernels.applyGainRamp(data, segment.length, segment.start, segment.step);
+            else if (segment.start != 1.0f)
+                kernels.applyGain(data, segment.length, segment.start);
+        }
+        pos += segment.length;
+    }
+}
+
+} // namespace villain::dsp
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "core/AudioBlock.h"
+#include "dsp/SmoothedValue.h"
+
+#include <cmath>
+
+namespace villain::dsp {
+
+inline float decibelsToGain(float decibels) noexcept
+{
+    return decibels <= -120.0f ? 0.0f : std::pow(10.0f, decibels * 0.05f);
+}
+
+// Gain with a fixed-time linear ramp whenever the target moves, so parameter updates do not
+// zipper regardless of the host's block size.
+class GainStage {
+public:
+    void prepare(double sampleRate, double rampSeconds) noexcept { smoother_.prepare(sampleRate, rampSeconds); }
+
+    void setGainDecibels(float decibels) noexcept { smoother_.setTarget(decibelsToGain(decibels)); }
+    void setGainLinear(float gain) noexcept { smoother_.setTarget(gain); }
+
+    // Jumps straight to the target; used on reset so the first block does not fade in.
+    void snapToTarget() noexcept { smoother_.snapToTarget(); }
+
+    void process(const AudioBlock& block) noexcept;
+
+    float currentGain() const noexcept { return smoother_.current(); }
+    float targetGain() const noexcept { return smoother_.target(); }
+    bool isSmoothing() const noexcept { return smoother_.isSmoothing(); }
+
+private:
+    SmoothedValue smoother_{1.0f};
+};
+
+} // namespace villain::dsp
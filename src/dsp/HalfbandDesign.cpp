@@ -0,0 +1,131 @@
+#include "dsp/HalfbandDesign.h"
+
+#include <cmath>
+
+namespace villain::dsp {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+double besselI0(double x) noexcept
+{
+    double sum = 1.0;
+    double term = 1.0;
+    const double halfX = x * 0.5;
+    for (int k = 1; k < 64; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-17)
+            break;
+    }
+    return sum;
+}
+
+double integerPower(double base, int exponent) noexcept
+{
+    double result = 1.0;
+    while (exponent > 0) {
+        if (exponent & 1)
+            result *= base;
+        base *= base;
+        exponent >>= 1;
+    }
+    return result;
+}
+
+double ellipticNumerator(double q, int order, int c) noexcept
+{
+    double acc = 0.0;
+    double sign = 1.0;
+    for (int i = 0;; ++i) {
+        const double term = integerPower(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * kPi / order) * sign;
+        acc += term;
+        sign = -sign;
+        if (std::fabs(term) <= 1e-100)
+            break;
+    }
+    return acc;
+}
+
+double ellipticDenominator(double q, int order, int c) noexcept
+{
+    double acc = 0.0;
+    double sign = -1.0;
+    for (int i = 1;; ++i) {
+        const double term = integerPower(q, i * i) * std::cos(i * 2 * c * kPi / order) * sign;
+        acc += term;
+        sign = -sign;
+        if (std::fabs(term) <= 1e-100)
+            break;
+    }
+    return acc;
+}
+
+} // namespace
+
+HalfbandFirDesign designHalfbandFir(int halfLength, double kaiserBeta)
+{
+    HalfbandFirDesign design;
+    design.halfLength = halfLength;
+    design.denseTaps.resize(static_cast<std::size_t>(2 * halfLength));
+
+    const int numTaps = design.numTaps();
+    const int centre = design.centreDelay();
+    const double windowNorm = besselI0(kaiserBeta);
+
+    double sum = 0.0;
+    for (int i = 0; i < 2 * halfLength; ++i) {
+        const int n = 2 * i;
+        const double t = static_cast<double>(n - centre);
+        const double sinc = std::sin(kPi * t * 0.5) / (kPi * t);
+        const double r = 2.0 * n / (numTaps - 1) - 1.0;
+        const double window = besselI0(kaiserBeta * std::sqrt(1.0 - r * r)) / windowNorm;
+        const double tap = sinc * window;
+        design.denseTaps[static_cast<std::size_t>(i)] = static_cast<float>(tap);
+        sum += tap;
+    }
+
+    for (float& tap : design.denseTaps)
+        tap = static_cast<float>(tap * 0.5 / sum);
+    return design;
+}
+
+double HalfbandIirDesign::chainDelay(int chain) const noexcept
+{
+    // A first-order allpass (a + z^-1) / (1 + a z^-1) delays DC by (1 - a) / (1 + a).
+    double delay = 0.0;
+    for (std::size_t i = static_cast<std::size_t>(chain); i < coefficients.size(); i += 2) {
+        const double a = coefficients[i];
+        delay += (1.0 - a) / (1.0 + a);
+    }
+    return delay;
+}
+
+HalfbandIirDesign designHalfbandIir(int numCoefficients, double transition)
+{
+    double k = std::tan((1.0 - transition * 2.0) * kPi / 4.0);
+    k *= k;
+    const double kksqrt = std::pow(1.0 - k * k, 0.25);
+    const double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+    const double e2 = e * e;
+    const double e4 = e2 * e2;
+    const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+    const int order = numCoefficients * 2 + 1;
+
+    HalfbandIirDesign design;
+    design.coefficients.resize(static_cast<std::size_t>(numCoefficients));
+    for (int index = 0; index < numCoefficients; ++index) {
+        const int c = index + 1;
+        const double num = ellipticNumerator(q, order, c) * std::pow(q, 0.25);
+        const double den = ellipticDenominator(q, order, c) + 0.5;
+        const double ww = num / den;
+        const double wwsq = ww * ww;
+        const double x = std::sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+        design.coefficients[static_cast<std::size_t>(index)] = static_cast<float>((1.0 - x) / (1.0 + x));
+    }
+    return design;
+}
+
+} // namespace villain::dsp
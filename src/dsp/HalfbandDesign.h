@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+
+namespace villain::dsp {
+
+// Linear-phase halfband FIR of length 4 * halfLength - 1. Only the centre tap (0.5) and the
+// even-indexed taps are non-zero; the even taps form the one dense polyphase branch.
+struct HalfbandFirDesign {
+    int halfLength = 0;              // K: dense branch has 2K taps
+    std::vector<float> denseTaps;    // h[2i], i = 0 .. 2K-1
+
+    int numTaps() const noexcept { return 4 * halfLength - 1; }
+    int centreDelay() const noexcept { return 2 * halfLength - 1; }
+};
+
+// Kaiser-windowed sinc. Dense taps are normalised so the filter has exactly unity DC gain.
+HalfbandFirDesign designHalfbandFir(int halfLength, double kaiserBeta);
+
+// Polyphase IIR halfband built from two parallel chains of first-order allpasses in z^-2.
+// Even-indexed coefficients belong to the first chain, odd-indexed to the second.
+struct HalfbandIirDesign {
+    std::vector<float> coefficients;
+
+    // Group delay at DC of the two chains, in samples at the low rate.
+    double chainDelay(int chain) const noexcept;
+};
+
+// Elliptic design after Valenzuela & Constantinides: `transition` is the normalised
+// transition bandwidth (0 < transition < 0.5, relative to the high rate).
+HalfbandIirDesign designHalfbandIir(int numCoefficients, double transition);
+
+} // namespace villain::dsp
@@ -0,0 +1,194 @@
+#include "dsp/ImpulseResponse.h"
+
+#include "core/AssetPack.h"
+#include "core/MappedFile.h"
+#include "core/Platform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace villain::dsp {
+
+namespace {
+
+constexpr std::uint16_t kFormatPcm = 1;
+constexpr std::uint16_t kFormatFloat = 3;
+constexpr std::uint16_t kFormatExtensible = 0xfffe;
+
+std::uint16_t getU16(const std::uint8_t* p) noexcept
+{
+    return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+
+std::uint32_t getU32(const std::uint8_t* p) noexcept
+{
+    std::uint32_t v = 0;
+    for (int i = 0; i < 4; ++i)
+        v |= static_cast<std::uint32_t>(p[i]) << (8 * i);
+    return v;
+}
+
+// One sample of the given encoding as a float in [-1, 1).
+float decodeSample(const std::uint8_t* p, std::uint16_t format, int bits) noexcept
+{
+    if (format == kFormatFloat) {
+        if (bits == 32) {
+            const std::uint32_t raw = getU32(p);
+            float value;
+            std::memcpy(&value, &raw, sizeof(value));
+            return value;
+        }
+        const std::uint64_t raw = getU32(p) | static_cast<std::uint64_t>(getU32(p + 4)) << 32;
+        double value;
+        std::memcpy(&value, &raw, sizeof(value));
+        return static_cast<float>(value);
+    }
+    switch (bits) {
+    case 16:
+        return static_cast<float>(static_cast<std::int16_t>(getU16(p))) * (1.0f / 32768.0f);
+    case 24:
+        // Place the 24 bits at the top of an int32 so the sign comes along.
+        return static_cast<float>(static_cast<std::int32_t>(static_cast<std::uint32_t>(p[0]) << 8 |
+                                                            static_cast<std::uint32_t>(p[1]) << 16 |
+                                                            static_cast<std::uint32_t>(p[2]) << 24)) *
+               (1.0f / 2147483648.0f);
+    default:
+        return static_cast<float>(static_cast<double>(static_cast<std::int32_t>(getU32(p))) * (1.0 / 2147483648.0));
+    }
+}
+
+double blackman(double x) noexcept
+{
+    // x in [-1, 1]
+    constexpr double kPi = 3.14159265358979323846;
+    return 0.42 + 0.5 * std::cos(kPi * x) + 0.08 * std::cos(2.0 * kPi * x);
+}
+
+} // namespace
+
+bool decodeWav(const std::uint8_t* data, std::size_t size, ImpulseResponse& ir)
+{
+    if (size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0)
+        return false;
+
+    std::uint16_t format = 0;
+    int channels = 0;
+    int bits = 0;
+    int blockAlign = 0;
+    std::uint32_t sampleRate = 0;
+    const std::uint8_t* samples = nullptr;
+    std::size_t sampleBytes = 0;
+
+    // Chunks are word-aligned; a truncated data chunk keeps the frames that are present.
+    for (std::size_t pos = 12; pos + 8 <= size;) {
+        const std::uint8_t* chunk = data + pos;
+        const std::size_t length = std::min<std::size_t>(getU32(chunk + 4), size - pos - 8);
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && length >= 16) {
+            format = getU16(chunk + 8);
+            channels = getU16(chunk + 10);
+            sampleRate = getU32(chunk + 12);
+            blockAlign = getU16(chunk + 20);
+            bits = getU16(chunk + 22);
+            // The sub-format GUID starts with the plain format tag.
+            if (format == kFormatExtensible && length >= 40)
+                format = getU16(chunk + 32);
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            samples = chunk + 8;
+            sampleBytes = length;
+        }
+        pos += 8 + length + (length & 1);
+    }
+
+    const bool supported = (format == kFormatPcm && (bits == 16 || bits == 24 || bits == 32)) ||
+                           (format == kFormatFloat && (bits == 32 || bits == 64));
+    if (!supported || samples == nullptr || sampleRate == 0 || channels < 1 || channels > kMaxChannels ||
+        blockAlign < channels * bits / 8)
+        return false;
+
+    const std::size_t maxFrames = static_cast<std::size_t>(ImpulseResponse::kMaxSeconds * sampleRate);
+    const std::size_t frames = std::min(sampleBytes / static_cast<std::size_t>(blockAlign), maxFrames);
+    if (frames == 0)
+        return false;
+
+    const int bytesPerSample = bits / 8;
+    ImpulseResponse decoded;
+    decoded.sampleRate = static_cast<double>(sampleRate);
+    decoded.channels.assign(static_cast<std::size_t>(channels), std::vector<float>(frames));
+    for (std::size_t i = 0; i < frames; ++i) {
+        const std::uint8_t* frame = samples + i * static_cast<std::size_t>(blockAlign);
+        for (int ch = 0; ch < channels; ++ch)
+            decoded.channels[static_cast<std::size_t>(ch)][i] = decodeSample(frame + ch * bytesPerSample, format, bits);
+    }
+    ir = std::move(decoded);
+    return true;
+}
+
+ImpulseResponseView::ImpulseResponseView(const ImpulseResponse& ir) noexcept
+    : sampleRate(ir.sampleRate), numChannels(ir.numChannels()), numFrames(ir.numFrames())
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+        channels[static_cast<std::size_t>(ch)] = ir.channels[static_cast<std::size_t>(ch)].data();
+}
+
+ImpulseResponseView impulseResponseAsset(const AssetEntry& asset) noexcept
+{
+    ImpulseResponseView view;
+    view.sampleRate = asset.sampleRate;
+    view.numChannels = asset.numChannels;
+    view.numFrames = asset.numFrames;
+    for (int ch = 0; ch < asset.numChannels; ++ch)
+        view.channels[static_cast<std::size_t>(ch)] = asset.channel(ch);
+    return view;
+}
+
+bool loadImpulseResponse(const std::string& path, ImpulseResponse& ir)
+{
+    MappedFile file;
+    return file.open(path) && decodeWav(file.data(), file.size(), ir);
+}
+
+ImpulseResponse resample(const ImpulseResponseView& ir, double sampleRate)
+{
+    ImpulseResponse out;
+    if (ir.empty() || ir.sampleRate == sampleRate) {
+        out.sampleRate = ir.sampleRate;
+        for (int ch = 0; ch < ir.numChannels; ++ch)
+            out.channels.emplace_back(ir.channel(ch), ir.channel(ch) + ir.numFrames);
+        return out;
+    }
+
+    // Zero crossings each side of the kernel centre at the lower of the two rates.
+    constexpr int kZeroCrossings = 32;
+    constexpr double kPi = 3.14159265358979323846;
+    const double ratio = sampleRate / ir.sampleRate;
+    const double cutoff = std::min(1.0, ratio);   // relative to the source Nyquist
+    const double halfWidth = kZeroCrossings / cutoff;
+    const int inFrames = ir.numFrames;
+    const int outFrames = static_cast<int>(std::ceil(inFrames * ratio));
+
+    out.sampleRate = sampleRate;
+    out.channels.assign(static_cast<std::size_t>(ir.numChannels), std::vector<float>(static_cast<std::size_t>(outFrames)));
+    std::vector<double> kernel;
+    for (int t = 0; t < outFrames; ++t) {
+        const double centre = t / ratio;
+        const int first = std::max(0, static_cast<int>(std::ceil(centre - halfWidth)));
+        const int last = std::min(inFrames - 1, static_cast<int>(std::floor(centre + halfWidth)));
+        kernel.clear();
+        for (int i = first; i <= last; ++i) {
+            const double x = (i - centre) * cutoff;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+            kernel.push_back(cutoff * sinc * blackman((i - centre) / halfWidth) / ratio);
+        }
+        for (int ch = 0; ch < ir.numChannels; ++ch) {
+            const float* taps = ir.channel(ch);
+            double sum = 0.0;
+            for (int i = first; i <= last; ++i)
+                sum += kernel[static_cast<std::size_t>(i - first)] * taps[i];
+            out.channels[static_cast<std::size_t>(ch)][static_cast<std::size_t>(t)] = static_cast<float>(sum);
+        }
+    }
+    return out;
+}
+
+} // namespace villain::dsp
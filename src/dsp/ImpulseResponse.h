@@ -0,0 +1,63 @@
+#pragma once
+
+#include "core/Platform.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace villain {
+struct AssetEntry;
+}
+
+namespace villain::dsp {
+
+// Impulse response for the cabinet stage: one array of taps per channel at a known rate.
+struct ImpulseResponse {
+    // Longer files are cut here; past ten seconds a cabinet response is all room.
+    static constexpr double kMaxSeconds = 10.0;
+
+    double sampleRate = 0.0;
+    std::vector<std::vector<float>> channels;
+
+    int numChannels() const noexcept { return static_cast<int>(channels.size()); }
+    int numFrames() const noexcept { return channels.empty() ? 0 : static_cast<int>(channels[0].size()); }
+    bool empty() const noexcept { return numFrames() == 0; }
+};
+
+// Read-only view of taps owned elsewhere: an ImpulseResponse, or an asset mapped from a
+// pack. Builders take views, so a pack's taps are read straight from the shared pages.
+struct ImpulseResponseView {
+    double sampleRate = 0.0;
+    int numChannels = 0;
+    int numFrames = 0;
+    std::array<const float*, kMaxChannels> channels{};
+
+    ImpulseResponseView() = default;
+    ImpulseResponseView(const ImpulseResponse& ir) noexcept;   // implicit: views what it is given
+
+    const float* channel(int ch) const noexcept { return channels[static_cast<std::size_t>(ch)]; }
+    bool empty() const noexcept { return numFrames == 0; }
+};
+
+// The taps of an AssetKind::ImpulseResponse asset, in place. Pass-through for the lifetime
+// of the pack that holds it.
+ImpulseResponseView impulseResponseAsset(const AssetEntry& asset) noexcept;
+
+// Decodes a RIFF/WAVE image: integer PCM (16, 24 or 32 bit) or IEEE float (32 or 64 bit),
+// including WAVE_FORMAT_EXTENSIBLE headers, up to kMaxChannels channels. Returns false and
+// leaves `ir` untouched for anything else.
+bool decodeWav(const std::uint8_t* data, std::size_t size, ImpulseResponse& ir);
+
+// decodeWav() on a memory-mapped file: samples are converted straight out of the page cache,
+// with no intermediate copy of the file. Non-realtime.
+bool loadImpulseResponse(const std::string& path, ImpulseResponse& ir);
+
+// Band-limited (windowed sinc) conversion to another sample rate. Taps are scaled by the
+// rate ratio so the response keeps its frequency-domain gain; at the same rate this is a
+// plain copy. Non-realtime.
+ImpulseResponse resample(const ImpulseResponseView& ir, double sampleRate);
+
+} // namespace villain::dsp
@@ -0,0 +1,297 @@
+#include "dsp/Modulation.h"
+
+#include "dsp/simd/Kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace villain::dsp {
+
+namespace {
+
+constexpr std::uint32_t kRandomSeed = 0x9e3779b9u;
+
+float approach(float value, float goal, float maxStep) noexcept
+{
+    return value < goal ? std::min(value + maxStep, goal) : std::max(value - maxStep, goal);
+}
+
+float lfoShape(std::uint32_t phase, LfoShape shape) noexcept
+{
+    // Phase as a half-cycle count in [-1, 1), zero at the rising zero crossing.
+    const float x = static_cast<float>(static_cast<std::int32_t>(phase)) * (1.0f / 2147483648.0f);
+    const float a = std::fabs(x);
+    if (shape == LfoShape::Triangle) {
+        const float t = 1.0f - std::fabs(2.0f * a - 1.0f);
+        return x < 0.0f ? -t : t;
+    }
+    // Parabola through the sine's zeros and peaks, then one correction term (error < 0.1%).
+    const float y = 4.0f * x * (1.0f - a);
+    return y * (0.775f + 0.225f * std::fabs(y));
+}
+
+} // namespace
+
+void ModulationMatrix::prepare(double sampleRate, int maxBlockSize)
+{
+    sampleRate_ = sampleRate;
+    maxBlockSize_ = maxBlockSize;
+    rendered_.allocate(static_cast<std::size_t>(kNumModSources) * maxBlockSize);
+    drive_.allocate(static_cast<std::size_t>(maxBlockSize));
+    // A chunk that starts mid-step touches one step more than its length covers.
+    const auto maxSteps = static_cast<std::size_t>(maxBlockSize / kModulationInterval + 2);
+    toneSteps_.allocate(maxSteps);
+    mixSteps_.allocate(maxSteps);
+
+    depthSlew_ = static_cast<float>(kDepthSlewPerSecond * kModulationInterval / sampleRate);
+    envelopeAttack_ = static_cast<float>(std::exp(-1.0 / (kEnvelopeAttackSeconds * sampleRate)));
+    setEnvelopeRelease(envelopeReleaseSeconds_);
+    reset();
+}
+
+void ModulationMatrix::reset() noexcept
+{
+    for (Slot& slot : slots_) {
+        slot.source = slot.requested.source;
+        slot.target = slot.requested.target;
+        slot.depthFrom = slot.requested.depth;
+        slot.depthTo = slot.requested.depth;
+    }
+    lfoPhase_ = 0;
+    envelope_ = 0.0f;
+    envelopePeak_ = 0.0f;
+    randomState_ = kRandomSeed;
+    randomPeriod_ = randomPendingPeriod_;
+    randomPosition_ = 0;
+    randomFrom_ = 0.0f;
+    randomTo_ = nextRandom();
+    time_ = 0;
+    toneValue_ = 0.0f;
+    mixValue_ = 0.0f;
+}
+
+void ModulationMatrix::setRoute(int slot, const ModulationRoute& route) noexcept
+{
+    ModulationRoute& requested = slots_[static_cast<std::size_t>(slot)].requested;
+    requested = route;
+    requested.depth = std::clamp(route.depth, -1.0f, 1.0f);
+}
+
+void ModulationMatrix::setLfo(float hz, LfoShape shape) noexcept
+{
+    lfoIncrement_ = static_cast<std::uint32_t>(std::llround(static_cast<double>(hz) / sampleRate_ * 4294967296.0));
+    lfoShape_ = shape;
+}
+
+void ModulationMatrix::setRandomRate(float hz) noexcept
+{
+    randomPendingPeriod_ = std::max(1, static_cast<int>(std::lround(sampleRate_ / std::max(hz, 1e-3f))));
+}
+
+void ModulationMatrix::setEnvelopeRelease(float seconds) noexcept
+{
+    envelopeReleaseSeconds_ = seconds;
+    envelopeRelease_ = static_cast<float>(std::exp(-1.0 / (std::max(static_cast<double>(seconds), 1e-4) * sampleRate_)));
+}
+
+bool ModulationMatrix::isActive() const noexcept
+{
+    for (const Slot& slot : slots_) {
+        if (slot.source != ModSource::Off && (slot.depthFrom != 0.0f || slot.depthTo != 0.0f))
+            return true;
+        if (slot.requested.source != ModSource::Off && slot.requested.depth != 0.0f)
+            return true;
+    }
+    return false;
+}
+
+float ModulationMatrix::maxDriveDecibels() const noexcept
+{
+    float depth = 0.0f;
+    for (const Slot& slot : slots_) {
+        if (slot.source != ModSource::Off && slot.target == ModTarget::Drive)
+            depth += std::max(std::fabs(slot.depthFrom), std::fabs(slot.depthTo));
+        if (slot.requested.source != ModSource::Off && slot.requested.target == ModTarget::Drive)
+            depth += std::fabs(slot.requested.depth);
+    }
+    return depth * kDriveModulationDb;
+}
+
+float ModulationMatrix::nextRandom() noexcept
+{
+    // xorshift32; the top 24 bits as a value in [-1, 1).
+    randomState_ ^= randomState_ << 13;
+    randomState_ ^= randomState_ >> 17;
+    randomState_ ^= randomState_ << 5;
+    return static_cast<float>(randomState_ >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+void ModulationMatrix::advanceRandom(int samples) noexcept
+{
+    randomPosition_ += samples;
+    while (randomPosition_ >= randomPeriod_) {
+        randomPosition_ -= randomPeriod_;
+        randomFrom_ = randomTo_;
+        randomTo_ = nextRandom();
+        randomPeriod_ = randomPendingPeriod_;
+    }
+}
+
+float ModulationMatrix::value(ModSource source) const noexcept
+{
+    switch (source) {
+    case ModSource::Lfo:
+        return lfoShape(lfoPhase_, lfoShape_);
+    case ModSource::Envelope:
+        return std::min(envelope_, 1.0f);
+    case ModSource::Random:
+        return randomFrom_ + (randomTo_ - randomFrom_) * (static_cast<float>(randomPosition_) / static_cast<float>(randomPeriod_));
+    case ModSource::Off:
+        break;
+    }
+    return 0.0f;
+}
+
+void ModulationMatrix::beginStep() noexcept
+{
+    // Re-routing fades the old route out before the new one fades in.
+    for (Slot& slot : slots_) {
+        slot.depthFrom = slot.depthTo;
+        const bool rerouted = slot.source != slot.requested.source || slot.target != slot.requested.target;
+        if (rerouted && slot.depthFrom == 0.0f) {
+            slot.source = slot.requested.source;
+            slot.target = slot.requested.target;
+        }
+        const bool settled = slot.source == slot.requested.source && slot.target == slot.requested.target;
+        slot.depthTo = approach(slot.depthFrom, settled ? slot.requested.depth : 0.0f, depthSlew_);
+    }
+
+    // At control rate the envelope takes one step per control step, on the previous step's peak.
+    if (!audioRate_[static_cast<std::size_t>(ModSource::Envelope)]) {
+        const float pole = envelopePeak_ > envelope_ ? envelopeAttack_ : envelopeRelease_;
+        envelope_ = envelopePeak_ + std::pow(pole, static_cast<float>(kModulationInterval)) * (envelope_ - envelopePeak_);
+        envelopePeak_ = 0.0f;
+    }
+
+    toneValue_ = 0.0f;
+    mixValue_ = 0.0f;
+    for (const Slot& slot : slots_) {
+        if (slot.source == ModSource::Off || slot.depthTo == 0.0f)
+            continue;
+        if (slot.target == ModTarget::Tone)
+            toneValue_ += slot.depthTo * value(slot.source);
+        else if (slot.target == ModTarget::Mix)
+            mixValue_ += slot.depthTo * value(slot.source);
+    }
+    toneValue_ *= kToneModulationOctaves;
+}
+
+void ModulationMatrix::advance(ModSource source, const AudioBlock& input, int start, int length, float* rendered) noexcept
+{
+    const simd::KernelTable& kernels = simd::activeKernels();
+    switch (source) {
+    case ModSource::Lfo:
+        if (rendered != nullptr) {
+            std::uint32_t phase = lfoPhase_;
+            for (int i = 0; i < length; ++i, phase += lfoIncrement_)
+                rendered[i] = lfoShape(phase, lfoShape_);
+        }
+        lfoPhase_ += lfoIncrement_ * static_cast<std::uint32_t>(length);
+        break;
+    case ModSource::Random:
+        if (rendered == nullptr) {
+            advanceRandom(length);
+            break;
+        }
+        for (int i = 0; i < length; ++i) {
+            rendered[i] = value(ModSource::Random);
+            advanceRandom(1);
+        }
+        break;
+    case ModSource::Envelope:
+        if (rendered == nullptr) {
+            for (int ch = 0; ch < input.numChannels(); ++ch)
+                envelopePeak_ = std::max(envelopePeak_, kernels.peakAbs(input.channel(ch) + start, length));
+            break;
+        }
+        std::memset(rendered, 0, sizeof(float) * static_cast<std::size_t>(length));
+        for (int ch = 0; ch < input.numChannels(); ++ch)
+            kernels.maxAbs(rendered, input.channel(ch) + start, length);
+        for (int i = 0; i < length; ++i) {
+            const float level = rendered[i];
+            const float pole = level > envelope_ ? envelopeAttack_ : envelopeRelease_;
+            envelope_ = level + pole * (envelope_ - level);
+            rendered[i] = std::min(envelope_, 1.0f);
+        }
+        break;
+    case ModSource::Off:
+        break;
+    }
+}
+
+void ModulationMatrix::process(const AudioBlock& envelopeInput, int numSamples, ModulationBlock& block) noexcept
+{
+    // A source feeding drive, now or once a pending re-route lands, runs per sample.
+    bool active[kNumModTargets] = {};
+    audioRate_.fill(false);
+    for (const Slot& slot : slots_) {
+        if (slot.source != ModSource::Off && (slot.depthFrom != 0.0f || slot.depthTo != 0.0f)) {
+            active[static_cast<int>(slot.target)] = true;
+            if (slot.target == ModTarget::Drive)
+                audioRate_[static_cast<std::size_t>(slot.source)] = true;
+        }
+        if (slot.requested.source != ModSource::Off && slot.requested.depth != 0.0f) {
+            active[static_cast<int>(slot.requested.target)] = true;
+            if (slot.requested.target == ModTarget::Drive)
+                audioRate_[static_cast<std::size_t>(slot.requested.source)] = true;
+        }
+    }
+    const bool driveActive = active[static_cast<int>(ModTarget::Drive)];
+    if (driveActive)
+        std::memset(drive_.data(), 0, sizeof(float) * static_cast<std::size_t>(numSamples));
+
+    block.firstStep = kModulationInterval - static_cast<int>(time_ % kModulationInterval);
+    int step = 0;
+    for (int pos = 0; pos < numSamples; ++step) {
+        const int within = static_cast<int>(time_ % kModulationInterval);
+        if (within == 0)
+            beginStep();
+        const int length = std::min(kModulationInterval - within, numSamples - pos);
+        toneSteps_[static_cast<std::size_t>(step)] = toneValue_;
+        mixSteps_[static_cast<std::size_t>(step)] = mixValue_;
+
+        for (int s = 1; s < kNumModSources; ++s) {
+            float* rendered = audioRate_[static_cast<std::size_t>(s)]
+                                  ? rendered_.data() + static_cast<std::size_t>(s) * maxBlockSize_ + pos
+                                  : nullptr;
+            advance(static_cast<ModSource>(s), envelopeInput, pos, length, rendered);
+        }
+
+        if (driveActive) {
+            // Depth moves linearly across the step, so drive never steps.
+            float* drive = drive_.data() + pos;
+            for (const Slot& slot : slots_) {
+                if (slot.source == ModSource::Off || slot.target != ModTarget::Drive ||
+                    (slot.depthFrom == 0.0f && slot.depthTo == 0.0f))
+                    continue;
+                const float* source = rendered_.data() + static_cast<std::size_t>(slot.source) * maxBlockSize_ + pos;
+                const float slope = (slot.depthTo - slot.depthFrom) * (kDriveModulationDb / kModulationInterval);
+                const float depth = slot.depthFrom * kDriveModulationDb + slope * static_cast<float>(within);
+                for (int i = 0; i < length; ++i)
+                    drive[i] += (depth + slope * static_cast<float>(i)) * source[i];
+            }
+        }
+
+        pos += length;
+        time_ += static_cast<std::uint64_t>(length);
+    }
+
+    if (driveActive)
+        simd::activeKernels().decibelsToGain(drive_.data(), numSamples);
+    block.driveGains = driveActive ? drive_.data() : nullptr;
+    block.toneOctaves = active[static_cast<int>(ModTarget::Tone)] ? toneSteps_.data() : nullptr;
+    block.mixOffset = active[static_cast<int>(ModTarget::Mix)] ? mixSteps_.data() : nullptr;
+}
+
+} // namespace villain::dsp
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "core/AlignedBuffer.h"
+#include "core/AudioBlock.h"
+
+#include <array>
+#include <cstdint>
+
+namespace villain::dsp {
+
+enum class ModSource {
+    Off,
+    Lfo,
+    Envelope,   // follows the input level, or the sidechain key when keyed
+    Random,     // smoothed random: straight lines between random points
+};
+
+enum class ModTarget {
+    Drive,
+    Tone,
+    Mix,
+};
+
+enum class LfoShape {
+    Sine,
+    Triangle,
+};
+
+constexpr int kNumModSources = 4;
+constexpr int kNumModTargets = 3;
+constexpr int kNumLfoShapes = 2;
+constexpr int kModulationSlots = 4;
+
+// Samples per control step: the "block rate" sources run at, independent of the host's
+// block size. Steps are aligned to absolute sample time, so any chunking gives one result.
+constexpr int kModulationInterval = 32;
+
+// What full depth (1.0) moves each target by.
+constexpr float kDriveModulationDb = 24.0f;
+constexpr float kToneModulationOctaves = 3.0f;
+
+struct ModulationRoute {
+    ModSource source = ModSource::Off;
+    ModTarget target = ModTarget::Drive;
+    float depth = 0.0f;   // -1 .. 1
+};
+
+// One chunk of modulation as the chains consume it. Null tracks leave their target alone.
+struct ModulationBlock {
+    const float* driveGains = nullptr;   // one linear gain per sample, applied with the drive
+    const float* toneOctaves = nullptr;  // one per control step
+    const float* mixOffset = nullptr;    // one per control step, added to the mix
+    int firstStep = kModulationInterval; // samples in the chunk's first (possibly partial) step
+
+    int stepLength(int step) const noexcept { return step == 0 ? firstStep : kModulationInterval; }
+};
+
+// Routes LFO, envelope and random sources to drive, tone and mix through a few slots.
+//
+// Sources run at the control rate by default: one value per kModulationInterval samples,
+// and a chain updates tone and mix once per step. Only drive, which is applied as a gain per
+// sample, needs audio rate; a source routed to it is rendered for every sample of the chunk,
+// in one batch. Either way a chunk's tracks are computed once, before any chain runs, and
+// shared by all of them.
+//
+// Depth changes and re-routing slew over a few steps rather than jumping. prepare()
+// allocates; everything else is audio-thread safe.
+class ModulationMatrix {
+public:
+    static constexpr double kEnvelopeAttackSeconds = 0.005;
+    // Full-scale depth change per second.
+    static constexpr float kDepthSlewPerSecond = 20.0f;
+
+    void prepare(double sampleRate, int maxBlockSize);
+    // Restarts every source: LFO at phase 0, envelope at rest, random sequence from its seed.
+    void reset() noexcept;
+
+    void setRoute(int slot, const ModulationRoute& route) noexcept;
+    void setLfo(float hz, LfoShape shape) noexcept;
+    void setRandomRate(float hz) noexcept;
+    void setEnvelopeRelease(float seconds) noexcept;
+
+    // True while any slot is routed with (or slewing from) a non-zero depth.
+    bool isActive() const noexcept;
+    // Upper bound on the boost drive modulation can add, now or once slewing settles.
+    float maxDriveDecibels() const noexcept;
+
+    // Advances every source by `numSamples` and fills the tracks `block` points at. The
+    // envelope follows `envelopeInput`, read in place; it may have no channels (silence).
+    void process(const AudioBlock& envelopeInput, int numSamples, ModulationBlock& block) noexcept;
+
+    // True if `source` is being rendered per sample (it feeds an audio-rate target).
+    bool isAudioRate(ModSource source) const noexcept { return audioRate_[static_cast<std::size_t>(source)]; }
+
+private:
+    struct Slot {
+        ModulationRoute requested;
+        ModSource source = ModSource::Off;   // routing in effect, which may lag `requested`
+        ModTarget target = ModTarget::Drive;
+        float depthFrom = 0.0f;              // depth across the current step
+        float depthTo = 0.0f;
+    };
+
+    void beginStep() noexcept;
+    float value(ModSource source) const noexcept;
+    void advance(ModSource source, const AudioBlock& input, int start, int length, float* rendered) noexcept;
+    void advanceRandom(int samples) noexcept;
+    float nextRandom() noexcept;
+
+    double sampleRate_ = 48000.0;
+    std::array<Slot, kModulationSlots> slots_{};
+    std::array<bool, kNumModSources> audioRate_{};
+    float depthSlew_ = 0.0f;   // per step
+
+    // LFO: a 32-bit phase, so stepping by one sample or by a whole step lands on the same value.
+    std::uint32_t lfoPhase_ = 0;
+    std::uint32_t lfoIncrement_ = 0;
+    LfoShape lfoShape_ = LfoShape::Sine;
+
+    float envelope_ = 0.0f;
+    float envelopePeak_ = 0.0f;   // peak of the current step, at control rate
+    float envelopeAttack_ = 0.0f;
+    float envelopeRelease_ = 0.0f;
+    float envelopeReleaseSeconds_ = 0.15f;
+
+    std::uint32_t randomState_ = 0;
+    int randomPeriod_ = 1;
+    int randomPendingPeriod_ = 1;   // takes over at the next random point
+    int randomPosition_ = 0;
+    float randomFrom_ = 0.0f;
+    float randomTo_ = 0.0f;
+
+    std::uint64_t time_ = 0;
+    float toneValue_ = 0.0f;   // the current step's target values
+    float mixValue_ = 0.0f;
+
+    AlignedBuffer<float> rendered_;   // [source][maxBlockSize], audio-rate sources
+    AlignedBuffer<float> drive_;      // maxBlockSize
+    AlignedBuffer<float> toneSteps_;
+    AlignedBuffer<float> mixSteps_;
+    int maxBlockSize_ = 0;
+};
+
+} // namespace villain::dsp
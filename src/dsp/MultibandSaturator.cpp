@@ -0,0 +1,144 @@
+#include "dsp/MultibandSaturator.h"
+
+#include "dsp/Gain.h"
+#include "dsp/simd/Kernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace villain::dsp {
+
+namespace {
+
+constexpr double kDriveSmoothingSeconds = 0.02;
+constexpr double kMaxSplitFraction = 0.4;
+constexpr int kHistoryPerChannel = simd::kMaxAntialiasingOrder * simd::kCrossoverLanes;
+
+} // namespace
+
+void MultibandSaturator::prepare(int numChannels)
+{
+    crossover_.prepare(numChannels);
+    lanes_.allocate(static_cast<std::size_t>(kFramesPerPass) * simd::kCrossoverLanes);
+    curves_ = acquireSaturationCurves();
+    history_.allocate(static_cast<std::size_t>(numChannels) * kHistoryPerChannel);
+    for (SmoothedValue& drive : drive_)
+        drive.setCurrentAndTarget(1.0f);
+    redesign();
+}
+
+void MultibandSaturator::reset() noexcept
+{
+    crossover_.reset();
+    for (SmoothedValue& drive : drive_)
+        drive.snapToTarget();
+    history_.clear();
+    primed_ = true;
+}
+
+void MultibandSaturator::setAntialiasing(Antialiasing mode) noexcept
+{
+    if (mode != antialiasing_)
+        primed_ = false;
+    antialiasing_ = mode;
+}
+
+void MultibandSaturator::setSampleRate(double sampleRate) noexcept
+{
+    sampleRate_ = sampleRate;
+    for (SmoothedValue& drive : drive_)
+        drive.prepare(sampleRate, kDriveSmoothingSeconds);
+    redesign();
+}
+
+void MultibandSaturator::setBands(int numBands, float lowHz, float highHz) noexcept
+{
+    numBands_ = std::clamp(numBands, 1, kMaxBands);
+    lowHz_ = lowHz;
+    highHz_ = std::max(highHz, lowHz);
+    redesign();
+}
+
+void MultibandSaturator::setBandDriveDecibels(int band, float decibels) noexcept
+{
+    if (band >= 0 && band < kMaxBands)
+        drive_[static_cast<std::size_t>(band)].setTarget(decibelsToGain(decibels));
+}
+
+float MultibandSaturator::maxDriveGain() const noexcept
+{
+    float gain = 0.0f;
+    for (int band = 0; band < numBands_; ++band)
+        gain = std::max(gain, drive_[static_cast<std::size_t>(band)].target());
+    return gain;
+}
+
+void MultibandSaturator::splitFrequencies(int numBands, float lowHz, float highHz, float* out) noexcept
+{
+    const int numSplits = numBands - 1;
+    if (numSplits == 1) {
+        out[0] = lowHz;
+        return;
+    }
+    const double ratio = static_cast<double>(highHz) / lowHz;
+    for (int i = 0; i < numSplits; ++i)
+        out[i] = static_cast<float>(lowHz * std::pow(ratio, static_cast<double>(i) / (numSplits - 1)));
+}
+
+void MultibandSaturator::redesign() noexcept
+{
+    // Keeps every split below Nyquist when the chain runs without oversampling.
+    const float limit = static_cast<float>(sampleRate_ * kMaxSplitFraction);
+    float frequencies[kMaxBands] = {};
+    splitFrequencies(numBands_, std::min(lowHz_, limit), std::min(highHz_, limit), frequencies);
+    crossover_.setBands(sampleRate_, numBands_, frequencies);
+}
+
+void MultibandSaturator::process(const AudioBlock& block) noexcept
+{
+    const simd::KernelTable& kernels = simd::activeKernels();
+    const auto shape = kernels.saturate[static_cast<int>(model_)];
+    const int order = curves_ != nullptr ? static_cast<int>(antialiasing_) : 0;
+    const auto shapeAntialiased = kernels.saturateAntialiased[order > 0 ? order - 1 : 0];
+    const simd::ShaperTable* table = curve_ != nullptr ? &curve_->table() : nullptr;
+    if (table == nullptr && curves_ != nullptr)
+        table = &curves_->table(model_);
+    float* lanes = lanes_.data();
+
+    alignas(32) float start[simd::kCrossoverLanes] = {};
+    alignas(32) float step[simd::kCrossoverLanes] = {};
+
+    for (int pos = 0; pos < block.numSamples(); pos += kFramesPerPass) {
+        const int frames = std::min(kFramesPerPass, block.numSamples() - pos);
+
+        // Drive ramps advance once per pass and are shared by every channel.
+        for (int band = 0; band < numBands_; ++band) {
+            SmoothedValue& drive = drive_[static_cast<std::size_t>(band)];
+            start[band] = drive.current();
+            drive.skip(frames);
+            step[band] = (drive.current() - start[band]) / static_cast<float>(frames);
+        }
+
+        for (int ch = 0; ch < block.numChannels(); ++ch) {
+            float* data = block.channel(ch) + pos;
+            crossover_.split(ch, data, lanes, frames);
+            kernels.laneGainRamp(lanes, frames, start, step);
+            if (order == 0 && curve_ != nullptr) {
+                kernels.shapeTabulated(lanes, frames * simd::kCrossoverLanes, *table);
+            } else if (order == 0) {
+                shape(lanes, frames * simd::kCrossoverLanes);
+            } else {
+                float* history = history_.data() + ch * kHistoryPerChannel;
+                if (!primed_)
+                    for (int j = 0; j < kHistoryPerChannel; ++j)
+                        history[j] = lanes[j % simd::kCrossoverLanes];
+                shapeAntialiased(lanes, frames, simd::kCrossoverLanes, *table,
+                                 history + (simd::kMaxAntialiasingOrder - order) * simd::kCrossoverLanes);
+            }
+            kernels.mergeLanes(lanes, data, frames);
+        }
+        primed_ = true;
+    }
+}
+
+} // namespace villain::dsp
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "core/AlignedBuffer.h"
+#include "core/AudioBlock.h"
+#include "dsp/Crossover.h"
+#include "dsp/SaturationModel.h"
+#include "dsp/ShaperCurve.h"
+#include "dsp/SmoothedValue.h"
+
+#include <array>
+#include <memory>
+#include <utility>
+
+namespace villain::dsp {
+
+// Splits each channel into Linkwitz-Riley bands, drives and shapes every band separately
+// and sums them back. The bands travel together as frames of lanes, so drive, shaping and
+// summing each cost one pass over the frame buffer whatever the band count.
+class MultibandSaturator {
+public:
+    void prepare(int numChannels);
+    void reset() noexcept;
+
+    // Rate process() runs at (the oversampled rate). Redesigns the filters and resets ramps.
+    void setSampleRate(double sampleRate) noexcept;
+
+    // Split points are spread geometrically from lowHz to highHz; two bands split at lowHz.
+    void setBands(int numBands, float lowHz, float highHz) noexcept;
+    void setBandDriveDecibels(int band, float decibels) noexcept;
+    void setModel(SaturationModel model) noexcept { model_ = model; }
+    void setAntialiasing(Antialiasing mode) noexcept;
+    // Non-realtime. A curve to shape with in place of the model's; null for the model.
+    void setCurve(std::shared_ptr<const ShaperCurve> curve) noexcept { curve_ = std::move(curve); }
+
+    int numBands() const noexcept { return numBands_; }
+    // Largest drive gain the active bands are heading for.
+    float maxDriveGain() const noexcept;
+
+    void process(const AudioBlock& block) noexcept;
+
+    static void splitFrequencies(int numBands, float lowHz, float highHz, float* out) noexcept;
+
+private:
+    // Frames per pass; sizes the lane buffer independently of block size and factor.
+    static constexpr int kFramesPerPass = 64;
+
+    void redesign() noexcept;
+
+    Crossover crossover_;
+    std::array<SmoothedValue, kMaxBands> drive_;
+    AlignedBuffer<float> lanes_;
+    std::shared_ptr<const SaturationCurves> curves_;
+    std::shared_ptr<const ShaperCurve> curve_;
+    AlignedBuffer<float> history_; // [channel][kMaxAntialiasingOrder][kCrossoverLanes]
+    SaturationModel model_ = SaturationModel::SoftClip;
+    Antialiasing antialiasing_ = Antialiasing::Off;
+    bool primed_ = true;
+    double sampleRate_ = 48000.0;
+    int numBands_ = 1;
+    float lowHz_ = 150.0f;
+    float highHz_ = 4000.0f;
+};
+
+} // namespace villain::dsp
@@ -0,0 +1,599 @@
+#include "dsp/Oversampler.h"
+
+#include "core/SharedTable.h"
+#include "dsp/simd/Kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace villain::dsp {
+
+namespace {
+
+struct StageSpec {
+    int firHalfLength;
+    double kaiserBeta;
+    int iirCoefficients;
+    double iirTransition;
+};
+
+// The first stage sees the full audio band and needs the steepest filters; later stages only
+// have to reject images well above the audio band, so they are progressively cheaper.
+constexpr StageSpec kStageSpecs[Oversampler::kMaxStages] = {
+    {16, 9.0, 12, 0.03},
+    {8, 8.0, 8, 0.10},
+    {4, 7.0, 6, 0.20},
+    {4, 7.0, 4, 0.25},
+};
+
+constexpr int kMaxFirHalfLength = 16;
+
+// The two allpass chains of a polyphase IIR stage have the same length, so one channel's
+// chains fill two lanes and a stereo pair fills four: one 128-bit op advances every chain of
+// both channels. Four lanes is the shape of the filter rather than of the machine, so this
+// stays on baseline SSE2 instead of going through the per-ISA kernels.
+#if defined(__SSE2__) || defined(_M_X64)
+using Quad = __m128;
+
+VILLAIN_FORCE_INLINE Quad quad(float a, float b, float c, float d) noexcept
+{
+    return _mm_setr_ps(a, b, c, d);
+}
+
+VILLAIN_FORCE_INLINE Quad allpass(Quad x, Quad a, Quad& xMem, Quad& yMem) noexcept
+{
+    const Quad y = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(x, yMem), a), xMem);
+    xMem = x;
+    yMem = y;
+    return y;
+}
+
+VILLAIN_FORCE_INLINE float lane(Quad q, int i) noexcept
+{
+    alignas(16) float v[4];
+    _mm_store_ps(v, q);
+    return v[i];
+}
+
+// Two adjacent samples from each channel: lanes (lo[0], lo[1], hi[0], hi[1]).
+VILLAIN_FORCE_INLINE Quad loadPairs(const float* lo, const float* hi) noexcept
+{
+    const Quad low = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(lo)));
+    return _mm_castpd_ps(_mm_loadh_pd(_mm_castps_pd(low), reinterpret_cast<const double*>(hi)));
+}
+
+VILLAIN_FORCE_INLINE void storeLowPair(Quad q, float* out) noexcept
+{
+    _mm_store_sd(reinterpret_cast<double*>(out), _mm_castps_pd(q));
+}
+
+VILLAIN_FORCE_INLINE void storeHighPair(Quad q, float* out) noexcept
+{
+    _mm_storeh_pd(reinterpret_cast<double*>(out), _mm_castps_pd(q));
+}
+
+// (lane0 + lane1, lane2 + lane3), each scaled by 0.5.
+VILLAIN_FORCE_INLINE void halfPairSums(Quad q, float& lo, float& hi) noexcept
+{
+    const Quad sums = _mm_mul_ps(_mm_add_ps(q, _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 3, 0, 1))), _mm_set1_ps(0.5f));
+    lo = _mm_cvtss_f32(sums);
+    hi = _mm_cvtss_f32(_mm_movehl_ps(sums, sums));
+}
+#else
+struct Quad {
+    float v[4];
+};
+
+VILLAIN_FORCE_INLINE Quad quad(float a, float b, float c, float d) noexcept
+{
+    return {{a, b, c, d}};
+}
+
+VILLAIN_FORCE_INLINE Quad allpass(Quad x, Quad a, Quad& xMem, Quad& yMem) noexcept
+{
+    Quad y;
+    for (int i = 0; i < 4; ++i)
+        y.v[i] = (x.v[i] - yMem.v[i]) * a.v[i] + xMem.v[i];
+    xMem = x;
+    yMem = y;
+    return y;
+}
+
+VILLAIN_FORCE_INLINE float lane(Quad q, int i) noexcept
+{
+    return q.v[i];
+}
+
+VILLAIN_FORCE_INLINE Quad loadPairs(const float* lo, const float* hi) noexcept
+{
+    return {{lo[0], lo[1], hi[0], hi[1]}};
+}
+
+VILLAIN_FORCE_INLINE void storeLowPair(Quad q, float* out) noexcept
+{
+    out[0] = q.v[0];
+    out[1] = q.v[1];
+}
+
+VILLAIN_FORCE_INLINE void storeHighPair(Quad q, float* out) noexcept
+{
+    out[0] = q.v[2];
+    out[1] = q.v[3];
+}
+
+VILLAIN_FORCE_INLINE void halfPairSums(Quad q, float& lo, float& hi) noexcept
+{
+    lo = 0.5f * (q.v[0] + q.v[1]);
+    hi = 0.5f * (q.v[2] + q.v[3]);
+}
+#endif
+
+// Channel and chain state for one stage direction. Lane 2c + l of step j runs coefficient
+// 2j + (l ^ Swap) of channel c; state stores (x, y) per coefficient. The decimator swaps
+// so each channel's incoming sample pair loads straight into its two lanes.
+template <int N, int C, int Swap>
+struct IirQuadState {
+    static_assert(N % 2 == 0, "both chains must have the same length");
+    static constexpr int kSteps = N / 2;
+
+    Quad c[kSteps], xm[kSteps], ym[kSteps];
+
+    VILLAIN_FORCE_INLINE static float at(float* const* state, int channel, int k, int which) noexcept
+    {
+        return channel < C ? state[channel][2 * k + which] : 0.0f;
+    }
+
+    IirQuadState(const float* a, float* const* state) noexcept
+    {
+        for (int j = 0; j < kSteps; ++j) {
+            const int k0 = 2 * j + Swap;
+            const int k1 = 2 * j + (1 - Swap);
+            c[j] = quad(a[k0], a[k1], a[k0], a[k1]);
+            xm[j] = quad(at(state, 0, k0, 0), at(state, 0, k1, 0), at(state, 1, k0, 0), at(state, 1, k1, 0));
+            ym[j] = quad(at(state, 0, k0, 1), at(state, 0, k1, 1), at(state, 1, k0, 1), at(state, 1, k1, 1));
+        }
+    }
+
+    void save(float* const* state) const noexcept
+    {
+        for (int j = 0; j < kSteps; ++j) {
+            const int k0 = 2 * j + Swap;
+            const int k1 = 2 * j + (1 - Swap);
+            for (int ch = 0; ch < C; ++ch) {
+                state[ch][2 * k0] = lane(xm[j], 2 * ch);
+                state[ch][2 * k1] = lane(xm[j], 2 * ch + 1);
+                state[ch][2 * k0 + 1] = lane(ym[j], 2 * ch);
+                state[ch][2 * k1 + 1] = lane(ym[j], 2 * ch + 1);
+            }
+        }
+    }
+
+    VILLAIN_FORCE_INLINE Quad run(Quad x) noexcept
+    {
+        for (int j = 0; j < kSteps; ++j)
+            x = allpass(x, c[j], xm[j], ym[j]);
+        return x;
+    }
+};
+
+// One 2x interpolation stage for C (1 or 2) channels: even outputs from the first chain,
+// odd outputs from the second.
+template <int N, int C>
+void iirUpQuad(const float* a, float* const* state, const float* const* in, float* const* out, int numSamples) noexcept
+{
+    IirQuadState<N, C, 0> chains(a, state);
+    const float* VILLAIN_RESTRICT in0 = in[0];
+    const float* VILLAIN_RESTRICT in1 = in[C - 1];
+    float* VILLAIN_RESTRICT out0 = out[0];
+    float* VILLAIN_RESTRICT out1 = out[C - 1];
+
+    for (int i = 0; i < numSamples; ++i) {
+        const Quad y = chains.run(quad(in0[i], in0[i], in1[i], in1[i]));
+        storeLowPair(y, out0 + 2 * i);
+        if constexpr (C == 2)
+            storeHighPair(y, out1 + 2 * i);
+    }
+    chains.save(state);
+}
+
+// One 2x decimation stage: the first chain takes the odd input, the second the even one.
+template <int N, int C>
+void iirDownQuad(const float* a, float* const* state, const float* const* in, float* const* out, int numSamples) noexcept
+{
+    IirQuadState<N, C, 1> chains(a, state);
+    const float* VILLAIN_RESTRICT in0 = in[0];
+    const float* VILLAIN_RESTRICT in1 = in[C - 1];
+    float* VILLAIN_RESTRICT out0 = out[0];
+    float* VILLAIN_RESTRICT out1 = out[C - 1];
+
+    for (int i = 0; i < numSamples; ++i) {
+        float lo;
+        float hi;
+        halfPairSums(chains.run(loadPairs(in0 + 2 * i, in1 + 2 * i)), lo, hi);
+        out0[i] = lo;
+        if constexpr (C == 2)
+            out1[i] = hi;
+    }
+    chains.save(state);
+}
+
+template <typename F, int... I>
+VILLAIN_FORCE_INLINE void forEachIndex(F&& f, std::integer_sequence<int, I...>) noexcept
+{
+    (f(std::integral_constant<int, I>{}), ...);
+}
+
+} // namespace
+
+struct OversamplerKernels {
+    struct Stage {
+        HalfbandFirDesign fir;
+        HalfbandIirDesign iir;
+        AlignedBuffer<float> upTaps;     // dense branch, reversed and scaled by 2
+        AlignedBuffer<float> downTaps;   // dense branch, reversed
+    };
+
+    std::array<Stage, Oversampler::kMaxStages> stages;
+
+    // Indexed by number of stages. padDelay only applies to LinearPhase.
+    std::array<int, Oversampler::kMaxStages + 1> minimumPhaseLatency{};
+    std::array<int, Oversampler::kMaxStages + 1> linearPhaseLatency{};
+    std::array<int, Oversampler::kMaxStages + 1> padDelay{};
+    int maxLatency = 0;
+};
+
+namespace {
+
+void computeLatencies(OversamplerKernels& kernels) noexcept
+{
+    for (int numStages = 1; numStages <= Oversampler::kMaxStages; ++numStages) {
+        // Linear phase: each stage delays by its centre tap on the way up and again on the
+        // way down, at its own rate. Sum in top-rate samples so everything stays integral.
+        const int topFactor = 1 << numStages;
+        int topSamples = 0;
+        for (int s = 0; s < numStages; ++s)
+            topSamples += 2 * kernels.stages[static_cast<std::size_t>(s)].fir.centreDelay() * (1 << (numStages - 1 - s));
+        const int pad = (topFactor - topSamples % topFactor) % topFactor;
+        kernels.padDelay[static_cast<std::size_t>(numStages)] = pad;
+        kernels.linearPhaseLatency[static_cast<std::size_t>(numStages)] = (topSamples + pad) / topFactor;
+
+        // Minimum phase: up and down together delay DC by the sum of both chains' delays, in
+        // samples at the stage's input rate.
+        double baseSamples = 0.0;
+        for (int s = 0; s < numStages; ++s) {
+            const HalfbandIirDesign& iir = kernels.stages[static_cast<std::size_t>(s)].iir;
+            baseSamples += (iir.chainDelay(0) + iir.chainDelay(1)) / static_cast<double>(1 << s);
+        }
+        kernels.minimumPhaseLatency[static_cast<std::size_t>(numStages)] = static_cast<int>(std::lround(baseSamples));
+    }
+
+    for (int numStages = 0; numStages <= Oversampler::kMaxStages; ++numStages) {
+        kernels.maxLatency = std::max({kernels.maxLatency, kernels.minimumPhaseLatency[static_cast<std::size_t>(numStages)],
+                                       kernels.linearPhaseLatency[static_cast<std::size_t>(numStages)]});
+    }
+}
+
+OversamplerKernels buildKernels()
+{
+    OversamplerKernels kernels;
+    for (int s = 0; s < Oversampler::kMaxStages; ++s) {
+        OversamplerKernels::Stage& stage = kernels.stages[static_cast<std::size_t>(s)];
+        const StageSpec& spec = kStageSpecs[s];
+        stage.fir = designHalfbandFir(spec.firHalfLength, spec.kaiserBeta);
+        stage.iir = designHalfbandIir(spec.iirCoefficients, spec.iirTransition);
+
+        const std::size_t length = stage.fir.denseTaps.size();
+        stage.upTaps.allocate(length);
+        stage.downTaps.allocate(length);
+        for (std::size_t i = 0; i < length; ++i) {
+            stage.upTaps[i] = 2.0f * stage.fir.denseTaps[length - 1 - i];
+            stage.downTaps[i] = stage.fir.denseTaps[length - 1 - i];
+        }
+    }
+    computeLatencies(kernels);
+    return kernels;
+}
+
+} // namespace
+
+void Oversampler::prepare(int numChannels, int maxBlockSize)
+{
+    kernels_ = SharedTable<OversamplerKernels>::acquire(&buildKernels);
+    numChannels_ = numChannels;
+    maxBlockSize_ = maxBlockSize;
+
+    for (int s = 0; s < kMaxStages; ++s) {
+        Stage& stage = stages_[static_cast<std::size_t>(s)];
+        const OversamplerKernels::Stage& design = kernels_->stages[static_cast<std::size_t>(s)];
+
+        stage.bufferStride = static_cast<int>(alignUp(static_cast<std::size_t>(maxBlockSize) << (s + 1), 16));
+        stage.buffer.allocate(static_cast<std::size_t>(stage.bufferStride) * static_cast<std::size_t>(numChannels));
+
+        // FIR: history tails for the upsampler and the decimator's even phase, plus the
+        // decimator's odd-phase delay. IIR: (x, y) memory per allpass, up and down.
+        const int history = 2 * design.fir.halfLength - 1;
+        const int firState = 2 * history + design.fir.halfLength;
+        const int iirState = 4 * static_cast<int>(design.iir.coefficients.size());
+        stage.stateStride = static_cast<int>(alignUp(static_cast<std::size_t>(std::max(firState, iirState)), 16));
+        stage.state.allocate(static_cast<std::size_t>(stage.stateStride) * static_cast<std::size_t>(numChannels));
+    }
+
+    // The widest FIR pass reads or writes maxBlockSize << (kMaxStages - 1) low-rate samples.
+    workSpan_ = static_cast<int>(alignUp((static_cast<std::size_t>(maxBlockSize) << (kMaxStages - 1)) +
+                                             2 * kMaxFirHalfLength, 16));
+    workStride_ = 3 * workSpan_;
+    work_.allocate(static_cast<std::size_t>(workStride_) * static_cast<std::size_t>(numChannels));
+
+    pad_.allocate(static_cast<std::size_t>(kPadCapacity) * static_cast<std::size_t>(numChannels));
+    configure();
+    reset();
+}
+
+void Oversampler::reset() noexcept
+{
+    for (Stage& stage : stages_)
+        stage.state.clear();
+    pad_.clear();
+    padPos_.fill(0);
+}
+
+void Oversampler::setNumStages(int numStages) noexcept
+{
+    numStages = std::clamp(numStages, 0, kMaxStages);
+    if (numStages == numStages_)
+        return;
+    numStages_ = numStages;
+    configure();
+    reset();
+}
+
+void Oversampler::setMode(OversamplingMode mode) noexcept
+{
+    if (mode == mode_)
+        return;
+    mode_ = mode;
+    configure();
+    reset();
+}
+
+void Oversampler::configure() noexcept
+{
+    if (!kernels_)
+        return;
+    const auto index = static_cast<std::size_t>(numStages_);
+    const bool linear = mode_ == OversamplingMode::LinearPhase;
+    latency_ = linear ? kernels_->linearPhaseLatency[index] : kernels_->minimumPhaseLatency[index];
+    padDelay_ = linear ? kernels_->padDelay[index] : 0;
+
+    static_assert(kMaxStages == 4, "one path per mode and factor");
+    up_ = nullptr;
+    down_ = nullptr;
+    switch (linear ? -numStages_ : numStages_) {
+    case 1: up_ = &Oversampler::upsampleIir<1>; down_ = &Oversampler::downsampleIir<1>; break;
+    case 2: up_ = &Oversampler::upsampleIir<2>; down_ = &Oversampler::downsampleIir<2>; break;
+    case 3: up_ = &Oversampler::upsampleIir<3>; down_ = &Oversampler::downsampleIir<3>; break;
+    case 4: up_ = &Oversampler::upsampleIir<4>; down_ = &Oversampler::downsampleIir<4>; break;
+    case -1: up_ = &Oversampler::upsampleFir<1>; down_ = &Oversampler::downsampleFir<1>; break;
+    case -2: up_ = &Oversampler::upsampleFir<2>; down_ = &Oversampler::downsampleFir<2>; break;
+    case -3: up_ = &Oversampler::upsampleFir<3>; down_ = &Oversampler::downsampleFir<3>; break;
+    case -4: up_ = &Oversampler::upsampleFir<4>; down_ = &Oversampler::downsampleFir<4>; break;
+    default: break;   // no stages: upsample() and downsample() pass straight through
+    }
+}
+
+int Oversampler::maxLatencySamples() const noexcept
+{
+    return kernels_ ? kernels_->maxLatency : 0;
+}
+
+AudioBlock Oversampler::upsample(const AudioBlock& input) noexcept
+{
+    currentSamples_ = input.numSamples();
+    if (numStages_ == 0)
+        return input;
+
+    (this->*up_)(input);
+    std::array<float*, kMaxChannels> pointers{};
+    for (int ch = 0; ch < input.numChannels(); ++ch)
+        pointers[static_cast<std::size_t>(ch)] = stages_[static_cast<std::size_t>(numStages_ - 1)].channelBuffer(ch);
+    return AudioBlock(pointers.data(), input.numChannels(), input.numSamples() << numStages_);
+}
+
+void Oversampler::downsample(const AudioBlock& output) noexcept
+{
+    if (numStages_ > 0)
+        (this->*down_)(output);
+}
+
+// Channels go through in pairs, both chains of both channels sharing one vector; an odd
+// channel out runs the same code at half width.
+template <int NumStages>
+void Oversampler::upsampleIir(const AudioBlock& input) noexcept
+{
+    for (int ch = 0; ch < input.numChannels(); ch += 2) {
+        if (ch + 1 < input.numChannels())
+            upsampleIirChannels<NumStages, 2>(input, ch);
+        else
+            upsampleIirChannels<NumStages, 1>(input, ch);
+    }
+}
+
+template <int NumStages>
+void Oversampler::downsampleIir(const AudioBlock& output) noexcept
+{
+    for (int ch = 0; ch < output.numChannels(); ch += 2) {
+        if (ch + 1 < output.numChannels())
+            downsampleIirChannels<NumStages, 2>(output, ch);
+        else
+            downsampleIirChannels<NumStages, 1>(output, ch);
+    }
+}
+
+template <int NumStages, int C>
+void Oversampler::upsampleIirChannels(const AudioBlock& input, int first) noexcept
+{
+    const float* in[2] = {input.channel(first), input.channel(first + C - 1)};
+    int n = input.numSamples();
+    forEachIndex(
+        [&](auto index) {
+            constexpr int s = decltype(index)::value;
+            Stage& stage = stages_[s];
+            float* out[2] = {stage.channelBuffer(first), stage.channelBuffer(first + C - 1)};
+            float* state[2] = {stage.channelState(first), stage.channelState(first + C - 1)};
+            iirUpQuad<kStageSpecs[s].iirCoefficients, C>(kernels_->stages[s].iir.coefficients.data(), state, in, out, n);
+            in[0] = out[0];
+            in[1] = out[1];
+            n *= 2;
+        },
+        std::make_integer_sequence<int, NumStages>{});
+}
+
+template <int NumStages, int C>
+void Oversampler::downsampleIirChannels(const AudioBlock& output, int first) noexcept
+{
+    int n = currentSamples_ << NumStages;
+    forEachIndex(
+        [&](auto index) {
+            constexpr int s = NumStages - 1 - decltype(index)::value;
+            constexpr int kCoefficients = kStageSpecs[s].iirCoefficients;
+            Stage& stage = stages_[s];
+            const float* in[2] = {stage.channelBuffer(first), stage.channelBuffer(first + C - 1)};
+            float* out[2];
+            if constexpr (s == 0) {
+                out[0] = output.channel(first);
+                out[1] = output.channel(first + C - 1);
+            } else {
+                out[0] = stages_[s - 1].channelBuffer(first);
+                out[1] = stages_[s - 1].channelBuffer(first + C - 1);
+            }
+            // The decimator's memories follow the interpolator's in each channel's state.
+            float* state[2] = {stage.channelState(first) + 2 * kCoefficients,
+                               stage.channelState(first + C - 1) + 2 * kCoefficients};
+            n /= 2;
+            iirDownQuad<kCoefficients, C>(kernels_->stages[s].iir.coefficients.data(), state, in, out, n);
+        },
+        std::make_integer_sequence<int, NumStages>{});
+}
+
+// Stage counts and filter lengths are compile-time here as on the IIR paths, so the
+// history copies and phase interleaves are fixed-size. Channels stay a runtime loop: each
+// one is a separate convolution through the ISA kernel, with nothing to share across lanes.
+template <int NumStages>
+void Oversampler::upsampleFir(const AudioBlock& input) noexcept
+{
+    for (int ch = 0; ch < input.numChannels(); ++ch) {
+        int n = input.numSamples();
+        const float* in = input.channel(ch);
+        forEachIndex(
+            [&](auto index) {
+                constexpr int s = decltype(index)::value;
+                float* out = stages_[s].channelBuffer(ch);
+                upStage<s>(ch, in, out, n);
+                in = out;
+                n *= 2;
+            },
+            std::make_integer_sequence<int, NumStages>{});
+    }
+}
+
+template <int NumStages>
+void Oversampler::downsampleFir(const AudioBlock& output) noexcept
+{
+    for (int ch = 0; ch < output.numChannels(); ++ch) {
+        int n = currentSamples_ << NumStages;
+        if (padDelay_ > 0)
+            applyPadDelay(stages_[NumStages - 1].channelBuffer(ch), ch, n);
+
+        forEachIndex(
+            [&](auto index) {
+                constexpr int s = NumStages - 1 - decltype(index)::value;
+                float* out;
+                if constexpr (s == 0)
+                    out = output.channel(ch);
+                else
+                    out = stages_[s - 1].channelBuffer(ch);
+                n /= 2;
+                downStage<s>(ch, stages_[s].channelBuffer(ch), out, n);
+            },
+            std::make_integer_sequence<int, NumStages>{});
+    }
+}
+
+template <int S>
+void Oversampler::upStage(int ch, const float* in, float* out, int numSamples) noexcept
+{
+    const OversamplerKernels::Stage& stage = kernels_->stages[S];
+    float* state = stages_[S].channelState(ch);
+
+    // Dense branch: a block convolution over [history | input]. Sparse branch: the input
+    // delayed to the centre tap.
+    constexpr int half = kStageSpecs[S].firHalfLength;
+    constexpr int length = 2 * half;
+    constexpr int history = length - 1;
+    float* work = channelWork(ch);
+    float* dense = work + 2 * workSpan_;
+
+    std::memcpy(work, state, sizeof(float) * history);
+    std::memcpy(work + history, in, sizeof(float) * static_cast<std::size_t>(numSamples));
+    simd::activeKernels().convolve(work, stage.upTaps.data(), length, dense, numSamples);
+
+    const float* delayed = work + history - (half - 1);
+    for (int i = 0; i < numSamples; ++i) {
+        out[2 * i] = dense[i];
+        out[2 * i + 1] = delayed[i];
+    }
+    std::memcpy(state, work + numSamples, sizeof(float) * history);
+}
+
+template <int S>
+void Oversampler::downStage(int ch, const float* in, float* out, int numSamples) noexcept
+{
+    const OversamplerKernels::Stage& stage = kernels_->stages[S];
+    float* state = stages_[S].channelState(ch);
+
+    // Even phase through the dense branch, odd phase through the centre-tap delay of K
+    // low-rate samples.
+    constexpr int half = kStageSpecs[S].firHalfLength;
+    constexpr int length = 2 * half;
+    constexpr int history = length - 1;
+    float* evenState = state + history;
+    float* oddState = state + 2 * history;
+    float* even = channelWork(ch);
+    float* odd = even + workSpan_;
+
+    std::memcpy(even, evenState, sizeof(float) * history);
+    std::memcpy(odd, oddState, sizeof(float) * half);
+    for (int i = 0; i < numSamples; ++i) {
+        even[history + i] = in[2 * i];
+        odd[half + i] = in[2 * i + 1];
+    }
+
+    simd::activeKernels().convolve(even, stage.downTaps.data(), length, out, numSamples);
+    for (int i = 0; i < numSamples; ++i)
+        out[i] += 0.5f * odd[i];
+
+    std::memcpy(evenState, even + numSamples, sizeof(float) * history);
+    std::memcpy(oddState, odd + numSamples, sizeof(float) * half);
+}
+
+void Oversampler::applyPadDelay(float* data, int ch, int numSamples) noexcept
+{
+    float* ring = pad_.data() + ch * kPadCapacity;
+    int pos = padPos_[static_cast<std::size_t>(ch)];
+    for (int i = 0; i < numSamples; ++i) {
+        const int readPos = (pos - padDelay_) & (kPadCapacity - 1);
+        ring[pos] = data[i];
+        data[i] = ring[readPos];
+        pos = (pos + 1) & (kPadCapacity - 1);
+    }
+    padPos_[static_cast<std::size_t>(ch)] = pos;
+}
+
+} // namespace villain::dsp
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "core/AlignedBuffer.h"
+#include "core/AudioBlock.h"
+#include "dsp/HalfbandDesign.h"
+
+#include <array>
+#include <memory>
+
+namespace villain::dsp {
+
+enum class OversamplingMode {
+    // Polyphase IIR allpass stages: causal, no pre-ringing, a few samples of group delay.
+    MinimumPhase,
+    // Polyphase FIR stages: flat group delay, reported exactly to the host.
+    LinearPhase,
+};
+
+// Filter designs and latency tables for every stage, built once per process and shared
+// read-only by all oversamplers.
+struct OversamplerKernels;
+
+// Cascade of 2x halfband stages (2x .. 16x). prepare() sizes every buffer for 16x in both
+// modes, so factor and mode can change at any time without allocating.
+//
+// Usage per block: run upsample() to get a view of the oversampled signal, process it in
+// place, then downsample() back into the base-rate block.
+class Oversampler {
+public:
+    static constexpr int kMaxStages = 4;
+
+    void prepare(int numChannels, int maxBlockSize);
+    void reset() noexcept;
+
+    // 0 = bypass, 1 = 2x ... 4 = 16x. Changing either setting clears filter state.
+    void setNumStages(int numStages) noexcept;
+    void setMode(OversamplingMode mode) noexcept;
+
+    int numStages() const noexcept { return numStages_; }
+    int factor() const noexcept { return 1 << numStages_; }
+    OversamplingMode mode() const noexcept { return mode_; }
+
+    // Round-trip (up + down) delay in base-rate samples. Exact for LinearPhase; for
+    // MinimumPhase it is the DC group delay, rounded.
+    int latencySamples() const noexcept { return latency_; }
+
+    // Largest latency any factor/mode combination can report; sizes compensation delays.
+    int maxLatencySamples() const noexcept;
+
+    // Returns a view into internal storage holding input.numSamples() * factor() samples.
+    AudioBlock upsample(const AudioBlock& input) noexcept;
+    // Consumes the view returned by the last upsample() and writes the base-rate result.
+    void downsample(const AudioBlock& output) noexcept;
+
+    // The shared tables this instance reads from; null before prepare().
+    const OversamplerKernels* kernels() const noexcept { return kernels_.get(); }
+
+private:
+    struct Stage {
+        AlignedBuffer<float> buffer;     // output of this stage's upsampler, all channels
+        AlignedBuffer<float> state;      // filter memories, all channels
+        int bufferStride = 0;
+        int stateStride = 0;
+
+        float* channelBuffer(int ch) noexcept { return buffer.data() + ch * bufferStride; }
+        float* channelState(int ch) noexcept { return state.data() + ch * stateStride; }
+    };
+
+    // Resampling paths, one instantiation per mode and factor, picked by configure() when a
+    // setting changes so process calls carry no per-stage or per-sample dispatch.
+    using Path = void (Oversampler::*)(const AudioBlock& block) noexcept;
+
+    void configure() noexcept;
+    template <int NumStages>
+    void upsampleIir(const AudioBlock& input) noexcept;
+    template <int NumStages>
+    void downsampleIir(const AudioBlock& output) noexcept;
+    template <int NumStages, int C>
+    void upsampleIirChannels(const AudioBlock& input, int first) noexcept;
+    template <int NumStages, int C>
+    void downsampleIirChannels(const AudioBlock& output, int first) noexcept;
+    template <int NumStages>
+    void upsampleFir(const AudioBlock& input) noexcept;
+    template <int NumStages>
+    void downsampleFir(const AudioBlock& output) noexcept;
+    template <int S>
+    void upStage(int ch, const float* in, float* out, int numSamples) noexcept;
+    template <int S>
+    void downStage(int ch, const float* in, float* out, int numSamples) noexcept;
+    void applyPadDelay(float* data, int ch, int numSamples) noexcept;
+
+    float* channelWork(int ch) noexcept { return work_.data() + ch * workStride_; }
+
+    std::shared_ptr<const OversamplerKernels> kernels_;
+    std::array<Stage, kMaxStages> stages_;
+
+    // Per-channel FIR workspace: history-prefixed input, odd-phase history and convolution
+    // output for the largest stage.
+    AlignedBuffer<float> work_;
+    int workStride_ = 0;
+    int workSpan_ = 0;
+    int numChannels_ = 0;
+    int maxBlockSize_ = 0;
+    int numStages_ = 0;
+    OversamplingMode mode_ = OversamplingMode::MinimumPhase;
+    int latency_ = 0;
+    int currentSamples_ = 0;
+    Path up_ = nullptr;
+    Path down_ = nullptr;
+
+    // Linear-phase stages delay by odd amounts at their own rate; this top-rate delay rounds
+    // the total up to a whole number of base-rate samples.
+    static constexpr int kPadCapacity = 1 << kMaxStages;
+    int padDelay_ = 0;
+    AlignedBuffer<float> pad_;
+    std::array<int, kMaxChannels> padPos_{};
+};
+
+} // namespace villain::dsp
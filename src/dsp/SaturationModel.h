@@ -0,0 +1,25 @@
+#pragma once
+
+namespace villain::dsp {
+
+enum class SaturationModel {
+    SoftClip,
+    HardClip,
+    Tube,
+};
+
+constexpr int kNumSaturationModels = 3;
+
+// Antiderivative anti-aliasing (ADAA) of the shapers. Each output is the shaper averaged
+// over the straight line between successive inputs (first order) or over a triangular
+// window across three of them (second order), which rolls off the harmonics that would
+// fold back. Costs half a sample and one sample of delay respectively.
+enum class Antialiasing {
+    Off,
+    FirstOrder,
+    SecondOrder,
+};
+
+constexpr int kNumAntialiasingModes = 3;
+
+} // namespace villain::dsp
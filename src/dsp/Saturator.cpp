@@ -0,0 +1,57 @@
+#include "dsp/Saturator.h"
+
+#include "dsp/simd/Kernels.h"
+
+namespace villain::dsp {
+
+void Saturator::prepare(int numChannels)
+{
+    curves_ = acquireSaturationCurves();
+    history_.allocate(static_cast<std::size_t>(numChannels) * simd::kMaxAntialiasingOrder);
+    primed_ = true;
+}
+
+void Saturator::reset() noexcept
+{
+    history_.clear();
+    primed_ = true;
+}
+
+void Saturator::setAntialiasing(Antialiasing mode) noexcept
+{
+    // The history went stale while another mode ran.
+    if (mode != antialiasing_)
+        primed_ = false;
+    antialiasing_ = mode;
+}
+
+void Saturator::process(const AudioBlock& block) noexcept
+{
+    const simd::KernelTable& kernels = simd::activeKernels();
+    const int order = static_cast<int>(antialiasing_);
+    if (order == 0 || curves_ == nullptr) {
+        const auto shape = kernels.saturate[static_cast<int>(model_)];
+        for (int ch = 0; ch < block.numChannels(); ++ch) {
+            if (curve_ != nullptr)
+                kernels.shapeTabulated(block.channel(ch), block.numSamples(), curve_->table());
+            else
+                shape(block.channel(ch), block.numSamples());
+        }
+        return;
+    }
+
+    const auto shape = kernels.saturateAntialiased[order - 1];
+    const simd::ShaperTable& table = curve_ != nullptr ? curve_->table() : curves_->table(model_);
+    for (int ch = 0; ch < block.numChannels(); ++ch) {
+        float* history = history_.data() + ch * simd::kMaxAntialiasingOrder;
+        // After a mode change: hold the first input, as if it had been there all along.
+        if (!primed_ && block.numSamples() > 0)
+            for (int j = 0; j < simd::kMaxAntialiasingOrder; ++j)
+                history[j] = block.channel(ch)[0];
+        // The kernel keeps the last `order` inputs; a second-order history is used in full.
+        shape(block.channel(ch), block.numSamples(), 1, table, history + simd::kMaxAntialiasingOrder - order);
+    }
+    primed_ = primed_ || block.numSamples() > 0;
+}
+
+} // namespace villain::dsp
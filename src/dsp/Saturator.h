@@ -0,0 +1,39 @@
+#pragma once
+
+#include "core/AlignedBuffer.h"
+#include "core/AudioBlock.h"
+#include "dsp/SaturationModel.h"
+#include "dsp/ShaperCurve.h"
+
+#include <memory>
+#include <utility>
+
+namespace villain::dsp {
+
+// Memoryless waveshaper applied in place to every channel, optionally with antiderivative
+// anti-aliasing. Without prepare() it only shapes sample by sample.
+class Saturator {
+public:
+    // Non-realtime. Takes the shared curve tables and allocates the anti-aliasing history.
+    void prepare(int numChannels);
+    void reset() noexcept;
+
+    void setModel(SaturationModel model) noexcept { model_ = model; }
+    SaturationModel model() const noexcept { return model_; }
+    void setAntialiasing(Antialiasing mode) noexcept;
+    Antialiasing antialiasing() const noexcept { return antialiasing_; }
+    // Non-realtime. A curve to shape with in place of the model's; null for the model.
+    void setCurve(std::shared_ptr<const ShaperCurve> curve) noexcept { curve_ = std::move(curve); }
+
+    void process(const AudioBlock& block) noexcept;
+
+private:
+    std::shared_ptr<const SaturationCurves> curves_;
+    std::shared_ptr<const ShaperCurve> curve_;
+    AlignedBuffer<float> history_; // [channel][kMaxAntialiasingOrder]
+    SaturationModel model_ = SaturationModel::SoftClip;
+    Antialiasing antialiasing_ = Antialiasing::Off;
+    bool primed_ = false; // history holds recent input
+};
+
+} // namespace villain::dsp
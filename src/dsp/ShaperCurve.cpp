@@ -0,0 +1,165 @@
+#include "dsp/ShaperCurve.h"
+
+#include "core/AssetPack.h"
+#include "core/SharedTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace villain::dsp {
+
+namespace {
+
+// Gauss-Legendre nodes and weights on [0, 1], applied to quarters of every segment so that
+// a corner inside a segment costs little accuracy.
+constexpr int kQuadraturePoints = 5;
+constexpr int kQuadratureParts = 4;
+constexpr double kQuadratureNodes[kQuadraturePoints] = {0.046910077030668, 0.230765344947158, 0.5,
+                                                         0.769234655052842, 0.953089922969332};
+constexpr double kQuadratureWeights[kQuadraturePoints] = {0.118463442528095, 0.239314335249683, 0.284444444444444,
+                                                           0.239314335249683, 0.118463442528095};
+
+// The built-in curves are flat beyond +/-3.3, so this range covers every corner.
+constexpr double kCurveLimit = 4.0;
+constexpr int kCurveSegments = 256;
+constexpr double kTubeBias = 0.3;
+
+double softClip(double x)
+{
+    const double c = std::clamp(x, -3.0, 3.0);
+    return c * (27.0 + c * c) / (27.0 + 9.0 * c * c);
+}
+
+double integrate(const std::function<double(double)>& shape, double from, double width)
+{
+    const double part = width / kQuadratureParts;
+    double sum = 0.0;
+    for (int p = 0; p < kQuadratureParts; ++p)
+        for (int q = 0; q < kQuadraturePoints; ++q)
+            sum += kQuadratureWeights[q] * shape(from + part * (p + kQuadratureNodes[q]));
+    return sum * part;
+}
+
+SaturationCurves buildSaturationCurves()
+{
+    SaturationCurves result;
+    const std::function<double(double)> shapes[kNumSaturationModels] = {
+        softClip,
+        [](double x) { return std::clamp(x, -1.0, 1.0); },
+        [](double x) { return softClip(x + kTubeBias) - softClip(kTubeBias); },
+    };
+    for (int model = 0; model < kNumSaturationModels; ++model)
+        result.curves[static_cast<std::size_t>(model)].tabulate(shapes[model], -kCurveLimit, kCurveLimit,
+                                                                kCurveSegments);
+    return result;
+}
+
+} // namespace
+
+void ShaperCurve::tabulate(const std::function<double(double)>& shape, double lower, double upper, int numSegments)
+{
+    const auto n = static_cast<std::size_t>(numSegments);
+    const double step = (upper - lower) / numSegments;
+
+    std::vector<double> value(n + 1);
+    for (std::size_t k = 0; k <= n; ++k)
+        value[k] = shape(lower + step * static_cast<double>(k));
+
+    // Per segment: the F1 cubic in t = (x - x_k) / step, matching f at both nodes and the
+    // integral of f in between. The end segments are flat by contract; their cubics are
+    // made exactly linear because the kernels extrapolate them.
+    std::vector<double> c1(n), c2(n), c3(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        const bool end = k == 0 || k + 1 == n;
+        const double flat = k == 0 ? value[0] : value[n];
+        const double f0 = end ? flat : value[k];
+        const double f1 = end ? flat : value[k + 1];
+        const double area = end ? flat * step : integrate(shape, lower + step * static_cast<double>(k), step);
+        c1[k] = step * f0;
+        c2[k] = end ? 0.0 : 3.0 * area - step * (2.0 * f0 + f1);
+        c3[k] = end ? 0.0 : step * (f0 + f1) - 2.0 * area;
+    }
+
+    // Node values of F1 and of F2, the exact integral of the cubics.
+    std::vector<double> first(n + 1, 0.0), second(n + 1, 0.0);
+    for (std::size_t k = 0; k < n; ++k) {
+        first[k + 1] = first[k] + c1[k] + c2[k] + c3[k];
+        second[k + 1] = second[k] + step * (first[k] + c1[k] / 2.0 + c2[k] / 3.0 + c3[k] / 4.0);
+    }
+    const auto anchor = static_cast<std::size_t>(std::clamp(std::lround(-lower / step), 0L, static_cast<long>(n)));
+    // F2 shifts by a linear term when F1 moves by a constant.
+    const double firstAtAnchor = first[anchor];
+    const double secondAtAnchor = second[anchor];
+    for (std::size_t k = 0; k <= n; ++k) {
+        const double offset = static_cast<double>(k) - static_cast<double>(anchor);
+        first[k] -= firstAtAnchor;
+        second[k] -= secondAtAnchor + firstAtAnchor * step * offset;
+    }
+
+    maxSlope_ = 0.0f;
+    for (std::size_t k = 0; k < n; ++k)
+        maxSlope_ = std::max(maxSlope_, static_cast<float>(std::abs(value[k + 1] - value[k]) / step));
+
+    rows_.allocate((n + 1) * simd::kShaperRowSize);
+    for (std::size_t k = 0; k <= n; ++k) {
+        float* row = rows_.data() + k * simd::kShaperRowSize;
+        row[0] = static_cast<float>(first[k]);
+        row[4] = static_cast<float>(second[k]);
+        row[5] = static_cast<float>(first[k] - row[0]);
+        row[6] = static_cast<float>(second[k] - row[4]);
+        if (k < n) {
+            row[1] = static_cast<float>(c1[k]);
+            row[2] = static_cast<float>(c2[k]);
+            row[3] = static_cast<float>(c3[k]);
+        }
+    }
+
+    table_.rows = rows_.data();
+    table_.lower = static_cast<float>(lower);
+    table_.step = static_cast<float>(step);
+    table_.invStep = static_cast<float>(1.0 / step);
+    table_.numSegments = numSegments;
+}
+
+std::shared_ptr<const SaturationCurves> acquireSaturationCurves()
+{
+    return SharedTable<SaturationCurves>::acquire(&buildSaturationCurves);
+}
+
+std::shared_ptr<const ShaperCurve> shaperCurveAsset(const AssetEntry& asset)
+{
+    const int numNodes = asset.numFrames;
+    if (asset.kind != AssetKind::ShaperCurve || numNodes < 2 || !(asset.lower < asset.upper) ||
+        !std::isfinite(asset.upper - asset.lower))
+        return nullptr;
+    const float* nodes = asset.channel(0);
+    for (int k = 0; k < numNodes; ++k)
+        if (!std::isfinite(nodes[k]))
+            return nullptr;
+
+    const double lower = asset.lower;
+    const double step = (static_cast<double>(asset.upper) - lower) / (numNodes - 1);
+    const auto linear = [=](double x) {
+        const double u = std::clamp((x - lower) / step, 0.0, static_cast<double>(numNodes - 1));
+        const int k = std::min(static_cast<int>(u), numNodes - 2);
+        return nodes[k] + (u - k) * (static_cast<double>(nodes[k + 1]) - nodes[k]);
+    };
+    const double atZero = linear(0.0);
+
+    // As fine as the built-in tables (within a size cap), since ADAA treats close inputs as
+    // sharing a segment; every asset node stays a table node, so each corner falls on one.
+    // One flat segment beyond each end.
+    constexpr double kBuiltInStep = 2.0 * kCurveLimit / kCurveSegments;
+    constexpr int kMaxAssetSegments = 1 << 16;
+    const int mostPerNode = std::max(1, kMaxAssetSegments / (numNodes - 1));
+    const double wanted = std::ceil(step / kBuiltInStep - 1e-9);
+    const int perNode = static_cast<int>(std::clamp(wanted, 1.0, static_cast<double>(mostPerNode)));
+    const double tableStep = step / perNode;
+    auto curve = std::make_shared<ShaperCurve>();
+    curve->tabulate([&](double x) { return linear(x) - atZero; }, lower - tableStep, asset.upper + tableStep,
+                    (numNodes - 1) * perNode + 2);
+    return curve;
+}
+
+} // namespace villain::dsp
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core/AlignedBuffer.h"
+#include "dsp/SaturationModel.h"
+#include "dsp/simd/Kernels.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+
+namespace villain {
+struct AssetEntry;
+}
+
+namespace villain::dsp {
+
+// A waveshaper tabulated for the antiderivative anti-aliasing kernels (simd::ShaperTable).
+class ShaperCurve {
+public:
+    // Non-realtime. Samples `shape` at numSegments + 1 nodes over [lower, upper] and
+    // integrates it twice. The shape must be flat over the first and last segment and beyond.
+    // Both antiderivatives are zero at the node nearest 0, so small signals around it see
+    // small values and keep their precision.
+    void tabulate(const std::function<double(double)>& shape, double lower, double upper, int numSegments);
+
+    const simd::ShaperTable& table() const noexcept { return table_; }
+    // Steepest slope between nodes. For a curve through the origin that is straight between
+    // nodes, as pack curves are, it bounds |f(x) / x|.
+    float maxSlope() const noexcept { return maxSlope_; }
+
+private:
+    AlignedBuffer<float> rows_;
+    simd::ShaperTable table_;
+    float maxSlope_ = 0.0f;
+};
+
+// The built-in saturation models as ShaperCurves, in double precision from the same
+// formulas as the saturate kernels.
+struct SaturationCurves {
+    std::array<ShaperCurve, kNumSaturationModels> curves;
+
+    const simd::ShaperTable& table(SaturationModel model) const noexcept
+    {
+        return curves[static_cast<std::size_t>(model)].table();
+    }
+};
+
+// Non-realtime. Tabulated once per process and shared by every instance.
+std::shared_ptr<const SaturationCurves> acquireSaturationCurves();
+
+// Non-realtime. The transfer curve of an AssetKind::ShaperCurve asset: its nodes joined by
+// straight lines, held flat beyond the ends and shifted so that f(0) = 0 and silence stays
+// silent. Null if the asset is not a usable curve (fewer than two nodes, an empty or
+// inverted range, or a value that is not finite).
+std::shared_ptr<const ShaperCurve> shaperCurveAsset(const AssetEntry& asset);
+
+} // namespace villain::dsp
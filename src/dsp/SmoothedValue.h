@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+
+namespace villain::dsp {
+
+// Linear ramp towards a target over a fixed time. Rather than stepping per sample, callers
+// pull whole segments (start value, per-sample step, length) and hand them to the vector
+// ramp kernels, so smoothing costs the same as a constant gain.
+class SmoothedValue {
+public:
+    struct Segment {
+        float start;
+        float step;
+        int length;
+    };
+
+    explicit SmoothedValue(float initial = 0.0f) noexcept : current_(initial), target_(initial) {}
+
+    void prepare(double sampleRate, double rampSeconds) noexcept
+    {
+        rampLength_ = std::max(1, static_cast<int>(sampleRate * rampSeconds));
+        snapToTarget();
+    }
+
+    void setTarget(float target) noexcept
+    {
+        if (target == target_)
+            return;
+        target_ = target;
+        remaining_ = rampLength_;
+        step_ = (target_ - current_) / static_cast<float>(rampLength_);
+    }
+
+    void snapToTarget() noexcept
+    {
+        current_ = target_;
+        remaining_ = 0;
+        step_ = 0.0f;
+    }
+
+    void setCurrentAndTarget(float value) noexcept
+    {
+        target_ = value;
+        snapToTarget();
+    }
+
+    bool isSmoothing() const noexcept { return remaining_ > 0; }
+    float current() const noexcept { return current_; }
+    float target() const noexcept { return target_; }
+
+    // The next run of at most maxSamples over which the value moves linearly (or holds, with
+    // step 0), advancing the smoother past it.
+    Segment next(int maxSamples) noexcept
+    {
+        if (remaining_ == 0)
+            return {current_, 0.0f, maxSamples};
+
+        const int length = std::min(maxSamples, remaining_);
+        const Segment segment{current_, step_, length};
+        remaining_ -= length;
+        current_ = remaining_ == 0 ? target_ : current_ + step_ * static_cast<float>(length);
+        return segment;
+    }
+
+    void skip(int numSamples) noexcept { next(numSamples); }
+
+private:
+    float current_ = 0.0f;
+    float target_ = 0.0f;
+    float step_ = 0.0f;
+    int remaining_ = 0;
+    int rampLength_ = 1;
+};
+
+} // namespace villain::dsp
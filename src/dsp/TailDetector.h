@@ -0,0 +1,66 @@
+#pragma once
+
+#include "core/AudioBlock.h"
+#include "dsp/simd/Kernels.h"
+
+#include <algorithm>
+
+namespace villain::dsp {
+
+// -120 dBFS: below this a signal is treated as silence.
+constexpr float kSilenceThreshold = 1.0e-6f;
+
+// Largest absolute sample across every channel of the block.
+inline float peakLevel(const AudioBlock& block) noexcept
+{
+    const auto peakAbs = simd::activeKernels().peakAbs;
+    float peak = 0.0f;
+    for (int ch = 0; ch < block.numChannels(); ++ch)
+        peak = std::max(peak, peakAbs(block.channel(ch), block.numSamples()));
+    return peak;
+}
+
+// Decides when a chain with recursive filters and delays has rung out. The caller reports
+// each processed run; once input and output have both stayed below the threshold for the
+// hold time (at least the chain's latency plus its filter decay) the detector goes idle, the
+// caller clears its state and stops computing, and any audible input wakes it again.
+class TailDetector {
+public:
+    void setHoldSamples(int samples) noexcept { holdSamples_ = std::max(samples, 0); }
+    int holdSamples() const noexcept { return holdSamples_; }
+
+    void reset() noexcept
+    {
+        quietSamples_ = 0;
+        idle_ = false;
+    }
+
+    bool isIdle() const noexcept { return idle_; }
+
+    void wake() noexcept
+    {
+        quietSamples_ = 0;
+        idle_ = false;
+    }
+
+    // Feeds one processed run. Returns true on the run that makes the detector go idle.
+    bool observe(bool inputSilent, float outputPeak, int numSamples) noexcept
+    {
+        if (!inputSilent || outputPeak >= kSilenceThreshold) {
+            quietSamples_ = 0;
+            return false;
+        }
+        quietSamples_ += numSamples;
+        if (quietSamples_ < holdSamples_)
+            return false;
+        idle_ = true;
+        return true;
+    }
+
+private:
+    int holdSamples_ = 0;
+    int quietSamples_ = 0;
+    bool idle_ = false;
+};
+
+} // namespace villain::dsp
@@ -0,0 +1,79 @@
+#include "dsp/simd/CpuFeatures.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace villain::simd {
+
+const char* toString(InstructionSet isa) noexcept
+{
+    switch (isa) {
+    case InstructionSet::Scalar: return "scalar";
+    case InstructionSet::SSE2: return "sse2";
+    case InstructionSet::AVX2: return "avx2";
+    case InstructionSet::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+#if defined(VILLAIN_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+
+InstructionSet detectInstructionSet() noexcept
+{
+    // libgcc/compiler-rt also check XCR0, so these are false when the OS does not save the
+    // wider register state.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return InstructionSet::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return InstructionSet::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return InstructionSet::SSE2;
+    return InstructionSet::Scalar;
+}
+
+#elif defined(VILLAIN_SIMD_X86) && defined(_MSC_VER)
+
+InstructionSet detectInstructionSet() noexcept
+{
+    int regs[4] = {};
+    __cpuid(regs, 0);
+    const int maxLeaf = regs[0];
+
+    __cpuid(regs, 1);
+    const bool sse2 = (regs[3] & (1 << 26)) != 0;
+    const bool fma = (regs[2] & (1 << 12)) != 0;
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    const bool ymmState = (xcr0 & 0x6) == 0x6;
+    const bool zmmState = (xcr0 & 0xe6) == 0xe6;
+
+    bool avx2 = false;
+    bool avx512f = false;
+    if (maxLeaf >= 7) {
+        __cpuidex(regs, 7, 0);
+        avx2 = (regs[1] & (1 << 5)) != 0;
+        avx512f = (regs[1] & (1 << 16)) != 0;
+    }
+
+    if (avx512f && zmmState)
+        return InstructionSet::AVX512;
+    if (avx2 && fma && ymmState)
+        return InstructionSet::AVX2;
+    if (sse2)
+        return InstructionSet::SSE2;
+    return InstructionSet::Scalar;
+}
+
+#else
+
+InstructionSet detectInstructionSet() noexcept
+{
+    return InstructionSet::Scalar;
+}
+
+#endif
+
+} // namespace villain::simd
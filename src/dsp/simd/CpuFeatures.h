@@ -0,0 +1,18 @@
+#pragma once
+
+namespace villain::simd {
+
+// Ordered from narrowest to widest; comparisons between values are meaningful.
+enum class InstructionSet {
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512,
+};
+
+const char* toString(InstructionSet isa) noexcept;
+
+// Widest instruction set both the CPU and the OS (saved register state) support.
+InstructionSet detectInstructionSet() noexcept;
+
+} // namespace villain::simd
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "dsp/simd/Kernels.h"
+
+// Per-instruction-set tables, each defined in a translation unit built with matching
+// compiler flags. Internal to the dispatcher.
+namespace villain::simd::detail {
+
+const KernelTable& scalarKernels() noexcept;
+
+#if defined(VILLAIN_SIMD_X86)
+const KernelTable& sse2Kernels() noexcept;
+const KernelTable& avx2Kernels() noexcept;
+const KernelTable& avx512Kernels() noexcept;
+#endif
+
+} // namespace villain::simd::detail
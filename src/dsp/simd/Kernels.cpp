@@ -0,0 +1,96 @@
+#include "dsp/simd/Kernels.h"
+
+#include "dsp/simd/KernelTables.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace villain::simd {
+
+namespace {
+
+InstructionSet requestedCeiling() noexcept
+{
+    const char* env = std::getenv("VILLAIN_ISA");
+    if (env == nullptr)
+        return InstructionSet::AVX512;
+    if (std::strcmp(env, "scalar") == 0)
+        return InstructionSet::Scalar;
+    if (std::strcmp(env, "sse2") == 0)
+        return InstructionSet::SSE2;
+    if (std::strcmp(env, "avx2") == 0)
+        return InstructionSet::AVX2;
+    return InstructionSet::AVX512;
+}
+
+const KernelTable* selectKernels() noexcept
+{
+    const InstructionSet detected = detectInstructionSet();
+    const InstructionSet ceiling = requestedCeiling();
+    InstructionSet isa = detected < ceiling ? detected : ceiling;
+
+    for (;;) {
+        if (const KernelTable* table = kernelsFor(isa))
+            return table;
+        isa = static_cast<InstructionSet>(static_cast<int>(isa) - 1);
+    }
+}
+
+// Resolved during static initialisation so the audio thread only ever reads a pointer.
+const KernelTable* const gActiveKernels = selectKernels();
+
+} // namespace
+
+void BiquadKernelCoefficients::compute(float nb0, float nb1, float nb2, float na1, float na2) noexcept
+{
+    b0 = nb0;
+    b1 = nb1;
+    b2 = nb2;
+    a1 = na1;
+    a2 = na2;
+
+    // Runs the recursion in double precision from each unit initial condition.
+    auto simulate = [&](double x0, double z1, double z2, float* out) {
+        for (int k = 0; k < kMaxSimdWidth; ++k) {
+            const double x = k == 0 ? x0 : 0.0;
+            const double y = nb0 * x + z1;
+            z1 = nb1 * x - na1 * y + z2;
+            z2 = nb2 * x - na2 * y;
+            out[k] = static_cast<float>(y);
+        }
+    };
+
+    float h[kMaxSimdWidth];
+    simulate(1.0, 0.0, 0.0, h);
+    simulate(0.0, 1.0, 0.0, fromZ1);
+    simulate(0.0, 0.0, 1.0, fromZ2);
+
+    for (int j = 0; j < kMaxSimdWidth; ++j)
+        for (int k = 0; k < kMaxSimdWidth; ++k)
+            impulse[j][k] = k >= j ? h[k - j] : 0.0f;
+}
+
+const KernelTable& activeKernels() noexcept
+{
+    return gActiveKernels != nullptr ? *gActiveKernels : detail::scalarKernels();
+}
+
+const KernelTable* kernelsFor(InstructionSet isa) noexcept
+{
+    if (isa > detectInstructionSet())
+        return nullptr;
+
+    switch (isa) {
+    case InstructionSet::Scalar: return &detail::scalarKernels();
+#if defined(VILLAIN_SIMD_X86)
+    case InstructionSet::SSE2: return &detail::sse2Kernels();
+    case InstructionSet::AVX2: return &detail::avx2Kernels();
+    case InstructionSet::AVX512: return &detail::avx512Kernels();
+#else
+    default: break;
+#endif
+    }
+    return nullptr;
+}
+
+} // namespace villain::simd
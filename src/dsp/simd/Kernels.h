@@ -0,0 +1,131 @@
+#pragma once
+
+#include "dsp/SaturationModel.h"
+#include "dsp/simd/CpuFeatures.h"
+
+namespace villain::simd {
+
+// Widest vector we ever process, in floats (AVX-512).
+constexpr int kMaxSimdWidth = 16;
+
+// A biquad unrolled over kMaxSimdWidth samples, so a whole vector of outputs is a sum of
+// broadcast inputs and the two carried states. Narrower instruction sets use a prefix of
+// every row.
+struct BiquadKernelCoefficients {
+    // impulse[j][k]: output at sample k for a unit input at sample j.
+    alignas(64) float impulse[kMaxSimdWidth][kMaxSimdWidth];
+    // Output at sample k for a unit z1 / z2 at the start of the vector.
+    alignas(64) float fromZ1[kMaxSimdWidth];
+    alignas(64) float fromZ2[kMaxSimdWidth];
+    float b0, b1, b2, a1, a2;
+
+    void compute(float b0, float b1, float b2, float a1, float a2) noexcept;
+};
+
+// Band-split lanes: a frame holds one sample of every band, so per-band work runs across a
+// whole frame in a single vector op. Eight lanes fill one AVX register and cover six bands.
+constexpr int kCrossoverLanes = 8;
+constexpr int kMaxCrossoverSections = 10;
+
+// Structure-of-arrays biquad cascade, [section][lane]. Every lane runs its own chain of
+// numSections sections on the same input; unused sections are identities.
+struct CrossoverKernelCoefficients {
+    alignas(32) float b0[kMaxCrossoverSections][kCrossoverLanes];
+    alignas(32) float b1[kMaxCrossoverSections][kCrossoverLanes];
+    alignas(32) float b2[kMaxCrossoverSections][kCrossoverLanes];
+    alignas(32) float a1[kMaxCrossoverSections][kCrossoverLanes];
+    alignas(32) float a2[kMaxCrossoverSections][kCrossoverLanes];
+    int numSections = 0;
+};
+
+// Floats of state one channel of crossoverSplit carries between calls.
+constexpr int kCrossoverStateSize = 2 * kMaxCrossoverSections * kCrossoverLanes;
+
+// Static gain curve of a compressor, in dB. Above the threshold the output level rises by
+// 1 + slope dB per input dB: slope 0 leaves the level alone, -1 holds it at the threshold.
+// The corner is rounded quadratically over kneeDb, centred on the threshold.
+struct GainCurve {
+    float thresholdDb = 0.0f;
+    float slope = 0.0f;
+    float kneeDb = 0.0f;
+};
+
+// A shaper f tabulated for antiderivative anti-aliasing, in rows of kShaperRowSize floats.
+// Row k belongs to the segment from node x_k = lower + k * step. With t = (x - x_k) / step,
+// the first antiderivative there is the cubic F1 = r[0] + r[1] t + r[2] t^2 + r[3] t^3, whose
+// derivative interpolates f, and the second is its exact integral, F2(x_k) = r[4]. r[5] and
+// r[6] carry the rounding error of r[0] and r[4]. f must be constant over the first and last
+// segments: their rows are used beyond the ends.
+constexpr int kShaperRowSize = 8;
+
+struct ShaperTable {
+    const float* rows = nullptr; // numSegments + 1 rows; the last carries node values only
+    float lower = 0.0f;
+    float step = 1.0f;
+    float invStep = 1.0f;
+    int numSegments = 0;
+};
+
+// Highest antiderivative order the kernels implement.
+constexpr int kMaxAntialiasingOrder = 2;
+
+// One set of DSP inner loops compiled for a particular instruction set. All kernels work in
+// place on a single channel and accept any length and alignment.
+struct KernelTable {
+    InstructionSet isa;
+
+    void (*applyGain)(float* data, int numSamples, float gain) noexcept;
+    // data[i] *= start + step * i
+    void (*applyGainRamp)(float* data, int numSamples, float start, float step) noexcept;
+    // wet[i] = dry[i] + (start + step * i) * (wet[i] - dry[i])
+    void (*mixDryWet)(float* wet, const float* dry, int numSamples, float start, float step) noexcept;
+    void (*saturate[dsp::kNumSaturationModels])(float* data, int numSamples) noexcept;
+    // Shaping with antiderivative anti-aliasing of order 1 or 2 (entry order - 1). data holds
+    // numFrames frames of numLanes interleaved signals (1 or kCrossoverLanes); history holds
+    // the previous order frames, oldest first, and is carried to the next call.
+    void (*saturateAntialiased[kMaxAntialiasingOrder])(float* data, int numFrames, int numLanes,
+                                                       const ShaperTable& table, float* history) noexcept;
+    // The tabulated shaper itself, without anti-aliasing: data[i] = f(data[i]), the slope of
+    // the table's first antiderivative.
+    void (*shapeTabulated)(float* data, int numSamples, const ShaperTable& table) noexcept;
+    float (*peakAbs)(const float* data, int numSamples) noexcept;
+    // peak[i] = max(peak[i], |data[i]|)
+    void (*maxAbs)(float* peak, const float* data, int numSamples) noexcept;
+    // data[i] *= gain[i]
+    void (*applyGainCurve)(float* data, const float* gain, int numSamples) noexcept;
+    // Linear level in, linear gain out: data[i] = curve(data[i]) / data[i].
+    void (*gainComputer)(float* data, int numSamples, const GainCurve& curve) noexcept;
+    // data[i] = 10^(data[i] / 20), for data within +/-700 dB.
+    void (*decibelsToGain)(float* data, int numSamples) noexcept;
+    float (*dotProduct)(const float* a, const float* b, int numSamples) noexcept;
+    // out[i] = sum_j taps[j] * history[i + j]; history holds numOutputs + numTaps - 1 samples.
+    void (*convolve)(const float* history, const float* taps, int numTaps, float* out, int numOutputs) noexcept;
+    // One radix-2 stage of a split-complex FFT over numPoints values: every group of 2 * span
+    // combines a = a + w b, b = a - w b, with twiddles w[j] = (twRe, twIm)[span + j].
+    void (*fftStage)(float* re, float* im, const float* twRe, const float* twIm, int numPoints, int span) noexcept;
+    // Split complex spectra: acc[i] += a[i] * b[i]
+    void (*complexMultiplyAdd)(float* accRe, float* accIm, const float* aRe, const float* aIm, const float* bRe,
+                               const float* bIm, int numBins) noexcept;
+    // Transposed direct form II; z1/z2 are read and written back.
+    void (*biquad)(float* data, int numSamples, const BiquadKernelCoefficients& coefficients, float& z1,
+                   float& z2) noexcept;
+
+    // Lane kernels work on frames of kCrossoverLanes floats.
+    // lanes[i][l] = cascade_l(in)[i]; state holds kCrossoverStateSize floats.
+    void (*crossoverSplit)(const float* in, float* lanes, int numFrames, const CrossoverKernelCoefficients& coefficients,
+                           float* state) noexcept;
+    // lanes[i][l] *= start[l] + step[l] * i
+    void (*laneGainRamp)(float* lanes, int numFrames, const float* start, const float* step) noexcept;
+    // out[i] = sum_l lanes[i][l]
+    void (*mergeLanes)(const float* lanes, float* out, int numFrames) noexcept;
+};
+
+// Kernels chosen once, at library load, for the widest instruction set the machine supports.
+// The VILLAIN_ISA environment variable (scalar, sse2, avx2, avx512) can lower the choice.
+const KernelTable& activeKernels() noexcept;
+
+// The table for a specific instruction set, or nullptr if this build or this CPU cannot run
+// it. Used by tests and benchmarks to compare paths.
+const KernelTable* kernelsFor(InstructionSet isa) noexcept;
+
+} // namespace villain::simd
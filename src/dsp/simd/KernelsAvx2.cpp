@@ -0,0 +1,73 @@
+#include "dsp/simd/KernelTables.h"
+
+#include <immintrin.h>
+
+namespace villain::simd {
+
+namespace {
+
+struct Vec {
+    static constexpr int width = 8;
+    __m256 v;
+
+    static Vec load(const float* p) noexcept { return {_mm256_loadu_ps(p)}; }
+    static Vec broadcast(float x) noexcept { return {_mm256_set1_ps(x)}; }
+    void store(float* p) const noexcept { _mm256_storeu_ps(p, v); }
+
+    friend Vec operator+(Vec a, Vec b) noexcept { return {_mm256_add_ps(a.v, b.v)}; }
+    friend Vec operator-(Vec a, Vec b) noexcept { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend Vec operator*(Vec a, Vec b) noexcept { return {_mm256_mul_ps(a.v, b.v)}; }
+    friend Vec operator/(Vec a, Vec b) noexcept { return {_mm256_div_ps(a.v, b.v)}; }
+    static Vec mulAdd(Vec a, Vec b, Vec c) noexcept { return {_mm256_fmadd_ps(a.v, b.v, c.v)}; }
+    static Vec min(Vec a, Vec b) noexcept { return {_mm256_min_ps(a.v, b.v)}; }
+    static Vec max(Vec a, Vec b) noexcept { return {_mm256_max_ps(a.v, b.v)}; }
+    static float reduceAdd(Vec a) noexcept
+    {
+        const __m128 quad = _mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+        const __m128 pairs = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 0x55)));
+    }
+    static float reduceMax(Vec a) noexcept
+    {
+        const __m128 quad = _mm_max_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+        const __m128 pairs = _mm_max_ps(quad, _mm_movehl_ps(quad, quad));
+        return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, 0x55)));
+    }
+    static Vec mantissa(Vec a) noexcept
+    {
+        const __m256i bits = _mm256_and_si256(_mm256_castps_si256(a.v), _mm256_set1_epi32(0x007fffff));
+        return {_mm256_castsi256_ps(_mm256_or_si256(bits, _mm256_set1_epi32(0x3f800000)))};
+    }
+    static Vec exponent(Vec a) noexcept
+    {
+        const __m256i biased = _mm256_srli_epi32(_mm256_castps_si256(a.v), 23);
+        return {_mm256_cvtepi32_ps(_mm256_sub_epi32(biased, _mm256_set1_epi32(127)))};
+    }
+    static Vec scale(Vec a, Vec e) noexcept
+    {
+        const __m256i bits =
+            _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(e.v), _mm256_set1_epi32(127)), 23);
+        return {_mm256_mul_ps(a.v, _mm256_castsi256_ps(bits))};
+    }
+    static Vec truncate(Vec a) noexcept { return {_mm256_round_ps(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)}; }
+    static Vec gather(const float* base, Vec index) noexcept
+    {
+        return {_mm256_i32gather_ps(base, _mm256_cvttps_epi32(index.v), 4)};
+    }
+    static Vec selectLess(Vec a, Vec b, Vec x, Vec y) noexcept
+    {
+        return {_mm256_blendv_ps(y.v, x.v, _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ))};
+    }
+};
+
+#include "dsp/simd/KernelsImpl.inl"
+
+} // namespace
+
+const KernelTable& detail::avx2Kernels() noexcept
+{
+    static const KernelTable table = makeKernelTable<Vec>(InstructionSet::AVX2);
+    return table;
+}
+
+} // namespace villain::simd
@@ -0,0 +1,59 @@
+#include "dsp/simd/KernelTables.h"
+
+#include <immintrin.h>
+
+namespace villain::simd {
+
+namespace {
+
+struct Vec {
+    static constexpr int width = 16;
+    __m512 v;
+
+    static Vec load(const float* p) noexcept { return {_mm512_loadu_ps(p)}; }
+    static Vec broadcast(float x) noexcept { return {_mm512_set1_ps(x)}; }
+    void store(float* p) const noexcept { _mm512_storeu_ps(p, v); }
+
+    friend Vec operator+(Vec a, Vec b) noexcept { return {_mm512_add_ps(a.v, b.v)}; }
+    friend Vec operator-(Vec a, Vec b) noexcept { return {_mm512_sub_ps(a.v, b.v)}; }
+    friend Vec operator*(Vec a, Vec b) noexcept { return {_mm512_mul_ps(a.v, b.v)}; }
+    friend Vec operator/(Vec a, Vec b) noexcept { return {_mm512_div_ps(a.v, b.v)}; }
+    static Vec mulAdd(Vec a, Vec b, Vec c) noexcept { return {_mm512_fmadd_ps(a.v, b.v, c.v)}; }
+    static Vec min(Vec a, Vec b) noexcept { return {_mm512_min_ps(a.v, b.v)}; }
+    static Vec max(Vec a, Vec b) noexcept { return {_mm512_max_ps(a.v, b.v)}; }
+    static float reduceAdd(Vec a) noexcept { return _mm512_reduce_add_ps(a.v); }
+    static float reduceMax(Vec a) noexcept { return _mm512_reduce_max_ps(a.v); }
+    static Vec mantissa(Vec a) noexcept { return {_mm512_getmant_ps(a.v, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero)}; }
+    static Vec exponent(Vec a) noexcept { return {_mm512_getexp_ps(a.v)}; }
+    static Vec scale(Vec a, Vec e) noexcept { return {_mm512_scalef_ps(a.v, e.v)}; }
+    static Vec truncate(Vec a) noexcept { return {_mm512_roundscale_ps(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)}; }
+    static Vec gather(const float* base, Vec index) noexcept
+    {
+        return {_mm512_i32gather_ps(_mm512_cvttps_epi32(index.v), base, 4)};
+    }
+    static Vec selectLess(Vec a, Vec b, Vec x, Vec y) noexcept
+    {
+        return {_mm512_mask_blend_ps(_mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ), y.v, x.v)};
+    }
+};
+
+#include "dsp/simd/KernelsImpl.inl"
+
+} // namespace
+
+const KernelTable& detail::avx512Kernels() noexcept
+{
+    static const KernelTable table = [] {
+        // A band frame is eight floats, half a 512-bit register; the AVX2 lane kernels
+        // already fill it.
+        KernelTable t = makeKernelTable<Vec>(InstructionSet::AVX512);
+        const KernelTable& avx2 = avx2Kernels();
+        t.crossoverSplit = avx2.crossoverSplit;
+        t.laneGainRamp = avx2.laneGainRamp;
+        t.mergeLanes = avx2.mergeLanes;
+        return t;
+    }();
+    return table;
+}
+
+} // namespace villain::simd
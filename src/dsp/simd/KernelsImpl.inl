@@ -0,0 +1,699 @@
+// Instruction-set-generic kernel bodies. Included exactly once per kernel translation unit,
+// inside an anonymous namespace, after that unit has defined `Vec` (its vector type). Every
+// symbol here therefore has internal linkage and is compiled only with that unit's flags;
+// do not call out to inline functions from other headers, and do not include anything.
+//
+// Vec must provide: static constexpr int width; load/store (unaligned); broadcast; + - * /;
+// mulAdd(a, b, c) = a * b + c; min; max; reduceAdd / reduceMax (horizontal sum / max);
+// mantissa / exponent (x = mantissa * 2^exponent, mantissa in [1, 2), for positive normal x)
+// and scale(x, e) = x * 2^e for integral e in the normal range. All three are exact.
+// truncate rounds toward zero; gather(base, index) reads base[index] per lane for integral,
+// non-negative index; selectLess(a, b, x, y) = a < b ? x : y per lane.
+
+// Single-lane fallback with the same interface, used for loop tails so the vector body and
+// the tail evaluate the same expressions.
+struct Lane {
+    static constexpr int width = 1;
+    float v;
+
+    static Lane load(const float* p) noexcept { return {*p}; }
+    static Lane broadcast(float x) noexcept { return {x}; }
+    void store(float* p) const noexcept { *p = v; }
+
+    friend Lane operator+(Lane a, Lane b) noexcept { return {a.v + b.v}; }
+    friend Lane operator-(Lane a, Lane b) noexcept { return {a.v - b.v}; }
+    friend Lane operator*(Lane a, Lane b) noexcept { return {a.v * b.v}; }
+    friend Lane operator/(Lane a, Lane b) noexcept { return {a.v / b.v}; }
+    static Lane mulAdd(Lane a, Lane b, Lane c) noexcept { return {a.v * b.v + c.v}; }
+    static Lane min(Lane a, Lane b) noexcept { return {b.v < a.v ? b.v : a.v}; }
+    static Lane max(Lane a, Lane b) noexcept { return {a.v < b.v ? b.v : a.v}; }
+    static float reduceAdd(Lane a) noexcept { return a.v; }
+    static float reduceMax(Lane a) noexcept { return a.v; }
+    static Lane mantissa(Lane a) noexcept
+    {
+        const auto bits = __builtin_bit_cast(unsigned, a.v);
+        return {__builtin_bit_cast(float, (bits & 0x007fffffu) | 0x3f800000u)};
+    }
+    static Lane exponent(Lane a) noexcept
+    {
+        const auto bits = __builtin_bit_cast(unsigned, a.v);
+        return {static_cast<float>(static_cast<int>(bits >> 23) - 127)};
+    }
+    static Lane scale(Lane a, Lane e) noexcept
+    {
+        const auto bits = static_cast<unsigned>(static_cast<int>(e.v) + 127) << 23;
+        return {a.v * __builtin_bit_cast(float, bits)};
+    }
+    static Lane truncate(Lane a) noexcept { return {static_cast<float>(static_cast<int>(a.v))}; }
+    static Lane gather(const float* base, Lane index) noexcept { return {base[static_cast<int>(index.v)]}; }
+    static Lane selectLess(Lane a, Lane b, Lane x, Lane y) noexcept { return a.v < b.v ? x : y; }
+};
+
+alignas(64) constexpr float kIota[kMaxSimdWidth] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+constexpr float kTubeBias = 0.3f;
+
+constexpr float softClipConstant(float x) noexcept
+{
+    return x * (27.0f + x * x) / (27.0f + 9.0f * x * x);
+}
+
+// Rational tanh approximation that reaches +/-1 with zero slope at |x| = 3.
+template <class V>
+inline V softClip(V x) noexcept
+{
+    const V c = V::min(V::max(x, V::broadcast(-3.0f)), V::broadcast(3.0f));
+    const V c2 = c * c;
+    return c * (V::broadcast(27.0f) + c2) / V::mulAdd(V::broadcast(9.0f), c2, V::broadcast(27.0f));
+}
+
+// log2 for positive x: exact exponent plus a 2*atanh series on the mantissa (|error| < 2e-6).
+template <class V>
+inline V log2Positive(V x) noexcept
+{
+    const V m = V::mantissa(x);
+    const V s = (m - V::broadcast(1.0f)) / (m + V::broadcast(1.0f));
+    const V s2 = s * s;
+    V p = V::mulAdd(s2, V::broadcast(2.0f / 9.0f), V::broadcast(2.0f / 7.0f));
+    p = V::mulAdd(p, s2, V::broadcast(2.0f / 5.0f));
+    p = V::mulAdd(p, s2, V::broadcast(2.0f / 3.0f));
+    p = V::mulAdd(p, s2, V::broadcast(2.0f));
+    return V::mulAdd(p * s, V::broadcast(1.44269504f), V::exponent(x));
+}
+
+// 2^x for x in [-126, 127]: nearest integer split off exactly, Taylor series on the rest
+// (|relative error| < 3e-6).
+template <class V>
+inline V exp2Bounded(V x) noexcept
+{
+    // Adding and removing 1.5 * 2^23 rounds to the nearest integer.
+    const V n = (x + V::broadcast(12582912.0f)) - V::broadcast(12582912.0f);
+    const V f = (x - n) * V::broadcast(0.693147181f);
+    V p = V::mulAdd(f, V::broadcast(1.0f / 120.0f), V::broadcast(1.0f / 24.0f));
+    p = V::mulAdd(p, f, V::broadcast(1.0f / 6.0f));
+    p = V::mulAdd(p, f, V::broadcast(0.5f));
+    p = V::mulAdd(p, f, V::broadcast(1.0f));
+    p = V::mulAdd(p, f, V::broadcast(1.0f));
+    return V::scale(p, n);
+}
+
+template <class V>
+inline V hardClip(V x) noexcept
+{
+    return V::min(V::max(x, V::broadcast(-1.0f)), V::broadcast(1.0f));
+}
+
+// Biased soft clip: asymmetric transfer for even harmonics, shifted so silence stays silent.
+template <class V>
+inline V tube(V x) noexcept
+{
+    return softClip(x + V::broadcast(kTubeBias)) - V::broadcast(softClipConstant(kTubeBias));
+}
+
+template <class V>
+void saturateSoftClipKernel(float* data, int numSamples) noexcept
+{
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width)
+        softClip(V::load(data + i)).store(data + i);
+    for (; i < numSamples; ++i)
+        softClip(Lane::load(data + i)).store(data + i);
+}
+
+template <class V>
+void saturateHardClipKernel(float* data, int numSamples) noexcept
+{
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width)
+        hardClip(V::load(data + i)).store(data + i);
+    for (; i < numSamples; ++i)
+        hardClip(Lane::load(data + i)).store(data + i);
+}
+
+template <class V>
+void saturateTubeKernel(float* data, int numSamples) noexcept
+{
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width)
+        tube(V::load(data + i)).store(data + i);
+    for (; i < numSamples; ++i)
+        tube(Lane::load(data + i)).store(data + i);
+}
+
+// Antiderivative anti-aliasing over a ShaperTable. Inputs on one segment use closed forms
+// of the polynomials' divided differences, which never divide by the distance between the
+// inputs; only inputs on different segments divide differences of antiderivative values.
+// Those are taken from node to node, with node values split into two floats, so nearby
+// inputs lose little to the size of the values themselves.
+
+template <class V>
+struct ShaperPoint {
+    V segment;
+    V row; // index of the segment's row in ShaperTable::rows
+    V t;   // position from the segment's first node, in steps
+};
+
+template <class V>
+inline ShaperPoint<V> locateShaper(V x, const ShaperTable& table) noexcept
+{
+    const V last = V::broadcast(static_cast<float>(table.numSegments - 1));
+    const V u = (x - V::broadcast(table.lower)) * V::broadcast(table.invStep);
+    const V segment = V::truncate(V::min(V::max(u, V::broadcast(0.0f)), last));
+    // Measured from the node rather than from `lower`, so small inputs near a node at zero
+    // keep their precision.
+    const V node = V::mulAdd(segment, V::broadcast(table.step), V::broadcast(table.lower));
+    return {segment, segment * V::broadcast(static_cast<float>(kShaperRowSize)),
+            (x - node) * V::broadcast(table.invStep)};
+}
+
+template <class V>
+inline V shaperColumn(const ShaperTable& table, V row, int column) noexcept
+{
+    return V::gather(table.rows + column, row);
+}
+
+// f(x) = F1'(x) = (c1 + 2 c2 t + 3 c3 t^2) / step; the end segments' rows are flat beyond.
+template <class V>
+inline V shaperValue(V x, const ShaperTable& table) noexcept
+{
+    const ShaperPoint<V> p = locateShaper(x, table);
+    const V c2 = shaperColumn(table, p.row, 2) * V::broadcast(2.0f);
+    const V c3 = shaperColumn(table, p.row, 3) * V::broadcast(3.0f);
+    return V::mulAdd(p.t, V::mulAdd(p.t, c3, c2), shaperColumn(table, p.row, 1)) * V::broadcast(table.invStep);
+}
+
+template <class V>
+void shapeTabulatedKernel(float* data, int numSamples, const ShaperTable& table) noexcept
+{
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width)
+        shaperValue(V::load(data + i), table).store(data + i);
+    for (; i < numSamples; ++i)
+        shaperValue(Lane::load(data + i), table).store(data + i);
+}
+
+// (F(a) - F(b)) / (a - b) for the first (Level 1) or second (Level 2) antiderivative.
+template <class V, int Level>
+inline V antiderivativeSlope(V a, V b, const ShaperTable& table) noexcept
+{
+    const V one = V::broadcast(1.0f);
+    const V lowX = V::min(a, b);
+    const V highX = V::max(a, b);
+    const ShaperPoint<V> low = locateShaper(lowX, table);
+    const ShaperPoint<V> high = locateShaper(highX, table);
+    const V tl = low.t;
+    const V th = high.t;
+
+    const V hc1 = shaperColumn(table, high.row, 1);
+    const V hc2 = shaperColumn(table, high.row, 2);
+    const V hc3 = shaperColumn(table, high.row, 3);
+    const V lc1 = shaperColumn(table, low.row, 1);
+    const V lc2 = shaperColumn(table, low.row, 2);
+    const V lc3 = shaperColumn(table, low.row, 3);
+    const V nextRow = low.row + V::broadcast(static_cast<float>(kShaperRowSize));
+
+    V within;
+    V rise; // from the high segment's first node up to highX
+    V fall; // from lowX up to the end of the low segment
+    V between;
+    if constexpr (Level == 1) {
+        const V sum = th + tl;
+        within = V::mulAdd(hc3, V::mulAdd(th, th, tl * sum), V::mulAdd(hc2, sum, hc1)) * V::broadcast(table.invStep);
+        rise = th * V::mulAdd(th, V::mulAdd(th, hc3, hc2), hc1);
+        fall = (one - tl) * V::mulAdd(lc3, V::mulAdd(tl, tl, tl + one), V::mulAdd(lc2, tl + one, lc1));
+        between = (shaperColumn(table, high.row, 0) - shaperColumn(table, nextRow, 0)) +
+                  (shaperColumn(table, high.row, 5) - shaperColumn(table, nextRow, 5));
+    } else {
+        // F2 on a segment is the integral of the F1 cubic, a quartic with coefficients
+        // step * (F1(x_k), c1 / 2, c2 / 3, c3 / 4).
+        const V half = V::broadcast(0.5f);
+        const V third = V::broadcast(1.0f / 3.0f);
+        const V quarter = V::broadcast(0.25f);
+        const V step = V::broadcast(table.step);
+        const V hn = shaperColumn(table, high.row, 0);
+        const V ln = shaperColumn(table, low.row, 0);
+        const V sum = th + tl;
+        const V squares = V::mulAdd(th, th, tl * tl);
+        within = V::mulAdd(hc3 * quarter, sum * squares, V::mulAdd(hc2 * third, squares + th * tl, V::mulAdd(hc1 * half, sum, hn)));
+        rise = step * th *
+               V::mulAdd(th, V::mulAdd(th, V::mulAdd(th, hc3 * quarter, hc2 * third), hc1 * half), hn);
+        const V tp = tl + one;
+        fall = step * (one - tl) *
+               V::mulAdd(lc3 * quarter, tp * V::mulAdd(tl, tl, one),
+                         V::mulAdd(lc2 * third, V::mulAdd(tl, tl, tp), V::mulAdd(lc1 * half, tp, ln)));
+        between = (shaperColumn(table, high.row, 4) - shaperColumn(table, nextRow, 4)) +
+                  (shaperColumn(table, high.row, 6) - shaperColumn(table, nextRow, 6));
+    }
+    const V across = (rise + between + fall) / (highX - lowX);
+    return V::selectLess(high.segment - low.segment, V::broadcast(0.5f), within, across);
+}
+
+template <class V>
+inline V absolute(V x) noexcept
+{
+    return V::max(x, V::broadcast(0.0f) - x);
+}
+
+// Second-order output for inputs x0 (newest) .. x2, given the first-order slopes of F2
+// between x0, x1 and x1, x2.
+template <class V>
+inline V antialiasSecondOrder(V x0, V x1, V x2, V slope01, V slope12, const ShaperTable& table) noexcept
+{
+    const V two = V::broadcast(2.0f);
+    const V third = V::broadcast(1.0f / 3.0f);
+    const V ends = x0 - x2;
+    const V mean = (x0 + x2) * V::broadcast(0.5f);
+    const V delta = mean - x1;
+
+    // Ends apart: the second divided difference of F2.
+    const V apart = two * (slope01 - slope12) / ends;
+
+    // Ends together, middle away (a turning point): its limit as x0 -> x2.
+    const ShaperPoint<V> m = locateShaper(mean, table);
+    const V firstAtMean = V::mulAdd(
+        m.t,
+        V::mulAdd(m.t, V::mulAdd(m.t, shaperColumn(table, m.row, 3), shaperColumn(table, m.row, 2)),
+                  shaperColumn(table, m.row, 1)),
+        shaperColumn(table, m.row, 0));
+    const V turning = two * (firstAtMean - antiderivativeSlope<V, 2>(mean, x1, table)) / delta;
+
+    // All close together, or all on one segment: the closed form on the centroid's segment.
+    const ShaperPoint<V> c = locateShaper((x0 + x1 + x2) * third, table);
+    const V node = V::mulAdd(c.segment, V::broadcast(table.step), V::broadcast(table.lower));
+    const V invStep = V::broadcast(table.invStep);
+    const V t0 = (x0 - node) * invStep;
+    const V t1 = (x1 - node) * invStep;
+    const V t2 = (x2 - node) * invStep;
+    const V sum = t0 + t1 + t2;
+    const V pairs = V::mulAdd(t0, t1, V::mulAdd(t0, t2, t1 * t2));
+    const V quadratic = V::mulAdd(sum, sum, V::broadcast(0.0f) - pairs); // t0^2 + t1^2 + t2^2 + pairs
+    const V closed = two * invStep *
+                     V::mulAdd(shaperColumn(table, c.row, 3) * V::broadcast(0.25f), quadratic,
+                               V::mulAdd(shaperColumn(table, c.row, 2) * third, sum,
+                                         shaperColumn(table, c.row, 1) * V::broadcast(0.5f)));
+
+    const V step = V::broadcast(table.step);
+    const V spread = absolute(ends);
+    const V far = V::selectLess(spread, step * V::broadcast(0.5f), turning, apart);
+    // Below 1 when every input is within half a step of the mean or all share a segment.
+    const V segments = locateShaper(V::max(V::max(x0, x1), x2), table).segment -
+                       locateShaper(V::min(V::min(x0, x1), x2), table).segment;
+    const V closeness = V::min(V::max(spread, absolute(delta)) * two * invStep, segments);
+    return V::selectLess(closeness, V::broadcast(1.0f), closed, far);
+}
+
+template <class V, int Order>
+void saturateAntialiasedKernel(float* data, int numFrames, int numLanes, const ShaperTable& table,
+                               float* history) noexcept
+{
+    constexpr int kChunk = 256;
+    static_assert(kChunk % kCrossoverLanes == 0, "chunks must hold whole frames");
+    // Inputs of this chunk after the previous `lead`; slopes between inputs a frame apart.
+    alignas(64) float in[kChunk + kMaxAntialiasingOrder * kCrossoverLanes];
+    alignas(64) float slopes[kChunk + kCrossoverLanes];
+    const int lead = Order * numLanes;
+    for (int j = 0; j < lead; ++j)
+        in[j] = history[j];
+
+    const int total = numFrames * numLanes;
+    for (int pos = 0; pos < total; pos += kChunk) {
+        const int n = total - pos < kChunk ? total - pos : kChunk;
+        float* out = data + pos;
+        for (int j = 0; j < n; ++j)
+            in[lead + j] = out[j];
+
+        if constexpr (Order == 1) {
+            int i = 0;
+            for (; i + V::width <= n; i += V::width)
+                antiderivativeSlope<V, 1>(V::load(in + i + numLanes), V::load(in + i), table).store(out + i);
+            for (; i < n; ++i)
+                antiderivativeSlope<Lane, 1>(Lane::load(in + i + numLanes), Lane::load(in + i), table).store(out + i);
+        } else {
+            const int numSlopes = n + numLanes;
+            int j = 0;
+            for (; j + V::width <= numSlopes; j += V::width)
+                antiderivativeSlope<V, 2>(V::load(in + j + numLanes), V::load(in + j), table).store(slopes + j);
+            for (; j < numSlopes; ++j)
+                antiderivativeSlope<Lane, 2>(Lane::load(in + j + numLanes), Lane::load(in + j), table).store(slopes + j);
+
+            int i = 0;
+            for (; i + V::width <= n; i += V::width)
+                antialiasSecondOrder(V::load(in + i + 2 * numLanes), V::load(in + i + numLanes), V::load(in + i),
+                                     V::load(slopes + i + numLanes), V::load(slopes + i), table)
+                    .store(out + i);
+            for (; i < n; ++i)
+                antialiasSecondOrder(Lane::load(in + i + 2 * numLanes), Lane::load(in + i + numLanes), Lane::load(in + i),
+                                     Lane::load(slopes + i + numLanes), Lane::load(slopes + i), table)
+                    .store(out + i);
+        }
+
+        for (int j = 0; j < lead; ++j)
+            in[j] = in[n + j];
+    }
+    for (int j = 0; j < lead; ++j)
+        history[j] = in[j];
+}
+
+template <class V>
+void applyGainKernel(float* data, int numSamples, float gain) noexcept
+{
+    const V g = V::broadcast(gain);
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width)
+        (V::load(data + i) * g).store(data + i);
+    for (; i < numSamples; ++i)
+        data[i] *= gain;
+}
+
+template <class V>
+void applyGainRampKernel(float* data, int numSamples, float start, float step) noexcept
+{
+    const V iota = V::load(kIota);
+    const V vStep = V::broadcast(step);
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width) {
+        const V g = V::mulAdd(iota + V::broadcast(static_cast<float>(i)), vStep, V::broadcast(start));
+        (V::load(data + i) * g).store(data + i);
+    }
+    for (; i < numSamples; ++i)
+        data[i] *= start + step * static_cast<float>(i);
+}
+
+template <class V>
+void mixDryWetKernel(float* wet, const float* dry, int numSamples, float start, float step) noexcept
+{
+    const V iota = V::load(kIota);
+    const V vStep = V::broadcast(step);
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width) {
+        const V m = V::mulAdd(iota + V::broadcast(static_cast<float>(i)), vStep, V::broadcast(start));
+        const V d = V::load(dry + i);
+        V::mulAdd(m, V::load(wet + i) - d, d).store(wet + i);
+    }
+    for (; i < numSamples; ++i) {
+        const float m = start + step * static_cast<float>(i);
+        wet[i] = dry[i] + m * (wet[i] - dry[i]);
+    }
+}
+
+template <class V>
+float peakAbsKernel(const float* data, int numSamples) noexcept
+{
+    const V zero = V::broadcast(0.0f);
+    V peak = zero;
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width) {
+        const V x = V::load(data + i);
+        peak = V::max(peak, V::max(x, zero - x));
+    }
+    float result = V::reduceMax(peak);
+    for (; i < numSamples; ++i) {
+        const float x = data[i] < 0.0f ? -data[i] : data[i];
+        result = x > result ? x : result;
+    }
+    return result;
+}
+
+template <class V>
+void maxAbsKernel(float* peak, const float* data, int numSamples) noexcept
+{
+    const V zero = V::broadcast(0.0f);
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width) {
+        const V x = V::load(data + i);
+        V::max(V::load(peak + i), V::max(x, zero - x)).store(peak + i);
+    }
+    for (; i < numSamples; ++i) {
+        const float x = data[i] < 0.0f ? -data[i] : data[i];
+        peak[i] = x > peak[i] ? x : peak[i];
+    }
+}
+
+template <class V>
+void applyGainCurveKernel(float* data, const float* gain, int numSamples) noexcept
+{
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width)
+        (V::load(data + i) * V::load(gain + i)).store(data + i);
+    for (; i < numSamples; ++i)
+        data[i] *= gain[i];
+}
+
+template <class V>
+inline V gainFromLevel(V level, const GainCurve& c) noexcept
+{
+    // Levels below -600 dB are silence as far as the curve cares; the floor also keeps
+    // zero out of the logarithm.
+    constexpr float kDecibelsPerOctave = 6.02059991f;
+    constexpr float kOctavesPerDecibel = 0.166096405f;
+    const float knee = c.kneeDb > 1e-3f ? c.kneeDb : 1e-3f;
+    const V halfKnee = V::broadcast(0.5f * knee);
+    const V zero = V::broadcast(0.0f);
+
+    const V db = log2Positive(V::max(level, V::broadcast(1e-30f))) * V::broadcast(kDecibelsPerOctave);
+    const V over = db - V::broadcast(c.thresholdDb);
+    const V inKnee = V::min(V::max(over + halfKnee, zero), V::broadcast(knee));
+    const V beyond = V::max(over - halfKnee, zero);
+    const V reduction = V::broadcast(c.slope) * V::mulAdd(inKnee * inKnee, V::broadcast(0.5f / knee), beyond);
+    return exp2Bounded(V::max(reduction * V::broadcast(kOctavesPerDecibel), V::broadcast(-126.0f)));
+}
+
+template <class V>
+void gainComputerKernel(float* data, int numSamples, const GainCurve& curve) noexcept
+{
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width)
+        gainFromLevel(V::load(data + i), curve).store(data + i);
+    for (; i < numSamples; ++i)
+        gainFromLevel(Lane::load(data + i), curve).store(data + i);
+}
+
+template <class V>
+void decibelsToGainKernel(float* data, int numSamples) noexcept
+{
+    constexpr float kOctavesPerDecibel = 0.166096405f;
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width)
+        exp2Bounded(V::load(data + i) * V::broadcast(kOctavesPerDecibel)).store(data + i);
+    for (; i < numSamples; ++i)
+        exp2Bounded(Lane::load(data + i) * Lane::broadcast(kOctavesPerDecibel)).store(data + i);
+}
+
+template <class V>
+float dotProductKernel(const float* a, const float* b, int numSamples) noexcept
+{
+    V acc = V::broadcast(0.0f);
+    int i = 0;
+    for (; i + V::width <= numSamples; i += V::width)
+        acc = V::mulAdd(V::load(a + i), V::load(b + i), acc);
+    float sum = V::reduceAdd(acc);
+    for (; i < numSamples; ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+template <class V>
+void convolveKernel(const float* history, const float* taps, int numTaps, float* out, int numOutputs) noexcept
+{
+    int i = 0;
+    for (; i + V::width <= numOutputs; i += V::width) {
+        V acc = V::broadcast(0.0f);
+        for (int j = 0; j < numTaps; ++j)
+            acc = V::mulAdd(V::broadcast(taps[j]), V::load(history + i + j), acc);
+        acc.store(out + i);
+    }
+    for (; i < numOutputs; ++i) {
+        float acc = 0.0f;
+        for (int j = 0; j < numTaps; ++j)
+            acc += taps[j] * history[i + j];
+        out[i] = acc;
+    }
+}
+
+template <class V>
+inline void fftButterfly(float* aRe, float* aIm, float* bRe, float* bIm, const float* wRe, const float* wIm) noexcept
+{
+    const V br = V::load(bRe);
+    const V bi = V::load(bIm);
+    const V wr = V::load(wRe);
+    const V wi = V::load(wIm);
+    const V tr = br * wr - bi * wi;
+    const V ti = V::mulAdd(br, wi, bi * wr);
+    const V ar = V::load(aRe);
+    const V ai = V::load(aIm);
+    (ar - tr).store(bRe);
+    (ai - ti).store(bIm);
+    (ar + tr).store(aRe);
+    (ai + ti).store(aIm);
+}
+
+template <class V>
+void fftStageKernel(float* re, float* im, const float* twRe, const float* twIm, int numPoints, int span) noexcept
+{
+    for (int start = 0; start < numPoints; start += 2 * span) {
+        int j = 0;
+        if (span >= V::width)
+            for (; j < span; j += V::width)
+                fftButterfly<V>(re + start + j, im + start + j, re + start + span + j, im + start + span + j,
+                                twRe + span + j, twIm + span + j);
+        for (; j < span; ++j)
+            fftButterfly<Lane>(re + start + j, im + start + j, re + start + span + j, im + start + span + j,
+                               twRe + span + j, twIm + span + j);
+    }
+}
+
+template <class V>
+void complexMultiplyAddKernel(float* accRe, float* accIm, const float* aRe, const float* aIm, const float* bRe,
+                              const float* bIm, int numBins) noexcept
+{
+    int i = 0;
+    for (; i + V::width <= numBins; i += V::width) {
+        const V ar = V::load(aRe + i);
+        const V ai = V::load(aIm + i);
+        const V br = V::load(bRe + i);
+        const V bi = V::load(bIm + i);
+        V::mulAdd(ar, br, V::load(accRe + i) - ai * bi).store(accRe + i);
+        V::mulAdd(ar, bi, V::mulAdd(ai, br, V::load(accIm + i))).store(accIm + i);
+    }
+    for (; i < numBins; ++i) {
+        accRe[i] += aRe[i] * bRe[i] - aIm[i] * bIm[i];
+        accIm[i] += aRe[i] * bIm[i] + aIm[i] * bRe[i];
+    }
+}
+
+template <class V>
+void biquadKernel(float* data, int numSamples, const BiquadKernelCoefficients& c, float& z1io,
+                  float& z2io) noexcept
+{
+    constexpr int W = V::width;
+    float z1 = z1io;
+    float z2 = z2io;
+    int i = 0;
+
+    if constexpr (W > 1) {
+        const V r1 = V::load(c.fromZ1);
+        const V r2 = V::load(c.fromZ2);
+        for (; i + W <= numSamples; i += W) {
+            float* x = data + i;
+            V y = V::mulAdd(r2, V::broadcast(z2), r1 * V::broadcast(z1));
+            for (int j = 0; j < W; ++j)
+                y = V::mulAdd(V::load(c.impulse[j]), V::broadcast(x[j]), y);
+
+            // TDF-II state after the vector depends only on the last two inputs and outputs.
+            const float x1 = x[W - 1];
+            const float x2 = x[W - 2];
+            y.store(x);
+            const float y1 = x[W - 1];
+            const float y2 = x[W - 2];
+            z1 = c.b1 * x1 - c.a1 * y1 + c.b2 * x2 - c.a2 * y2;
+            z2 = c.b2 * x1 - c.a2 * y1;
+        }
+    }
+
+    for (; i < numSamples; ++i) {
+        const float x = data[i];
+        const float y = c.b0 * x + z1;
+        z1 = c.b1 * x - c.a1 * y + z2;
+        z2 = c.b2 * x - c.a2 * y;
+        data[i] = y;
+    }
+
+    z1io = z1;
+    z2io = z2;
+}
+
+template <class V>
+void crossoverSplitKernel(const float* in, float* lanes, int numFrames, const CrossoverKernelCoefficients& c,
+                          float* state) noexcept
+{
+    constexpr int L = kCrossoverLanes;
+    constexpr int S = kMaxCrossoverSections;
+    static_assert(L % V::width == 0, "lane groups must tile the frame");
+    const int sections = c.numSections;
+
+    for (int l = 0; l < L; l += V::width) {
+        V z1[S];
+        V z2[S];
+        for (int s = 0; s < sections; ++s) {
+            z1[s] = V::load(state + s * L + l);
+            z2[s] = V::load(state + (S + s) * L + l);
+        }
+
+        for (int i = 0; i < numFrames; ++i) {
+            V x = V::broadcast(in[i]);
+            for (int s = 0; s < sections; ++s) {
+                const V y = V::mulAdd(V::load(c.b0[s] + l), x, z1[s]);
+                z1[s] = V::mulAdd(V::load(c.b1[s] + l), x, z2[s]) - V::load(c.a1[s] + l) * y;
+                z2[s] = V::load(c.b2[s] + l) * x - V::load(c.a2[s] + l) * y;
+                x = y;
+            }
+            x.store(lanes + i * L + l);
+        }
+
+        for (int s = 0; s < sections; ++s) {
+            z1[s].store(state + s * L + l);
+            z2[s].store(state + (S + s) * L + l);
+        }
+    }
+}
+
+template <class V>
+void laneGainRampKernel(float* lanes, int numFrames, const float* start, const float* step) noexcept
+{
+    constexpr int L = kCrossoverLanes;
+    for (int l = 0; l < L; l += V::width) {
+        V gain = V::load(start + l);
+        const V delta = V::load(step + l);
+        for (int i = 0; i < numFrames; ++i) {
+            float* frame = lanes + i * L + l;
+            (V::load(frame) * gain).store(frame);
+            gain = gain + delta;
+        }
+    }
+}
+
+template <class V>
+void mergeLanesKernel(const float* lanes, float* out, int numFrames) noexcept
+{
+    constexpr int L = kCrossoverLanes;
+    for (int i = 0; i < numFrames; ++i) {
+        const float* frame = lanes + i * L;
+        V sum = V::load(frame);
+        for (int l = V::width; l < L; l += V::width)
+            sum = sum + V::load(frame + l);
+        out[i] = V::reduceAdd(sum);
+    }
+}
+
+template <class V>
+KernelTable makeKernelTable(InstructionSet isa) noexcept
+{
+    KernelTable table{};
+    table.isa = isa;
+    table.applyGain = &applyGainKernel<V>;
+    table.applyGainRamp = &applyGainRampKernel<V>;
+    table.mixDryWet = &mixDryWetKernel<V>;
+    table.saturate[static_cast<int>(dsp::SaturationModel::SoftClip)] = &saturateSoftClipKernel<V>;
+    table.saturate[static_cast<int>(dsp::SaturationModel::HardClip)] = &saturateHardClipKernel<V>;
+    table.saturate[static_cast<int>(dsp::SaturationModel::Tube)] = &saturateTubeKernel<V>;
+    table.saturateAntialiased[0] = &saturateAntialiasedKernel<V, 1>;
+    table.saturateAntialiased[1] = &saturateAntialiasedKernel<V, 2>;
+    table.shapeTabulated = &shapeTabulatedKernel<V>;
+    table.peakAbs = &peakAbsKernel<V>;
+    table.maxAbs = &maxAbsKernel<V>;
+    table.applyGainCurve = &applyGainCurveKernel<V>;
+    table.gainComputer = &gainComputerKernel<V>;
+    table.decibelsToGain = &decibelsToGainKernel<V>;
+    table.dotProduct = &dotProductKernel<V>;
+    table.convolve = &convolveKernel<V>;
+    table.fftStage = &fftStageKernel<V>;
+    table.complexMultiplyAdd = &complexMultiplyAddKernel<V>;
+    table.biquad = &biquadKernel<V>;
+    // Wider-than-frame ISAs borrow the lane kernels of a narrower table.
+    if constexpr (kCrossoverLanes % V::width == 0) {
+        table.crossoverSplit = &crossoverSplitKernel<V>;
+        table.laneGainRamp = &laneGainRampKernel<V>;
+        table.mergeLanes = &mergeLanesKernel<V>;
+    }
+    return table;
+}
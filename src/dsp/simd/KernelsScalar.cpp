@@ -0,0 +1,17 @@
+#include "dsp/simd/KernelTables.h"
+
+namespace villain::simd {
+
+namespace {
+
+#include "dsp/simd/KernelsImpl.inl"
+
+} // namespace
+
+const KernelTable& detail::scalarKernels() noexcept
+{
+    static const KernelTable table = makeKernelTable<Lane>(InstructionSet::Scalar);
+    return table;
+}
+
+} // namespace villain::simd
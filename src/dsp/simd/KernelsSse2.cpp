@@ -0,0 +1,73 @@
+#include "dsp/simd/KernelTables.h"
+
+#include <emmintrin.h>
+
+namespace villain::simd {
+
+namespace {
+
+struct Vec {
+    static constexpr int width = 4;
+    __m128 v;
+
+    static Vec load(const float* p) noexcept { return {_mm_loadu_ps(p)}; }
+    static Vec broadcast(float x) noexcept { return {_mm_set1_ps(x)}; }
+    void store(float* p) const noexcept { _mm_storeu_ps(p, v); }
+
+    friend Vec operator+(Vec a, Vec b) noexcept { return {_mm_add_ps(a.v, b.v)}; }
+    friend Vec operator-(Vec a, Vec b) noexcept { return {_mm_sub_ps(a.v, b.v)}; }
+    friend Vec operator*(Vec a, Vec b) noexcept { return {_mm_mul_ps(a.v, b.v)}; }
+    friend Vec operator/(Vec a, Vec b) noexcept { return {_mm_div_ps(a.v, b.v)}; }
+    static Vec mulAdd(Vec a, Vec b, Vec c) noexcept { return {_mm_add_ps(_mm_mul_ps(a.v, b.v), c.v)}; }
+    static Vec min(Vec a, Vec b) noexcept { return {_mm_min_ps(a.v, b.v)}; }
+    static Vec max(Vec a, Vec b) noexcept { return {_mm_max_ps(a.v, b.v)}; }
+    static float reduceAdd(Vec a) noexcept
+    {
+        const __m128 pairs = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 0x55)));
+    }
+    static float reduceMax(Vec a) noexcept
+    {
+        const __m128 pairs = _mm_max_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, 0x55)));
+    }
+    static Vec mantissa(Vec a) noexcept
+    {
+        const __m128i bits = _mm_and_si128(_mm_castps_si128(a.v), _mm_set1_epi32(0x007fffff));
+        return {_mm_castsi128_ps(_mm_or_si128(bits, _mm_set1_epi32(0x3f800000)))};
+    }
+    static Vec exponent(Vec a) noexcept
+    {
+        const __m128i biased = _mm_srli_epi32(_mm_castps_si128(a.v), 23);
+        return {_mm_cvtepi32_ps(_mm_sub_epi32(biased, _mm_set1_epi32(127)))};
+    }
+    static Vec scale(Vec a, Vec e) noexcept
+    {
+        const __m128i bits = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(e.v), _mm_set1_epi32(127)), 23);
+        return {_mm_mul_ps(a.v, _mm_castsi128_ps(bits))};
+    }
+    static Vec truncate(Vec a) noexcept { return {_mm_cvtepi32_ps(_mm_cvttps_epi32(a.v))}; }
+    static Vec gather(const float* base, Vec index) noexcept
+    {
+        alignas(16) int i[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(i), _mm_cvttps_epi32(index.v));
+        return {_mm_setr_ps(base[i[0]], base[i[1]], base[i[2]], base[i[3]])};
+    }
+    static Vec selectLess(Vec a, Vec b, Vec x, Vec y) noexcept
+    {
+        const __m128 less = _mm_cmplt_ps(a.v, b.v);
+        return {_mm_or_ps(_mm_and_ps(less, x.v), _mm_andnot_ps(less, y.v))};
+    }
+};
+
+#include "dsp/simd/KernelsImpl.inl"
+
+} // namespace
+
+const KernelTable& detail::sse2Kernels() noexcept
+{
+    static const KernelTable table = makeKernelTable<Vec>(InstructionSet::SSE2);
+    return table;
+}
+
+} // namespace villain::simd
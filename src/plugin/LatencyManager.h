@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+namespace villain {
+
+enum class LatencyMode {
+    // Zero latency for live monitoring: no stage buffers audio. Linear-phase filters and
+    // lookahead are swapped for causal variants, whose few samples of group delay are part
+    // of the sound (as with analog gear) rather than latency, so nothing is reported.
+    Live,
+    // Highest quality: every stage runs as configured and its delay is compensated and
+    // reported.
+    Render,
+};
+
+// Stages that can hold audio back, in base-rate samples.
+enum class LatencySource {
+    Oversampling,   // halfband cascade; exact for linear phase, DC group delay otherwise
+    Antialiasing,   // second-order ADAA, padded to one sample
+    Lookahead,      // dynamics lookahead
+    Count,
+};
+
+// Adds up the delay of every latency-bearing stage and publishes the total for the host.
+//
+// Contributions are written on the audio thread (or in prepare) whenever a stage changes;
+// the total can be read from any thread. In Live mode the total is pinned to zero: stages
+// are expected to have switched to paths that hold nothing back, and anything they still
+// report is a design error rather than something to compensate.
+class LatencyManager {
+public:
+    void setMode(LatencyMode mode) noexcept
+    {
+        mode_ = mode;
+        publish();
+    }
+    LatencyMode mode() const noexcept { return mode_; }
+    bool isLive() const noexcept { return mode_ == LatencyMode::Live; }
+
+    void setContribution(LatencySource source, int samples) noexcept
+    {
+        contributions_[static_cast<std::size_t>(source)] = samples;
+        publish();
+    }
+    int contribution(LatencySource source) const noexcept { return contributions_[static_cast<std::size_t>(source)]; }
+
+    // Any thread.
+    int totalSamples() const noexcept { return total_.load(std::memory_order_relaxed); }
+
+    // Any thread. True once per change of the total, for a wrapper to forward to the host.
+    bool takeChange() noexcept { return changed_.exchange(false, std::memory_order_acq_rel); }
+
+private:
+    void publish() noexcept
+    {
+        int total = 0;
+        if (!isLive())
+            for (int samples : contributions_)
+                total += samples;
+        if (total_.exchange(total, std::memory_order_relaxed) != total)
+            changed_.store(true, std::memory_order_release);
+    }
+
+    std::array<int, static_cast<std::size_t>(LatencySource::Count)> contributions_{};
+    LatencyMode mode_ = LatencyMode::Render;
+    std::atomic<int> total_{0};
+    std::atomic<bool> changed_{false};
+};
+
+} // namespace villain
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "plugin/ParameterLayout.h"
+
+namespace villain {
+
+// A parameter change the host scheduled at a specific sample of the current block.
+struct ParameterEvent {
+    int sampleOffset;
+    ParamId id;
+    float value;
+};
+
+// Non-owning view of the host's event list for one block, sorted by sampleOffset as hosts
+// deliver it. Offsets at or past the block end take effect after the last sample.
+struct ParameterEventList {
+    const ParameterEvent* events = nullptr;
+    int numEvents = 0;
+
+    bool empty() const noexcept { return numEvents == 0; }
+    const ParameterEvent& operator[](int i) const noexcept { return events[i]; }
+};
+
+} // namespace villain
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+
+namespace villain {
+
+enum class ParamId : int {
+    InputGain,
+    Drive,
+    Tone,
+    Mix,
+    OutputGain,
+    SaturationModel,
+    OversamplingStages,
+    OversamplingMode,
+    Bands,
+    CrossoverLow,
+    CrossoverHigh,
+    BandDrive1,
+    BandDrive2,
+    BandDrive3,
+    BandDrive4,
+    BandDrive5,
+    BandDrive6,
+    LatencyMode,
+    Dynamics,
+    DynamicsThreshold,
+    DynamicsRatio,
+    DynamicsAttack,
+    DynamicsRelease,
+    DynamicsLookahead,
+    DynamicsDriveLink,
+    CabinetMix,
+    Antialiasing,
+    Sidechain,
+    SidechainDuck,
+    Mod1Source,
+    Mod1Target,
+    Mod1Depth,
+    Mod2Source,
+    Mod2Target,
+    Mod2Depth,
+    Mod3Source,
+    Mod3Target,
+    Mod3Depth,
+    Mod4Source,
+    Mod4Target,
+    Mod4Depth,
+    LfoRate,
+    LfoShape,
+    RandomRate,
+    EnvelopeRelease,
+    Count,
+};
+
+constexpr int kNumParameters = static_cast<int>(ParamId::Count);
+
+// Host-facing description of one parameter, in user units.
+struct ParameterInfo {
+    const char* id;
+    const char* name;
+    float minValue;
+    float maxValue;
+    float defaultValue;
+    bool discrete;
+};
+
+// Indexed by ParamId. `id` strings are persisted in sessions and must never change.
+constexpr std::array<ParameterInfo, kNumParameters> kParameterInfo = {{
+    {"input_gain", "Input", -24.0f, 24.0f, 0.0f, false},
+    {"drive", "Drive", 0.0f, 48.0f, 0.0f, false},
+    {"tone", "Tone", 200.0f, 20000.0f, 12000.0f, false},
+    {"mix", "Mix", 0.0f, 1.0f, 1.0f, false},
+    {"output_gain", "Output", -24.0f, 24.0f, 0.0f, false},
+    {"saturation_model", "Model", 0.0f, 2.0f, 0.0f, true},
+    {"oversampling", "Oversampling", 0.0f, 4.0f, 2.0f, true},
+    {"oversampling_mode", "Filter Mode", 0.0f, 1.0f, 0.0f, true},
+    {"bands", "Bands", 1.0f, 6.0f, 1.0f, true},
+    {"crossover_low", "Low Split", 40.0f, 2000.0f, 150.0f, false},
+    {"crossover_high", "High Split", 500.0f, 16000.0f, 4000.0f, false},
+    {"band_drive_1", "Band 1 Drive", -24.0f, 24.0f, 0.0f, false},
+    {"band_drive_2", "Band 2 Drive", -24.0f, 24.0f, 0.0f, false},
+    {"band_drive_3", "Band 3 Drive", -24.0f, 24.0f, 0.0f, false},
+    {"band_drive_4", "Band 4 Drive", -24.0f, 24.0f, 0.0f, false},
+    {"band_drive_5", "Band 5 Drive", -24.0f, 24.0f, 0.0f, false},
+    {"band_drive_6", "Band 6 Drive", -24.0f, 24.0f, 0.0f, false},
+    {"latency_mode", "Latency", 0.0f, 1.0f, 1.0f, true},
+    {"dynamics", "Dynamics", 0.0f, 2.0f, 0.0f, true},
+    {"dyn_threshold", "Threshold", -48.0f, 0.0f, -6.0f, false},
+    {"dyn_ratio", "Ratio", 1.0f, 20.0f, 4.0f, false},
+    {"dyn_attack", "Attack", 0.1f, 100.0f, 5.0f, false},
+    {"dyn_release", "Release", 5.0f, 1000.0f, 100.0f, false},
+    {"dyn_lookahead", "Lookahead", 0.0f, 10.0f, 2.0f, false},
+    {"dyn_drive_link", "Drive Link", 0.0f, 1.0f, 0.0f, false},
+    {"cab_mix", "Cabinet Mix", 0.0f, 1.0f, 1.0f, false},
+    {"antialiasing", "Anti-aliasing", 0.0f, 2.0f, 0.0f, true},
+    {"sidechain", "Sidechain", 0.0f, 1.0f, 0.0f, true},
+    {"sc_duck", "Duck", 0.0f, 24.0f, 0.0f, false},
+    {"mod1_source", "Mod 1 Source", 0.0f, 3.0f, 0.0f, true},
+    {"mod1_target", "Mod 1 Target", 0.0f, 2.0f, 0.0f, true},
+    {"mod1_depth", "Mod 1 Depth", -1.0f, 1.0f, 0.0f, false},
+    {"mod2_source", "Mod 2 Source", 0.0f, 3.0f, 0.0f, true},
+    {"mod2_target", "Mod 2 Target", 0.0f, 2.0f, 0.0f, true},
+    {"mod2_depth", "Mod 2 Depth", -1.0f, 1.0f, 0.0f, false},
+    {"mod3_source", "Mod 3 Source", 0.0f, 3.0f, 0.0f, true},
+    {"mod3_target", "Mod 3 Target", 0.0f, 2.0f, 0.0f, true},
+    {"mod3_depth", "Mod 3 Depth", -1.0f, 1.0f, 0.0f, false},
+    {"mod4_source", "Mod 4 Source", 0.0f, 3.0f, 0.0f, true},
+    {"mod4_target", "Mod 4 Target", 0.0f, 2.0f, 0.0f, true},
+    {"mod4_depth", "Mod 4 Depth", -1.0f, 1.0f, 0.0f, false},
+    {"lfo_rate", "LFO Rate", 0.01f, 20.0f, 1.0f, false},
+    {"lfo_shape", "LFO Shape", 0.0f, 1.0f, 0.0f, true},
+    {"rnd_rate", "Random Rate", 0.1f, 50.0f, 4.0f, false},
+    {"env_release", "Env Release", 10.0f, 1000.0f, 150.0f, false},
+}};
+
+constexpr ParamId bandDriveParam(int band) noexcept
+{
+    return static_cast<ParamId>(static_cast<int>(ParamId::BandDrive1) + band);
+}
+
+// Each modulation slot has a source, a target and a depth, in that order.
+constexpr ParamId modSourceParam(int slot) noexcept
+{
+    return static_cast<ParamId>(static_cast<int>(ParamId::Mod1Source) + 3 * slot);
+}
+
+constexpr ParamId modTargetParam(int slot) noexcept
+{
+    return static_cast<ParamId>(static_cast<int>(ParamId::Mod1Target) + 3 * slot);
+}
+
+constexpr ParamId modDepthParam(int slot) noexcept
+{
+    return static_cast<ParamId>(static_cast<int>(ParamId::Mod1Depth) + 3 * slot);
+}
+
+constexpr const ParameterInfo& parameterInfo(ParamId id) noexcept
+{
+    return kParameterInfo[static_cast<std::size_t>(id)];
+}
+
+} // namespace villain
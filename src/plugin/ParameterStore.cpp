@@ -0,0 +1,117 @@
+#include "plugin/ParameterStore.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace villain {
+
+ParameterStore::ParameterStore() noexcept
+{
+    for (int i = 0; i < kNumParameters; ++i)
+        values_[static_cast<std::size_t>(i)].store(kParameterInfo[static_cast<std::size_t>(i)].defaultValue,
+                                                   std::memory_order_relaxed);
+    markAllChanged();
+}
+
+void ParameterStore::set(ParamId id, float value) noexcept
+{
+    // std::clamp would pass a NaN through, and discrete values are later cast to int.
+    if (!std::isfinite(value))
+        return;
+    const ParameterInfo& info = parameterInfo(id);
+    float clamped = std::clamp(value, info.minValue, info.maxValue);
+    if (info.discrete)
+        clamped = std::round(clamped);
+
+    const auto index = static_cast<std::size_t>(id);
+    values_[index].store(clamped, std::memory_order_relaxed);
+    dirty_.fetch_or(std::uint64_t{1} << index, std::memory_order_release);
+}
+
+void ParameterStore::setAll(const Parameters& p) noexcept
+{
+    set(ParamId::InputGain, p.inputGainDb);
+    set(ParamId::Drive, p.driveDb);
+    set(ParamId::Tone, p.toneHz);
+    set(ParamId::Mix, p.mix);
+    set(ParamId::OutputGain, p.outputGainDb);
+    set(ParamId::SaturationModel, static_cast<float>(p.saturationModel));
+    set(ParamId::OversamplingStages, static_cast<float>(p.oversamplingStages));
+    set(ParamId::OversamplingMode, static_cast<float>(p.oversamplingMode));
+    set(ParamId::Bands, static_cast<float>(p.numBands));
+    set(ParamId::CrossoverLow, p.crossoverLowHz);
+    set(ParamId::CrossoverHigh, p.crossoverHighHz);
+    for (int band = 0; band < dsp::kMaxBands; ++band)
+        set(bandDriveParam(band), p.bandDriveDb[static_cast<std::size_t>(band)]);
+    set(ParamId::LatencyMode, static_cast<float>(p.latencyMode));
+    set(ParamId::Dynamics, static_cast<float>(p.dynamicsMode));
+    set(ParamId::DynamicsThreshold, p.dynamicsThresholdDb);
+    set(ParamId::DynamicsRatio, p.dynamicsRatio);
+    set(ParamId::DynamicsAttack, p.dynamicsAttackMs);
+    set(ParamId::DynamicsRelease, p.dynamicsReleaseMs);
+    set(ParamId::DynamicsLookahead, p.dynamicsLookaheadMs);
+    set(ParamId::DynamicsDriveLink, p.dynamicsDriveLink);
+    set(ParamId::CabinetMix, p.cabinetMix);
+    set(ParamId::Antialiasing, static_cast<float>(p.antialiasing));
+    set(ParamId::Sidechain, p.sidechain ? 1.0f : 0.0f);
+    set(ParamId::SidechainDuck, p.sidechainDuckDb);
+    for (int slot = 0; slot < dsp::kModulationSlots; ++slot) {
+        const dsp::ModulationRoute& route = p.modulation[static_cast<std::size_t>(slot)];
+        set(modSourceParam(slot), static_cast<float>(route.source));
+        set(modTargetParam(slot), static_cast<float>(route.target));
+        set(modDepthParam(slot), route.depth);
+    }
+    set(ParamId::LfoRate, p.lfoRateHz);
+    set(ParamId::LfoShape, static_cast<float>(p.lfoShape));
+    set(ParamId::RandomRate, p.randomRateHz);
+    set(ParamId::EnvelopeRelease, p.envelopeReleaseMs);
+}
+
+Parameters ParameterStore::snapshot() const noexcept
+{
+    Parameters p;
+    p.inputGainDb = get(ParamId::InputGain);
+    p.driveDb = get(ParamId::Drive);
+    p.toneHz = get(ParamId::Tone);
+    p.mix = get(ParamId::Mix);
+    p.outputGainDb = get(ParamId::OutputGain);
+    p.saturationModel = static_cast<dsp::SaturationModel>(static_cast<int>(get(ParamId::SaturationModel)));
+    p.oversamplingStages = static_cast<int>(get(ParamId::OversamplingStages));
+    p.oversamplingMode = static_cast<dsp::OversamplingMode>(static_cast<int>(get(ParamId::OversamplingMode)));
+    p.numBands = static_cast<int>(get(ParamId::Bands));
+    p.crossoverLowHz = get(ParamId::CrossoverLow);
+    p.crossoverHighHz = get(ParamId::CrossoverHigh);
+    for (int band = 0; band < dsp::kMaxBands; ++band)
+        p.bandDriveDb[static_cast<std::size_t>(band)] = get(bandDriveParam(band));
+    p.latencyMode = static_cast<LatencyMode>(static_cast<int>(get(ParamId::LatencyMode)));
+    p.dynamicsMode = static_cast<dsp::DynamicsMode>(static_cast<int>(get(ParamId::Dynamics)));
+    p.dynamicsThresholdDb = get(ParamId::DynamicsThreshold);
+    p.dynamicsRatio = get(ParamId::DynamicsRatio);
+    p.dynamicsAttackMs = get(ParamId::DynamicsAttack);
+    p.dynamicsReleaseMs = get(ParamId::DynamicsRelease);
+    p.dynamicsLookaheadMs = get(ParamId::DynamicsLookahead);
+    p.dynamicsDriveLink = get(ParamId::DynamicsDriveLink);
+    p.cabinetMix = get(ParamId::CabinetMix);
+    p.antialiasing = static_cast<dsp::Antialiasing>(static_cast<int>(get(ParamId::Antialiasing)));
+    p.sidechain = get(ParamId::Sidechain) >= 0.5f;
+    p.sidechainDuckDb = get(ParamId::SidechainDuck);
+    for (int slot = 0; slot < dsp::kModulationSlots; ++slot) {
+        dsp::ModulationRoute& route = p.modulation[static_cast<std::size_t>(slot)];
+        route.source = static_cast<dsp::ModSource>(static_cast<int>(get(modSourceParam(slot))));
+        route.target = static_cast<dsp::ModTarget>(static_cast<int>(get(modTargetParam(slot))));
+        route.depth = get(modDepthParam(slot));
+    }
+    p.lfoRateHz = get(ParamId::LfoRate);
+    p.lfoShape = static_cast<dsp::LfoShape>(static_cast<int>(get(ParamId::LfoShape)));
+    p.randomRateHz = get(ParamId::RandomRate);
+    p.envelopeReleaseMs = get(ParamId::EnvelopeRelease);
+    return p;
+}
+
+void ParameterStore::markAllChanged() noexcept
+{
+    dirty_.store((kNumParameters == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << kNumParameters) - 1),
+                 std::memory_order_release);
+}
+
+} // namespace villain
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "plugin/ParameterLayout.h"
+#include "plugin/Parameters.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace villain {
+
+// The hand-off point between the threads that change parameters (host, editor) and the
+// audio thread. Writers store into per-parameter atomics and flag the parameter in a dirty
+// mask; the audio thread swaps the mask out once per block. Every operation is a single
+// atomic instruction, so any number of writers can run alongside the audio thread and no
+// thread can ever block another.
+class ParameterStore {
+public:
+    ParameterStore() noexcept;
+
+    // Any thread. Values are clamped to the parameter's range (and rounded if discrete);
+    // NaN and infinities are ignored, leaving the parameter as it was.
+    void set(ParamId id, float value) noexcept;
+    void setAll(const Parameters& parameters) noexcept;
+
+    float get(ParamId id) const noexcept
+    {
+        return values_[static_cast<std::size_t>(id)].load(std::memory_order_relaxed);
+    }
+
+    // Typed view of the current values. Each field is read atomically; the set as a whole
+    // may straddle a concurrent update, which the audio thread's smoothing absorbs.
+    Parameters snapshot() const noexcept;
+
+    // Audio thread. Bit i set means parameter i changed since the previous call.
+    std::uint64_t takeChanges() noexcept { return dirty_.exchange(0, std::memory_order_acquire); }
+
+    // Marks every parameter changed, e.g. after prepare() so the audio thread resyncs.
+    void markAllChanged() noexcept;
+
+private:
+    static_assert(kNumParameters <= 64, "dirty mask is a single 64-bit word");
+    static_assert(std::atomic<float>::is_always_lock_free, "parameter values must be lock-free");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "dirty mask must be lock-free");
+
+    std::array<std::atomic<float>, kNumParameters> values_;
+    std::atomic<std::uint64_t> dirty_{0};
+};
+
+} // namespace villain
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "dsp/Crossover.h"
+#include "dsp/Dynamics.h"
+#include "dsp/Modulation.h"
+#include "dsp/Oversampler.h"
+#include "dsp/SaturationModel.h"
+#include "plugin/LatencyManager.h"
+
+#include <array>
+
+namespace villain {
+
+// Plain-value parameter set, in user units.
+struct Parameters {
+    float inputGainDb = 0.0f;
+    float driveDb = 0.0f;
+    float toneHz = 12000.0f;
+    float mix = 1.0f;
+    float outputGainDb = 0.0f;
+    dsp::SaturationModel saturationModel = dsp::SaturationModel::SoftClip;
+    int oversamplingStages = 2; // 0 = off, 1 = 2x ... 4 = 16x
+    dsp::OversamplingMode oversamplingMode = dsp::OversamplingMode::MinimumPhase;
+    int numBands = 1; // 1 = single-band saturation
+    float crossoverLowHz = 150.0f;
+    float crossoverHighHz = 4000.0f;
+    std::array<float, dsp::kMaxBands> bandDriveDb{};
+    LatencyMode latencyMode = LatencyMode::Render;
+    dsp::DynamicsMode dynamicsMode = dsp::DynamicsMode::Off;
+    float dynamicsThresholdDb = -6.0f;
+    float dynamicsRatio = 4.0f;
+    float dynamicsAttackMs = 5.0f;
+    float dynamicsReleaseMs = 100.0f;
+    float dynamicsLookaheadMs = 2.0f; // Render mode only
+    float dynamicsDriveLink = 0.0f;   // 1 = threshold falls dB for dB with drive
+    float cabinetMix = 1.0f;          // only heard once an impulse response is loaded
+    dsp::Antialiasing antialiasing = dsp::Antialiasing::Off;
+    bool sidechain = false;        // detectors follow the sidechain bus when the host sends one
+    float sidechainDuckDb = 0.0f;  // drive reduction at a 0 dBFS key
+    std::array<dsp::ModulationRoute, dsp::kModulationSlots> modulation{};
+    float lfoRateHz = 1.0f;
+    dsp::LfoShape lfoShape = dsp::LfoShape::Sine;
+    float randomRateHz = 4.0f;
+    float envelopeReleaseMs = 150.0f;
+};
+
+} // namespace villain
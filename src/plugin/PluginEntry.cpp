@@ -0,0 +1,222 @@
+#include "plugin/PluginEntry.h"
+
+#include "plugin/StateFormat.h"
+#include "plugin/VillainProcessor.h"
+
+#include <algorithm>
+#include <new>
+
+struct VillainInstance {
+    villain::VillainProcessor processor;
+};
+
+namespace {
+
+using namespace villain;
+
+// Host events are converted on the stack in runs of this many.
+constexpr int kEventChunk = 64;
+
+bool isParameter(int parameter) noexcept
+{
+    return parameter >= 0 && parameter < kNumParameters;
+}
+
+void processWithEvents(VillainProcessor& processor, const AudioBlock& block, const AudioBlock& sidechain,
+                       const VillainParameterEvent* events, int numEvents) noexcept
+{
+    if (numEvents <= 0) {
+        processor.process(block, sidechain);
+        return;
+    }
+
+    // Each run of events covers the block up to the next run's first offset, so long event
+    // lists cost extra block cuts but never an allocation.
+    const int numFrames = block.numSamples();
+    ParameterEvent chunk[kEventChunk];
+    int done = 0;
+    int next = 0;
+    while (next < numEvents) {
+        const int last = std::min(next + kEventChunk, numEvents);
+        const int end = last < numEvents ? std::clamp(events[last].sampleOffset, done, numFrames) : numFrames;
+        int count = 0;
+        for (int i = next; i < last; ++i)
+            if (isParameter(events[i].parameter))
+                chunk[count++] = {events[i].sampleOffset - done, static_cast<ParamId>(events[i].parameter), events[i].value};
+        const AudioBlock key = sidechain.numChannels() > 0 ? sidechain.subBlock(done, end - done) : sidechain;
+        processor.process(block.subBlock(done, end - done), key, {chunk, count});
+        done = end;
+        next = last;
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+int villain_api_version(void)
+{
+    return VILLAIN_API_VERSION;
+}
+
+int villain_num_parameters(void)
+{
+    return kNumParameters;
+}
+
+int villain_parameter_info(int index, VillainParameterInfo* info)
+{
+    if (!isParameter(index) || info == nullptr)
+        return 0;
+    const ParameterInfo& source = kParameterInfo[static_cast<std::size_t>(index)];
+    *info = {source.id, source.name, source.minValue, source.maxValue, source.defaultValue, source.discrete ? 1 : 0};
+    return 1;
+}
+
+VillainInstance* villain_create(void)
+{
+    return new (std::nothrow) VillainInstance;
+}
+
+void villain_destroy(VillainInstance* instance)
+{
+    delete instance;
+}
+
+int villain_prepare(VillainInstance* instance, double sampleRate, int maxBlockSize, int numChannels, int offline)
+{
+    if (instance == nullptr || sampleRate <= 0.0 || maxBlockSize <= 0 || numChannels <= 0 || numChannels > kMaxChannels)
+        return 0;
+    ProcessSpec spec;
+    spec.sampleRate = sampleRate;
+    spec.maxBlockSize = maxBlockSize;
+    spec.numChannels = numChannels;
+    spec.offline = offline != 0;
+    // Allocation, or std::system_error from starting the worker threads; nothing may
+    // unwind across the C boundary.
+    try {
+        instance->processor.prepare(spec);
+    } catch (...) {
+        instance->processor.release();
+        return 0;
+    }
+    return 1;
+}
+
+int villain_latency_samples(const VillainInstance* instance)
+{
+    return instance->processor.latencySamples();
+}
+
+void villain_process(VillainInstance* instance, float* const* channels, int numChannels, int numFrames,
+                     const VillainParameterEvent* events, int numEvents)
+{
+    const AudioBlock block(channels, std::min(numChannels, kMaxChannels), numFrames);
+    processWithEvents(instance->processor, block, AudioBlock(), events, numEvents);
+}
+
+void villain_process_sidechain(VillainInstance* instance, float* const* channels, int numChannels, int numFrames,
+                               const float* const* sidechain, int numSidechainChannels,
+                               const VillainParameterEvent* events, int numEvents)
+{
+    const AudioBlock block(channels, std::min(numChannels, kMaxChannels), numFrames);
+    // AudioBlock views are mutable; the key is only ever read.
+    const AudioBlock key(const_cast<float* const*>(sidechain), sidechain != nullptr ? std::min(numSidechainChannels, kMaxChannels) : 0,
+                         numFrames);
+    processWithEvents(instance->processor, block, key, events, numEvents);
+}
+
+void villain_set_parameter(VillainInstance* instance, int parameter, float value)
+{
+    if (isParameter(parameter))
+        instance->processor.parameters().set(static_cast<ParamId>(parameter), value);
+}
+
+float villain_get_parameter(const VillainInstance* instance, int parameter)
+{
+    return isParameter(parameter) ? instance->processor.parameters().get(static_cast<ParamId>(parameter)) : 0.0f;
+}
+
+size_t villain_state_size(void)
+{
+    return kMaxStateSize;
+}
+
+size_t villain_save_state(const VillainInstance* instance, void* buffer, size_t capacity)
+{
+    if (instance == nullptr)
+        return 0;
+    return instance->processor.saveState(buffer, capacity);
+}
+
+int villain_load_state(VillainInstance* instance, const void* data, size_t size)
+{
+    if (instance == nullptr)
+        return 0;
+    try {
+        return instance->processor.loadState(data, size) ? 1 : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+int villain_load_impulse_response(VillainInstance* instance, const char* path)
+{
+    if (instance == nullptr || path == nullptr)
+        return 0;
+    try {
+        return instance->processor.loadImpulseResponse(path) ? 1 : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+void villain_clear_impulse_response(VillainInstance* instance)
+{
+    if (instance == nullptr)
+        return;
+    try {
+        instance->processor.clearImpulseResponse();
+    } catch (...) {
+        // Out of memory for the swap; the current response stays.
+    }
+}
+
+int villain_set_asset_pack(VillainInstance* instance, const char* path)
+{
+    if (instance == nullptr || path == nullptr)
+        return 0;
+    try {
+        return instance->processor.setAssetPack(path) ? 1 : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+int villain_load_cabinet_asset(VillainInstance* instance, const char* name)
+{
+    if (instance == nullptr || name == nullptr)
+        return 0;
+    try {
+        return instance->processor.loadCabinetAsset(name) ? 1 : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+int villain_load_curve_asset(VillainInstance* instance, const char* name)
+{
+    if (instance == nullptr)
+        return 0;
+    try {
+        if (name == nullptr) {
+            instance->processor.clearCurve();
+            return 1;
+        }
+        return instance->processor.loadCurveAsset(name) ? 1 : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+} // extern "C"
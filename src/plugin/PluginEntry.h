@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stddef.h>
+
+// The plugin module's C entry points: everything a host wrapper (VST3, CLAP, AU shell) needs
+// to run the processor, with no C++ types crossing the module boundary. These are the only
+// symbols the module exports.
+//
+// Threading follows VillainProcessor: create/destroy/prepare/load_impulse_response on the
+// setup thread, process on the audio thread, parameters and state from any thread.
+//
+// No exception crosses these functions. Calls that report success return 0 for a null
+// instance or string and for any failure inside, such as a failed allocation or a worker
+// thread that cannot be started.
+
+#if defined(_WIN32)
+#if defined(VILLAIN_BUILDING_PLUGIN)
+#define VILLAIN_EXPORT __declspec(dllexport)
+#else
+#define VILLAIN_EXPORT __declspec(dllimport)
+#endif
+#else
+#define VILLAIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bumped whenever a signature below changes meaning.
+#define VILLAIN_API_VERSION 1
+
+typedef struct VillainInstance VillainInstance;
+
+typedef struct VillainParameterInfo {
+    const char* id;     // persisted; never changes
+    const char* name;
+    float minValue;
+    float maxValue;
+    float defaultValue;
+    int discrete;
+} VillainParameterInfo;
+
+// Host automation at a sample of the block; sorted by sampleOffset.
+typedef struct VillainParameterEvent {
+    int sampleOffset;
+    int parameter;
+    float value;
+} VillainParameterEvent;
+
+VILLAIN_EXPORT int villain_api_version(void);
+
+VILLAIN_EXPORT int villain_num_parameters(void);
+// Returns 0 if `index` is out of range.
+VILLAIN_EXPORT int villain_parameter_info(int index, VillainParameterInfo* info);
+
+// Returns NULL if the instance cannot be allocated.
+VILLAIN_EXPORT VillainInstance* villain_create(void);
+VILLAIN_EXPORT void villain_destroy(VillainInstance* instance);
+
+// Returns 0 on failure, leaving the instance unprepared.
+VILLAIN_EXPORT int villain_prepare(VillainInstance* instance, double sampleRate, int maxBlockSize, int numChannels,
+                                   int offline);
+VILLAIN_EXPORT int villain_latency_samples(const VillainInstance* instance);
+
+// In place, on planar channels. Events with an unknown parameter are ignored.
+VILLAIN_EXPORT void villain_process(VillainInstance* instance, float* const* channels, int numChannels, int numFrames,
+                                    const VillainParameterEvent* events, int numEvents);
+// Same, with the host's sidechain bus (numFrames long), which is read in place.
+VILLAIN_EXPORT void villain_process_sidechain(VillainInstance* instance, float* const* channels, int numChannels,
+                                              int numFrames, const float* const* sidechain, int numSidechainChannels,
+                                              const VillainParameterEvent* events, int numEvents);
+
+VILLAIN_EXPORT void villain_set_parameter(VillainInstance* instance, int parameter, float value);
+VILLAIN_EXPORT float villain_get_parameter(const VillainInstance* instance, int parameter);
+
+// Session state: every parameter plus the names of the pack cabinet and curve in use.
+// villain_state_size() is the most a state can take; save returns the bytes written, or 0
+// if `capacity` is too small for this instance's state.
+VILLAIN_EXPORT size_t villain_state_size(void);
+VILLAIN_EXPORT size_t villain_save_state(const VillainInstance* instance, void* buffer, size_t capacity);
+// Returns 0, leaving every parameter as it was, if the blob is not a valid state. Named
+// assets are loaded from the current pack; a missing one leaves its stage as it was.
+VILLAIN_EXPORT int villain_load_state(VillainInstance* instance, const void* data, size_t size);
+
+// Returns 0, keeping the current response, if the file cannot be decoded.
+VILLAIN_EXPORT int villain_load_impulse_response(VillainInstance* instance, const char* path);
+VILLAIN_EXPORT void villain_clear_impulse_response(VillainInstance* instance);
+
+// Factory asset pack, mapped once per process and shared by every instance. Each returns 0,
+// keeping what was there, if the pack cannot be opened or holds no asset of that name.
+VILLAIN_EXPORT int villain_set_asset_pack(VillainInstance* instance, const char* path);
+VILLAIN_EXPORT int villain_load_cabinet_asset(VillainInstance* instance, const char* name);
+// A measured shaper curve in place of the saturation model's; a null name goes back to it.
+VILLAIN_EXPORT int villain_load_curve_asset(VillainInstance* instance, const char* name);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "plugin/Parameters.h"
+
+#include <string>
+
+namespace villain {
+
+// A factory or user preset: parameter values plus the pack assets they use. Assets are
+// referenced by name, so a preset costs nothing until it is loaded.
+struct Preset {
+    Parameters parameters;
+    std::string cabinet;   // impulse response in the asset pack; empty for none
+    std::string curve;     // shaper curve in the asset pack; empty for the model's own
+};
+
+} // namespace villain
@@ -0,0 +1,294 @@
+#include "plugin/SignalChain.h"
+
+#include "dsp/simd/Kernels.h"
+#include "plugin/TraceStages.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace villain {
+
+namespace {
+
+constexpr float kToneQ = 0.70710678f;
+constexpr double kSmoothingSeconds = 0.02;
+constexpr float kMinToneHz = 20.0f;
+constexpr float kMaxToneHz = 20000.0f;
+// Well below the audio band, yet settles within a fraction of a second of a level change.
+constexpr double kDcBlockerHz = 10.0;
+
+// While the tone control glides, its coefficients are recomputed at this interval; the
+// same grid modulation steps on.
+constexpr int kToneUpdateInterval = dsp::kModulationInterval;
+
+} // namespace
+
+void SignalChain::prepare(double sampleRate, int maxBlockSize, int numChannels)
+{
+    sampleRate_ = sampleRate;
+
+    // One dry copy per channel for the mix stage.
+    const std::size_t perChannel = ScratchArena::floatFootprint(static_cast<std::size_t>(maxBlockSize));
+    scratch_.reserve(perChannel * static_cast<std::size_t>(numChannels));
+
+    oversampler_.prepare(numChannels, maxBlockSize);
+    saturator_.prepare(numChannels);
+    multiband_.prepare(numChannels);
+    multiband_.setSampleRate(sampleRate * oversampler_.factor());
+    constexpr int kMaxFactor = 1 << dsp::Oversampler::kMaxStages;
+    antialiasingPad_.prepare(numChannels, maxBlockSize * kMaxFactor, kMaxFactor - 1);
+    dryDelay_.prepare(numChannels, maxBlockSize, oversampler_.maxLatencySamples() + 1);
+
+    preGain_.prepare(sampleRate, kSmoothingSeconds);
+    outputGain_.prepare(sampleRate, kSmoothingSeconds);
+    toneHz_.prepare(sampleRate, kSmoothingSeconds);
+    mix_.prepare(sampleRate, kSmoothingSeconds);
+    dcBlocker_.setCoefficients(dsp::BiquadCoefficients::dcBlocker(sampleRate, kDcBlockerHz));
+}
+
+void SignalChain::release()
+{
+    scratch_.reserve(0);
+}
+
+void SignalChain::reset() noexcept
+{
+    snapSmoothing();
+    clearState();
+}
+
+void SignalChain::clearState() noexcept
+{
+    tone_.reset();
+    dcBlocker_.reset();
+    oversampler_.reset();
+    saturator_.reset();
+    multiband_.reset();
+    antialiasingPad_.reset();
+    dryDelay_.reset();
+}
+
+void SignalChain::snapSmoothing() noexcept
+{
+    preGain_.snapToTarget();
+    outputGain_.snapToTarget();
+    toneHz_.snapToTarget();
+    mix_.snapToTarget();
+    updateTone(0.0f);
+    toneModulated_ = false;
+    mixOffsetFrom_ = 0.0f;
+    mixOffsetTo_ = 0.0f;
+}
+
+void SignalChain::updateTone(float octaves) noexcept
+{
+    const float hz = octaves == 0.0f ? toneHz_.current() : toneHz_.current() * std::exp2(octaves);
+    tone_.setCoefficients(dsp::BiquadCoefficients::lowPass(sampleRate_, std::clamp(hz, kMinToneHz, kMaxToneHz), kToneQ));
+}
+
+void SignalChain::setOversampling(dsp::OversamplingMode mode, int numStages) noexcept
+{
+    requestedMode_ = mode;
+    requestedStages_ = numStages;
+    applyOversampling();
+}
+
+void SignalChain::setLatencyMode(LatencyMode mode) noexcept
+{
+    live_ = mode == LatencyMode::Live;
+    applyOversampling();
+}
+
+void SignalChain::setAntialiasing(dsp::Antialiasing mode) noexcept
+{
+    saturator_.setAntialiasing(mode);
+    multiband_.setAntialiasing(mode);
+    antialiasing_ = mode;
+    updateDelays();
+}
+
+void SignalChain::setSaturationModel(dsp::SaturationModel model) noexcept
+{
+    saturator_.setModel(model);
+    multiband_.setModel(model);
+    model_ = model;
+    updateDcBlocking();
+}
+
+void SignalChain::setCurve(std::shared_ptr<const dsp::ShaperCurve> curve) noexcept
+{
+    curveSlope_ = curve != nullptr ? curve->maxSlope() : 1.0f;
+    hasCurve_ = curve != nullptr;
+    saturator_.setCurve(curve);
+    multiband_.setCurve(std::move(curve));
+    updateDcBlocking();
+}
+
+void SignalChain::updateDcBlocking() noexcept
+{
+    // The tube's bias makes its output offset depend on the level driven into it; the other
+    // models and pack curves are centred, so they skip the filter. It starts from rest, as
+    // the model change itself is already a step in the sound.
+    const bool blocking = model_ == dsp::SaturationModel::Tube && !hasCurve_;
+    if (blocking && !dcBlocking_)
+        dcBlocker_.reset();
+    dcBlocking_ = blocking;
+}
+
+void SignalChain::applyOversampling() noexcept
+{
+    // Every buffer involved is sized for the worst case in prepare(), so neither the mode
+    // nor the factor reallocates here.
+    oversampler_.setMode(live_ ? dsp::OversamplingMode::MinimumPhase : requestedMode_);
+    oversampler_.setNumStages(requestedStages_);
+    updateDelays();
+    multiband_.setSampleRate(sampleRate_ * oversampler_.factor());
+}
+
+void SignalChain::updateDelays() noexcept
+{
+    // The shaper's own one-sample lag plus the pad make up one base-rate sample.
+    antialiasingPad_.setDelay(antialiasingLatency() * oversampler_.factor() - antialiasingLatency());
+    dryDelay_.setDelay(latencySamples());
+}
+
+float SignalChain::maxGain() const noexcept
+{
+    // The larger of the wet path and the unity dry path. The models' shapers and the tone
+    // filter never amplify (a pack curve may), but with bands above 1 each band adds its own
+    // drive (up to +24 dB).
+    float wet = preGain_.targetGain() * outputGain_.targetGain() * curveSlope_;
+    if (multiband_.numBands() > 1)
+        wet *= multiband_.maxDriveGain();
+    return std::max(wet, 1.0f);
+}
+
+void SignalChain::process(const AudioBlock& block, const dsp::ModulationBlock& modulation) noexcept
+{
+    ScratchArena::Frame frame(scratch_);
+    const int n = block.numSamples();
+    VILLAIN_TRACE_LAP(lap, trace_, traceTrack_, n);
+    // With latency in the wet path the dry signal is tracked even at 100% wet, so the delay
+    // line holds real history the moment the mix is pulled back.
+    const bool mixing = mix_.isSmoothing() || mix_.current() < 1.0f || modulation.mixOffset != nullptr;
+    const bool needsDry = mixing || dryDelay_.delay() > 0;
+
+    float* dry[kMaxChannels] = {};
+    if (needsDry) {
+        for (int ch = 0; ch < block.numChannels(); ++ch) {
+            dry[ch] = scratch_.allocateFloats(static_cast<std::size_t>(n));
+            std::memcpy(dry[ch], block.channel(ch), sizeof(float) * static_cast<std::size_t>(n));
+        }
+        dryDelay_.process(AudioBlock(dry, block.numChannels(), n));
+        VILLAIN_TRACE_MARK(lap, TraceStage::DryCopy);
+    }
+
+    preGain_.process(block);
+    if (modulation.driveGains != nullptr)
+        for (int ch = 0; ch < block.numChannels(); ++ch)
+            simd::activeKernels().applyGainCurve(block.channel(ch), modulation.driveGains, n);
+    VILLAIN_TRACE_MARK(lap, TraceStage::PreGain);
+    const AudioBlock oversampled = oversampler_.upsample(block);
+    VILLAIN_TRACE_MARK(lap, TraceStage::Upsample);
+    if (multiband_.numBands() > 1)
+        multiband_.process(oversampled);
+    else
+        saturator_.process(oversampled);
+    if (antialiasingPad_.delay() > 0)
+        antialiasingPad_.process(oversampled);
+    VILLAIN_TRACE_MARK(lap, TraceStage::Saturate);
+    oversampler_.downsample(block);
+    if (dcBlocking_)
+        dcBlocker_.process(block);
+    VILLAIN_TRACE_MARK(lap, TraceStage::Downsample);
+    processTone(block, modulation);
+    VILLAIN_TRACE_MARK(lap, TraceStage::Tone);
+    outputGain_.process(block);
+    VILLAIN_TRACE_MARK(lap, TraceStage::OutputGain);
+
+    if (mixing) {
+        processMix(block, dry, modulation);
+        VILLAIN_TRACE_MARK(lap, TraceStage::Mix);
+    }
+}
+
+void SignalChain::processTone(const AudioBlock& block, const dsp::ModulationBlock& modulation) noexcept
+{
+    if (modulation.toneOctaves != nullptr) {
+        // Modulation holds one cutoff per control step, glide or not.
+        toneModulated_ = true;
+        for (int pos = 0, step = 0; pos < block.numSamples(); ++step) {
+            const int length = std::min(modulation.stepLength(step), block.numSamples() - pos);
+            toneHz_.skip(length);
+            updateTone(modulation.toneOctaves[step]);
+            tone_.process(block.subBlock(pos, length));
+            pos += length;
+        }
+        return;
+    }
+
+    if (!toneHz_.isSmoothing()) {
+        if (toneModulated_) {
+            updateTone(0.0f);
+            toneModulated_ = false;
+        }
+        tone_.process(block);
+        return;
+    }
+
+    for (int pos = 0; pos < block.numSamples(); pos += kToneUpdateInterval) {
+        const int length = std::min(kToneUpdateInterval, block.numSamples() - pos);
+        toneHz_.skip(length);
+        updateTone(0.0f);
+        tone_.process(block.subBlock(pos, length));
+    }
+    toneModulated_ = false;
+}
+
+void SignalChain::processMix(const AudioBlock& wet, float* const* dry, const dsp::ModulationBlock& modulation) noexcept
+{
+    const auto mixDryWet = simd::activeKernels().mixDryWet;
+    const int n = wet.numSamples();
+
+    if (modulation.mixOffset == nullptr) {
+        mixOffsetFrom_ = 0.0f;
+        mixOffsetTo_ = 0.0f;
+        for (int pos = 0; pos < n;) {
+            const dsp::SmoothedValue::Segment segment = mix_.next(n - pos);
+            for (int ch = 0; ch < wet.numChannels(); ++ch)
+                mixDryWet(wet.channel(ch) + pos, dry[ch] + pos, segment.length, segment.start, segment.step);
+            pos += segment.length;
+        }
+        return;
+    }
+
+    // The offset glides linearly across each control step, on top of the mix ramp; the sum
+    // is clamped to [0, 1] at the ends of each run.
+    constexpr float kPerSample = 1.0f / static_cast<float>(dsp::kModulationInterval);
+    for (int pos = 0, step = 0; pos < n; ++step) {
+        const int stepLength = modulation.stepLength(step);
+        if (stepLength == dsp::kModulationInterval) {
+            mixOffsetFrom_ = mixOffsetTo_;
+            mixOffsetTo_ = modulation.mixOffset[step];
+        }
+        const int stepStart = pos;
+        const int stepEnd = std::min(pos + stepLength, n);
+        const int within = dsp::kModulationInterval - stepLength;
+        const float slope = (mixOffsetTo_ - mixOffsetFrom_) * kPerSample;
+        while (pos < stepEnd) {
+            const dsp::SmoothedValue::Segment segment = mix_.next(stepEnd - pos);
+            const float offset = mixOffsetFrom_ + slope * static_cast<float>(within + pos - stepStart);
+            const float first = std::clamp(segment.start + offset, 0.0f, 1.0f);
+            const float last = std::clamp(segment.start + offset + (segment.step + slope) * static_cast<float>(segment.length - 1),
+                                          0.0f, 1.0f);
+            const float rampStep = segment.length > 1 ? (last - first) / static_cast<float>(segment.length - 1) : 0.0f;
+            for (int ch = 0; ch < wet.numChannels(); ++ch)
+                mixDryWet(wet.channel(ch) + pos, dry[ch] + pos, segment.length, first, rampStep);
+            pos += segment.length;
+        }
+    }
+}
+
+} // namespace villain
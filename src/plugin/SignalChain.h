@@ -0,0 +1,121 @@
+#pragma once
+
+#include "core/AudioBlock.h"
+#include "core/ScratchArena.h"
+#include "core/TraceRing.h"
+#include "dsp/Biquad.h"
+#include "dsp/DelayLine.h"
+#include "dsp/Gain.h"
+#include "dsp/Modulation.h"
+#include "dsp/MultibandSaturator.h"
+#include "dsp/Oversampler.h"
+#include "dsp/Saturator.h"
+#include "dsp/SmoothedValue.h"
+#include "plugin/LatencyManager.h"
+
+#include <memory>
+
+namespace villain {
+
+// The processor's full DSP chain for one group of channels. Chains share settings but no
+// state or scratch memory, so the processor can run several of them on different cores.
+// prepare() allocates; everything else is audio-thread safe.
+class SignalChain {
+public:
+    void prepare(double sampleRate, int maxBlockSize, int numChannels);
+    void release();
+
+    // Ends every ramp and clears filter and delay state.
+    void reset() noexcept;
+    // Clears filter and delay state only.
+    void clearState() noexcept;
+    // Ends every ramp at its target; used while the output is silent.
+    void snapSmoothing() noexcept;
+
+    void setPreGainDecibels(float decibels) noexcept { preGain_.setGainDecibels(decibels); }
+    void setOutputGainDecibels(float decibels) noexcept { outputGain_.setGainDecibels(decibels); }
+    void setToneFrequency(float hz) noexcept { toneHz_.setTarget(hz); }
+    void setMix(float mix) noexcept { mix_.setTarget(mix); }
+    void setSaturationModel(dsp::SaturationModel model) noexcept;
+    void setAntialiasing(dsp::Antialiasing mode) noexcept;
+    // Non-realtime: a pack curve replaces the model's shaper (null for the model).
+    void setCurve(std::shared_ptr<const dsp::ShaperCurve> curve) noexcept;
+    void setBands(int numBands, float lowHz, float highHz) noexcept { multiband_.setBands(numBands, lowHz, highHz); }
+    // Moves the splits and keeps the band count.
+    void setCrossover(float lowHz, float highHz) noexcept { multiband_.setBands(multiband_.numBands(), lowHz, highHz); }
+    void setBandDriveDecibels(int band, float decibels) noexcept { multiband_.setBandDriveDecibels(band, decibels); }
+    void setOversampling(dsp::OversamplingMode mode, int numStages) noexcept;
+    // Live forces the minimum-phase oversampler and drops compensation; the requested
+    // oversampling mode comes back in Render.
+    void setLatencyMode(LatencyMode mode) noexcept;
+
+    // Delay the chain compensates internally (dry path) and expects the host to compensate.
+    int latencySamples() const noexcept { return oversamplingLatency() + antialiasingLatency(); }
+    int oversamplingLatency() const noexcept { return live_ ? 0 : oversampler_.latencySamples(); }
+    // Second-order ADAA lags one oversampled sample; the wet path is padded to a whole
+    // base-rate sample so it can be compensated. First order's half oversampled sample is
+    // left as part of the sound (at most half a sample, at 1x).
+    int antialiasingLatency() const noexcept
+    {
+        return !live_ && antialiasing_ == dsp::Antialiasing::SecondOrder ? 1 : 0;
+    }
+    bool isSmoothing() const noexcept
+    {
+        return preGain_.isSmoothing() || outputGain_.isSmoothing() || toneHz_.isSmoothing() || mix_.isSmoothing();
+    }
+
+    // Upper bound on the chain's gain at its target settings.
+    float maxGain() const noexcept;
+
+    // Stage timings go to `ring` on row `track` when built with VILLAIN_TRACE.
+    void setTrace(TraceRing* ring, int track) noexcept
+    {
+        trace_ = ring;
+        traceTrack_ = track;
+    }
+
+    // Processes `block` in place; its channel count must not exceed the prepared one.
+    // `modulation` carries the chunk's modulation tracks (drive gains include the sidechain
+    // ducking), computed once and shared by every chain.
+    void process(const AudioBlock& block, const dsp::ModulationBlock& modulation = {}) noexcept;
+
+private:
+    void processTone(const AudioBlock& block, const dsp::ModulationBlock& modulation) noexcept;
+    void processMix(const AudioBlock& wet, float* const* dry, const dsp::ModulationBlock& modulation) noexcept;
+    void updateTone(float octaves) noexcept;
+    void applyOversampling() noexcept;
+    void updateDelays() noexcept;
+    void updateDcBlocking() noexcept;
+
+    double sampleRate_ = 48000.0;
+    ScratchArena scratch_;
+
+    dsp::GainStage preGain_;
+    dsp::Oversampler oversampler_;
+    dsp::Saturator saturator_;
+    dsp::MultibandSaturator multiband_;
+    dsp::DelayLine antialiasingPad_;   // oversampled rate
+    dsp::Biquad dcBlocker_;
+    dsp::Biquad tone_;
+    dsp::SmoothedValue toneHz_{12000.0f};
+    dsp::GainStage outputGain_;
+    dsp::DelayLine dryDelay_;
+    dsp::SmoothedValue mix_{1.0f};
+    bool toneModulated_ = false;   // coefficients are off the smoother's value
+    float mixOffsetFrom_ = 0.0f;   // mix modulation across the current control step
+    float mixOffsetTo_ = 0.0f;
+
+    dsp::OversamplingMode requestedMode_ = dsp::OversamplingMode::MinimumPhase;
+    int requestedStages_ = 0;
+    dsp::Antialiasing antialiasing_ = dsp::Antialiasing::Off;
+    float curveSlope_ = 1.0f;   // the curve's gain bound; the models never amplify
+    dsp::SaturationModel model_ = dsp::SaturationModel::SoftClip;
+    bool hasCurve_ = false;
+    bool dcBlocking_ = false;
+    bool live_ = false;
+
+    TraceRing* trace_ = nullptr;
+    int traceTrack_ = 0;
+};
+
+} // namespace villain
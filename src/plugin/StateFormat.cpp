@@ -0,0 +1,241 @@
+#include "plugin/StateFormat.h"
+
+#include <cstring>
+#include <utility>
+
+namespace villain {
+
+namespace {
+
+// Byte-wise so the format is the same on any host byte order and alignment.
+void putU16(std::uint8_t* p, std::uint16_t v) noexcept
+{
+    p[0] = static_cast<std::uint8_t>(v);
+    p[1] = static_cast<std::uint8_t>(v >> 8);
+}
+
+void putU32(std::uint8_t* p, std::uint32_t v) noexcept
+{
+    for (int i = 0; i < 4; ++i)
+        p[i] = static_cast<std::uint8_t>(v >> (8 * i));
+}
+
+std::uint16_t getU16(const std::uint8_t* p) noexcept
+{
+    return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+
+std::uint32_t getU32(const std::uint8_t* p) noexcept
+{
+    std::uint32_t v = 0;
+    for (int i = 0; i < 4; ++i)
+        v |= static_cast<std::uint32_t>(p[i]) << (8 * i);
+    return v;
+}
+
+std::uint32_t floatBits(float value) noexcept
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float bitsFloat(std::uint32_t bits) noexcept
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::uint32_t checksum(const std::uint8_t* data, std::size_t size) noexcept
+{
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i)
+        hash = (hash ^ data[i]) * 16777619u;
+    return hash;
+}
+
+constexpr bool keysAreUnique() noexcept
+{
+    for (int i = 0; i < kNumParameters; ++i)
+        for (int j = i + 1; j < kNumParameters; ++j)
+            if (stateKey(static_cast<ParamId>(i)) == stateKey(static_cast<ParamId>(j)))
+                return false;
+    return true;
+}
+static_assert(keysAreUnique(), "two parameter ids hash to the same state key");
+
+// Header and entries; the asset section, if any, follows them.
+void writeParameters(const ParameterStore& store, std::uint8_t* out) noexcept
+{
+    std::uint8_t* entries = out + kStateHeaderSize;
+    for (int i = 0; i < kNumParameters; ++i) {
+        const auto id = static_cast<ParamId>(i);
+        std::uint8_t* entry = entries + static_cast<std::size_t>(i) * kStateEntrySize;
+        putU32(entry, stateKey(id));
+        putU32(entry + 4, floatBits(store.get(id)));
+    }
+
+    const std::size_t entryBytes = stateSize() - kStateHeaderSize;
+    putU32(out, kStateMagic);
+    putU16(out + 4, kStateVersion);
+    putU16(out + 6, static_cast<std::uint16_t>(kStateHeaderSize));
+    putU16(out + 8, static_cast<std::uint16_t>(kStateEntrySize));
+    putU16(out + 10, 0);
+    putU32(out + 12, static_cast<std::uint32_t>(kNumParameters));
+    putU32(out + 16, checksum(entries, entryBytes));
+}
+
+} // namespace
+
+std::size_t writeState(const ParameterStore& store, void* buffer, std::size_t capacity) noexcept
+{
+    if (buffer == nullptr || capacity < stateSize())
+        return 0;
+    writeParameters(store, static_cast<std::uint8_t*>(buffer));
+    return stateSize();
+}
+
+std::size_t writeState(const ParameterStore& store, const StateAssets& assets, void* buffer,
+                       std::size_t capacity) noexcept
+{
+    const std::size_t size = stateSize(assets);
+    if (buffer == nullptr || capacity < size || assets.cabinet.size() > AssetPack::kMaxNameLength ||
+        assets.curve.size() > AssetPack::kMaxNameLength)
+        return 0;
+
+    auto* out = static_cast<std::uint8_t*>(buffer);
+    const std::size_t sectionBytes = size - stateSize();
+    writeParameters(store, out);
+
+    std::uint8_t* section = out + stateSize();
+    std::uint8_t* field = section + 8;
+    std::uint16_t count = 0;
+    const std::pair<std::uint32_t, std::string_view> slots[] = {{kCabinetSlot, assets.cabinet},
+                                                                {kCurveSlot, assets.curve}};
+    for (const auto& [slot, name] : slots) {
+        if (name.empty())
+            continue;
+        putU32(field, slot);
+        putU16(field + 4, static_cast<std::uint16_t>(name.size()));
+        std::memcpy(field + kStateAssetHeaderSize, name.data(), name.size());
+        field += kStateAssetHeaderSize + name.size();
+        ++count;
+    }
+    putU32(section, kStateAssetMagic);
+    putU16(section + 4, static_cast<std::uint16_t>(sectionBytes));
+    putU16(section + 6, count);
+    putU32(field, checksum(section, sectionBytes - 4));
+    return size;
+}
+
+std::vector<std::uint8_t> saveState(const ParameterStore& store)
+{
+    std::vector<std::uint8_t> blob(stateSize());
+    writeState(store, blob.data(), blob.size());
+    return blob;
+}
+
+std::vector<std::uint8_t> saveState(const ParameterStore& store, const StateAssets& assets)
+{
+    std::vector<std::uint8_t> blob(stateSize(assets));
+    blob.resize(writeState(store, assets, blob.data(), blob.size()));
+    return blob;
+}
+
+StateReader::StateReader(const void* data, std::size_t size) noexcept
+{
+    const auto* in = static_cast<const std::uint8_t*>(data);
+    if (in == nullptr || size < kStateHeaderSize || getU32(in) != kStateMagic)
+        return;
+
+    const std::uint16_t headerSize = getU16(in + 6);
+    const std::uint16_t entrySize = getU16(in + 8);
+    const std::uint32_t count = getU32(in + 12);
+    // Entries must at least hold the fields this reader looks at.
+    if (headerSize < kStateHeaderSize || entrySize < kStateEntrySize || headerSize > size)
+        return;
+    if (static_cast<std::uint64_t>(count) * entrySize > size - headerSize)
+        return;
+
+    const std::size_t entryBytes = static_cast<std::size_t>(count) * entrySize;
+    if (checksum(in + headerSize, entryBytes) != getU32(in + 16))
+        return;
+    const std::uint8_t* section = in + headerSize + entryBytes;
+    const std::size_t rest = size - headerSize - entryBytes;
+    if (rest >= 4 && getU32(section) == kStateAssetMagic && !readAssets(section, rest))
+        return;
+
+    entries_ = in + headerSize;
+    numEntries_ = count;
+    entrySize_ = entrySize;
+    version_ = getU16(in + 4);
+}
+
+bool StateReader::readAssets(const std::uint8_t* section, std::size_t available) noexcept
+{
+    if (available < kStateSectionOverhead)
+        return false;
+    const std::uint16_t size = getU16(section + 4);
+    if (size < kStateSectionOverhead || size > available || checksum(section, size - 4u) != getU32(section + size - 4))
+        return false;
+    const std::uint16_t count = getU16(section + 6);
+    std::size_t pos = 8;
+    const std::size_t end = size - 4u;
+    StateAssets found;
+    for (std::uint16_t i = 0; i < count; ++i) {
+        if (end - pos < kStateAssetHeaderSize)
+            return false;
+        const std::uint32_t slot = getU32(section + pos);
+        const std::uint16_t length = getU16(section + pos + 4);
+        pos += kStateAssetHeaderSize;
+        if (end - pos < length)
+            return false;
+        const std::string_view name(reinterpret_cast<const char*>(section + pos), length);
+        pos += length;
+        // Slots this build does not know are skipped.
+        if (slot == kCabinetSlot)
+            found.cabinet = name;
+        else if (slot == kCurveSlot)
+            found.curve = name;
+    }
+    assets_ = found;
+    hasAssets_ = true;
+    return true;
+}
+
+bool StateReader::find(ParamId id, float& value) const noexcept
+{
+    const std::uint32_t key = stateKey(id);
+    // Blobs from this build store parameter i at entry i, so try that first.
+    const auto index = static_cast<std::uint32_t>(id);
+    if (index < numEntries_ && getU32(entries_ + index * entrySize_) == key) {
+        value = bitsFloat(getU32(entries_ + index * entrySize_ + 4));
+        return true;
+    }
+    for (std::uint32_t i = 0; i < numEntries_; ++i) {
+        const std::uint8_t* entry = entries_ + static_cast<std::size_t>(i) * entrySize_;
+        if (getU32(entry) == key) {
+            value = bitsFloat(getU32(entry + 4));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool loadState(ParameterStore& store, const void* data, std::size_t size) noexcept
+{
+    const StateReader reader(data, size);
+    if (!reader.isValid())
+        return false;
+
+    for (int i = 0; i < kNumParameters; ++i) {
+        const auto id = static_cast<ParamId>(i);
+        float value = parameterInfo(id).defaultValue;
+        reader.find(id, value);
+        store.set(id, value);
+    }
+    return true;
+}
+
+} // namespace villain
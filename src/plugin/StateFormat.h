@@ -0,0 +1,136 @@
+#pragma once
+
+#include "core/AssetPack.h"
+#include "plugin/ParameterLayout.h"
+#include "plugin/ParameterStore.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace villain {
+
+// Binary plugin state, little-endian throughout:
+//
+//   offset  size  field
+//        0     4  magic "VLNS"
+//        4     2  version
+//        6     2  header size (bytes before the first entry)
+//        8     2  entry size
+//       10     2  reserved, 0
+//       12     4  entry count
+//       16     4  FNV-1a of the entry bytes
+//       20        entries: u32 FNV-1a of the parameter's persisted id, f32 value
+//
+// then, from version 2, an optional asset section naming the pack assets the session uses:
+//
+//        0     4  magic "VLNA"
+//        4     2  section size, from the magic through the checksum
+//        6     2  asset count
+//        8        assets: u32 FNV-1a of the slot ("cabinet", "curve"), u16 name length, name
+//                 u32 FNV-1a of the section bytes before it
+//
+// Entries are keyed by id hash rather than position, so parameters can be added, removed or
+// reordered without a format change: readers skip hashes they do not know and leave missing
+// parameters at their defaults. Assets work the same way by slot. Later versions may grow
+// the header or the entries; readers step over both by the sizes recorded here. Bytes after
+// the entries that do not start with the section magic are ignored, as version 1 readers
+// ignore the section.
+constexpr std::uint32_t kStateMagic = 0x534e4c56;   // "VLNS" read as a little-endian u32
+constexpr std::uint16_t kStateVersion = 2;
+constexpr std::size_t kStateHeaderSize = 20;
+constexpr std::size_t kStateEntrySize = 8;
+constexpr std::uint32_t kStateAssetMagic = 0x414e4c56;   // "VLNA"
+constexpr std::size_t kStateSectionOverhead = 12;   // magic, size, count and checksum
+constexpr std::size_t kStateAssetHeaderSize = 6;    // slot and name length
+
+constexpr std::uint32_t fnv1a(const char* text) noexcept
+{
+    std::uint32_t hash = 2166136261u;
+    for (; *text != '\0'; ++text)
+        hash = (hash ^ static_cast<unsigned char>(*text)) * 16777619u;
+    return hash;
+}
+
+constexpr std::uint32_t stateKey(ParamId id) noexcept
+{
+    return fnv1a(parameterInfo(id).id);
+}
+
+constexpr std::uint32_t kCabinetSlot = fnv1a("cabinet");
+constexpr std::uint32_t kCurveSlot = fnv1a("curve");
+
+// Names of the pack assets a session uses; empty for none. Views, so writing a state never
+// copies them.
+struct StateAssets {
+    std::string_view cabinet;
+    std::string_view curve;
+};
+
+// Bytes writeState() produces for the current parameter set, without and with assets.
+constexpr std::size_t stateSize() noexcept
+{
+    return kStateHeaderSize + kStateEntrySize * static_cast<std::size_t>(kNumParameters);
+}
+
+constexpr std::size_t stateSize(const StateAssets& assets) noexcept
+{
+    std::size_t section = kStateSectionOverhead;
+    for (std::string_view name : {assets.cabinet, assets.curve})
+        if (!name.empty())
+            section += kStateAssetHeaderSize + name.size();
+    return stateSize() + section;
+}
+
+// Largest state with assets: both named, at the longest name a pack allows.
+constexpr std::size_t kMaxStateSize =
+    stateSize() + kStateSectionOverhead + 2 * (kStateAssetHeaderSize + AssetPack::kMaxNameLength);
+
+// Any thread; reads the store atomically per value and never blocks the audio thread.
+// Returns the bytes written, or 0 if `capacity` is below stateSize(), or a name is longer
+// than a pack allows. With `assets` the blob always carries the asset section, so loading
+// it also clears stages that had no asset.
+std::size_t writeState(const ParameterStore& store, void* buffer, std::size_t capacity) noexcept;
+std::size_t writeState(const ParameterStore& store, const StateAssets& assets, void* buffer,
+                       std::size_t capacity) noexcept;
+std::vector<std::uint8_t> saveState(const ParameterStore& store);
+std::vector<std::uint8_t> saveState(const ParameterStore& store, const StateAssets& assets);
+
+// Zero-copy view of a state blob: validation and lookups read the caller's bytes in place.
+// The blob must outlive the view.
+class StateReader {
+public:
+    StateReader(const void* data, std::size_t size) noexcept;
+
+    // Magic, sizes and checksum all check out.
+    bool isValid() const noexcept { return entries_ != nullptr; }
+    std::uint16_t version() const noexcept { return version_; }
+    std::uint32_t numEntries() const noexcept { return numEntries_; }
+
+    // The stored value for `id`, if present.
+    bool find(ParamId id, float& value) const noexcept;
+
+    // True if the blob has an asset section; assets() then views the names in it.
+    bool hasAssets() const noexcept { return hasAssets_; }
+    const StateAssets& assets() const noexcept { return assets_; }
+
+private:
+    bool readAssets(const std::uint8_t* section, std::size_t available) noexcept;
+
+    const std::uint8_t* entries_ = nullptr;
+    std::uint32_t numEntries_ = 0;
+    std::uint16_t entrySize_ = 0;
+    std::uint16_t version_ = 0;
+    StateAssets assets_;
+    bool hasAssets_ = false;
+};
+
+// Any thread. Writes every parameter through the store (missing ones get their defaults,
+// non-finite ones are ignored by it), so the audio thread picks the state up at its next
+// block. Leaves the store untouched and returns false if the blob is not a valid state,
+// which includes a damaged asset section. The assets themselves are the processor's to
+// load (VillainProcessor::loadState()).
+bool loadState(ParameterStore& store, const void* data, std::size_t size) noexcept;
+
+} // namespace villain
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "core/TraceRecorder.h"
+
+namespace villain {
+
+// Spans the processor records when built with VILLAIN_TRACE. Block covers one processed
+// chunk on the audio thread, and the stages that run once per chunk around the chains
+// (Modulation to Dynamics) nest inside it on the same track. The rest are the stages of
+// one chain, on that chain's track.
+enum class TraceStage {
+    Block,
+    DryCopy,
+    PreGain,
+    Upsample,
+    Saturate,
+    Downsample,
+    Tone,
+    OutputGain,
+    Mix,
+    Modulation,
+    Duck,
+    Cabinet,
+    Dynamics,
+    Count,
+};
+
+constexpr const char* kTraceStageNames[] = {
+    "block", "dry_copy", "pre_gain", "upsample", "saturate", "downsample", "tone", "output_gain", "mix",
+    "modulation", "duck", "cabinet", "dynamics",
+};
+static_assert(sizeof(kTraceStageNames) / sizeof(kTraceStageNames[0]) == static_cast<std::size_t>(TraceStage::Count),
+              "one name per stage");
+
+inline TraceFormat traceFormat(double sampleRate) noexcept
+{
+    TraceFormat format;
+    format.stageNames = kTraceStageNames;
+    format.numStages = static_cast<int>(TraceStage::Count);
+    format.blockStage = static_cast<int>(TraceStage::Block);
+    format.sampleRate = sampleRate;
+    return format;
+}
+
+} // namespace villain
@@ -0,0 +1,808 @@
+#include "plugin/VillainProcessor.h"
+
+#include "core/ScopedNoDenormals.h"
+#include "dsp/simd/Kernels.h"
+#include "plugin/StateFormat.h"
+#include "plugin/TraceStages.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <thread>
+
+namespace villain {
+
+namespace {
+
+// Ring-out allowed on top of the reported latency before silence counts as settled. Covers
+// the tone filter and the minimum-phase oversampler's allpass decay to -120 dB.
+constexpr int kTailHoldSamples = 1024;
+
+// Below this many samples handing chains to the pool costs more than it saves.
+constexpr int kMinParallelSamples = 32;
+
+// Offline renders oversample one step further than the session asks for.
+constexpr int kOfflineExtraStages = 1;
+
+// Room for a few seconds of spans between drains of a TraceRecorder.
+constexpr std::size_t kTraceCapacity = std::size_t{1} << 16;
+
+constexpr double kCabinetMixSeconds = 0.02;
+
+} // namespace
+
+void VillainProcessor::prepare(const ProcessSpec& spec)
+{
+    // Nothing may be building from the old spec while it changes.
+    builder_.stop();
+    spec_ = spec;
+    spec_.numChannels = std::clamp(spec.numChannels, 1, kMaxChannels);
+    // Offline, host blocks are never cut below kOfflineBlockSize: fewer, longer passes
+    // amortise per-block overhead and give each worker a worthwhile share.
+    spec_.maxBlockSize = std::max(spec.maxBlockSize, spec.offline ? kOfflineBlockSize : 1);
+
+    channelsPerChain_ = spec.offline ? 1 : kChannelsPerChain;
+    numChains_ = (spec_.numChannels + channelsPerChain_ - 1) / channelsPerChain_;
+#if VILLAIN_TRACE
+    if (trace_.capacity() == 0)
+        trace_.allocate(kTraceCapacity);
+#endif
+
+    requestedStages_ = oversamplingStages();
+    requestedMode_ = effectiveOversamplingMode();
+    requestedAntialiasing_ = antialiasing();
+    requestedLive_ = latencyMode() == LatencyMode::Live;
+    requestedBands_ = numBands();
+    buildFailed_.store(false, std::memory_order_relaxed);
+    chainSet_.replace(buildChains(presetLoads_.load(std::memory_order_acquire)));
+    chainFade_.prepare(spec_.sampleRate, kChainFadeSeconds);
+    fadeInput_.allocate(static_cast<std::size_t>(spec_.numChannels) * spec_.maxBlockSize);
+    for (int ch = 0; ch < spec_.numChannels; ++ch)
+        fadeChannels_[static_cast<std::size_t>(ch)] = fadeInput_.data() + static_cast<std::size_t>(ch) * spec_.maxBlockSize;
+    cabinet_.replace(buildCabinet());
+    cabinetLength_ = cabinet_.get() != nullptr ? cabinet_.get()->length() : 0;
+    cabinetDry_.allocate(static_cast<std::size_t>(spec_.numChannels) * spec_.maxBlockSize);
+    cabinetMix_.prepare(spec_.sampleRate, kCabinetMixSeconds);
+    dynamics_.prepare(spec_.sampleRate, spec_.numChannels, spec_.maxBlockSize);
+    ducker_.prepare(spec_.sampleRate);
+    duckGains_.allocate(static_cast<std::size_t>(spec_.maxBlockSize));
+    modulation_.prepare(spec_.sampleRate, spec_.maxBlockSize);
+
+    // The audio thread takes one chain itself, so more workers than chains - 1 would idle,
+    // and more than the spare cores would only compete with it. Offline there is no
+    // deadline to share with other instances, so every spare core is used.
+    const int spareCores = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+    const int requested = spec.offline ? spareCores : spec.maxWorkerThreads;
+    spec_.maxWorkerThreads = std::clamp(requested, 0, std::min(numChains_ - 1, spareCores));
+    pool_.start(spec_.maxWorkerThreads);
+    builder_.start(&rebuildChains, this);
+
+    prepared_ = true;
+    store_.markAllChanged();
+    pullParameterChanges();
+    reset();
+}
+
+void VillainProcessor::release()
+{
+    builder_.stop();
+    pool_.stop();
+    chainSet_.replace(nullptr);
+    cabinet_.replace(nullptr);
+    cabinetLength_ = 0;
+    prepared_ = false;
+}
+
+bool VillainProcessor::loadImpulseResponse(const std::string& path)
+{
+    dsp::ImpulseResponse ir;
+    if (!dsp::loadImpulseResponse(path, ir))
+        return false;
+    setImpulseResponse(std::move(ir));
+    return true;
+}
+
+void VillainProcessor::setImpulseResponse(dsp::ImpulseResponse ir)
+{
+    cabinetSource_ = std::move(ir);
+    cabinetPack_.reset();
+    cabinetAsset_.clear();
+    cabinetView_ = cabinetSource_;
+    if (prepared_)
+        cabinet_.publish(buildCabinet());
+}
+
+bool VillainProcessor::setAssetPack(const std::string& path)
+{
+    std::shared_ptr<const AssetPack> pack = AssetPack::acquire(path);
+    if (pack == nullptr)
+        return false;
+    assetPack_ = std::move(pack);
+    return true;
+}
+
+bool VillainProcessor::loadCabinetAsset(const std::string& name)
+{
+    const AssetEntry* asset = assetPack_ != nullptr ? assetPack_->find(name, AssetKind::ImpulseResponse) : nullptr;
+    if (asset == nullptr)
+        return false;
+    // The pages stream in on the pack's thread while the build below walks them.
+    assetPack_->prefetch(*asset);
+    cabinetSource_ = {};
+    cabinetPack_ = assetPack_;
+    cabinetView_ = dsp::impulseResponseAsset(*asset);
+    cabinetAsset_ = name;
+    if (prepared_)
+        cabinet_.publish(buildCabinet());
+    return true;
+}
+
+bool VillainProcessor::loadCurveAsset(const std::string& name)
+{
+    if (!selectCurve(name))
+        return false;
+    builder_.request();
+    return true;
+}
+
+void VillainProcessor::clearCurve()
+{
+    selectCurve({});
+    builder_.request();
+}
+
+bool VillainProcessor::selectCurve(const std::string& name)
+{
+    // Only stores the curve; the next build hands it to the chains.
+    std::shared_ptr<const dsp::ShaperCurve> curve;
+    if (!name.empty()) {
+        const AssetEntry* asset = assetPack_ != nullptr ? assetPack_->find(name, AssetKind::ShaperCurve) : nullptr;
+        curve = asset != nullptr ? dsp::shaperCurveAsset(*asset) : nullptr;
+        if (curve == nullptr)
+            return false;
+    }
+    std::atomic_store(&curve_, std::move(curve));
+    curveAsset_ = name;
+    return true;
+}
+
+void VillainProcessor::prefetchPreset(const Preset& preset) const
+{
+    if (assetPack_ == nullptr || preset.cabinet.empty())
+        return;
+    if (const AssetEntry* asset = assetPack_->find(preset.cabinet, AssetKind::ImpulseResponse))
+        assetPack_->prefetch(*asset);
+}
+
+bool VillainProcessor::loadPreset(const Preset& preset)
+{
+    prefetchPreset(preset);
+    // Counted before the values change, so the audio thread holds its chains as they are
+    // from here until a set built with the new values replaces them.
+    presetLoads_.fetch_add(1, std::memory_order_acq_rel);
+    setParameters(preset.parameters);
+    // Before the request, so the preset's chains are built with it.
+    const bool curveFound = selectCurve(preset.curve);
+    builder_.request();
+    if (preset.cabinet.empty()) {
+        clearImpulseResponse();
+        return curveFound;
+    }
+    return loadCabinetAsset(preset.cabinet) && curveFound;
+}
+
+std::size_t VillainProcessor::saveState(void* buffer, std::size_t capacity) const noexcept
+{
+    return writeState(store_, {cabinetAsset_, curveAsset_}, buffer, capacity);
+}
+
+bool VillainProcessor::loadState(const void* data, std::size_t size)
+{
+    const StateReader reader(data, size);
+    if (!villain::loadState(store_, data, size))
+        return false;
+    if (!reader.hasAssets())
+        return true;
+
+    // Hosts reload state freely; assets already in place are not rebuilt.
+    const StateAssets& assets = reader.assets();
+    if (assets.curve != curveAsset_ && selectCurve(std::string(assets.curve)))
+        builder_.request();
+    if (assets.cabinet.empty())
+        clearImpulseResponse();
+    else if (assets.cabinet != cabinetAsset_)
+        loadCabinetAsset(std::string(assets.cabinet));
+    return true;
+}
+
+std::unique_ptr<VillainProcessor::ChainSet> VillainProcessor::buildChains(std::uint32_t preset)
+{
+    auto set = std::make_unique<ChainSet>();
+    set->preset = preset;
+    const std::shared_ptr<const dsp::ShaperCurve> curve = std::atomic_load(&curve_);
+    for (int id = 0; id < kNumParameters; ++id)
+        set->values[static_cast<std::size_t>(id)] = store_.get(static_cast<ParamId>(id));
+
+    for (int c = 0; c < numChains_; ++c) {
+        SignalChain& chain = set->chains[static_cast<std::size_t>(c)];
+        chain.prepare(spec_.sampleRate, spec_.maxBlockSize, std::min(channelsPerChain_, spec_.numChannels - c * channelsPerChain_));
+        // Track 0 is the audio thread's block span; chains follow.
+        chain.setTrace(&trace_, c + 1);
+        chain.setCurve(curve);
+        for (int id = 0; id < kNumParameters; ++id)
+            configureChain(chain, static_cast<ParamId>(id));
+        chain.reset();
+    }
+    return set;
+}
+
+void VillainProcessor::rebuildChains(void* context)
+{
+    auto& self = *static_cast<VillainProcessor*>(context);
+    // Read before the values, so a set never claims a load that started after it read them.
+    // It can claim one that was still writing its values; those arrive as parameter changes,
+    // which the audio thread applies to the set once it is current (see swapChains()).
+    const std::uint32_t preset = self.presetLoads_.load(std::memory_order_acquire);
+    try {
+        self.chainSet_.publish(self.buildChains(preset));
+    } catch (const std::bad_alloc&) {
+        // No set is coming for this request. The audio thread is told, so it does not hold
+        // the current chains waiting for one.
+        self.failedPreset_.store(preset, std::memory_order_relaxed);
+        self.buildFailed_.store(true, std::memory_order_release);
+    }
+}
+
+void VillainProcessor::swapChains() noexcept
+{
+    // Offline there is no deadline to protect, and waiting keeps the render exact.
+    if (spec_.offline)
+        builder_.wait();
+    const bool failed = buildFailed_.exchange(false, std::memory_order_acquire);
+    const bool swapped = chainSet_.updateKeepingPrevious();
+    if (failed)
+        recoverFailedBuild();
+    if (!swapped)
+        return;
+
+    catchUpChains(*chainSet_.get());
+    latency_.setContribution(LatencySource::Oversampling, chain(0).oversamplingLatency());
+    latency_.setContribution(LatencySource::Antialiasing, chain(0).antialiasingLatency());
+    updateTailHold();
+
+    if (chainSet_.previous() == nullptr || tail_.isIdle()) {
+        chainSet_.releasePrevious();
+        return;
+    }
+    chainFade_.setCurrentAndTarget(0.0f);
+    chainFade_.setTarget(1.0f);
+}
+
+void VillainProcessor::catchUpChains(const ChainSet& set) noexcept
+{
+    // Whatever changed since the set read its values. Oversampling, antialiasing, latency
+    // mode and band count changes are never applied in place; they have asked for a build of
+    // their own.
+    for (int i = 0; i < kNumParameters; ++i) {
+        const auto id = static_cast<ParamId>(i);
+        if (rebuildsChains(id) || store_.get(id) == set.values[static_cast<std::size_t>(i)])
+            continue;
+        for (int c = 0; c < numChains_; ++c)
+            configureChain(chain(c), id);
+    }
+}
+
+void VillainProcessor::recoverFailedBuild() noexcept
+{
+    // Out of memory on the build thread. The current chains take the values the failed set
+    // would have had in place, and the next oversampling, antialiasing, latency mode or band
+    // count change asks for a build again.
+    ChainSet& set = *chainSet_.get();
+    const std::uint32_t failed = failedPreset_.load(std::memory_order_relaxed);
+    if (static_cast<std::int32_t>(failed - set.preset) > 0)
+        set.preset = failed;
+    catchUpChains(set);
+    requestedStages_ = -1;
+}
+
+void VillainProcessor::endChainFade() noexcept
+{
+    chainSet_.releasePrevious();
+    chainFade_.setCurrentAndTarget(1.0f);
+}
+
+std::unique_ptr<dsp::Convolver> VillainProcessor::buildCabinet() const
+{
+    if (cabinetView_.empty())
+        return nullptr;
+    // A bounce has no deadline to protect, so it computes the long partitions inline. At the
+    // session rate the taps are read where they are; otherwise a resampled copy lives only
+    // as long as the build.
+    auto cabinet = std::make_unique<dsp::Convolver>();
+    if (cabinetView_.sampleRate == spec_.sampleRate)
+        cabinet->prepare(cabinetView_, spec_.numChannels, !spec_.offline);
+    else
+        cabinet->prepare(dsp::resample(cabinetView_, spec_.sampleRate), spec_.numChannels, !spec_.offline);
+    return cabinet;
+}
+
+void VillainProcessor::reset() noexcept
+{
+    if (chainSet_.get() != nullptr) {
+        endChainFade();
+        for (int c = 0; c < numChains_; ++c)
+            chain(c).reset();
+    }
+    if (dsp::Convolver* cabinet = cabinet_.get())
+        cabinet->reset();
+    cabinetMix_.snapToTarget();
+    dynamics_.reset();
+    ducker_.reset();
+    modulation_.reset();
+    tail_.reset();
+}
+
+void VillainProcessor::clearState() noexcept
+{
+    endChainFade();
+    for (int c = 0; c < numChains_; ++c)
+        chain(c).clearState();
+    if (dsp::Convolver* cabinet = cabinet_.get())
+        cabinet->reset();
+    dynamics_.reset();
+    ducker_.reset();
+}
+
+void VillainProcessor::pullParameterChanges() noexcept
+{
+    std::uint64_t changes = store_.takeChanges();
+    while (changes != 0) {
+        int index = 0;
+        while ((changes & (std::uint64_t{1} << index)) == 0)
+            ++index;
+        changes &= changes - 1;
+        applyParameter(static_cast<ParamId>(index));
+    }
+}
+
+void VillainProcessor::applyParameter(ParamId id) noexcept
+{
+    const float value = store_.get(id);
+
+    if (rebuildsChains(id)) {
+        requestRebuild();
+    } else if (presetLoads_.load(std::memory_order_acquire) == chainSet_.get()->preset) {
+        // While a preset's chains are being built, the current ones keep the old preset.
+        ChainSet* outgoing = chainSet_.previous();
+        for (int c = 0; c < numChains_; ++c) {
+            configureChain(chain(c), id);
+            if (outgoing != nullptr)
+                configureChain(outgoing->chains[static_cast<std::size_t>(c)], id);
+        }
+    }
+
+    applyDynamics(id);
+    applyModulation(id);
+    if (id == ParamId::CabinetMix)
+        cabinetMix_.setTarget(value);
+    if (id == ParamId::Sidechain)
+        sidechainEnabled_ = value >= 0.5f;
+    if (id == ParamId::SidechainDuck)
+        ducker_.setDepthDecibels(value);
+
+    if (id == ParamId::LatencyMode)
+        latency_.setMode(latencyMode());
+    latency_.setContribution(LatencySource::Oversampling, chain(0).oversamplingLatency());
+    latency_.setContribution(LatencySource::Antialiasing, chain(0).antialiasingLatency());
+    latency_.setContribution(LatencySource::Lookahead, dynamics_.latencySamples());
+    updateTailHold();
+}
+
+void VillainProcessor::configureChain(SignalChain& chain, ParamId id) const noexcept
+{
+    const float value = store_.get(id);
+
+    switch (id) {
+    case ParamId::InputGain:
+    case ParamId::Drive:
+        chain.setPreGainDecibels(store_.get(ParamId::InputGain) + store_.get(ParamId::Drive));
+        break;
+    case ParamId::OutputGain:
+        chain.setOutputGainDecibels(value);
+        break;
+    case ParamId::Tone:
+        chain.setToneFrequency(value);
+        break;
+    case ParamId::Mix:
+        chain.setMix(value);
+        break;
+    case ParamId::SaturationModel:
+        chain.setSaturationModel(static_cast<dsp::SaturationModel>(static_cast<int>(value)));
+        break;
+    case ParamId::Antialiasing:
+        chain.setAntialiasing(antialiasing());
+        break;
+    case ParamId::OversamplingStages:
+    case ParamId::OversamplingMode:
+        chain.setOversampling(oversamplingMode(), oversamplingStages());
+        break;
+    case ParamId::Bands:
+        chain.setBands(numBands(), store_.get(ParamId::CrossoverLow), store_.get(ParamId::CrossoverHigh));
+        break;
+    case ParamId::CrossoverLow:
+    case ParamId::CrossoverHigh:
+        // Keeps the chain's own band count: a new one arrives with new chains.
+        chain.setCrossover(store_.get(ParamId::CrossoverLow), store_.get(ParamId::CrossoverHigh));
+        break;
+    case ParamId::BandDrive1:
+    case ParamId::BandDrive2:
+    case ParamId::BandDrive3:
+    case ParamId::BandDrive4:
+    case ParamId::BandDrive5:
+    case ParamId::BandDrive6:
+        chain.setBandDriveDecibels(static_cast<int>(id) - static_cast<int>(ParamId::BandDrive1), value);
+        break;
+    case ParamId::LatencyMode:
+        chain.setLatencyMode(latencyMode());
+        break;
+    case ParamId::Dynamics:
+    case ParamId::DynamicsThreshold:
+    case ParamId::DynamicsRatio:
+    case ParamId::DynamicsAttack:
+    case ParamId::DynamicsRelease:
+    case ParamId::DynamicsLookahead:
+    case ParamId::DynamicsDriveLink:
+    case ParamId::CabinetMix:
+    case ParamId::Sidechain:
+    case ParamId::SidechainDuck:
+    case ParamId::Mod1Source:
+    case ParamId::Mod1Target:
+    case ParamId::Mod1Depth:
+    case ParamId::Mod2Source:
+    case ParamId::Mod2Target:
+    case ParamId::Mod2Depth:
+    case ParamId::Mod3Source:
+    case ParamId::Mod3Target:
+    case ParamId::Mod3Depth:
+    case ParamId::Mod4Source:
+    case ParamId::Mod4Target:
+    case ParamId::Mod4Depth:
+    case ParamId::LfoRate:
+    case ParamId::LfoShape:
+    case ParamId::RandomRate:
+    case ParamId::EnvelopeRelease:
+    case ParamId::Count:
+        break;
+    }
+}
+
+void VillainProcessor::updateTailHold() noexcept
+{
+    // The cabinet adds no latency but rings out for the length of its response.
+    tail_.setHoldSamples(latencySamples() + kTailHoldSamples + cabinetLength_);
+}
+
+void VillainProcessor::applyDynamics(ParamId id) noexcept
+{
+    switch (id) {
+    case ParamId::Dynamics:
+        dynamics_.setMode(static_cast<dsp::DynamicsMode>(static_cast<int>(store_.get(ParamId::Dynamics))));
+        break;
+    case ParamId::Drive:
+    case ParamId::DynamicsThreshold:
+    case ParamId::DynamicsDriveLink:
+        // Linked, the threshold follows the drive down, so pushing the saturator harder
+        // changes its colour rather than its level.
+        dynamics_.setThresholdDecibels(store_.get(ParamId::DynamicsThreshold) -
+                                       store_.get(ParamId::DynamicsDriveLink) * store_.get(ParamId::Drive));
+        break;
+    case ParamId::DynamicsRatio:
+        dynamics_.setRatio(store_.get(ParamId::DynamicsRatio));
+        break;
+    case ParamId::DynamicsAttack:
+        dynamics_.setAttackSeconds(store_.get(ParamId::DynamicsAttack) * 0.001f);
+        break;
+    case ParamId::DynamicsRelease:
+        dynamics_.setReleaseSeconds(store_.get(ParamId::DynamicsRelease) * 0.001f);
+        break;
+    case ParamId::LatencyMode:
+    case ParamId::DynamicsLookahead: {
+        // Live monitoring cannot wait for the future; the limiter then clamps on arrival.
+        const double seconds = latencyMode() == LatencyMode::Live ? 0.0 : store_.get(ParamId::DynamicsLookahead) * 0.001;
+        dynamics_.setLookaheadSamples(static_cast<int>(std::lround(seconds * spec_.sampleRate)));
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void VillainProcessor::applyModulation(ParamId id) noexcept
+{
+    switch (id) {
+    case ParamId::LfoRate:
+    case ParamId::LfoShape:
+        modulation_.setLfo(store_.get(ParamId::LfoRate), static_cast<dsp::LfoShape>(static_cast<int>(store_.get(ParamId::LfoShape))));
+        break;
+    case ParamId::RandomRate:
+        modulation_.setRandomRate(store_.get(ParamId::RandomRate));
+        break;
+    case ParamId::EnvelopeRelease:
+        modulation_.setEnvelopeRelease(store_.get(ParamId::EnvelopeRelease) * 0.001f);
+        break;
+    default:
+        if (id >= ParamId::Mod1Source && id <= ParamId::Mod4Depth) {
+            const int slot = (static_cast<int>(id) - static_cast<int>(ParamId::Mod1Source)) / 3;
+            dsp::ModulationRoute route;
+            route.source = static_cast<dsp::ModSource>(static_cast<int>(store_.get(modSourceParam(slot))));
+            route.target = static_cast<dsp::ModTarget>(static_cast<int>(store_.get(modTargetParam(slot))));
+            route.depth = store_.get(modDepthParam(slot));
+            modulation_.setRoute(slot, route);
+        }
+        break;
+    }
+}
+
+int VillainProcessor::oversamplingStages() const noexcept
+{
+    const int requested = static_cast<int>(store_.get(ParamId::OversamplingStages));
+    return spec_.offline ? std::min(requested + kOfflineExtraStages, dsp::Oversampler::kMaxStages) : requested;
+}
+
+dsp::OversamplingMode VillainProcessor::oversamplingMode() const noexcept
+{
+    return static_cast<dsp::OversamplingMode>(static_cast<int>(store_.get(ParamId::OversamplingMode)));
+}
+
+dsp::OversamplingMode VillainProcessor::effectiveOversamplingMode() const noexcept
+{
+    // Live swaps linear-phase stages for minimum-phase ones (see SignalChain::setLatencyMode).
+    return latencyMode() == LatencyMode::Live ? dsp::OversamplingMode::MinimumPhase : oversamplingMode();
+}
+
+bool VillainProcessor::rebuildsChains(ParamId id) noexcept
+{
+    // Each of these moves a delay inside the chain or reshapes its band filters, which cannot
+    // change in place without a jump.
+    return id == ParamId::OversamplingStages || id == ParamId::OversamplingMode || id == ParamId::Antialiasing ||
+           id == ParamId::LatencyMode || id == ParamId::Bands;
+}
+
+void VillainProcessor::requestRebuild() noexcept
+{
+    // Asked once per new setting: the value is re-applied every block an event touches it.
+    // Live also drops the dry-path compensation, so it counts even when the mode stays.
+    const int stages = oversamplingStages();
+    const dsp::OversamplingMode mode = effectiveOversamplingMode();
+    const dsp::Antialiasing antialiasing = this->antialiasing();
+    const bool live = latencyMode() == LatencyMode::Live;
+    const int bands = numBands();
+    if (stages == requestedStages_ && mode == requestedMode_ && antialiasing == requestedAntialiasing_ &&
+        live == requestedLive_ && bands == requestedBands_)
+        return;
+    requestedStages_ = stages;
+    requestedMode_ = mode;
+    requestedAntialiasing_ = antialiasing;
+    requestedLive_ = live;
+    requestedBands_ = bands;
+    builder_.request();
+}
+
+int VillainProcessor::numBands() const noexcept
+{
+    return static_cast<int>(store_.get(ParamId::Bands));
+}
+
+dsp::Antialiasing VillainProcessor::antialiasing() const noexcept
+{
+    return static_cast<dsp::Antialiasing>(static_cast<int>(store_.get(ParamId::Antialiasing)));
+}
+
+LatencyMode VillainProcessor::latencyMode() const noexcept
+{
+    // A bounce has no one listening live, so it always gets the compensated path.
+    return spec_.offline ? LatencyMode::Render : static_cast<LatencyMode>(static_cast<int>(store_.get(ParamId::LatencyMode)));
+}
+
+void VillainProcessor::applyEvent(const ParameterEvent& event) noexcept
+{
+    // Going through the store keeps the editor in sync with automation. The dirty bit this
+    // sets re-applies the same value next block, which is a no-op.
+    store_.set(event.id, event.value);
+    applyParameter(event.id);
+}
+
+void VillainProcessor::process(const AudioBlock& block, const AudioBlock& sidechain, ParameterEventList events) noexcept
+{
+    if (!prepared_)
+        return;
+
+    ScopedNoDenormals noDenormals;
+    pullParameterChanges();
+    if (cabinet_.update()) {
+        cabinetLength_ = cabinet_.get() != nullptr ? cabinet_.get()->length() : 0;
+        updateTailHold();
+    }
+
+    const int numChannels = std::min(block.numChannels(), spec_.numChannels);
+    const int numSamples = block.numSamples();
+    const AudioBlock active(block.channels(), numChannels, numSamples);
+    // Sub-blocks of the host's own buffers: nothing below copies the key.
+    const bool keyed = sidechain.numChannels() > 0 && sidechain.numSamples() >= numSamples;
+
+    int eventIndex = 0;
+    for (int pos = 0; pos < numSamples;) {
+        while (eventIndex < events.numEvents && events[eventIndex].sampleOffset <= pos)
+            applyEvent(events[eventIndex++]);
+
+        int end = std::min(numSamples, pos + spec_.maxBlockSize);
+        if (eventIndex < events.numEvents)
+            end = std::min(end, events[eventIndex].sampleOffset);
+
+        processChunk(active.subBlock(pos, end - pos), keyed ? sidechain.subBlock(pos, end - pos) : AudioBlock());
+        pos = end;
+    }
+
+    while (eventIndex < events.numEvents)
+        applyEvent(events[eventIndex++]);
+}
+
+bool VillainProcessor::inputIsSilent(const AudioBlock& block) const noexcept
+{
+    // Scaled by the chain's gain bound, so quiet input stays quiet at full drive.
+    const float modulationGain = dsp::decibelsToGain(modulation_.maxDriveDecibels());
+    return dsp::peakLevel(block) * chain(0).maxGain() * modulationGain < dsp::kSilenceThreshold;
+}
+
+TraceFormat VillainProcessor::traceFormat() const noexcept
+{
+    return villain::traceFormat(spec_.sampleRate);
+}
+
+void VillainProcessor::processChunk(const AudioBlock& block, const AudioBlock& sidechain) noexcept
+{
+    VILLAIN_TRACE_LAP(lap, &trace_, 0, block.numSamples());
+    swapChains();
+    const bool inputSilent = inputIsSilent(block);
+    if (tail_.isIdle()) {
+        if (inputSilent) {
+            bypassSilent(block);
+            VILLAIN_TRACE_MARK(lap, TraceStage::Block);
+            return;
+        }
+        tail_.wake();
+    }
+
+    // Without a key the ducker hears silence, so it releases rather than holding its last gain.
+    const bool keyed = sidechainEnabled_ && sidechain.numChannels() > 0;
+    const int n = block.numSamples();
+    // The per-chunk stages get laps of their own, so Block still spans the whole chunk.
+    VILLAIN_TRACE_LAP(control, &trace_, 0, n);
+    dsp::ModulationBlock modulation;
+    if (modulation_.isActive())
+        modulation_.process(keyed ? sidechain : block, n, modulation);
+    VILLAIN_TRACE_MARK(control, TraceStage::Modulation);
+    if (sidechainEnabled_ && ducker_.isActive()) {
+        ducker_.computeGains(AudioBlock(sidechain.channels(), keyed ? sidechain.numChannels() : 0, n), duckGains_.data());
+        if (modulation.driveGains != nullptr)
+            simd::activeKernels().applyGainCurve(duckGains_.data(), modulation.driveGains, n);
+        modulation.driveGains = duckGains_.data();
+    }
+    VILLAIN_TRACE_MARK(control, TraceStage::Duck);
+
+    processChains(block, modulation);
+    VILLAIN_TRACE_LAP(output, &trace_, 0, n);
+    processCabinet(block);
+    VILLAIN_TRACE_MARK(output, TraceStage::Cabinet);
+    dynamics_.process(block, keyed ? sidechain : block);
+    VILLAIN_TRACE_MARK(output, TraceStage::Dynamics);
+
+    if (tail_.observe(inputSilent, dsp::peakLevel(block), block.numSamples()))
+        clearState();
+    VILLAIN_TRACE_MARK(lap, TraceStage::Block);
+}
+
+void VillainProcessor::bypassSilent(const AudioBlock& block) noexcept
+{
+    for (int ch = 0; ch < block.numChannels(); ++ch)
+        std::memset(block.channel(ch), 0, sizeof(float) * static_cast<std::size_t>(block.numSamples()));
+
+    // Nothing is audible, so ramps can finish immediately; the chain wakes on the targets.
+    for (int c = 0; c < numChains_; ++c)
+        if (chain(c).isSmoothing())
+            chain(c).snapSmoothing();
+    cabinetMix_.snapToTarget();
+}
+
+void VillainProcessor::processCabinet(const AudioBlock& block) noexcept
+{
+    dsp::Convolver* cabinet = cabinet_.get();
+    if (cabinet == nullptr)
+        return;
+
+    // The convolver keeps running at mix 0 so its history is current when the mix comes up.
+    const int n = block.numSamples();
+    const bool mixing = cabinetMix_.isSmoothing() || cabinetMix_.current() < 1.0f;
+    if (mixing)
+        for (int ch = 0; ch < block.numChannels(); ++ch)
+            std::memcpy(cabinetDry_.data() + static_cast<std::size_t>(ch) * spec_.maxBlockSize, block.channel(ch),
+                        sizeof(float) * static_cast<std::size_t>(n));
+
+    cabinet->process(block);
+
+    if (!mixing)
+        return;
+    const auto mixDryWet = simd::activeKernels().mixDryWet;
+    for (int pos = 0; pos < n;) {
+        const dsp::SmoothedValue::Segment segment = cabinetMix_.next(n - pos);
+        for (int ch = 0; ch < block.numChannels(); ++ch)
+            mixDryWet(block.channel(ch) + pos, cabinetDry_.data() + static_cast<std::size_t>(ch) * spec_.maxBlockSize + pos,
+                      segment.length, segment.start, segment.step);
+        pos += segment.length;
+    }
+}
+
+AudioBlock VillainProcessor::chainBlock(const AudioBlock& block, int chain) const noexcept
+{
+    const int first = chain * channelsPerChain_;
+    const int count = std::clamp(block.numChannels() - first, 0, channelsPerChain_);
+    return AudioBlock(block.channels() + first, count, block.numSamples());
+}
+
+void VillainProcessor::processChain(int task) noexcept
+{
+    // Tasks past the chain count run the outgoing set on its copy of the input.
+    const bool outgoing = task >= parallelChains_;
+    const int c = outgoing ? task - parallelChains_ : task;
+    const AudioBlock block = chainBlock(outgoing ? fadeBlock_ : parallelBlock_, c);
+    ChainSet& set = outgoing ? *chainSet_.previous() : *chainSet_.get();
+    if (block.numChannels() > 0)
+        set.chains[static_cast<std::size_t>(c)].process(block, parallelModulation_);
+}
+
+void VillainProcessor::runChain(void* context, int task) noexcept
+{
+    // Workers start with the thread's default FP mode, so each task sets its own.
+    ScopedNoDenormals noDenormals;
+    static_cast<VillainProcessor*>(context)->processChain(task);
+}
+
+void VillainProcessor::processChains(const AudioBlock& block, const dsp::ModulationBlock& modulation) noexcept
+{
+    const int numChains = (block.numChannels() + channelsPerChain_ - 1) / channelsPerChain_;
+    const bool fading = chainSet_.previous() != nullptr;
+    const int n = block.numSamples();
+    parallelBlock_ = block;
+    parallelChains_ = numChains;
+    parallelModulation_ = modulation;
+    if (fading) {
+        fadeBlock_ = AudioBlock(fadeChannels_.data(), block.numChannels(), n);
+        for (int ch = 0; ch < block.numChannels(); ++ch)
+            std::memcpy(fadeBlock_.channel(ch), block.channel(ch), sizeof(float) * static_cast<std::size_t>(n));
+    }
+
+    // Both sets run through a fade, and the pool splits them like any other chains.
+    const int numTasks = fading ? 2 * numChains : numChains;
+    if (pool_.numWorkers() > 0 && numTasks > 1 && n >= kMinParallelSamples)
+        pool_.run(numTasks, &runChain, this);
+    else
+        for (int task = 0; task < numTasks; ++task)
+            processChain(task);
+    if (!fading)
+        return;
+
+    // Linear: the two sets run on the same input and are strongly correlated. Sets that
+    // differ in latency comb briefly over the fade.
+    const auto mixDryWet = simd::activeKernels().mixDryWet;
+    for (int pos = 0; pos < n;) {
+        const dsp::SmoothedValue::Segment segment = chainFade_.next(n - pos);
+        for (int ch = 0; ch < block.numChannels(); ++ch)
+            mixDryWet(block.channel(ch) + pos, fadeBlock_.channel(ch) + pos, segment.length, segment.start, segment.step);
+        pos += segment.length;
+    }
+    if (!chainFade_.isSmoothing())
+        endChainFade();
+}
+
+} // namespace villain
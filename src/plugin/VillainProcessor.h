@@ -0,0 +1,274 @@
+#pragma once
+
+#include "core/AlignedBuffer.h"
+#include "core/AssetPack.h"
+#include "core/AudioBlock.h"
+#include "core/BuildWorker.h"
+#include "core/ProcessSpec.h"
+#include "core/SwapSlot.h"
+#include "core/TraceRecorder.h"
+#include "core/TraceRing.h"
+#include "core/WorkerPool.h"
+#include "dsp/Convolver.h"
+#include "dsp/Ducker.h"
+#include "dsp/Dynamics.h"
+#include "dsp/ImpulseResponse.h"
+#include "dsp/Modulation.h"
+#include "dsp/SmoothedValue.h"
+#include "dsp/TailDetector.h"
+#include "plugin/LatencyManager.h"
+#include "plugin/ParameterEvents.h"
+#include "plugin/ParameterStore.h"
+#include "plugin/Parameters.h"
+#include "plugin/Preset.h"
+#include "plugin/SignalChain.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace villain {
+
+// The plugin's DSP core. prepare() and release() run on the host's setup thread and are the
+// only places that allocate; process() is wait-free, lock-free and makes no system calls.
+//
+// Parameters are written through parameters() from any thread and picked up by the audio
+// thread at the start of the next process() call, then smoothed there.
+//
+// process() runs with flush-to-zero enabled, and once the input has been silent long enough
+// for every filter and delay to ring out the processor goes idle: state is cleared and
+// silent blocks are answered with zeros without touching the chain.
+//
+// Channels are processed in independent pairs. With ProcessSpec::maxWorkerThreads set, wide
+// layouts spread those pairs over a WorkerPool; the audio thread always works alongside the
+// pool, and the only system call it may make is the futex wake of a sleeping worker.
+//
+// A ProcessSpec::offline prepare switches to the render path: internal blocks of at least
+// kOfflineBlockSize, one more oversampling stage than requested, Render latency mode, and
+// one chain per channel spread over every spare core.
+//
+// A loaded impulse response (the cabinet stage) and then the compressor / limiter run after
+// the chains, over all channels at once, so the limiter's detector is linked across the
+// whole layout whichever way the chains are split.
+//
+// With the `sidechain` parameter on, a sidechain bus passed to process() keys the detectors:
+// it ducks the drive (`sc_duck`) and replaces the main input at the compressor / limiter's
+// detector. The host's sidechain buffers are read in place and never copied.
+//
+// The modulation matrix runs once per chunk ahead of the chains, and every chain reads the
+// same tracks. Its envelope follows the key when keyed, otherwise the main input.
+//
+// A change of oversampling factor, oversampling mode, antialiasing, latency mode or band
+// count, or a loadPreset(), never rebuilds the chains on the audio thread. A background thread builds a
+// whole new set of chains at the new settings, and the audio thread swaps it in at a chunk
+// boundary, then crossfades from the old set over kChainFadeSeconds while both run. Until
+// the swap, the old set keeps playing as it was; the reported latency follows the mode at
+// once. Offline, the audio thread waits for the build, so a render does not depend on timing.
+class VillainProcessor {
+public:
+    static constexpr int kChannelsPerChain = 2;
+    static constexpr int kMaxChains = kMaxChannels;   // offline runs one chain per channel
+    static constexpr int kOfflineBlockSize = 4096;
+    static constexpr double kChainFadeSeconds = 0.01;
+
+    VillainProcessor() = default;
+
+    void prepare(const ProcessSpec& spec);
+    void release();
+    void reset() noexcept;
+
+    ParameterStore& parameters() noexcept { return store_; }
+    const ParameterStore& parameters() const noexcept { return store_; }
+
+    // Convenience for writing every parameter at once; same threading rules as parameters().
+    void setParameters(const Parameters& parameters) noexcept { store_.setAll(parameters); }
+
+    // Processes in place. Blocks longer than spec.maxBlockSize are split internally rather than
+    // growing any buffer. Host automation in `events` is applied at its exact sample: the
+    // block is cut at each event offset and every run between events goes through the
+    // vector path as a whole.
+    void process(const AudioBlock& block, ParameterEventList events = {}) noexcept
+    {
+        process(block, AudioBlock(), events);
+    }
+    // Same, with the host's sidechain bus. It must be at least as long as `block`, or it is
+    // ignored; any channel count works.
+    void process(const AudioBlock& block, const AudioBlock& sidechain, ParameterEventList events = {}) noexcept;
+
+    // Current processing delay, to be reported to the host: the sum of every latency-bearing
+    // stage, or zero in LatencyMode::Live. Safe to read from any thread.
+    int latencySamples() const noexcept { return latency_.totalSamples(); }
+
+    // True once after each change of latencySamples(); a wrapper polls this from its
+    // message thread and asks the host to re-query the latency.
+    bool takeLatencyChange() noexcept { return latency_.takeChange(); }
+    const LatencyManager& latency() const noexcept { return latency_; }
+
+    // True while silent input is being bypassed.
+    bool isIdle() const noexcept { return tail_.isIdle(); }
+
+    bool isPrepared() const noexcept { return prepared_; }
+    const ProcessSpec& spec() const noexcept { return spec_; }
+    int numWorkerThreads() const noexcept { return pool_.numWorkers(); }
+    bool isOffline() const noexcept { return spec_.offline; }
+
+    // Cabinet impulse response. Call from the setup or message thread, never concurrently
+    // with prepare(). The convolution engine is built on the calling thread at the session
+    // rate, then swapped in by the audio thread at the start of its next block; engines it
+    // replaces are freed by the next call here (or by release()). A mono response is used
+    // on every channel, otherwise channel c uses response channel c % channels. Returns
+    // false, keeping the current response, if the file cannot be decoded.
+    bool loadImpulseResponse(const std::string& path);
+    void setImpulseResponse(dsp::ImpulseResponse ir);
+    void clearImpulseResponse() { setImpulseResponse({}); }
+    bool hasImpulseResponse() const noexcept { return !cabinetView_.empty(); }
+
+    // Factory assets, same threading as the cabinet calls above. setAssetPack() maps a pack
+    // once per process (see AssetPack::acquire); returns false, keeping the current pack, if
+    // it cannot be opened. loadCabinetAsset() uses a pack response as the cabinet, reading
+    // its taps from the shared pages: the instance keeps no copy of them, and only the pages
+    // of responses actually loaded are ever read. Returns false, keeping the current
+    // response, if no pack is set or it holds no response of that name.
+    bool setAssetPack(const std::string& path);
+    const AssetPack* assetPack() const noexcept { return assetPack_.get(); }
+    bool loadCabinetAsset(const std::string& name);
+    // loadCurveAsset() shapes with a measured pack curve in place of the saturation model's
+    // own, in every band and with any antialiasing; clearCurve() goes back to the model.
+    // The chains are rebuilt with it in the background and crossfaded in (see above).
+    // Returns false, keeping the current curve, if no pack is set or it holds no usable
+    // curve of that name.
+    bool loadCurveAsset(const std::string& name);
+    void clearCurve();
+    // Names of the pack assets in use; empty for none (or a cabinet loaded from a file).
+    const std::string& cabinetAsset() const noexcept { return cabinetAsset_; }
+    const std::string& curveAsset() const noexcept { return curveAsset_; }
+
+    // Preset change: starts the background prefetch of the preset's assets, then applies its
+    // parameters, curve and cabinet. The chains for the new values are built in the
+    // background and crossfaded in (see above). Returns false if the curve or the cabinet
+    // cannot be found; everything else is applied either way.
+    bool loadPreset(const Preset& preset);
+    // Just the prefetch, for a preset browser to call as the selection moves.
+    void prefetchPreset(const Preset& preset) const;
+
+    // Session state (see StateFormat.h): every parameter plus the names of the pack assets
+    // in use, same threading as the asset calls. loadState() applies the parameters like
+    // loadState(parameters(), ...) and then loads the named assets from the current pack,
+    // clearing stages the state has none for; an asset the pack lacks leaves its stage as
+    // it was. A cabinet loaded from a file is saved as none: its path is the wrapper's to
+    // keep. Returns 0 / false as the StateFormat calls do.
+    std::size_t saveState(void* buffer, std::size_t capacity) const noexcept;
+    bool loadState(const void* data, std::size_t size);
+
+    // True while chains for a new preset or oversampling setting are being built.
+    // waitForChains() blocks until they are; the audio thread swaps them in at its next
+    // process().
+    bool isBuildingChains() const noexcept { return builder_.isPending(); }
+    void waitForChains() noexcept { builder_.wait(); }
+
+    // Per-block and per-stage timings, filled only in VILLAIN_TRACE builds (the ring stays
+    // unallocated otherwise). Drain it with a TraceRecorder and save with traceFormat().
+    TraceRing& trace() noexcept { return trace_; }
+    TraceFormat traceFormat() const noexcept;
+
+private:
+    // Everything a preset, oversampling or antialiasing change rebuilds, with the parameter
+    // values it was built for and the loadPreset() those include.
+    struct ChainSet {
+        std::array<SignalChain, kMaxChains> chains;
+        std::array<float, kNumParameters> values{};
+        std::uint32_t preset = 0;
+    };
+
+    void pullParameterChanges() noexcept;
+    void applyParameter(ParamId id) noexcept;
+    void configureChain(SignalChain& chain, ParamId id) const noexcept;
+    static bool rebuildsChains(ParamId id) noexcept;
+    void requestRebuild() noexcept;
+    std::unique_ptr<ChainSet> buildChains(std::uint32_t preset);
+    static void rebuildChains(void* context);
+    void swapChains() noexcept;
+    void catchUpChains(const ChainSet& set) noexcept;
+    void recoverFailedBuild() noexcept;
+    void endChainFade() noexcept;
+    SignalChain& chain(int c) const noexcept { return chainSet_.get()->chains[static_cast<std::size_t>(c)]; }
+    void applyDynamics(ParamId id) noexcept;
+    void applyModulation(ParamId id) noexcept;
+    void applyEvent(const ParameterEvent& event) noexcept;
+    int oversamplingStages() const noexcept;
+    dsp::OversamplingMode oversamplingMode() const noexcept;
+    dsp::OversamplingMode effectiveOversamplingMode() const noexcept;
+    int numBands() const noexcept;
+    dsp::Antialiasing antialiasing() const noexcept;
+    LatencyMode latencyMode() const noexcept;
+    void processChunk(const AudioBlock& block, const AudioBlock& sidechain) noexcept;
+    void processChains(const AudioBlock& block, const dsp::ModulationBlock& modulation) noexcept;
+    void bypassSilent(const AudioBlock& block) noexcept;
+    bool inputIsSilent(const AudioBlock& block) const noexcept;
+    void clearState() noexcept;
+    void updateTailHold() noexcept;
+    std::unique_ptr<dsp::Convolver> buildCabinet() const;
+    void processCabinet(const AudioBlock& block) noexcept;
+    bool selectCurve(const std::string& name);
+
+    AudioBlock chainBlock(const AudioBlock& block, int chain) const noexcept;
+    void processChain(int task) noexcept;
+    static void runChain(void* context, int task) noexcept;
+
+    ProcessSpec spec_;
+    ParameterStore store_;
+    bool prepared_ = false;
+
+    // Published by builder_ (or prepare()); previous() is the set being faded out.
+    SwapSlot<ChainSet> chainSet_;
+    int numChains_ = 1;
+    int channelsPerChain_ = kChannelsPerChain;
+    std::atomic<std::uint32_t> presetLoads_{0};
+    std::atomic<std::uint32_t> failedPreset_{0};   // the loads a failed build had claimed
+    std::atomic<bool> buildFailed_{false};
+    int requestedStages_ = 0;   // audio thread: the settings last asked of builder_
+    dsp::OversamplingMode requestedMode_ = dsp::OversamplingMode::MinimumPhase;
+    dsp::Antialiasing requestedAntialiasing_ = dsp::Antialiasing::Off;
+    bool requestedLive_ = false;
+    int requestedBands_ = 1;
+    dsp::SmoothedValue chainFade_;
+    AlignedBuffer<float> fadeInput_;   // [channel][maxBlockSize], the outgoing set's input
+    std::array<float*, kMaxChannels> fadeChannels_{};
+
+    WorkerPool pool_;
+    // The chunk the chain tasks are working on, and its copy for the outgoing set.
+    AudioBlock parallelBlock_;
+    AudioBlock fadeBlock_;
+    int parallelChains_ = 0;
+    dsp::ModulationBlock parallelModulation_;
+
+    // Setup thread: the cabinet as loaded, rebuilt from by prepare(). The view points into
+    // cabinetSource_ (a file) or into cabinetPack_'s mapping (a factory asset).
+    dsp::ImpulseResponse cabinetSource_;
+    std::shared_ptr<const AssetPack> cabinetPack_;
+    dsp::ImpulseResponseView cabinetView_;
+    std::shared_ptr<const AssetPack> assetPack_;
+    std::string cabinetAsset_;
+    std::string curveAsset_;
+    // Written on the setup thread, read by buildChains() on builder_'s thread.
+    std::shared_ptr<const dsp::ShaperCurve> curve_;
+    SwapSlot<dsp::Convolver> cabinet_;
+    AlignedBuffer<float> cabinetDry_;      // [channel][maxBlockSize]
+    dsp::SmoothedValue cabinetMix_{1.0f};
+    int cabinetLength_ = 0;
+
+    dsp::Dynamics dynamics_;
+    dsp::Ducker ducker_;
+    AlignedBuffer<float> duckGains_;   // maxBlockSize
+    bool sidechainEnabled_ = false;
+    dsp::ModulationMatrix modulation_;
+    dsp::TailDetector tail_;
+    LatencyManager latency_;
+    TraceRing trace_;
+    // Declared last, so its thread is joined before anything it builds from goes away.
+    BuildWorker builder_;
+};
+
+} // namespace villain
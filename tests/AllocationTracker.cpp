@@ -0,0 +1,63 @@
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local bool tTracking = false;
+thread_local std::size_t tAllocations = 0;
+
+void* allocate(std::size_t size, std::size_t alignment)
+{
+    if (tTracking)
+        ++tAllocations;
+    if (size == 0)
+        size = 1;
+
+    void* ptr = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        ptr = std::malloc(size);
+    } else {
+        size = (size + alignment - 1) / alignment * alignment;
+        ptr = std::aligned_alloc(alignment, size);
+    }
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return allocate(size, 0); }
+void* operator new[](std::size_t size) { return allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+namespace villain::test {
+
+ScopedAllocationCounter::ScopedAllocationCounter() noexcept : previous_(tTracking), start_(tAllocations)
+{
+    tTracking = true;
+}
+
+ScopedAllocationCounter::~ScopedAllocationCounter()
+{
+    tTracking = previous_;
+}
+
+std::size_t ScopedAllocationCounter::count() const noexcept
+{
+    return tAllocations - start_;
+}
+
+} // namespace villain::test
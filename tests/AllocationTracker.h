@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+namespace villain::test {
+
+// Counts heap allocations made by the current thread while alive. Backed by replacement
+// global operator new/delete in AllocationTracker.cpp.
+class ScopedAllocationCounter {
+public:
+    ScopedAllocationCounter() noexcept;
+    ~ScopedAllocationCounter();
+
+    ScopedAllocationCounter(const ScopedAllocationCounter&) = delete;
+    ScopedAllocationCounter& operator=(const ScopedAllocationCounter&) = delete;
+
+    std::size_t count() const noexcept;
+
+private:
+    bool previous_;
+    std::size_t start_;
+};
+
+} // namespace villain::test
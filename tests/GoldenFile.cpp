@@ -0,0 +1,50 @@
+#include "GoldenFile.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace villain::test {
+
+namespace {
+
+constexpr char kMagic[4] = {'V', 'G', 'L', 'D'};
+constexpr std::uint32_t kVersion = 1;
+
+} // namespace
+
+bool writeGoldenFile(const std::string& path, const Channels& channels)
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    const std::uint32_t header[3] = {kVersion, static_cast<std::uint32_t>(channels.size()),
+                                     static_cast<std::uint32_t>(channels.empty() ? 0 : channels[0].size())};
+    bool ok = std::fwrite(kMagic, 1, sizeof(kMagic), file) == sizeof(kMagic);
+    ok = ok && std::fwrite(header, sizeof(header), 1, file) == 1;
+    for (const auto& channel : channels)
+        ok = ok && std::fwrite(channel.data(), sizeof(float), channel.size(), file) == channel.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+bool readGoldenFile(const std::string& path, Channels& channels)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    char magic[4] = {};
+    std::uint32_t header[3] = {};
+    bool ok = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) && std::memcmp(magic, kMagic, 4) == 0;
+    ok = ok && std::fread(header, sizeof(header), 1, file) == 1 && header[0] == kVersion;
+    if (ok) {
+        channels.assign(header[1], std::vector<float>(header[2]));
+        for (auto& channel : channels)
+            ok = ok && std::fread(channel.data(), sizeof(float), channel.size(), file) == channel.size();
+    }
+    std::fclose(file);
+    return ok;
+}
+
+} // namespace villain::test
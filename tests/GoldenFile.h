@@ -0,0 +1,14 @@
+#pragma once
+
+#include "TestFramework.h"
+
+#include <string>
+
+namespace villain::test {
+
+// Reference renders are planar float32 with a small header:
+//   "VGLD" | u32 version | u32 channels | u32 frames | channels * frames float32 (LE)
+bool writeGoldenFile(const std::string& path, const Channels& channels);
+bool readGoldenFile(const std::string& path, Channels& channels);
+
+} // namespace villain::test
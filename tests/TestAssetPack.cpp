@@ -0,0 +1,335 @@
+#include "TestFramework.h"
+#include "TestSignals.h"
+
+#include "core/AssetPack.h"
+#include "core/SharedTable.h"
+#include "dsp/ImpulseResponse.h"
+#include "plugin/StateFormat.h"
+#include "plugin/VillainProcessor.h"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+// Per process: ctest runs the suite once per instruction set, side by side.
+std::string tempPath(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / (std::to_string(::getpid()) + "_" + name)).string();
+}
+
+// A decaying stereo response, long enough to reach the convolver's background tail.
+PackedAsset cabinetAsset(const std::string& name, double sampleRate, int frames)
+{
+    PackedAsset asset;
+    asset.name = name;
+    asset.kind = AssetKind::ImpulseResponse;
+    asset.sampleRate = sampleRate;
+    asset.channels = {sweepWithNoise(frames, sampleRate, 7u), sweepWithNoise(frames, sampleRate, 8u)};
+    for (std::vector<float>& channel : asset.channels)
+        for (std::size_t i = 0; i < channel.size(); ++i)
+            channel[i] *= std::exp(-6.0f * static_cast<float>(i) / static_cast<float>(frames));
+    return asset;
+}
+
+PackedAsset curveAsset()
+{
+    PackedAsset asset;
+    asset.name = "measured/tape";
+    asset.kind = AssetKind::ShaperCurve;
+    asset.lower = -4.0f;
+    asset.upper = 4.0f;
+    asset.channels.assign(1, std::vector<float>(257));
+    for (std::size_t i = 0; i < 257; ++i)
+        asset.channels[0][i] = std::tanh(-4.0f + 8.0f * static_cast<float>(i) / 256.0f);
+    return asset;
+}
+
+std::vector<std::uint8_t> readFile(const std::string& path)
+{
+    std::vector<std::uint8_t> bytes(std::filesystem::file_size(path));
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file != nullptr) {
+        bytes.resize(std::fread(bytes.data(), 1, bytes.size(), file));
+        std::fclose(file);
+    }
+    return bytes;
+}
+
+void writeFile(const std::string& path, const std::vector<std::uint8_t>& bytes)
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file != nullptr) {
+        std::fwrite(bytes.data(), 1, bytes.size(), file);
+        std::fclose(file);
+    }
+}
+
+} // namespace
+
+VILLAIN_TEST(asset_pack_maps_assets_in_place)
+{
+    const std::vector<PackedAsset> assets = {cabinetAsset("cab/4x12", 48000.0, 5000), curveAsset(),
+                                             cabinetAsset("cab/tiny", 44100.0, 1)};
+    const std::string path = tempPath("villain_assets.vpak");
+    CHECK(writeAssetPack(path, assets));
+
+    AssetPack pack;
+    CHECK(pack.open(path));
+    CHECK(pack.numAssets() == 3);
+    for (int i = 0; i < pack.numAssets(); ++i) {
+        const AssetEntry& entry = pack.asset(i);
+        const PackedAsset& source = assets[static_cast<std::size_t>(i)];
+        CHECK(entry.name == source.name && entry.kind == source.kind);
+        CHECK(entry.numChannels == static_cast<int>(source.channels.size()));
+        CHECK(entry.numFrames == static_cast<int>(source.channels[0].size()));
+        CHECK(entry.sampleRate == source.sampleRate && entry.lower == source.lower && entry.upper == source.upper);
+        // Every payload starts on its own page, so faulting one never reads another.
+        CHECK(entry.offset % AssetPack::kPayloadAlignment == 0);
+        bool same = true;
+        for (int ch = 0; ch < entry.numChannels; ++ch)
+            for (int f = 0; f < entry.numFrames; ++f)
+                same = same && entry.channel(ch)[f] == source.channels[static_cast<std::size_t>(ch)][static_cast<std::size_t>(f)];
+        CHECK(same);
+    }
+
+    CHECK(pack.find("cab/4x12", AssetKind::ImpulseResponse) == &pack.asset(0));
+    CHECK(pack.find("measured/tape", AssetKind::ShaperCurve) == &pack.asset(1));
+    CHECK(pack.find("measured/tape", AssetKind::ImpulseResponse) == nullptr);
+    CHECK(pack.find("cab/missing", AssetKind::ImpulseResponse) == nullptr);
+
+    // A pack response is viewed where it lies, not copied.
+    const dsp::ImpulseResponseView view = dsp::impulseResponseAsset(pack.asset(0));
+    CHECK(view.channel(1) == pack.asset(0).channel(1) && view.numFrames == 5000 && view.sampleRate == 48000.0);
+
+    pack.prefetch(pack.asset(0));
+    pack.prefetch(pack.asset(1));
+    pack.waitForPrefetches();
+
+    pack = AssetPack();
+    std::remove(path.c_str());
+}
+
+VILLAIN_TEST(asset_pack_rejects_damaged_files)
+{
+    const std::string path = tempPath("villain_damaged.vpak");
+    CHECK(writeAssetPack(path, {cabinetAsset("cab/a", 48000.0, 300), curveAsset()}));
+    const std::vector<std::uint8_t> good = readFile(path);
+    AssetPack pack;
+    CHECK(pack.open(path));
+
+    const auto opensWith = [&](std::vector<std::uint8_t> bytes) {
+        writeFile(path, bytes);
+        AssetPack damaged;
+        const bool opened = damaged.open(path);
+        return opened || damaged.isOpen() || damaged.numAssets() != 0;
+    };
+    std::vector<std::uint8_t> bytes = good;
+    bytes[0] ^= 1;   // magic
+    CHECK(!opensWith(bytes));
+    bytes = good;
+    bytes[AssetPack::kHeaderSize + 60] ^= 1;   // channel count, caught by the index checksum
+    CHECK(!opensWith(bytes));
+    bytes = good;
+    bytes.resize(pack.asset(1).offset + pack.asset(1).byteSize() - 1);   // the last payload runs past the end
+    CHECK(!opensWith(bytes));
+    bytes.resize(AssetPack::kHeaderSize - 1);
+    CHECK(!opensWith(bytes));
+    CHECK(!pack.open(path + ".missing") && !pack.isOpen() && pack.numAssets() == 0);
+
+    // The writer refuses what the reader would.
+    PackedAsset ragged = cabinetAsset("cab/ragged", 48000.0, 64);
+    ragged.channels[1].pop_back();
+    CHECK(!writeAssetPack(path, {ragged}));
+    CHECK(!writeAssetPack(path, {cabinetAsset("", 48000.0, 64)}));
+    CHECK(!writeAssetPack(path, {cabinetAsset(std::string(AssetPack::kMaxNameLength + 1, 'x'), 48000.0, 64)}));
+    std::remove(path.c_str());
+}
+
+VILLAIN_TEST(asset_pack_is_shared_by_every_instance)
+{
+    const std::string path = tempPath("villain_shared.vpak");
+    const PackedAsset cabinet = cabinetAsset("cab/room", kTestSampleRate, 6000);
+    CHECK(writeAssetPack(path, {cabinet, cabinetAsset("cab/other", 44100.0, 2000)}));
+
+    Preset preset;
+    preset.parameters.driveDb = 12.0f;
+    preset.cabinet = "cab/room";
+
+    ProcessSpec spec;
+    spec.sampleRate = kTestSampleRate;
+    spec.maxBlockSize = 512;
+    std::vector<std::unique_ptr<VillainProcessor>> instances;
+    for (int i = 0; i < 3; ++i) {
+        instances.push_back(std::make_unique<VillainProcessor>());
+        instances.back()->prepare(spec);
+        CHECK(instances.back()->setAssetPack(path));
+    }
+    // One mapping for all of them.
+    CHECK(instances[0]->assetPack() == instances[1]->assetPack() && instances[1]->assetPack() == instances[2]->assetPack());
+    CHECK(SharedTable<AssetPack>::liveCount() == 1);
+    CHECK(!instances[0]->setAssetPack(path + ".missing") && instances[0]->assetPack() != nullptr);
+
+    // A preset that names the response renders like its values plus the same taps loaded
+    // as a file, once the chains have crossfaded to it.
+    CHECK(instances[0]->loadPreset(preset));
+    CHECK(instances[0]->hasImpulseResponse());
+    instances[0]->waitForChains();
+    CHECK(!instances[1]->loadCabinetAsset("cab/missing") && !instances[1]->hasImpulseResponse());
+
+    VillainProcessor reference;
+    reference.setParameters(preset.parameters);
+    reference.prepare(spec);
+    dsp::ImpulseResponse ir;
+    ir.sampleRate = cabinet.sampleRate;
+    ir.channels = cabinet.channels;
+    reference.setImpulseResponse(ir);
+
+    // The steady state: past the 10 ms fade and a full response length after it, the
+    // cabinet has heard nothing but the preset's chains.
+    constexpr int kFrames = 16384;
+    constexpr int kSteady = 8192;
+    Channels expected = stereoTestSignal(kFrames);
+    Channels actual = expected;
+    for (int pos = 0; pos < kFrames; pos += 512) {
+        reference.process(blockOf(expected, pos, 512));
+        instances[0]->process(blockOf(actual, pos, 512));
+    }
+    const auto steady = [](const Channels& channels) {
+        Channels result;
+        for (const std::vector<float>& channel : channels)
+            result.emplace_back(channel.begin() + kSteady, channel.end());
+        return result;
+    };
+    ctx.expectNull("pack preset vs file cabinet", steady(actual), steady(expected), 1e-5);
+
+    // A response at another rate is resampled for the session; the pack keeps the original.
+    CHECK(instances[2]->loadCabinetAsset("cab/other"));
+    Preset empty;
+    CHECK(instances[2]->loadPreset(empty) && !instances[2]->hasImpulseResponse());
+
+    instances.clear();
+    CHECK(SharedTable<AssetPack>::liveCount() == 0);
+    std::remove(path.c_str());
+}
+
+VILLAIN_TEST(asset_pack_curve_replaces_the_model)
+{
+    // Straight from (-1, -1) to (1, 1) and flat beyond: a measured hard clip.
+    PackedAsset hard;
+    hard.name = "measured/hard";
+    hard.kind = AssetKind::ShaperCurve;
+    hard.lower = -1.0f;
+    hard.upper = 1.0f;
+    hard.channels = {{-1.0f, 1.0f}};
+    PackedAsset broken = hard;
+    broken.name = "measured/broken";
+    broken.channels = {{-1.0f, std::nanf("")}};
+    const std::string path = tempPath("villain_curves.vpak");
+    CHECK(writeAssetPack(path, {hard, broken, curveAsset(), cabinetAsset("cab/room", kTestSampleRate, 64)}));
+
+    ProcessSpec spec;
+    spec.sampleRate = kTestSampleRate;
+    spec.maxBlockSize = 512;
+    for (dsp::Antialiasing antialiasing : {dsp::Antialiasing::Off, dsp::Antialiasing::SecondOrder}) {
+        for (int bands : {1, 3}) {
+            Parameters p;
+            p.driveDb = 12.0f;
+            p.numBands = bands;
+            p.antialiasing = antialiasing;
+            p.saturationModel = dsp::SaturationModel::SoftClip;
+            VillainProcessor measured;
+            measured.setParameters(p);
+            CHECK(measured.setAssetPack(path));
+            CHECK(measured.loadCurveAsset("measured/hard") && measured.curveAsset() == "measured/hard");
+            measured.prepare(spec);
+
+            p.saturationModel = dsp::SaturationModel::HardClip;
+            VillainProcessor model;
+            model.setParameters(p);
+            model.prepare(spec);
+
+            Channels expected = stereoTestSignal();
+            Channels actual = expected;
+            for (int pos = 0; pos < kTestFrames; pos += 512) {
+                model.process(blockOf(expected, pos, 512));
+                measured.process(blockOf(actual, pos, 512));
+            }
+            ctx.expectNull("hard clip curve, antialiasing " + std::to_string(static_cast<int>(antialiasing)) +
+                               ", bands " + std::to_string(bands),
+                           actual, expected, 1e-4);
+        }
+    }
+
+    // Only usable curves of that name are taken; the current one stays otherwise.
+    VillainProcessor processor;
+    processor.prepare(spec);
+    CHECK(!processor.loadCurveAsset("measured/hard"));
+    CHECK(processor.setAssetPack(path));
+    CHECK(processor.loadCurveAsset("measured/tape"));
+    CHECK(!processor.loadCurveAsset("measured/broken"));
+    CHECK(!processor.loadCurveAsset("cab/room"));
+    CHECK(processor.curveAsset() == "measured/tape");
+    processor.waitForChains();
+
+    // A curve a preset names is built into the preset's chains; none goes back to the model.
+    Preset preset;
+    preset.curve = "measured/hard";
+    CHECK(processor.loadPreset(preset) && processor.curveAsset() == "measured/hard");
+    preset.curve = "measured/missing";
+    CHECK(!processor.loadPreset(preset) && processor.curveAsset() == "measured/hard");
+    CHECK(processor.loadPreset(Preset()) && processor.curveAsset().empty());
+    processor.waitForChains();
+    std::remove(path.c_str());
+}
+
+VILLAIN_TEST(asset_pack_names_travel_with_the_state)
+{
+    const std::string path = tempPath("villain_state_assets.vpak");
+    CHECK(writeAssetPack(path, {cabinetAsset("cab/room", kTestSampleRate, 2000), curveAsset()}));
+
+    ProcessSpec spec;
+    spec.sampleRate = kTestSampleRate;
+    spec.maxBlockSize = 512;
+    VillainProcessor source;
+    source.prepare(spec);
+    CHECK(source.setAssetPack(path));
+    CHECK(source.loadCabinetAsset("cab/room") && source.loadCurveAsset("measured/tape"));
+    source.parameters().set(ParamId::Drive, 21.0f);
+
+    std::vector<std::uint8_t> blob(kMaxStateSize);
+    blob.resize(source.saveState(blob.data(), blob.size()));
+    CHECK(!blob.empty());
+
+    // A session reopened with the same pack gets its cabinet and curve back.
+    VillainProcessor restored;
+    restored.prepare(spec);
+    CHECK(restored.setAssetPack(path));
+    CHECK(restored.loadState(blob.data(), blob.size()));
+    CHECK(restored.cabinetAsset() == "cab/room" && restored.hasImpulseResponse());
+    CHECK(restored.curveAsset() == "measured/tape");
+    CHECK(restored.parameters().get(ParamId::Drive) == 21.0f);
+
+    // A parameter-only blob leaves the assets alone; a state saved without any clears them.
+    const std::vector<std::uint8_t> parametersOnly = saveState(source.parameters());
+    CHECK(restored.loadState(parametersOnly.data(), parametersOnly.size()));
+    CHECK(restored.cabinetAsset() == "cab/room" && restored.curveAsset() == "measured/tape");
+    VillainProcessor plain;
+    std::vector<std::uint8_t> plainBlob(kMaxStateSize);
+    plainBlob.resize(plain.saveState(plainBlob.data(), plainBlob.size()));
+    CHECK(restored.loadState(plainBlob.data(), plainBlob.size()));
+    CHECK(restored.cabinetAsset().empty() && !restored.hasImpulseResponse() && restored.curveAsset().empty());
+
+    source.waitForChains();
+    restored.waitForChains();
+    std::remove(path.c_str());
+}
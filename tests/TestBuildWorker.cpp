@@ -0,0 +1,82 @@
+#include "TestFramework.h"
+
+#include "core/BuildWorker.h"
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <string>
+#include <thread>
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+struct SlowBuild {
+    std::atomic<int> runs{0};
+    std::atomic<int> setting{0};
+    std::atomic<int> built{-1};
+    bool failFirst = false;
+
+    static void job(void* context)
+    {
+        auto& self = *static_cast<SlowBuild*>(context);
+        const int run = self.runs.fetch_add(1);
+        if (self.failFirst && run == 0)
+            throw std::bad_alloc();
+        const int setting = self.setting.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        self.built.store(setting);
+    }
+};
+
+} // namespace
+
+VILLAIN_TEST(build_worker_folds_requests_into_the_latest_build)
+{
+    BuildWorker worker;
+    SlowBuild build;
+    worker.wait();   // not running: returns at once
+    CHECK(!worker.isRunning() && !worker.isPending());
+
+    worker.start(&SlowBuild::job, &build);
+    for (int i = 1; i <= 20; ++i) {
+        build.setting.store(i);
+        worker.request();
+    }
+    worker.wait();
+    // However the requests were batched, the last build saw the last setting, and a slow
+    // job was not rerun once per request.
+    CHECK(!worker.isPending());
+    CHECK(build.built.load() == 20);
+    ctx.note("20 requests, " + std::to_string(build.runs.load()) + " builds");
+    CHECK(build.runs.load() >= 1 && build.runs.load() < 20);
+
+    const int runs = build.runs.load();
+    worker.request();
+    worker.wait();
+    CHECK(build.runs.load() == runs + 1);
+
+    worker.stop();
+    worker.request();
+    worker.wait();
+    CHECK(!worker.isRunning() && build.runs.load() == runs + 1);
+}
+
+VILLAIN_TEST(build_worker_survives_a_failed_build)
+{
+    BuildWorker worker;
+    SlowBuild build;
+    build.failFirst = true;
+    worker.start(&SlowBuild::job, &build);
+    build.setting.store(1);
+    worker.request();
+    worker.wait();
+    CHECK(build.runs.load() == 1 && build.built.load() == -1);
+
+    build.setting.store(2);
+    worker.request();
+    worker.wait();
+    CHECK(build.built.load() == 2);
+}
@@ -0,0 +1,270 @@
+#include "AllocationTracker.h"
+#include "TestFramework.h"
+#include "TestSignals.h"
+
+#include "dsp/Convolver.h"
+#include "dsp/Fft.h"
+#include "dsp/ImpulseResponse.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+// Decaying noise, so every partition carries energy and a misplaced one shows.
+dsp::ImpulseResponse decayingNoise(int numChannels, int length, std::uint32_t seed)
+{
+    dsp::ImpulseResponse ir;
+    ir.sampleRate = kTestSampleRate;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        std::vector<float> taps = sweepWithNoise(length, kTestSampleRate, seed + static_cast<std::uint32_t>(ch), 1.0f);
+        for (int i = 0; i < length; ++i)
+            taps[static_cast<std::size_t>(i)] *= std::exp(-3.0f * static_cast<float>(i) / static_cast<float>(length));
+        ir.channels.push_back(std::move(taps));
+    }
+    return ir;
+}
+
+Channels directConvolution(const Channels& input, const dsp::ImpulseResponse& ir)
+{
+    Channels output = input;
+    for (std::size_t ch = 0; ch < input.size(); ++ch) {
+        const std::vector<float>& taps = ir.channels[ch % ir.channels.size()];
+        for (std::size_t i = 0; i < input[ch].size(); ++i) {
+            double sum = 0.0;
+            for (std::size_t j = 0; j < taps.size() && j <= i; ++j)
+                sum += static_cast<double>(taps[j]) * input[ch][i - j];
+            output[ch][i] = static_cast<float>(sum);
+        }
+    }
+    return output;
+}
+
+void processInBlocks(dsp::Convolver& convolver, Channels& signal, int blockSize, int pauseMicroseconds = 0)
+{
+    const int frames = static_cast<int>(signal[0].size());
+    for (int pos = 0; pos < frames; pos += blockSize) {
+        convolver.process(blockOf(signal, pos, std::min(blockSize, frames - pos)));
+        if (pauseMicroseconds > 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(pauseMicroseconds));
+    }
+}
+
+void putU16(std::vector<std::uint8_t>& out, int v)
+{
+    out.push_back(static_cast<std::uint8_t>(v));
+    out.push_back(static_cast<std::uint8_t>(v >> 8));
+}
+
+void putU32(std::vector<std::uint8_t>& out, std::uint32_t v)
+{
+    for (int i = 0; i < 4; ++i)
+        out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+}
+
+// A WAV image with a junk chunk ahead of "fmt " and an odd-sized one between it and "data".
+std::vector<std::uint8_t> wavImage(int format, int channels, int bits, int rate, const std::vector<std::uint8_t>& samples)
+{
+    std::vector<std::uint8_t> wav = {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E', 'J', 'U', 'N', 'K'};
+    putU32(wav, 4);
+    putU32(wav, 0);
+    const bool extensible = format != 1 && bits == 24;
+    wav.insert(wav.end(), {'f', 'm', 't', ' '});
+    putU32(wav, extensible ? 40 : 16);
+    putU16(wav, extensible ? 0xfffe : format);
+    putU16(wav, channels);
+    putU32(wav, static_cast<std::uint32_t>(rate));
+    putU32(wav, static_cast<std::uint32_t>(rate * channels * bits / 8));
+    putU16(wav, channels * bits / 8);
+    putU16(wav, bits);
+    if (extensible) {
+        putU16(wav, 22);
+        putU16(wav, bits);
+        putU32(wav, 0);
+        putU16(wav, 1);   // sub-format: PCM
+        wav.insert(wav.end(), 14, 0);
+    }
+    wav.insert(wav.end(), {'L', 'I', 'S', 'T'});
+    putU32(wav, 3);
+    wav.insert(wav.end(), {1, 2, 3, 0});
+    wav.insert(wav.end(), {'d', 'a', 't', 'a'});
+    putU32(wav, static_cast<std::uint32_t>(samples.size()));
+    wav.insert(wav.end(), samples.begin(), samples.end());
+    const std::uint32_t riffSize = static_cast<std::uint32_t>(wav.size() - 8);
+    for (int i = 0; i < 4; ++i)
+        wav[4 + static_cast<std::size_t>(i)] = static_cast<std::uint8_t>(riffSize >> (8 * i));
+    return wav;
+}
+
+std::string writeTempFile(const std::string& name, const std::vector<std::uint8_t>& bytes)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file != nullptr) {
+        std::fwrite(bytes.data(), 1, bytes.size(), file);
+        std::fclose(file);
+    }
+    return path;
+}
+
+} // namespace
+
+VILLAIN_TEST(fft_matches_direct_transform)
+{
+    for (int size : {4, 16, 128, 2048}) {
+        dsp::RealFft fft;
+        fft.prepare(size);
+        const std::vector<float> input = sweepWithNoise(size, kTestSampleRate, 21u, 1.0f);
+        std::vector<float> re(static_cast<std::size_t>(fft.numBins()));
+        std::vector<float> im(static_cast<std::size_t>(fft.numBins()));
+        fft.forward(input.data(), re.data(), im.data());
+
+        Channels result = {re, im};
+        Channels reference = result;
+        for (int k = 0; k < fft.numBins(); ++k) {
+            double sumRe = 0.0;
+            double sumIm = 0.0;
+            for (int n = 0; n < size; ++n) {
+                const double angle = -2.0 * 3.14159265358979323846 * k * n / size;
+                sumRe += input[static_cast<std::size_t>(n)] * std::cos(angle);
+                sumIm += input[static_cast<std::size_t>(n)] * std::sin(angle);
+            }
+            reference[0][static_cast<std::size_t>(k)] = static_cast<float>(sumRe);
+            reference[1][static_cast<std::size_t>(k)] = static_cast<float>(sumIm);
+        }
+        ctx.expectNull("fft n=" + std::to_string(size), result, reference, 2e-6 * size);
+
+        // Unnormalised round trip.
+        std::vector<float> back(static_cast<std::size_t>(size));
+        fft.inverse(re.data(), im.data(), back.data());
+        for (float& x : back)
+            x /= static_cast<float>(size);
+        ctx.expectNull("fft round trip n=" + std::to_string(size), {back}, {input}, 1e-5);
+    }
+}
+
+VILLAIN_TEST(convolver_matches_direct_convolution)
+{
+    // Head only, head and body, and all three levels; stereo and mono responses. Float
+    // rounding grows with the number of taps summed, hence the length-scaled tolerance.
+    const Channels input = stereoTestSignal(6000, 0.5f);
+    for (int length : {40, 1500, 5000}) {
+        for (int irChannels : {1, 2}) {
+            const dsp::ImpulseResponse ir = decayingNoise(irChannels, length, 31u);
+            const Channels reference = directConvolution(input, ir);
+            for (int blockSize : {1, 97, 512}) {
+                dsp::Convolver convolver;
+                convolver.prepare(ir, 2, false);
+                Channels output = input;
+                {
+                    ScopedAllocationCounter allocations;
+                    processInBlocks(convolver, output, blockSize);
+                    CHECK(allocations.count() == 0);
+                }
+                ctx.expectNull("convolver len=" + std::to_string(length) + " ir ch=" + std::to_string(irChannels) +
+                                   " bs=" + std::to_string(blockSize),
+                               output, reference, 2e-8 * length + 1e-6);
+            }
+        }
+    }
+}
+
+VILLAIN_TEST(convolver_background_tail_matches_inline)
+{
+    const dsp::ImpulseResponse ir = decayingNoise(2, 7000, 41u);
+    const Channels input = stereoTestSignal(12288, 0.5f);
+
+    dsp::Convolver inlineTail;
+    inlineTail.prepare(ir, 2, false);
+    dsp::Convolver background;
+    background.prepare(ir, 2, true);
+    CHECK(!inlineTail.hasBackgroundTail());
+    CHECK(background.hasBackgroundTail());
+
+    // Paced like a real-time stream, so the worker always has time to finish; a reset part
+    // way through must restart both the same way.
+    Channels expected = input;
+    Channels output = input;
+    for (int pass = 0; pass < 2; ++pass) {
+        processInBlocks(inlineTail, expected, 256);
+        processInBlocks(background, output, 256, 1000);
+        ctx.expectNull("background tail pass " + std::to_string(pass), output, expected, 0.0);
+        inlineTail.reset();
+        background.reset();
+        expected = input;
+        output = input;
+    }
+    CHECK(background.tailUnderruns() == 0);
+}
+
+VILLAIN_TEST(impulse_response_decodes_wav_through_a_mapping)
+{
+    // 16-bit stereo: full scale negative, half, and a small negative value.
+    const std::vector<std::uint8_t> pcm16 = {0x00, 0x80, 0x00, 0x40, 0xff, 0xff, 0x01, 0x00};
+    dsp::ImpulseResponse ir;
+    const std::string path16 = writeTempFile("villain_ir16.wav", wavImage(1, 2, 16, 44100, pcm16));
+    CHECK(dsp::loadImpulseResponse(path16, ir));
+    CHECK(ir.numChannels() == 2 && ir.numFrames() == 2 && ir.sampleRate == 44100.0);
+    CHECK(ir.channels[0][0] == -1.0f && ir.channels[1][0] == 0.5f);
+    CHECK(ir.channels[0][1] == -1.0f / 32768.0f && ir.channels[1][1] == 1.0f / 32768.0f);
+
+    // 24-bit mono behind an extensible header.
+    const std::vector<std::uint8_t> pcm24 = {0x00, 0x00, 0x40, 0x00, 0x00, 0xc0};
+    const std::string path24 = writeTempFile("villain_ir24.wav", wavImage(1, 1, 24, 48000, pcm24));
+    CHECK(dsp::loadImpulseResponse(path24, ir));
+    CHECK(ir.numChannels() == 1 && ir.numFrames() == 2);
+    CHECK(ir.channels[0][0] == 0.5f && ir.channels[0][1] == -0.5f);
+
+    // 32-bit float.
+    const float values[2] = {0.25f, -0.75f};
+    std::vector<std::uint8_t> f32(sizeof(values));
+    std::memcpy(f32.data(), values, sizeof(values));
+    CHECK(dsp::decodeWav(wavImage(3, 1, 32, 96000, f32).data(), wavImage(3, 1, 32, 96000, f32).size(), ir));
+    CHECK(ir.channels[0][0] == 0.25f && ir.channels[0][1] == -0.75f && ir.sampleRate == 96000.0);
+
+    // Unsupported or broken files leave the response alone.
+    CHECK(!dsp::decodeWav(wavImage(1, 1, 8, 48000, {0x80}).data(), wavImage(1, 1, 8, 48000, {0x80}).size(), ir));
+    CHECK(!dsp::decodeWav(pcm16.data(), pcm16.size(), ir));
+    CHECK(!dsp::loadImpulseResponse(path16 + ".missing", ir));
+    CHECK(ir.sampleRate == 96000.0);
+
+    std::remove(path16.c_str());
+    std::remove(path24.c_str());
+}
+
+VILLAIN_TEST(impulse_response_resampling_keeps_its_response)
+{
+    // A smooth low-pass response: its DC gain and its shape over time survive 44.1 -> 48 kHz.
+    dsp::ImpulseResponse ir;
+    ir.sampleRate = 44100.0;
+    ir.channels.assign(1, std::vector<float>(2000));
+    for (int i = 0; i < 2000; ++i)
+        ir.channels[0][static_cast<std::size_t>(i)] = 0.01f * std::exp(-static_cast<float>(i) / 200.0f);
+
+    const dsp::ImpulseResponse resampled = dsp::resample(ir, 48000.0);
+    CHECK(resampled.sampleRate == 48000.0);
+    CHECK(resampled.numFrames() == static_cast<int>(std::ceil(2000 * 48000.0 / 44100.0)));
+
+    double inSum = 0.0;
+    double outSum = 0.0;
+    for (float x : ir.channels[0])
+        inSum += x;
+    for (float x : resampled.channels[0])
+        outSum += x;
+    CHECK(std::fabs(outSum / inSum - 1.0) < 1e-3);
+
+    // Half-way down the decay, at the same instant.
+    const double at = 0.01 * std::exp(-(1000.0 / 44100.0) * 44100.0 / 200.0) * 44100.0 / 48000.0;
+    const float value = resampled.channels[0][static_cast<std::size_t>(std::lround(1000.0 * 48000.0 / 44100.0))];
+    CHECK(std::fabs(value - at) < 0.02 * at);
+}
@@ -0,0 +1,149 @@
+#include "AllocationTracker.h"
+#include "TestFramework.h"
+#include "TestSignals.h"
+
+#include "dsp/Biquad.h"
+#include "dsp/Crossover.h"
+#include "dsp/Gain.h"
+#include "dsp/MultibandSaturator.h"
+
+#include <string>
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+constexpr double kSampleRate = kTestSampleRate;
+constexpr float kLowHz = 120.0f;
+constexpr float kHighHz = 6000.0f;
+
+// Float sections at a low split round differently from a lone allpass; this is about -66 dB
+// at the levels used here, far below any phase or level error a wrong design would leave.
+constexpr double kCoherenceTolerance = 5e-4;
+
+// What a coherent crossover sums to: one second-order allpass per split, in series.
+Channels allPassCascade(const Channels& input, int numBands)
+{
+    float frequencies[dsp::kMaxBands] = {};
+    dsp::MultibandSaturator::splitFrequencies(numBands, kLowHz, kHighHz, frequencies);
+
+    Channels output = input;
+    for (int split = 0; split < numBands - 1; ++split) {
+        dsp::Biquad allPass;
+        allPass.setCoefficients(dsp::BiquadCoefficients::allPass(kSampleRate, frequencies[split], 0.70710678));
+        allPass.process(blockOf(output));
+    }
+    return output;
+}
+
+} // namespace
+
+VILLAIN_TEST(crossover_bands_sum_to_allpass)
+{
+    const std::vector<float> input = sweepWithNoise(kTestFrames, kSampleRate, 11u, 0.5f);
+    std::vector<float> lanes(static_cast<std::size_t>(kTestFrames) * simd::kCrossoverLanes);
+
+    for (int numBands = 2; numBands <= dsp::kMaxBands; ++numBands) {
+        float frequencies[dsp::kMaxBands] = {};
+        dsp::MultibandSaturator::splitFrequencies(numBands, kLowHz, kHighHz, frequencies);
+
+        dsp::Crossover crossover;
+        crossover.prepare(1);
+        crossover.setBands(kSampleRate, numBands, frequencies);
+        // Split unevenly so the carried state crosses vector boundaries.
+        crossover.split(0, input.data(), lanes.data(), 333);
+        crossover.split(0, input.data() + 333, lanes.data() + 333 * simd::kCrossoverLanes, kTestFrames - 333);
+
+        Channels summed = {std::vector<float>(static_cast<std::size_t>(kTestFrames))};
+        bool unusedLanesSilent = true;
+        for (int i = 0; i < kTestFrames; ++i) {
+            const float* frame = lanes.data() + static_cast<std::size_t>(i) * simd::kCrossoverLanes;
+            for (int lane = 0; lane < simd::kCrossoverLanes; ++lane) {
+                if (lane < numBands)
+                    summed[0][static_cast<std::size_t>(i)] += frame[lane];
+                else
+                    unusedLanesSilent = unusedLanesSilent && frame[lane] == 0.0f;
+            }
+        }
+        CHECK(unusedLanesSilent);
+        ctx.expectNull(std::to_string(numBands) + " band sum", summed, allPassCascade({input}, numBands),
+                       kCoherenceTolerance);
+    }
+}
+
+VILLAIN_TEST(crossover_band_count_change_keeps_running_bands)
+{
+    // Dropping the top split leaves every remaining band's leading sections as they were, so
+    // with their state kept the three bands carry on exactly as a three-band crossover that
+    // ran all along; a restart from silence would cut them off mid-signal.
+    constexpr int kChange = 1024;
+    const std::vector<float> input = sweepWithNoise(kTestFrames, kSampleRate, 17u, 0.5f);
+    std::vector<float> lanes(static_cast<std::size_t>(kTestFrames) * simd::kCrossoverLanes);
+    std::vector<float> reference(lanes.size());
+    const float frequencies[dsp::kMaxBands] = {kLowHz, 1000.0f, kHighHz};
+
+    dsp::Crossover crossover;
+    crossover.prepare(1);
+    crossover.setBands(kSampleRate, 4, frequencies);
+    crossover.split(0, input.data(), lanes.data(), kChange);
+    {
+        ScopedAllocationCounter allocations;
+        crossover.setBands(kSampleRate, 3, frequencies);
+        CHECK(allocations.count() == 0);
+    }
+    crossover.split(0, input.data() + kChange, lanes.data() + kChange * simd::kCrossoverLanes, kTestFrames - kChange);
+
+    dsp::Crossover threeBands;
+    threeBands.prepare(1);
+    threeBands.setBands(kSampleRate, 3, frequencies);
+    threeBands.split(0, input.data(), reference.data(), kTestFrames);
+
+    Channels bands(3, std::vector<float>(static_cast<std::size_t>(kTestFrames - kChange)));
+    Channels expected = bands;
+    bool droppedLaneSilent = true;
+    for (int i = kChange; i < kTestFrames; ++i) {
+        const std::size_t frame = static_cast<std::size_t>(i) * simd::kCrossoverLanes;
+        for (std::size_t band = 0; band < 3; ++band) {
+            bands[band][static_cast<std::size_t>(i - kChange)] = lanes[frame + band];
+            expected[band][static_cast<std::size_t>(i - kChange)] = reference[frame + band];
+        }
+        droppedLaneSilent = droppedLaneSilent && lanes[frame + 3] == 0.0f;
+    }
+    CHECK(droppedLaneSilent);
+    ctx.expectNull("bands after dropping one", bands, expected, 1e-6);
+}
+
+VILLAIN_TEST(multiband_equal_drive_stays_phase_coherent)
+{
+    // Hard clip is exactly linear below its knee, so at this level the only thing between
+    // input and output is the crossover and the band drive.
+    const Channels input = {sweepWithNoise(kTestFrames, kSampleRate, 5u, 0.2f),
+                            sweepWithNoise(kTestFrames, kSampleRate, 6u, 0.2f)};
+
+    for (int numBands = 2; numBands <= dsp::kMaxBands; ++numBands) {
+        dsp::MultibandSaturator multiband;
+        multiband.prepare(2);
+        multiband.setSampleRate(kSampleRate);
+        multiband.setModel(dsp::SaturationModel::HardClip);
+        multiband.setBands(numBands, kLowHz, kHighHz);
+        for (int band = 0; band < numBands; ++band)
+            multiband.setBandDriveDecibels(band, -6.0f);
+        multiband.reset();
+
+        Channels output = input;
+        {
+            ScopedAllocationCounter allocations;
+            for (int pos = 0; pos < kTestFrames; pos += 512)
+                multiband.process(blockOf(output, pos, std::min(512, kTestFrames - pos)));
+            CHECK(allocations.count() == 0);
+        }
+
+        Channels expected = allPassCascade(input, numBands);
+        const float gain = dsp::decibelsToGain(-6.0f);
+        for (auto& channel : expected)
+            for (float& x : channel)
+                x *= gain;
+        ctx.expectNull(std::to_string(numBands) + " band drive -6 dB", output, expected, kCoherenceTolerance);
+    }
+}
@@ -0,0 +1,282 @@
+#include "TestFramework.h"
+#include "TestSignals.h"
+
+#include "core/ScopedNoDenormals.h"
+#include "dsp/Biquad.h"
+#include "dsp/DelayLine.h"
+#include "dsp/Gain.h"
+#include "dsp/Saturator.h"
+#include "dsp/SmoothedValue.h"
+#include "dsp/TailDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+// Cross-ISA differences stay well below these; anything larger is a real change. Recursive
+// filters get more room because each instruction set unrolls them differently and the
+// feedback amplifies the rounding.
+constexpr double kGoldenTolerance = 1e-5;
+constexpr double kRecursiveGoldenTolerance = 1e-4;
+
+// Hard clip's antiderivatives, exact; zero at zero like the tabulated ones.
+long double hardClipFirst(long double x)
+{
+    const long double a = std::fabs(x);
+    return a <= 1.0L ? x * x / 2.0L : a - 0.5L;
+}
+
+long double hardClipSecond(long double x)
+{
+    if (x > 1.0L)
+        return x * x / 2.0L - x / 2.0L + 1.0L / 6.0L;
+    if (x < -1.0L)
+        return -(x * x / 2.0L + x / 2.0L + 1.0L / 6.0L);
+    return x * x * x / 6.0L;
+}
+
+// Textbook ADAA of hard clip in long double, starting from silence.
+std::vector<float> hardClipAntialiased(const std::vector<float>& input, int order)
+{
+    const auto slope = [](long double (*antiderivative)(long double), long double a, long double b,
+                          long double (*fallback)(long double)) {
+        return std::fabs(a - b) < 1e-12L ? fallback((a + b) / 2.0L) : (antiderivative(a) - antiderivative(b)) / (a - b);
+    };
+    const auto clip = [](long double x) { return std::clamp(x, -1.0L, 1.0L); };
+
+    std::vector<float> out(input.size());
+    long double x1 = 0.0L;
+    long double x2 = 0.0L;
+    for (std::size_t i = 0; i < input.size(); ++i) {
+        const long double x0 = input[i];
+        long double y = 0.0L;
+        if (order == 1) {
+            y = slope(hardClipFirst, x0, x1, clip);
+        } else if (std::fabs(x0 - x2) < 1e-12L) {
+            // Limit of the divided difference as x0 -> x2.
+            const long double delta = x0 - x1;
+            y = std::fabs(delta) < 1e-12L ? clip(x0)
+                                          : 2.0L * (hardClipFirst(x0) - slope(hardClipSecond, x0, x1, hardClipFirst)) / delta;
+        } else {
+            y = 2.0L * (slope(hardClipSecond, x0, x1, hardClipFirst) - slope(hardClipSecond, x1, x2, hardClipFirst)) /
+                (x0 - x2);
+        }
+        out[i] = static_cast<float>(y);
+        x2 = x1;
+        x1 = x0;
+    }
+    return out;
+}
+
+// Share of a periodic signal's power that is not at a multiple of its fundamental, in dB.
+// The signal holds a whole number of `periods`, so every harmonic lands on its own bin.
+double inharmonicPowerDb(const std::vector<float>& x, int periods)
+{
+    constexpr double kTwoPi = 6.283185307179586;
+    const int n = static_cast<int>(x.size());
+    double total = 0.0;
+    for (float v : x)
+        total += static_cast<double>(v) * v;
+
+    double harmonic = 0.0;
+    for (int bin = 0; 2 * bin <= n; bin += periods) {
+        double re = 0.0;
+        double im = 0.0;
+        for (int i = 0; i < n; ++i) {
+            const double phase = kTwoPi * static_cast<double>((static_cast<long long>(bin) * i) % n) / n;
+            re += x[static_cast<std::size_t>(i)] * std::cos(phase);
+            im -= x[static_cast<std::size_t>(i)] * std::sin(phase);
+        }
+        harmonic += (bin == 0 || 2 * bin == n ? 1.0 : 2.0) * (re * re + im * im) / n;
+    }
+    return 10.0 * std::log10((total - harmonic) / total);
+}
+
+} // namespace
+
+VILLAIN_TEST(dsp_gain_stage_golden)
+{
+    Channels signal = stereoTestSignal();
+    dsp::GainStage gain;
+    gain.prepare(kTestSampleRate, 0.01);
+    gain.setGainDecibels(-6.0f);
+    gain.snapToTarget();
+    gain.setGainDecibels(12.0f);
+    gain.process(blockOf(signal));
+    ctx.expectGolden("dsp_gain_stage", signal, kGoldenTolerance);
+}
+
+VILLAIN_TEST(dsp_gain_stage_reaches_target)
+{
+    Channels signal = {std::vector<float>(1000, 1.0f)};
+    dsp::GainStage gain;
+    gain.prepare(kTestSampleRate, 0.01);
+    gain.setGainLinear(0.5f);
+    gain.process(blockOf(signal));
+    CHECK(!gain.isSmoothing());
+    CHECK(signal[0][0] == 1.0f);
+    CHECK(signal[0][999] == 0.5f);
+    CHECK(std::fabs(signal[0][240] - 0.75f) < 1e-3f);
+}
+
+VILLAIN_TEST(dsp_saturation_golden)
+{
+    const char* names[dsp::kNumSaturationModels] = {"dsp_saturation_softclip", "dsp_saturation_hardclip",
+                                                    "dsp_saturation_tube"};
+    for (int model = 0; model < dsp::kNumSaturationModels; ++model) {
+        Channels signal = stereoTestSignal(kTestFrames, 2.0f);
+        dsp::Saturator saturator;
+        saturator.setModel(static_cast<dsp::SaturationModel>(model));
+        saturator.process(blockOf(signal));
+        ctx.expectGolden(names[model], signal, kGoldenTolerance);
+    }
+}
+
+VILLAIN_TEST(dsp_saturation_silence_stays_silent)
+{
+    for (int model = 0; model < dsp::kNumSaturationModels; ++model) {
+        for (int mode = 0; mode < dsp::kNumAntialiasingModes; ++mode) {
+            Channels signal = {std::vector<float>(64, 0.0f)};
+            dsp::Saturator saturator;
+            saturator.prepare(1);
+            saturator.setModel(static_cast<dsp::SaturationModel>(model));
+            saturator.setAntialiasing(static_cast<dsp::Antialiasing>(mode));
+            saturator.process(blockOf(signal));
+            ctx.expectNull("model " + std::to_string(model) + " adaa " + std::to_string(mode), signal,
+                           {std::vector<float>(64, 0.0f)}, 1e-7);
+        }
+    }
+}
+
+VILLAIN_TEST(dsp_antialiased_saturation_matches_exact_antiderivatives)
+{
+    // Crosses the knee at every slope, including turning points right at it.
+    const std::vector<float> input = sweepWithNoise(kTestFrames, kTestSampleRate, 3u, 2.0f);
+    const double tolerance[] = {1e-6, 1e-4};
+    for (int order = 1; order <= 2; ++order) {
+        dsp::Saturator saturator;
+        saturator.prepare(1);
+        saturator.setModel(dsp::SaturationModel::HardClip);
+        saturator.setAntialiasing(static_cast<dsp::Antialiasing>(order));
+        saturator.reset();
+
+        Channels output = {input};
+        for (int pos = 0; pos < kTestFrames; pos += 333)
+            saturator.process(blockOf(output, pos, std::min(333, kTestFrames - pos)));
+        ctx.expectNull("order " + std::to_string(order), output, {hardClipAntialiased(input, order)},
+                       tolerance[order - 1]);
+    }
+}
+
+VILLAIN_TEST(dsp_antialiasing_reduces_aliasing)
+{
+    // 4010 Hz driven 12 dB into hard clip with no oversampling: most of its harmonics fold.
+    constexpr int kLength = 4800;
+    constexpr int kPeriods = 401;
+    double inharmonic[dsp::kNumAntialiasingModes] = {};
+    for (int mode = 0; mode < dsp::kNumAntialiasingModes; ++mode) {
+        dsp::Saturator saturator;
+        saturator.prepare(1);
+        saturator.setModel(dsp::SaturationModel::HardClip);
+        saturator.setAntialiasing(static_cast<dsp::Antialiasing>(mode));
+
+        // The second pass starts from the first pass's history, as a steady state.
+        Channels signal = {sine(kLength, kTestSampleRate * kPeriods / kLength, kTestSampleRate, 4.0f)};
+        Channels settled = signal;
+        saturator.process(blockOf(signal));
+        saturator.process(blockOf(settled));
+        inharmonic[mode] = inharmonicPowerDb(settled[0], kPeriods);
+        ctx.note("adaa " + std::to_string(mode) + ": aliasing " + std::to_string(inharmonic[mode]) + " dB");
+    }
+    CHECK(inharmonic[1] < inharmonic[0] - 5.0);
+    CHECK(inharmonic[2] < inharmonic[1] - 5.0);
+}
+
+VILLAIN_TEST(dsp_biquad_golden)
+{
+    Channels signal = stereoTestSignal();
+    dsp::Biquad biquad;
+    biquad.setCoefficients(dsp::BiquadCoefficients::lowPass(kTestSampleRate, 3000.0, 0.7071));
+    biquad.process(blockOf(signal, 0, 1000));
+    biquad.process(blockOf(signal, 1000, kTestFrames - 1000));
+    ctx.expectGolden("dsp_biquad_lowpass", signal, kRecursiveGoldenTolerance);
+
+    Channels highPassed = stereoTestSignal();
+    biquad.reset();
+    biquad.setCoefficients(dsp::BiquadCoefficients::highPass(kTestSampleRate, 500.0, 0.7071));
+    biquad.process(blockOf(highPassed));
+    ctx.expectGolden("dsp_biquad_highpass", highPassed, kRecursiveGoldenTolerance);
+}
+
+VILLAIN_TEST(dsp_delay_line_null)
+{
+    constexpr int kDelay = 37;
+    const Channels input = stereoTestSignal();
+    Channels delayed = input;
+
+    dsp::DelayLine delay;
+    delay.prepare(2, 256, 64);
+    delay.setDelay(kDelay);
+    for (int pos = 0; pos < kTestFrames; pos += 256)
+        delay.process(blockOf(delayed, pos, std::min(256, kTestFrames - pos)));
+
+    Channels expected = input;
+    for (auto& channel : expected) {
+        channel.insert(channel.begin(), kDelay, 0.0f);
+        channel.resize(kTestFrames);
+    }
+    ctx.expectNull("delay 37", delayed, expected, 0.0);
+}
+
+VILLAIN_TEST(dsp_smoothed_value_segments)
+{
+    dsp::SmoothedValue value(0.0f);
+    value.prepare(1000.0, 0.1);
+    value.setTarget(1.0f);
+
+    const dsp::SmoothedValue::Segment first = value.next(40);
+    CHECK(first.length == 40);
+    CHECK(first.start == 0.0f);
+    CHECK(std::fabs(first.step - 0.01f) < 1e-7f);
+
+    const dsp::SmoothedValue::Segment second = value.next(200);
+    CHECK(second.length == 60);
+    CHECK(!value.isSmoothing());
+    CHECK(value.current() == 1.0f);
+
+    const dsp::SmoothedValue::Segment hold = value.next(200);
+    CHECK(hold.length == 200);
+    CHECK(hold.step == 0.0f);
+}
+
+VILLAIN_TEST(dsp_no_denormals_scope_flushes_and_restores)
+{
+#if defined(VILLAIN_HAS_MXCSR) || defined(__aarch64__)
+    volatile float tiny = 1.0e-38f;
+    volatile float scale = 0.01f;
+    {
+        ScopedNoDenormals noDenormals;
+        CHECK(tiny * scale == 0.0f);
+    }
+    CHECK(tiny * scale != 0.0f);
+#else
+    CHECK(true);
+#endif
+}
+
+VILLAIN_TEST(dsp_tail_detector_waits_for_hold)
+{
+    dsp::TailDetector tail;
+    tail.setHoldSamples(1000);
+    CHECK(!tail.observe(true, 0.0f, 600));
+    CHECK(!tail.observe(true, 0.5f, 600)); // output still ringing restarts the count
+    CHECK(!tail.observe(true, 0.0f, 600));
+    CHECK(tail.observe(true, 0.0f, 600));
+    CHECK(tail.isIdle());
+    tail.wake();
+    CHECK(!tail.isIdle());
+}
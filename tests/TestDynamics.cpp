@@ -0,0 +1,186 @@
+#include "AllocationTracker.h"
+#include "TestFramework.h"
+#include "TestSignals.h"
+
+#include "dsp/Dynamics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+constexpr int kLookahead = 96;
+
+// Loud, bursty material: a sweep with noise under a gate that opens and closes every few
+// hundred samples, so the limiter keeps attacking and releasing.
+Channels burstySignal()
+{
+    Channels signal = {sweepWithNoise(kTestFrames, kTestSampleRate, 3u, 1.5f),
+                       sweepWithNoise(kTestFrames, kTestSampleRate, 4u, 1.5f)};
+    for (int i = 0; i < kTestFrames; ++i) {
+        const float gate = (i / 300) % 3 == 1 ? 0.05f : 1.0f;
+        signal[0][static_cast<std::size_t>(i)] *= gate;
+        signal[1][static_cast<std::size_t>(i)] *= gate;
+    }
+    return signal;
+}
+
+void processInBlocks(dsp::Dynamics& dynamics, Channels& signal, int blockSize)
+{
+    const int frames = static_cast<int>(signal[0].size());
+    for (int pos = 0; pos < frames; pos += blockSize)
+        dynamics.process(blockOf(signal, pos, std::min(blockSize, frames - pos)));
+}
+
+// The limiter written out the slow way: brute-force window maximum, exact gain curve,
+// instant attack, one-pole release and a plain moving average.
+Channels referenceLimiter(const Channels& input, float thresholdDb, float releaseSeconds)
+{
+    const int frames = static_cast<int>(input[0].size());
+    const double threshold = std::pow(10.0, thresholdDb / 20.0);
+    const double release = std::exp(-1.0 / (releaseSeconds * kTestSampleRate));
+
+    std::vector<double> smoothed(static_cast<std::size_t>(frames));
+    double g = 1.0;
+    for (int i = 0; i < frames; ++i) {
+        double peak = 0.0;
+        for (int j = std::max(0, i - kLookahead); j <= i; ++j)
+            for (const std::vector<float>& channel : input)
+                peak = std::max(peak, static_cast<double>(std::fabs(channel[static_cast<std::size_t>(j)])));
+        const double target = peak > threshold ? threshold / peak : 1.0;
+        g = target < g ? target : target + release * (g - target);
+        smoothed[static_cast<std::size_t>(i)] = g;
+    }
+
+    Channels output = input;
+    for (int i = 0; i < frames; ++i) {
+        double sum = 0.0;
+        for (int j = i - kLookahead; j <= i; ++j)
+            sum += j < 0 ? 1.0 : smoothed[static_cast<std::size_t>(j)];
+        const int source = i - kLookahead;
+        for (std::size_t ch = 0; ch < input.size(); ++ch)
+            output[ch][static_cast<std::size_t>(i)] =
+                source < 0 ? 0.0f : static_cast<float>(input[ch][static_cast<std::size_t>(source)] * sum / (kLookahead + 1));
+    }
+    return output;
+}
+
+} // namespace
+
+VILLAIN_TEST(dynamics_limiter_matches_reference_at_any_block_size)
+{
+    const Channels input = burstySignal();
+    const Channels reference = referenceLimiter(input, -6.0f, 0.02f);
+
+    for (int blockSize : {1, 97, 256, 1000}) {
+        dsp::Dynamics limiter;
+        limiter.prepare(kTestSampleRate, 2, 1000);
+        limiter.setMode(dsp::DynamicsMode::Limiter);
+        limiter.setThresholdDecibels(-6.0f);
+        limiter.setReleaseSeconds(0.02f);
+        limiter.setLookaheadSamples(kLookahead);
+        CHECK(limiter.latencySamples() == kLookahead);
+
+        Channels output = input;
+        {
+            ScopedAllocationCounter allocations;
+            processInBlocks(limiter, output, blockSize);
+            CHECK(allocations.count() == 0);
+        }
+        // The vector log/exp pair is good to a few parts per million.
+        ctx.expectNull("limiter bs=" + std::to_string(blockSize), output, reference, 2e-5);
+    }
+}
+
+VILLAIN_TEST(dynamics_limiter_holds_its_ceiling)
+{
+    const float ceiling = std::pow(10.0f, -3.0f / 20.0f);
+    for (int lookahead : {0, kLookahead}) {
+        dsp::Dynamics limiter;
+        limiter.prepare(kTestSampleRate, 2, 512);
+        limiter.setMode(dsp::DynamicsMode::Limiter);
+        limiter.setThresholdDecibels(-3.0f);
+        limiter.setLookaheadSamples(lookahead);
+
+        Channels signal = burstySignal();
+        processInBlocks(limiter, signal, 512);
+        float peak = 0.0f;
+        for (const std::vector<float>& channel : signal)
+            for (float sample : channel)
+                peak = std::max(peak, std::fabs(sample));
+        CHECK(peak <= ceiling * 1.0001f);
+        CHECK(peak > ceiling * 0.9f);
+    }
+}
+
+VILLAIN_TEST(dynamics_compressor_settles_on_its_curve)
+{
+    // A constant level above the knee: 4:1 from -20 dB turns -6 dB into -16.5 dB.
+    dsp::Dynamics compressor;
+    compressor.prepare(kTestSampleRate, 1, 512);
+    compressor.setMode(dsp::DynamicsMode::Compressor);
+    compressor.setThresholdDecibels(-20.0f);
+    compressor.setRatio(4.0f);
+    compressor.setAttackSeconds(0.001f);
+
+    Channels signal = {std::vector<float>(static_cast<std::size_t>(kTestFrames), 0.5f)};
+    processInBlocks(compressor, signal, 512);
+
+    const double inputDb = 20.0 * std::log10(0.5);
+    const double expectedDb = -20.0 + (inputDb + 20.0) / 4.0;
+    const double outputDb = 20.0 * std::log10(signal[0].back());
+    CHECK(std::fabs(outputDb - expectedDb) < 1e-3);
+
+    // Below the knee nothing is touched, and without lookahead nothing is delayed.
+    dsp::Dynamics quiet;
+    quiet.prepare(kTestSampleRate, 2, 512);
+    quiet.setMode(dsp::DynamicsMode::Compressor);
+    quiet.setThresholdDecibels(0.0f);
+    const Channels input = stereoTestSignal(kTestFrames, 0.25f);
+    Channels output = input;
+    processInBlocks(quiet, output, 512);
+    ctx.expectNull("compressor below knee", output, input, 0.0);
+}
+
+VILLAIN_TEST(dynamics_detects_on_sidechain_key)
+{
+    // A quiet signal under a loud key: the key alone sets the gain, and is only read.
+    dsp::Dynamics keyed;
+    keyed.prepare(kTestSampleRate, 2, 512);
+    keyed.setMode(dsp::DynamicsMode::Compressor);
+    keyed.setThresholdDecibels(-20.0f);
+    keyed.setRatio(4.0f);
+    keyed.setAttackSeconds(0.001f);
+
+    const Channels input = stereoTestSignal(kTestFrames, 0.05f);
+    Channels key = {std::vector<float>(static_cast<std::size_t>(kTestFrames), 0.5f)};
+    const Channels keyBefore = key;
+    Channels output = input;
+    for (int pos = 0; pos < kTestFrames; pos += 512) {
+        const int length = std::min(512, kTestFrames - pos);
+        keyed.process(blockOf(output, pos, length), blockOf(key, pos, length));
+    }
+    ctx.expectNull("key untouched", key, keyBefore, 0.0);
+
+    const double keyDb = 20.0 * std::log10(0.5);
+    const double expectedGainDb = (-20.0 + (keyDb + 20.0) / 4.0) - keyDb;
+    CHECK(std::fabs(20.0 * std::log10(keyed.currentGain()) - expectedGainDb) < 1e-3);
+
+    // A silent key leaves even a loud signal alone.
+    dsp::Dynamics silent;
+    silent.prepare(kTestSampleRate, 2, 512);
+    silent.setMode(dsp::DynamicsMode::Compressor);
+    silent.setThresholdDecibels(-20.0f);
+    const Channels loud = stereoTestSignal(kTestFrames, 0.9f);
+    Channels unkeyed = loud;
+    Channels quietKey = {std::vector<float>(static_cast<std::size_t>(kTestFrames), 0.0f)};
+    for (int pos = 0; pos < kTestFrames; pos += 512) {
+        const int length = std::min(512, kTestFrames - pos);
+        silent.process(blockOf(unkeyed, pos, length), blockOf(quietKey, pos, length));
+    }
+    ctx.expectNull("silent key", unkeyed, loud, 0.0);
+}
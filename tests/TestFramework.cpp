@@ -0,0 +1,138 @@
+#include "TestFramework.h"
+
+#include "GoldenFile.h"
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace villain::test {
+
+namespace {
+
+std::string formatComparison(const std::string& label, const Comparison& c, double tolerance)
+{
+    char line[256];
+    if (c.sizeMismatch) {
+        std::snprintf(line, sizeof(line), "%s: size mismatch", label.c_str());
+    } else {
+        std::snprintf(line, sizeof(line), "%s: max_abs=%.3g rms=%.3g null=%.1f dB tol=%.3g%s", label.c_str(),
+                      c.maxAbsError, c.rmsError, c.nullDepthDb, tolerance, c.bitExact ? " bit-exact" : "");
+    }
+    return line;
+}
+
+} // namespace
+
+std::vector<TestCase>& registry()
+{
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+Comparison compare(const Channels& result, const Channels& reference)
+{
+    Comparison c;
+    if (result.size() != reference.size()) {
+        c.sizeMismatch = true;
+        c.bitExact = false;
+        return c;
+    }
+
+    double errorEnergy = 0.0;
+    double referenceEnergy = 0.0;
+    std::size_t count = 0;
+    for (std::size_t ch = 0; ch < result.size(); ++ch) {
+        if (result[ch].size() != reference[ch].size()) {
+            c.sizeMismatch = true;
+            c.bitExact = false;
+            return c;
+        }
+        for (std::size_t i = 0; i < result[ch].size(); ++i) {
+            const double diff = static_cast<double>(result[ch][i]) - static_cast<double>(reference[ch][i]);
+            c.bitExact = c.bitExact && result[ch][i] == reference[ch][i];
+            c.maxAbsError = std::max(c.maxAbsError, std::fabs(diff));
+            errorEnergy += diff * diff;
+            referenceEnergy += static_cast<double>(reference[ch][i]) * static_cast<double>(reference[ch][i]);
+            ++count;
+        }
+    }
+
+    c.rmsError = count > 0 ? std::sqrt(errorEnergy / static_cast<double>(count)) : 0.0;
+    if (errorEnergy == 0.0)
+        c.nullDepthDb = -std::numeric_limits<double>::infinity();
+    else if (referenceEnergy == 0.0)
+        c.nullDepthDb = std::numeric_limits<double>::infinity();
+    else
+        c.nullDepthDb = 10.0 * std::log10(errorEnergy / referenceEnergy);
+    return c;
+}
+
+TestContext::TestContext(std::string goldenDir, bool updateGolden)
+    : goldenDir_(std::move(goldenDir)), updateGolden_(updateGolden)
+{
+}
+
+void TestContext::check(bool condition, const char* expression, const char* file, int line)
+{
+    if (condition)
+        return;
+    char message[512];
+    std::snprintf(message, sizeof(message), "%s:%d: CHECK(%s) failed", file, line, expression);
+    fail(message);
+}
+
+void TestContext::fail(const std::string& message)
+{
+    failed_ = true;
+    lines_.push_back("FAIL " + message);
+}
+
+void TestContext::note(const std::string& message)
+{
+    lines_.push_back(message);
+}
+
+bool TestContext::expectNull(const std::string& label, const Channels& result, const Channels& reference,
+                             double tolerance)
+{
+    const Comparison c = compare(result, reference);
+    const bool ok = !c.sizeMismatch && (tolerance == 0.0 ? c.bitExact : c.maxAbsError <= tolerance);
+    const std::string line = formatComparison("null " + label, c, tolerance);
+    if (ok)
+        note(line);
+    else
+        fail(line);
+    return ok;
+}
+
+bool TestContext::expectGolden(const std::string& name, const Channels& result, double tolerance)
+{
+    const std::string path = goldenDir_ + "/" + name + ".f32";
+
+    if (updateGolden_) {
+        if (!writeGoldenFile(path, result)) {
+            fail("could not write " + path);
+            return false;
+        }
+        note("golden " + name + ": updated");
+        return true;
+    }
+
+    Channels reference;
+    if (!readGoldenFile(path, reference)) {
+        fail("missing or unreadable golden file " + path + " (run with --update-golden)");
+        return false;
+    }
+
+    const Comparison c = compare(result, reference);
+    const bool ok = !c.sizeMismatch && c.maxAbsError <= tolerance;
+    const std::string line = formatComparison("golden " + name, c, tolerance);
+    if (ok)
+        note(line);
+    else
+        fail(line);
+    return ok;
+}
+
+} // namespace villain::test
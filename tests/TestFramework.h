@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace villain::test {
+
+using Channels = std::vector<std::vector<float>>;
+
+// Differences between a result and its reference. Null depth is the residual's RMS relative
+// to the reference's, in dB (more negative is better; -inf when bit-exact).
+struct Comparison {
+    double maxAbsError = 0.0;
+    double rmsError = 0.0;
+    double nullDepthDb = 0.0;
+    bool bitExact = true;
+    bool sizeMismatch = false;
+};
+
+Comparison compare(const Channels& result, const Channels& reference);
+
+class TestContext {
+public:
+    TestContext(std::string goldenDir, bool updateGolden);
+
+    void check(bool condition, const char* expression, const char* file, int line);
+    void fail(const std::string& message);
+    void note(const std::string& message);
+
+    // Null test against an in-memory reference; passes when every sample is within tolerance.
+    // Use tolerance 0 to demand bit-exactness.
+    bool expectNull(const std::string& label, const Channels& result, const Channels& reference, double tolerance);
+
+    // Golden-file test against tests/golden/<name>.f32. With --update-golden the file is
+    // rewritten instead and the test passes.
+    bool expectGolden(const std::string& name, const Channels& result, double tolerance);
+
+    bool failed() const noexcept { return failed_; }
+    const std::vector<std::string>& lines() const noexcept { return lines_; }
+
+private:
+    std::string goldenDir_;
+    bool updateGolden_;
+    bool failed_ = false;
+    std::vector<std::string> lines_;
+};
+
+using TestFunction = void (*)(TestContext&);
+
+struct TestCase {
+    const char* name;
+    TestFunction function;
+};
+
+std::vector<TestCase>& registry();
+
+struct Registrar {
+    Registrar(const char* name, TestFunction function) { registry().push_back({name, function}); }
+};
+
+} // namespace villain::test
+
+#define VILLAIN_TEST(name)                                                            \
+    static void name(::villain::test::TestContext& ctx);                              \
+    static const ::villain::test::Registrar name##Registrar(#name, &name);            \
+    static void name([[maybe_unused]] ::villain::test::TestContext& ctx)
+
+#define CHECK(condition) ctx.check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
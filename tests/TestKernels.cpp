@@ -0,0 +1,235 @@
+#include "TestFramework.h"
+#include "TestSignals.h"
+
+#include "dsp/Biquad.h"
+#include "dsp/ShaperCurve.h"
+#include "dsp/simd/Kernels.h"
+
+#include <cmath>
+#include <string>
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+// Odd length so every kernel also runs its scalar tail.
+constexpr int kKernelFrames = 1021;
+
+std::vector<const simd::KernelTable*> availableTables()
+{
+    std::vector<const simd::KernelTable*> tables;
+    for (int isa = 0; isa <= static_cast<int>(simd::InstructionSet::AVX512); ++isa)
+        if (const simd::KernelTable* table = simd::kernelsFor(static_cast<simd::InstructionSet>(isa)))
+            tables.push_back(table);
+    return tables;
+}
+
+template <typename Run>
+void compareAgainstScalar(TestContext& ctx, const char* kernel, double tolerance, Run run)
+{
+    const simd::KernelTable* scalar = simd::kernelsFor(simd::InstructionSet::Scalar);
+    const std::vector<float> input = sweepWithNoise(kKernelFrames, kTestSampleRate, 7u, 2.0f);
+
+    Channels reference = {input};
+    run(*scalar, reference[0]);
+
+    for (const simd::KernelTable* table : availableTables()) {
+        Channels result = {input};
+        run(*table, result[0]);
+        ctx.expectNull(std::string(kernel) + " " + simd::toString(table->isa) + " vs scalar", result, reference,
+                       tolerance);
+    }
+}
+
+} // namespace
+
+VILLAIN_TEST(kernels_active_table_is_supported)
+{
+    CHECK(simd::activeKernels().isa <= simd::detectInstructionSet());
+    CHECK(simd::kernelsFor(simd::InstructionSet::Scalar) != nullptr);
+    ctx.note(std::string("active ") + simd::toString(simd::activeKernels().isa));
+}
+
+VILLAIN_TEST(kernels_gain_match_scalar)
+{
+    compareAgainstScalar(ctx, "gain", 0.0, [](const simd::KernelTable& k, std::vector<float>& x) {
+        k.applyGain(x.data(), kKernelFrames, 0.7f);
+    });
+    compareAgainstScalar(ctx, "gain_ramp", 1e-6, [](const simd::KernelTable& k, std::vector<float>& x) {
+        k.applyGainRamp(x.data(), kKernelFrames, 0.25f, 0.001f);
+    });
+}
+
+VILLAIN_TEST(kernels_saturation_match_scalar)
+{
+    for (int model = 0; model < dsp::kNumSaturationModels; ++model) {
+        compareAgainstScalar(ctx, ("saturate" + std::to_string(model)).c_str(), 1e-6,
+                             [model](const simd::KernelTable& k, std::vector<float>& x) {
+                                 k.saturate[model](x.data(), kKernelFrames);
+                             });
+    }
+}
+
+VILLAIN_TEST(kernels_mix_and_dot_match_scalar)
+{
+    const std::vector<float> dry = sweepWithNoise(kKernelFrames, kTestSampleRate, 11u);
+    compareAgainstScalar(ctx, "mix", 1e-6, [&dry](const simd::KernelTable& k, std::vector<float>& x) {
+        k.mixDryWet(x.data(), dry.data(), kKernelFrames, 0.1f, 0.0005f);
+    });
+    compareAgainstScalar(ctx, "dot", 1e-3, [&dry](const simd::KernelTable& k, std::vector<float>& x) {
+        x.assign(1, k.dotProduct(x.data(), dry.data(), kKernelFrames));
+    });
+    compareAgainstScalar(ctx, "peak", 0.0, [](const simd::KernelTable& k, std::vector<float>& x) {
+        x.assign(1, k.peakAbs(x.data(), kKernelFrames));
+    });
+    compareAgainstScalar(ctx, "convolve", 1e-5, [&dry](const simd::KernelTable& k, std::vector<float>& x) {
+        std::vector<float> out(kKernelFrames - 31);
+        k.convolve(x.data(), dry.data(), 32, out.data(), static_cast<int>(out.size()));
+        x = out;
+    });
+    // Halves of each signal stand in for the real and imaginary parts.
+    compareAgainstScalar(ctx, "complex_mac", 1e-5, [&dry](const simd::KernelTable& k, std::vector<float>& x) {
+        const int bins = kKernelFrames / 2;
+        std::vector<float> acc(dry.begin(), dry.begin() + 2 * bins);
+        k.complexMultiplyAdd(acc.data(), acc.data() + bins, x.data(), x.data() + bins, dry.data() + 1,
+                             dry.data() + bins + 1, bins);
+        x = acc;
+    });
+    // Every span from scalar-only up to one group covering the whole array; any values will
+    // do as twiddles for comparing paths.
+    compareAgainstScalar(ctx, "fft_stage", 1e-5, [&dry](const simd::KernelTable& k, std::vector<float>& x) {
+        constexpr int kPoints = 256;
+        for (int span = 1; span < kPoints; span <<= 1)
+            k.fftStage(x.data(), x.data() + kPoints, dry.data(), dry.data() + kPoints, kPoints, span);
+        x.resize(2 * kPoints);
+    });
+}
+
+VILLAIN_TEST(kernels_antialiased_saturation_match_scalar)
+{
+    const auto curves = dsp::acquireSaturationCurves();
+    for (int model = 0; model < dsp::kNumSaturationModels; ++model) {
+        const simd::ShaperTable& table = curves->table(static_cast<dsp::SaturationModel>(model));
+        compareAgainstScalar(ctx, ("tabulated model " + std::to_string(model)).c_str(), 1e-6,
+                             [&](const simd::KernelTable& k, std::vector<float>& x) {
+                                 k.shapeTabulated(x.data(), kKernelFrames, table);
+                             });
+        for (int order = 1; order <= simd::kMaxAntialiasingOrder; ++order) {
+            for (int lanes : {1, simd::kCrossoverLanes}) {
+                const std::string name = "adaa" + std::to_string(order) + " model " + std::to_string(model) +
+                                         " lanes " + std::to_string(lanes);
+                // Split unevenly so the history crosses vector and chunk boundaries.
+                compareAgainstScalar(ctx, name.c_str(), 2e-5, [&](const simd::KernelTable& k, std::vector<float>& x) {
+                    const int frames = kKernelFrames / lanes;
+                    std::vector<float> history(static_cast<std::size_t>(order * lanes), 0.25f);
+                    k.saturateAntialiased[order - 1](x.data(), 77, lanes, table, history.data());
+                    k.saturateAntialiased[order - 1](x.data() + 77 * lanes, frames - 77, lanes, table, history.data());
+                    x.resize(static_cast<std::size_t>(frames * lanes));
+                });
+            }
+        }
+    }
+}
+
+VILLAIN_TEST(kernels_biquad_match_scalar)
+{
+    const dsp::BiquadCoefficients c = dsp::BiquadCoefficients::lowPass(kTestSampleRate, 2500.0, 0.9);
+    simd::BiquadKernelCoefficients kc;
+    kc.compute(c.b0, c.b1, c.b2, c.a1, c.a2);
+
+    // Split unevenly so the carried state crosses vector and tail boundaries.
+    compareAgainstScalar(ctx, "biquad", 1e-5, [&kc](const simd::KernelTable& k, std::vector<float>& x) {
+        float z1 = 0.0f;
+        float z2 = 0.0f;
+        k.biquad(x.data(), 333, kc, z1, z2);
+        k.biquad(x.data() + 333, kKernelFrames - 333, kc, z1, z2);
+    });
+}
+
+VILLAIN_TEST(kernels_dynamics_match_scalar)
+{
+    const std::vector<float> other = sweepWithNoise(kKernelFrames, kTestSampleRate, 13u);
+    compareAgainstScalar(ctx, "max_abs", 0.0, [&other](const simd::KernelTable& k, std::vector<float>& x) {
+        k.maxAbs(x.data(), other.data(), kKernelFrames);
+    });
+    compareAgainstScalar(ctx, "gain_curve", 0.0, [&other](const simd::KernelTable& k, std::vector<float>& x) {
+        k.applyGainCurve(x.data(), other.data(), kKernelFrames);
+    });
+
+    // +/-40 dB, against the exact conversion.
+    compareAgainstScalar(ctx, "db_to_gain", 1e-4, [](const simd::KernelTable& k, std::vector<float>& x) {
+        for (float& value : x)
+            value *= 20.0f;
+        k.decibelsToGain(x.data(), kKernelFrames);
+    });
+    const std::vector<float> decibels = sweepWithNoise(kKernelFrames, kTestSampleRate, 17u, 40.0f);
+    Channels gains = {decibels};
+    for (float& value : gains[0])
+        value = static_cast<float>(std::pow(10.0, value / 20.0));
+    for (const simd::KernelTable* table : availableTables()) {
+        Channels result = {decibels};
+        table->decibelsToGain(result[0].data(), kKernelFrames);
+        ctx.expectNull(std::string("db_to_gain ") + simd::toString(table->isa) + " vs exact", result, gains, 1e-3);
+    }
+
+    // Levels from silence to +12 dBFS through a soft-knee curve, against the exact formula.
+    simd::GainCurve curve;
+    curve.thresholdDb = -18.0f;
+    curve.slope = 1.0f / 3.0f - 1.0f;
+    curve.kneeDb = 6.0f;
+    std::vector<float> levels(kKernelFrames);
+    for (int i = 0; i < kKernelFrames; ++i)
+        levels[static_cast<std::size_t>(i)] = i == 0 ? 0.0f : std::pow(10.0f, (-120.0f + 132.0f * i / kKernelFrames) / 20.0f);
+
+    Channels exact = {levels};
+    for (float& value : exact[0]) {
+        const double over = (value > 0.0f ? 20.0 * std::log10(value) : -1000.0) - curve.thresholdDb;
+        double reduction = 0.0;
+        if (over > curve.kneeDb / 2)
+            reduction = curve.slope * over;
+        else if (over > -curve.kneeDb / 2)
+            reduction = curve.slope * (over + curve.kneeDb / 2) * (over + curve.kneeDb / 2) / (2 * curve.kneeDb);
+        value = static_cast<float>(std::pow(10.0, reduction / 20.0));
+    }
+    for (const simd::KernelTable* table : availableTables()) {
+        Channels result = {levels};
+        table->gainComputer(result[0].data(), kKernelFrames, curve);
+        ctx.expectNull(std::string("gain_computer ") + simd::toString(table->isa) + " vs exact", result, exact, 1e-5);
+    }
+}
+
+VILLAIN_TEST(kernels_crossover_lanes_match_scalar)
+{
+    // A different filter in every lane and section, so any lane or section mix-up shows.
+    simd::CrossoverKernelCoefficients kc{};
+    kc.numSections = 3;
+    for (int s = 0; s < kc.numSections; ++s) {
+        for (int lane = 0; lane < simd::kCrossoverLanes; ++lane) {
+            const double f = 200.0 * (lane + 1) * (s + 1);
+            const dsp::BiquadCoefficients c = (lane + s) % 2 == 0 ? dsp::BiquadCoefficients::lowPass(kTestSampleRate, f, 0.8)
+                                                                  : dsp::BiquadCoefficients::highPass(kTestSampleRate, f, 0.6);
+            kc.b0[s][lane] = c.b0;
+            kc.b1[s][lane] = c.b1;
+            kc.b2[s][lane] = c.b2;
+            kc.a1[s][lane] = c.a1;
+            kc.a2[s][lane] = c.a2;
+        }
+    }
+
+    // Split, drive each lane and merge back into the one channel the harness compares.
+    compareAgainstScalar(ctx, "crossover", 1e-5, [&kc](const simd::KernelTable& k, std::vector<float>& x) {
+        std::vector<float> state(simd::kCrossoverStateSize, 0.0f);
+        std::vector<float> lanes(x.size() * simd::kCrossoverLanes);
+        alignas(32) float start[simd::kCrossoverLanes];
+        alignas(32) float step[simd::kCrossoverLanes];
+        for (int lane = 0; lane < simd::kCrossoverLanes; ++lane) {
+            start[lane] = 0.5f + 0.1f * lane;
+            step[lane] = 1e-4f * lane;
+        }
+        k.crossoverSplit(x.data(), lanes.data(), 333, kc, state.data());
+        k.crossoverSplit(x.data() + 333, lanes.data() + 333 * simd::kCrossoverLanes, kKernelFrames - 333, kc, state.data());
+        k.laneGainRamp(lanes.data(), kKernelFrames, start, step);
+        k.mergeLanes(lanes.data(), x.data(), kKernelFrames);
+    });
+}
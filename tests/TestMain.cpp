@@ -0,0 +1,76 @@
+#include "TestFramework.h"
+
+#include "dsp/simd/Kernels.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifndef VILLAIN_GOLDEN_DIR
+#define VILLAIN_GOLDEN_DIR "tests/golden"
+#endif
+
+namespace {
+
+void printUsage(const char* argv0)
+{
+    std::printf("usage: %s [--output PATH] [--golden-dir DIR] [--update-golden] [--filter SUBSTRING]\n", argv0);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string outputPath = "test_output.txt";
+    std::string goldenDir = VILLAIN_GOLDEN_DIR;
+    std::string filter;
+    bool updateGolden = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--golden-dir") == 0 && i + 1 < argc) {
+            goldenDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--update-golden") == 0) {
+            updateGolden = true;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    std::FILE* report = std::fopen(outputPath.c_str(), "w");
+    if (report == nullptr) {
+        std::fprintf(stderr, "failed to open %s\n", outputPath.c_str());
+        return 1;
+    }
+    std::fprintf(report, "# villain-vst test report\n");
+    std::fprintf(report, "# isa=%s\n", villain::simd::toString(villain::simd::activeKernels().isa));
+
+    int passed = 0;
+    int failed = 0;
+    for (const villain::test::TestCase& test : villain::test::registry()) {
+        if (!filter.empty() && std::strstr(test.name, filter.c_str()) == nullptr)
+            continue;
+
+        villain::test::TestContext ctx(goldenDir, updateGolden);
+        test.function(ctx);
+
+        const char* status = ctx.failed() ? "FAIL" : "PASS";
+        std::fprintf(report, "[%s] %s\n", status, test.name);
+        std::printf("[%s] %s\n", status, test.name);
+        for (const std::string& line : ctx.lines()) {
+            std::fprintf(report, "       %s\n", line.c_str());
+            if (ctx.failed())
+                std::printf("       %s\n", line.c_str());
+        }
+        (ctx.failed() ? failed : passed) += 1;
+    }
+
+    std::fprintf(report, "summary: %d passed, %d failed\n", passed, failed);
+    std::fclose(report);
+    std::printf("summary: %d passed, %d failed (report: %s)\n", passed, failed, outputPath.c_str());
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+#include "AllocationTracker.h"
+#include "TestFramework.h"
+#include "TestSignals.h"
+
+#include "dsp/Modulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+// Every track a matrix produced, expanded to one value per sample.
+struct Tracks {
+    std::vector<float> drive;
+    std::vector<float> tone;
+    std::vector<float> mix;
+};
+
+void configure(dsp::ModulationMatrix& matrix, int maxBlockSize)
+{
+    matrix.prepare(kTestSampleRate, maxBlockSize);
+    matrix.setLfo(3.0f, dsp::LfoShape::Sine);
+    matrix.setRandomRate(40.0f);
+    matrix.setEnvelopeRelease(0.05f);
+    matrix.setRoute(0, {dsp::ModSource::Lfo, dsp::ModTarget::Drive, 0.5f});
+    matrix.setRoute(1, {dsp::ModSource::Random, dsp::ModTarget::Tone, -0.7f});
+    matrix.setRoute(2, {dsp::ModSource::Envelope, dsp::ModTarget::Mix, 0.4f});
+    matrix.setRoute(3, {dsp::ModSource::Envelope, dsp::ModTarget::Drive, 0.25f});
+    matrix.reset();
+}
+
+Tracks run(dsp::ModulationMatrix& matrix, Channels& input, int blockSize)
+{
+    Tracks tracks;
+    const int frames = static_cast<int>(input[0].size());
+    for (int pos = 0; pos < frames; pos += blockSize) {
+        const int length = std::min(blockSize, frames - pos);
+        dsp::ModulationBlock block;
+        matrix.process(blockOf(input, pos, length), length, block);
+        for (int i = 0, step = 0, done = 0; i < length; ++i) {
+            if (i - done == block.stepLength(step)) {
+                done = i;
+                ++step;
+            }
+            tracks.drive.push_back(block.driveGains != nullptr ? block.driveGains[i] : 1.0f);
+            tracks.tone.push_back(block.toneOctaves != nullptr ? block.toneOctaves[step] : 0.0f);
+            tracks.mix.push_back(block.mixOffset != nullptr ? block.mixOffset[step] : 0.0f);
+        }
+    }
+    return tracks;
+}
+
+float maxDifference(const std::vector<float>& a, const std::vector<float>& b)
+{
+    float worst = 0.0f;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        worst = std::max(worst, std::fabs(a[i] - b[i]));
+    return worst;
+}
+
+// The LFO's value at each sample, read back through a full-depth route to drive.
+std::vector<float> lfoThroughDrive(dsp::LfoShape shape, float hz, int frames)
+{
+    dsp::ModulationMatrix matrix;
+    matrix.prepare(kTestSampleRate, frames);
+    matrix.setLfo(hz, shape);
+    matrix.setRoute(0, {dsp::ModSource::Lfo, dsp::ModTarget::Drive, 1.0f});
+    matrix.reset();
+
+    dsp::ModulationBlock block;
+    matrix.process(AudioBlock(), frames, block);
+    std::vector<float> lfo(static_cast<std::size_t>(frames));
+    for (int i = 0; i < frames; ++i)
+        lfo[static_cast<std::size_t>(i)] = 20.0f * std::log10(block.driveGains[i]) / dsp::kDriveModulationDb;
+    return lfo;
+}
+
+} // namespace
+
+VILLAIN_TEST(modulation_matches_at_any_block_size)
+{
+    Channels input = stereoTestSignal();
+    dsp::ModulationMatrix whole;
+    configure(whole, kTestFrames);
+    const Tracks reference = run(whole, input, kTestFrames);
+
+    for (int blockSize : {1, 31, 100, 512}) {
+        dsp::ModulationMatrix matrix;
+        configure(matrix, blockSize);
+        const Tracks tracks = run(matrix, input, blockSize);
+        const std::string label = "block " + std::to_string(blockSize);
+        ctx.note(label + ": drive off by " + std::to_string(maxDifference(tracks.drive, reference.drive)));
+        CHECK(maxDifference(tracks.drive, reference.drive) < 1e-5f);
+        CHECK(maxDifference(tracks.tone, reference.tone) == 0.0f);
+        CHECK(maxDifference(tracks.mix, reference.mix) == 0.0f);
+    }
+
+    // Something actually moved.
+    CHECK(*std::max_element(reference.drive.begin(), reference.drive.end()) > 1.5f);
+    CHECK(*std::min_element(reference.tone.begin(), reference.tone.end()) < -0.1f);
+    CHECK(*std::max_element(reference.mix.begin(), reference.mix.end()) > 0.05f);
+}
+
+VILLAIN_TEST(modulation_lfo_shapes_and_period)
+{
+    // 100 Hz: one cycle every 480 samples.
+    constexpr int kPeriod = 480;
+    constexpr double kPi = 3.14159265358979323846;
+    const std::vector<float> sine = lfoThroughDrive(dsp::LfoShape::Sine, 100.0f, 4 * kPeriod);
+    const std::vector<float> triangle = lfoThroughDrive(dsp::LfoShape::Triangle, 100.0f, 4 * kPeriod);
+
+    float sineError = 0.0f;
+    float triangleError = 0.0f;
+    float periodError = 0.0f;
+    for (int i = 0; i < 4 * kPeriod; ++i) {
+        const double phase = static_cast<double>(i % kPeriod) / kPeriod;
+        const double exactTriangle = phase < 0.25 ? 4.0 * phase : phase < 0.75 ? 2.0 - 4.0 * phase : 4.0 * phase - 4.0;
+        sineError = std::max(sineError, static_cast<float>(std::fabs(sine[static_cast<std::size_t>(i)] - std::sin(2.0 * kPi * phase))));
+        triangleError = std::max(triangleError, static_cast<float>(std::fabs(triangle[static_cast<std::size_t>(i)] - exactTriangle)));
+        if (i >= kPeriod)
+            periodError = std::max(periodError, std::fabs(sine[static_cast<std::size_t>(i)] - sine[static_cast<std::size_t>(i - kPeriod)]));
+    }
+    ctx.note("sine error " + std::to_string(sineError) + ", triangle error " + std::to_string(triangleError));
+    CHECK(sineError < 2e-3f);
+    CHECK(triangleError < 1e-4f);
+    CHECK(periodError < 1e-4f);
+}
+
+VILLAIN_TEST(modulation_uses_audio_rate_only_for_drive)
+{
+    dsp::ModulationMatrix matrix;
+    matrix.prepare(kTestSampleRate, 256);
+    dsp::ModulationBlock block;
+
+    // Unrouted, or routed at zero depth, the matrix does nothing.
+    matrix.setRoute(0, {dsp::ModSource::Lfo, dsp::ModTarget::Tone, 0.0f});
+    CHECK(!matrix.isActive());
+
+    matrix.setRoute(0, {dsp::ModSource::Lfo, dsp::ModTarget::Tone, 0.5f});
+    matrix.setRoute(1, {dsp::ModSource::Random, dsp::ModTarget::Mix, 0.5f});
+    CHECK(matrix.isActive());
+    matrix.process(AudioBlock(), 256, block);
+    CHECK(!matrix.isAudioRate(dsp::ModSource::Lfo));
+    CHECK(!matrix.isAudioRate(dsp::ModSource::Random));
+    CHECK(block.driveGains == nullptr && block.toneOctaves != nullptr && block.mixOffset != nullptr);
+
+    matrix.setRoute(1, {dsp::ModSource::Random, dsp::ModTarget::Drive, 0.5f});
+    matrix.process(AudioBlock(), 256, block);
+    CHECK(!matrix.isAudioRate(dsp::ModSource::Lfo));
+    CHECK(matrix.isAudioRate(dsp::ModSource::Random));
+    CHECK(block.driveGains != nullptr);
+
+    // A route that is switched off slews out, then the track goes away.
+    matrix.setRoute(0, {});
+    matrix.setRoute(1, {});
+    for (int i = 0; i < 8 && matrix.isActive(); ++i)
+        matrix.process(AudioBlock(), 256, block);
+    CHECK(!matrix.isActive());
+}
+
+VILLAIN_TEST(modulation_process_does_not_allocate)
+{
+    Channels input = stereoTestSignal();
+    dsp::ModulationMatrix matrix;
+    configure(matrix, 512);
+    ScopedAllocationCounter allocations;
+    for (int pos = 0; pos < kTestFrames; pos += 512) {
+        dsp::ModulationBlock block;
+        matrix.process(blockOf(input, pos, 512), 512, block);
+    }
+    CHECK(allocations.count() == 0);
+}
@@ -0,0 +1,205 @@
+#include "TestFramework.h"
+#include "TestSignals.h"
+
+#include "core/SharedTable.h"
+#include "dsp/Oversampler.h"
+
+#include <cmath>
+#include <string>
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+constexpr double kGoldenTolerance = 1e-5;
+
+void roundTrip(dsp::Oversampler& oversampler, Channels& signal, int blockSize)
+{
+    const int frames = static_cast<int>(signal[0].size());
+    for (int pos = 0; pos < frames; pos += blockSize) {
+        const AudioBlock block = blockOf(signal, pos, std::min(blockSize, frames - pos));
+        oversampler.upsample(block);
+        oversampler.downsample(block);
+    }
+}
+
+const char* modeName(dsp::OversamplingMode mode)
+{
+    return mode == dsp::OversamplingMode::LinearPhase ? "lin" : "min";
+}
+
+} // namespace
+
+VILLAIN_TEST(oversampler_linear_phase_latency_is_exact)
+{
+    for (int stages = 1; stages <= dsp::Oversampler::kMaxStages; ++stages) {
+        dsp::Oversampler oversampler;
+        oversampler.prepare(1, 64);
+        oversampler.setMode(dsp::OversamplingMode::LinearPhase);
+        oversampler.setNumStages(stages);
+
+        Channels impulse = {std::vector<float>(512, 0.0f)};
+        impulse[0][10] = 1.0f;
+        roundTrip(oversampler, impulse, 64);
+
+        // A linear-phase response is symmetric about its peak, which must sit exactly at the
+        // reported latency.
+        const int latency = oversampler.latencySamples();
+        int peak = 0;
+        for (int i = 0; i < 512; ++i)
+            if (std::fabs(impulse[0][static_cast<std::size_t>(i)]) > std::fabs(impulse[0][static_cast<std::size_t>(peak)]))
+                peak = i;
+        CHECK(peak == 10 + latency);
+
+        double asymmetry = 0.0;
+        for (int k = 1; k <= 10 + latency && k < 100; ++k)
+            asymmetry = std::max(asymmetry, std::fabs(static_cast<double>(impulse[0][static_cast<std::size_t>(peak + k)]) -
+                                                      impulse[0][static_cast<std::size_t>(peak - k)]));
+        CHECK(asymmetry < 1e-6);
+        ctx.note(std::to_string(1 << stages) + "x latency " + std::to_string(latency));
+    }
+}
+
+VILLAIN_TEST(oversampler_linear_phase_null)
+{
+    // A 1 kHz tone is deep in every stage's passband: after compensating the reported
+    // latency the round trip must null against the input.
+    for (int stages = 1; stages <= dsp::Oversampler::kMaxStages; ++stages) {
+        dsp::Oversampler oversampler;
+        oversampler.prepare(1, 128);
+        oversampler.setMode(dsp::OversamplingMode::LinearPhase);
+        oversampler.setNumStages(stages);
+
+        const std::vector<float> tone = sine(4096, 1000.0, kTestSampleRate);
+        Channels processed = {tone};
+        roundTrip(oversampler, processed, 128);
+
+        const int latency = oversampler.latencySamples();
+        Channels result = {std::vector<float>(processed[0].begin() + 1024 + latency, processed[0].begin() + 3072 + latency)};
+        Channels reference = {std::vector<float>(tone.begin() + 1024, tone.begin() + 3072)};
+        ctx.expectNull(std::to_string(1 << stages) + "x 1 kHz", result, reference, 1e-3);
+    }
+}
+
+VILLAIN_TEST(oversampler_minimum_phase_latency_matches_group_delay)
+{
+    for (int stages = 1; stages <= dsp::Oversampler::kMaxStages; ++stages) {
+        dsp::Oversampler oversampler;
+        oversampler.prepare(1, 64);
+        oversampler.setNumStages(stages);
+
+        Channels impulse = {std::vector<float>(1024, 0.0f)};
+        impulse[0][0] = 1.0f;
+        roundTrip(oversampler, impulse, 64);
+
+        double sum = 0.0;
+        double moment = 0.0;
+        for (int i = 0; i < 1024; ++i) {
+            sum += impulse[0][static_cast<std::size_t>(i)];
+            moment += i * static_cast<double>(impulse[0][static_cast<std::size_t>(i)]);
+        }
+        CHECK(std::fabs(sum - 1.0) < 1e-4);
+        CHECK(std::lround(moment / sum) == oversampler.latencySamples());
+    }
+}
+
+VILLAIN_TEST(oversampler_golden)
+{
+    for (auto mode : {dsp::OversamplingMode::MinimumPhase, dsp::OversamplingMode::LinearPhase}) {
+        for (int stages : {1, 2, 4}) {
+            dsp::Oversampler oversampler;
+            oversampler.prepare(2, 256);
+            oversampler.setMode(mode);
+            oversampler.setNumStages(stages);
+
+            Channels signal = stereoTestSignal();
+            roundTrip(oversampler, signal, 256);
+            ctx.expectGolden(std::string("oversampler_") + modeName(mode) + "_" + std::to_string(1 << stages) + "x",
+                             signal, kGoldenTolerance);
+        }
+    }
+}
+
+VILLAIN_TEST(oversampler_block_size_invariant)
+{
+    for (auto mode : {dsp::OversamplingMode::MinimumPhase, dsp::OversamplingMode::LinearPhase}) {
+        dsp::Oversampler a;
+        dsp::Oversampler b;
+        a.prepare(2, 512);
+        b.prepare(2, 512);
+        a.setMode(mode);
+        b.setMode(mode);
+        a.setNumStages(3);
+        b.setNumStages(3);
+
+        Channels big = stereoTestSignal();
+        Channels small = big;
+        roundTrip(a, big, 512);
+        roundTrip(b, small, 37);
+        ctx.expectNull(std::string(modeName(mode)) + " 512 vs 37", small, big, 1e-6);
+    }
+}
+
+VILLAIN_TEST(oversampler_channel_pairing_is_transparent)
+{
+    // Minimum-phase stages run channels in vector pairs with a half-width path for an odd
+    // one out. Which lane a channel lands in must not change a single sample.
+    const std::vector<float> a = sweepWithNoise(kTestFrames, kTestSampleRate, 3u, 0.5f);
+    const std::vector<float> b = sweepWithNoise(kTestFrames, kTestSampleRate, 4u, 0.5f);
+
+    for (int stages = 1; stages <= dsp::Oversampler::kMaxStages; ++stages) {
+        dsp::Oversampler mono;
+        mono.prepare(1, 256);
+        mono.setNumStages(stages);
+        Channels alone = {a};
+        roundTrip(mono, alone, 256);
+
+        dsp::Oversampler wide;
+        wide.prepare(3, 256);
+        wide.setNumStages(stages);
+        Channels three = {b, a, a};
+        roundTrip(wide, three, 256);
+
+        const std::string factor = std::to_string(1 << stages) + "x";
+        ctx.expectNull(factor + " paired vs mono", {three[1]}, alone, 0.0);
+        ctx.expectNull(factor + " odd channel vs mono", {three[2]}, alone, 0.0);
+    }
+}
+
+VILLAIN_TEST(oversampler_kernels_are_shared_between_instances)
+{
+    dsp::Oversampler first;
+    dsp::Oversampler second;
+    CHECK(first.kernels() == nullptr);
+
+    first.prepare(2, 256);
+    second.prepare(1, 64);
+    CHECK(first.kernels() != nullptr);
+    CHECK(first.kernels() == second.kernels());
+    CHECK(SharedTable<dsp::OversamplerKernels>::liveCount() == 1);
+    CHECK(first.maxLatencySamples() == second.maxLatencySamples());
+}
+
+VILLAIN_TEST(shared_table_builds_once_per_key)
+{
+    int builds = 0;
+    auto build = [&builds] {
+        ++builds;
+        return std::vector<float>(64, 1.0f);
+    };
+
+    auto a = SharedTable<std::vector<float>>::acquire(7, build);
+    auto b = SharedTable<std::vector<float>>::acquire(7, build);
+    auto c = SharedTable<std::vector<float>>::acquire(8, build);
+    CHECK(builds == 2);
+    CHECK(a == b);
+    CHECK(a != c);
+
+    // Released tables are dropped and rebuilt on the next request.
+    a.reset();
+    b.reset();
+    CHECK(SharedTable<std::vector<float>>::liveCount() == 1);
+    auto d = SharedTable<std::vector<float>>::acquire(7, build);
+    CHECK(builds == 3);
+}
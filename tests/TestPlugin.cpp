@@ -0,0 +1,219 @@
+#include "TestFramework.h"
+#include "TestSignals.h"
+
+#include "plugin/PluginEntry.h"
+#include "plugin/StateFormat.h"
+#include "plugin/VillainProcessor.h"
+
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+// The built plugin binary, loaded the way a host would.
+class PluginModule {
+public:
+    PluginModule()
+    {
+#if defined(_WIN32)
+        handle_ = LoadLibraryA(VILLAIN_PLUGIN_PATH);
+#else
+        handle_ = dlopen(VILLAIN_PLUGIN_PATH, RTLD_NOW | RTLD_LOCAL);
+#endif
+    }
+
+    ~PluginModule()
+    {
+#if defined(_WIN32)
+        if (handle_ != nullptr)
+            FreeLibrary(static_cast<HMODULE>(handle_));
+#else
+        if (handle_ != nullptr)
+            dlclose(handle_);
+#endif
+    }
+
+    PluginModule(const PluginModule&) = delete;
+    PluginModule& operator=(const PluginModule&) = delete;
+
+    bool loaded() const noexcept { return handle_ != nullptr; }
+
+    void* find(const char* symbol) const noexcept
+    {
+#if defined(_WIN32)
+        return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(handle_), symbol));
+#else
+        return dlsym(handle_, symbol);
+#endif
+    }
+
+    template <typename Function>
+    Function* entry(const char* symbol) const noexcept
+    {
+        return reinterpret_cast<Function*>(find(symbol));
+    }
+
+private:
+    void* handle_ = nullptr;
+};
+
+} // namespace
+
+VILLAIN_TEST(plugin_module_exports_entry_points)
+{
+    const PluginModule module;
+    CHECK(module.loaded());
+    if (!module.loaded())
+        return;
+
+    const auto version = module.entry<decltype(villain_api_version)>("villain_api_version");
+    const auto count = module.entry<decltype(villain_num_parameters)>("villain_num_parameters");
+    const auto info = module.entry<decltype(villain_parameter_info)>("villain_parameter_info");
+    CHECK(version != nullptr && count != nullptr && info != nullptr);
+    if (version == nullptr || count == nullptr || info == nullptr)
+        return;
+
+    CHECK(version() == VILLAIN_API_VERSION);
+    CHECK(count() == kNumParameters);
+    for (int i = 0; i < kNumParameters; ++i) {
+        VillainParameterInfo described{};
+        CHECK(info(i, &described) == 1);
+        CHECK(std::string(described.id) == kParameterInfo[static_cast<std::size_t>(i)].id);
+        CHECK(described.defaultValue == kParameterInfo[static_cast<std::size_t>(i)].defaultValue);
+    }
+    VillainParameterInfo outside{};
+    CHECK(info(kNumParameters, &outside) == 0);
+
+#if defined(__linux__)
+    // The library inside stays private: villain::simd::activeKernels() is not visible.
+    CHECK(module.find("_ZN7villain4simd13activeKernelsEv") == nullptr);
+#endif
+}
+
+VILLAIN_TEST(plugin_module_rejects_null_arguments)
+{
+    const PluginModule module;
+    CHECK(module.loaded());
+    if (!module.loaded())
+        return;
+
+    const auto create = module.entry<decltype(villain_create)>("villain_create");
+    const auto destroy = module.entry<decltype(villain_destroy)>("villain_destroy");
+    const auto prepare = module.entry<decltype(villain_prepare)>("villain_prepare");
+    const auto loadResponse = module.entry<decltype(villain_load_impulse_response)>("villain_load_impulse_response");
+    const auto setPack = module.entry<decltype(villain_set_asset_pack)>("villain_set_asset_pack");
+    const auto loadCabinet = module.entry<decltype(villain_load_cabinet_asset)>("villain_load_cabinet_asset");
+    const auto loadCurve = module.entry<decltype(villain_load_curve_asset)>("villain_load_curve_asset");
+    const auto loadState = module.entry<decltype(villain_load_state)>("villain_load_state");
+    CHECK(create && destroy && prepare && loadResponse && setPack && loadCabinet && loadCurve && loadState);
+    if (!(create && destroy && prepare && loadResponse && setPack && loadCabinet && loadCurve && loadState))
+        return;
+
+    VillainInstance* instance = create();
+    CHECK(instance != nullptr);
+    if (instance == nullptr)
+        return;
+    CHECK(loadResponse(instance, nullptr) == 0);
+    CHECK(loadResponse(nullptr, "cab.wav") == 0);
+    CHECK(setPack(instance, nullptr) == 0 && setPack(nullptr, "factory.vpak") == 0);
+    CHECK(loadCabinet(instance, nullptr) == 0 && loadCabinet(nullptr, "cab/room") == 0);
+    CHECK(loadCurve(nullptr, "measured/tape") == 0);
+    CHECK(loadState(nullptr, nullptr, 0) == 0);
+    CHECK(prepare(nullptr, kTestSampleRate, 256, 2, 0) == 0);
+    destroy(instance);
+}
+
+VILLAIN_TEST(plugin_module_matches_linked_processor)
+{
+    const PluginModule module;
+    CHECK(module.loaded());
+    if (!module.loaded())
+        return;
+
+    const auto create = module.entry<decltype(villain_create)>("villain_create");
+    const auto destroy = module.entry<decltype(villain_destroy)>("villain_destroy");
+    const auto prepare = module.entry<decltype(villain_prepare)>("villain_prepare");
+    const auto process = module.entry<decltype(villain_process)>("villain_process");
+    const auto setParameter = module.entry<decltype(villain_set_parameter)>("villain_set_parameter");
+    const auto getParameter = module.entry<decltype(villain_get_parameter)>("villain_get_parameter");
+    const auto latency = module.entry<decltype(villain_latency_samples)>("villain_latency_samples");
+    const auto stateCapacity = module.entry<decltype(villain_state_size)>("villain_state_size");
+    const auto saveState = module.entry<decltype(villain_save_state)>("villain_save_state");
+    const auto loadState = module.entry<decltype(villain_load_state)>("villain_load_state");
+    const auto processKeyed = module.entry<decltype(villain_process_sidechain)>("villain_process_sidechain");
+    CHECK(create && destroy && prepare && process && setParameter && getParameter && latency && stateCapacity && saveState &&
+          loadState && processKeyed);
+    if (!(create && destroy && prepare && process && setParameter && getParameter && latency && stateCapacity && saveState &&
+          loadState && processKeyed))
+        return;
+
+    constexpr int kFrames = 2048;
+    ProcessSpec spec;
+    spec.maxBlockSize = 512;
+
+    VillainProcessor linked;
+    linked.prepare(spec);
+    linked.parameters().set(ParamId::Drive, 12.0f);
+
+    VillainInstance* instance = create();
+    CHECK(instance != nullptr);
+    if (instance == nullptr)
+        return;
+    CHECK(prepare(instance, spec.sampleRate, spec.maxBlockSize, spec.numChannels, 0) == 1);
+    CHECK(prepare(instance, spec.sampleRate, 0, spec.numChannels, 0) == 0);
+    CHECK(prepare(instance, spec.sampleRate, spec.maxBlockSize, spec.numChannels, 0) == 1);
+    setParameter(instance, static_cast<int>(ParamId::Drive), 12.0f);
+    CHECK(getParameter(instance, static_cast<int>(ParamId::Drive)) == 12.0f);
+    CHECK(latency(instance) == linked.latencySamples());
+
+    // More events than the entry point converts at once, plus one it must ignore.
+    std::vector<ParameterEvent> events;
+    std::vector<VillainParameterEvent> hostEvents;
+    for (int i = 0; i < 150; ++i) {
+        const float drive = static_cast<float>(i % 7) * 4.0f;
+        events.push_back({i * 13, ParamId::Drive, drive});
+        hostEvents.push_back({i * 13, static_cast<int>(ParamId::Drive), drive});
+        if (i == 70)
+            hostEvents.push_back({i * 13, kNumParameters, 1.0f});
+    }
+
+    Channels expected = stereoTestSignal(kFrames);
+    Channels actual = expected;
+    linked.process(blockOf(expected), {events.data(), static_cast<int>(events.size())});
+    process(instance, blockOf(actual).channels(), 2, kFrames, hostEvents.data(), static_cast<int>(hostEvents.size()));
+    ctx.expectNull("module vs linked", actual, expected, 0.0);
+
+    // The sidechain entry point, with the key ducking the drive.
+    linked.parameters().set(ParamId::Sidechain, 1.0f);
+    linked.parameters().set(ParamId::SidechainDuck, 12.0f);
+    setParameter(instance, static_cast<int>(ParamId::Sidechain), 1.0f);
+    setParameter(instance, static_cast<int>(ParamId::SidechainDuck), 12.0f);
+    Channels key = {sine(kFrames, 80.0, kTestSampleRate, 0.9f)};
+    expected = stereoTestSignal(kFrames);
+    actual = expected;
+    linked.process(blockOf(expected), blockOf(key));
+    processKeyed(instance, blockOf(actual).channels(), 2, kFrames, blockOf(key).channels(), 1, nullptr, 0);
+    ctx.expectNull("keyed module vs linked", actual, expected, 0.0);
+
+    // No pack assets loaded: the state names none, so it is short of the capacity.
+    std::vector<std::uint8_t> blob(stateCapacity());
+    CHECK(blob.size() == kMaxStateSize);
+    blob.resize(saveState(instance, blob.data(), blob.size()));
+    CHECK(blob.size() == stateSize(StateAssets{}));
+    VillainInstance* restored = create();
+    CHECK(loadState(restored, blob.data(), blob.size()) == 1);
+    CHECK(getParameter(restored, static_cast<int>(ParamId::Drive)) == getParameter(instance, static_cast<int>(ParamId::Drive)));
+    CHECK(loadState(restored, blob.data(), blob.size() - 1) == 0);
+
+    destroy(restored);
+    destroy(instance);
+}
@@ -0,0 +1,878 @@
+#include "AllocationTracker.h"
+#include "TestFramework.h"
+#include "TestSignals.h"
+
+#include "plugin/VillainProcessor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <new>
+#include <string>
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+constexpr double kGoldenTolerance = 1e-4;
+
+Parameters characterParameters()
+{
+    Parameters p;
+    p.driveDb = 18.0f;
+    p.toneHz = 6000.0f;
+    p.mix = 0.8f;
+    p.outputGainDb = -6.0f;
+    return p;
+}
+
+std::unique_ptr<VillainProcessor> makeProcessor(const Parameters& params, int maxBlockSize = 512, int numChannels = 2)
+{
+    auto processor = std::make_unique<VillainProcessor>();
+    processor->setParameters(params);
+    processor->prepare({kTestSampleRate, maxBlockSize, numChannels});
+    return processor;
+}
+
+void render(VillainProcessor& processor, Channels& signal, int blockSize)
+{
+    const int frames = static_cast<int>(signal[0].size());
+    for (int pos = 0; pos < frames; pos += blockSize)
+        processor.process(blockOf(signal, pos, std::min(blockSize, frames - pos)));
+}
+
+// Largest sample-to-sample step over [from, to) in any channel.
+double largestStep(const Channels& channels, int from, int to)
+{
+    double largest = 0.0;
+    for (const std::vector<float>& channel : channels)
+        for (int i = from; i < to; ++i)
+            largest = std::max(largest, std::fabs(static_cast<double>(channel[static_cast<std::size_t>(i)]) -
+                                                  channel[static_cast<std::size_t>(i - 1)]));
+    return largest;
+}
+
+Channels tailOf(const Channels& channels, int from)
+{
+    Channels result;
+    for (const std::vector<float>& channel : channels)
+        result.emplace_back(channel.begin() + from, channel.end());
+    return result;
+}
+
+int peakIndex(const std::vector<float>& x)
+{
+    int index = 0;
+    for (int i = 1; i < static_cast<int>(x.size()); ++i)
+        if (std::abs(x[static_cast<std::size_t>(i)]) > std::abs(x[static_cast<std::size_t>(index)]))
+            index = i;
+    return index;
+}
+
+} // namespace
+
+VILLAIN_TEST(processor_golden_default_chain)
+{
+    auto processor = makeProcessor(characterParameters());
+    Channels signal = stereoTestSignal();
+    render(*processor, signal, 512);
+    ctx.expectGolden("processor_default_chain", signal, kGoldenTolerance);
+}
+
+VILLAIN_TEST(processor_golden_each_model_and_factor)
+{
+    for (int model = 0; model < dsp::kNumSaturationModels; ++model) {
+        for (int stages : {0, 2}) {
+            Parameters p = characterParameters();
+            p.saturationModel = static_cast<dsp::SaturationModel>(model);
+            p.oversamplingStages = stages;
+            p.oversamplingMode = dsp::OversamplingMode::LinearPhase;
+            auto processor = makeProcessor(p);
+
+            Channels signal = stereoTestSignal();
+            render(*processor, signal, 256);
+            ctx.expectGolden("processor_model" + std::to_string(model) + "_os" + std::to_string(1 << stages), signal,
+                             kGoldenTolerance);
+        }
+    }
+}
+
+VILLAIN_TEST(processor_tube_output_has_no_dc)
+{
+    // The tube's bias shifts its output by an amount that depends on the drive; the chain
+    // filters the offset out, whatever the level.
+    constexpr int kFrames = 48000;
+    constexpr int kSettled = 24000;   // a whole number of 100 Hz cycles follows
+    for (float driveDb : {0.0f, 12.0f, 24.0f}) {
+        Parameters p = characterParameters();
+        p.saturationModel = dsp::SaturationModel::Tube;
+        p.driveDb = driveDb;
+        p.mix = 1.0f;
+        auto processor = makeProcessor(p, 512, 1);
+
+        Channels signal{sine(kFrames, 100.0, kTestSampleRate)};
+        render(*processor, signal, 512);
+        double sum = 0.0;
+        double peak = 0.0;
+        for (int i = kSettled; i < kFrames; ++i) {
+            sum += signal[0][static_cast<std::size_t>(i)];
+            peak = std::max(peak, static_cast<double>(std::fabs(signal[0][static_cast<std::size_t>(i)])));
+        }
+        const double mean = sum / (kFrames - kSettled);
+        ctx.note("drive " + std::to_string(driveDb) + " dB: mean " + std::to_string(mean) + ", peak " +
+                 std::to_string(peak));
+        CHECK(std::fabs(mean) < 1e-3 * peak);
+    }
+}
+
+VILLAIN_TEST(processor_dry_mix_nulls_against_delayed_input)
+{
+    for (auto mode : {dsp::OversamplingMode::MinimumPhase, dsp::OversamplingMode::LinearPhase}) {
+        Parameters p = characterParameters();
+        p.mix = 0.0f;
+        p.oversamplingMode = mode;
+        auto processor = makeProcessor(p);
+
+        const Channels input = stereoTestSignal();
+        Channels output = input;
+        render(*processor, output, 100);
+
+        const int latency = processor->latencySamples();
+        Channels expected = input;
+        for (auto& channel : expected) {
+            channel.insert(channel.begin(), static_cast<std::size_t>(latency), 0.0f);
+            channel.resize(input[0].size());
+        }
+        ctx.expectNull("mix 0, latency " + std::to_string(latency), output, expected, 0.0);
+    }
+}
+
+VILLAIN_TEST(processor_second_order_adaa_keeps_the_mix_aligned)
+{
+    // Nearly linear, a low sine comes through second-order ADAA as the plain chain one
+    // sample later. At mix 0.5 the dry path has to move with it, or the two comb.
+    for (int stages : {0, 1}) {
+        Parameters p;
+        p.mix = 0.5f;
+        p.oversamplingStages = stages;
+        auto plain = makeProcessor(p);
+        p.antialiasing = dsp::Antialiasing::SecondOrder;
+        auto smoothed = makeProcessor(p);
+        CHECK(smoothed->latencySamples() == plain->latencySamples() + 1);
+        CHECK(smoothed->latency().contribution(LatencySource::Antialiasing) == 1);
+
+        const std::vector<float> tone = sine(kTestFrames, 500.0, kTestSampleRate, 0.1f);
+        Channels expected = {tone, tone};
+        Channels output = expected;
+        render(*plain, expected, 512);
+        render(*smoothed, output, 512);
+        for (auto& channel : expected) {
+            channel.insert(channel.begin(), 0.0f);
+            channel.pop_back();
+        }
+        ctx.expectNull("adaa 2 at mix 0.5, " + std::to_string(1 << stages) + "x", tailOf(output, 256), tailOf(expected, 256), 1e-4);
+    }
+}
+
+VILLAIN_TEST(processor_block_size_invariant)
+{
+    auto a = makeProcessor(characterParameters());
+    auto b = makeProcessor(characterParameters());
+    Channels large = stereoTestSignal();
+    Channels small = large;
+    render(*a, large, 512);
+    render(*b, small, 29);
+    ctx.expectNull("512 vs 29", small, large, 1e-5);
+}
+
+VILLAIN_TEST(processor_automation_is_sample_accurate)
+{
+    // An event at offset 200 must be indistinguishable from splitting the block there and
+    // setting the parameter between the two calls.
+    constexpr int kOffset = 200;
+    const ParameterEvent events[] = {{kOffset, ParamId::Drive, 30.0f}, {kOffset, ParamId::Tone, 2000.0f}};
+
+    auto withEvents = makeProcessor(characterParameters());
+    auto split = makeProcessor(characterParameters());
+
+    Channels a = stereoTestSignal(512);
+    Channels b = a;
+    withEvents->process(blockOf(a), {events, 2});
+
+    split->process(blockOf(b, 0, kOffset));
+    split->parameters().set(ParamId::Drive, 30.0f);
+    split->parameters().set(ParamId::Tone, 2000.0f);
+    split->process(blockOf(b, kOffset, 512 - kOffset));
+
+    ctx.expectNull("event vs split", a, b, 0.0);
+    CHECK(withEvents->parameters().get(ParamId::Drive) == 30.0f);
+}
+
+VILLAIN_TEST(processor_parameter_change_is_smoothed)
+{
+    Parameters p;
+    p.oversamplingStages = 0;
+    auto processor = makeProcessor(p);
+
+    Channels signal = {std::vector<float>(2048, 0.25f), std::vector<float>(2048, 0.25f)};
+    const ParameterEvent jump[] = {{256, ParamId::OutputGain, -24.0f}};
+    processor->process(blockOf(signal, 0, 512), {jump, 1});
+    processor->process(blockOf(signal, 512, 1536));
+
+    // Once the filters have settled on the DC input, no sample-to-sample step may exceed what
+    // the ramp allows.
+    double largestStep = 0.0;
+    for (std::size_t i = 128; i < signal[0].size(); ++i)
+        largestStep = std::max(largestStep, std::fabs(static_cast<double>(signal[0][i]) - signal[0][i - 1]));
+    CHECK(largestStep < 1e-3);
+}
+
+VILLAIN_TEST(processor_goes_idle_once_tail_has_rung_out)
+{
+    Parameters p = characterParameters();
+    p.oversamplingStages = 3;
+    auto processor = makeProcessor(p);
+
+    Channels signal = stereoTestSignal();
+    render(*processor, signal, 512);
+    CHECK(!processor->isIdle());
+
+    Channels silence = {std::vector<float>(kTestFrames * 4, 0.0f), std::vector<float>(kTestFrames * 4, 0.0f)};
+    render(*processor, silence, 512);
+    CHECK(processor->isIdle());
+
+    // Idle output is exact silence, and waking up starts from the same cleared state as a
+    // freshly prepared processor.
+    Channels idleBlock = {std::vector<float>(512, 1.0e-9f), std::vector<float>(512, -1.0e-9f)};
+    processor->process(blockOf(idleBlock, 0, 512));
+    CHECK(processor->isIdle());
+    for (const auto& channel : idleBlock)
+        for (float x : channel)
+            CHECK(x == 0.0f);
+
+    Channels resumed = stereoTestSignal();
+    Channels fresh = stereoTestSignal();
+    render(*processor, resumed, 512);
+    render(*makeProcessor(p), fresh, 512);
+    CHECK(!processor->isIdle());
+    ctx.expectNull("resume after idle", resumed, fresh, 0.0);
+}
+
+VILLAIN_TEST(processor_band_drive_keeps_quiet_input_awake)
+{
+    // -134 dBFS is below the silence threshold on its own, but +24 dB of band drive lifts
+    // it above, so it has to wake an idle processor.
+    Parameters p;
+    p.oversamplingStages = 0;
+    p.numBands = 2;
+    p.bandDriveDb[0] = 24.0f;
+    p.bandDriveDb[1] = 24.0f;
+    auto processor = makeProcessor(p);
+
+    Channels silence = {std::vector<float>(kTestFrames * 4, 0.0f), std::vector<float>(kTestFrames * 4, 0.0f)};
+    render(*processor, silence, 512);
+    CHECK(processor->isIdle());
+
+    const std::vector<float> quiet = sine(kTestFrames, 1000.0, kTestSampleRate, 2.0e-7f);
+    Channels signal = {quiet, quiet};
+    render(*processor, signal, 512);
+    CHECK(!processor->isIdle());
+    float peak = 0.0f;
+    for (std::size_t i = kTestFrames / 2; i < signal[0].size(); ++i)
+        peak = std::max(peak, std::fabs(signal[0][i]));
+    ctx.note("peak " + std::to_string(peak));
+    CHECK(peak > dsp::kSilenceThreshold);
+}
+
+VILLAIN_TEST(processor_parallel_chains_match_serial)
+{
+    // 7.1.4: six channel pairs, split over the audio thread and up to five workers (fewer
+    // on machines with fewer spare cores).
+    constexpr int kChannels = 12;
+    Channels serial;
+    for (int ch = 0; ch < kChannels; ++ch)
+        serial.push_back(sweepWithNoise(kTestFrames, kTestSampleRate, 100u + static_cast<std::uint32_t>(ch)));
+    Channels parallel = serial;
+
+    const Parameters p = characterParameters();
+    auto reference = makeProcessor(p, 256, kChannels);
+    auto threaded = std::make_unique<VillainProcessor>();
+    threaded->setParameters(p);
+    threaded->prepare({kTestSampleRate, 256, kChannels, 8});
+    CHECK(threaded->numWorkerThreads() <= 5);
+
+    render(*reference, serial, 256);
+    {
+        ScopedAllocationCounter allocations;
+        render(*threaded, parallel, 256);
+        CHECK(allocations.count() == 0);
+    }
+    ctx.expectNull("parallel vs serial", parallel, serial, 0.0);
+}
+
+VILLAIN_TEST(processor_construction_defers_all_setup)
+{
+    // Hosts construct instances in bulk while loading a session; everything heavy waits
+    // for prepare().
+    alignas(VillainProcessor) unsigned char storage[sizeof(VillainProcessor)];
+    {
+        ScopedAllocationCounter allocations;
+        auto* processor = new (storage) VillainProcessor();
+        CHECK(!processor->isPrepared());
+        CHECK(processor->numWorkerThreads() == 0);
+        processor->~VillainProcessor();
+        CHECK(allocations.count() == 0);
+    }
+}
+
+VILLAIN_TEST(processor_latency_modes_switch_without_allocating)
+{
+    Parameters p;
+    p.oversamplingStages = 3;
+    p.oversamplingMode = dsp::OversamplingMode::LinearPhase;
+    auto processor = makeProcessor(p, 256);
+
+    const int renderLatency = processor->latencySamples();
+    CHECK(renderLatency > 0);
+    CHECK(renderLatency == processor->latency().contribution(LatencySource::Oversampling));
+    processor->takeLatencyChange();
+
+    // Live mode holds nothing back, so an impulse peaks within the minimum-phase filters'
+    // rise time; in Render mode the linear-phase filters centre it on the reported latency.
+    Channels impulse = {std::vector<float>(256, 0.0f), std::vector<float>(256, 0.0f)};
+    impulse[0][0] = impulse[1][0] = 0.5f;
+
+    // The switch builds new chains in the background; the impulse goes through them once
+    // they are swapped in and the crossfade (480 samples) is over.
+    Channels silence = {std::vector<float>(256, 0.0f), std::vector<float>(256, 0.0f)};
+    Channels live = impulse;
+    {
+        ScopedAllocationCounter allocations;
+        const ParameterEvent toLive[] = {{0, ParamId::LatencyMode, static_cast<float>(LatencyMode::Live)}};
+        processor->process(blockOf(silence), {toLive, 1});
+        CHECK(allocations.count() == 0);
+    }
+    processor->waitForChains();
+    {
+        ScopedAllocationCounter allocations;
+        for (int i = 0; i < 2; ++i)
+            processor->process(blockOf(silence));   // through the crossfade
+        processor->process(blockOf(live));
+        CHECK(allocations.count() == 0);
+    }
+    CHECK(processor->latencySamples() == 0);
+    CHECK(processor->takeLatencyChange());
+    CHECK(!processor->takeLatencyChange());
+    CHECK(peakIndex(live[0]) < renderLatency / 2);
+
+    Channels rendered = impulse;
+    {
+        ScopedAllocationCounter allocations;
+        const ParameterEvent toRender[] = {{0, ParamId::LatencyMode, static_cast<float>(LatencyMode::Render)}};
+        processor->process(blockOf(silence), {toRender, 1});
+        CHECK(allocations.count() == 0);
+    }
+    processor->waitForChains();
+    {
+        ScopedAllocationCounter allocations;
+        for (int i = 0; i < 2; ++i)
+            processor->process(blockOf(silence));
+        processor->process(blockOf(rendered));
+        CHECK(allocations.count() == 0);
+    }
+    CHECK(processor->latencySamples() == renderLatency);
+    CHECK(processor->takeLatencyChange());
+    CHECK(peakIndex(rendered[0]) >= renderLatency / 2);
+}
+
+VILLAIN_TEST(processor_limiter_lookahead_is_render_only)
+{
+    Parameters p = characterParameters();
+    p.driveDb = 30.0f;
+    p.outputGainDb = 12.0f;
+    p.dynamicsMode = dsp::DynamicsMode::Limiter;
+    p.dynamicsThresholdDb = -1.0f;
+    p.dynamicsLookaheadMs = 2.0f;
+    auto processor = makeProcessor(p, 256);
+
+    const int lookahead = static_cast<int>(std::lround(0.002 * kTestSampleRate));
+    CHECK(processor->latency().contribution(LatencySource::Lookahead) == lookahead);
+    CHECK(processor->latencySamples() ==
+          lookahead + processor->latency().contribution(LatencySource::Oversampling));
+
+    const float ceiling = std::pow(10.0f, -1.0f / 20.0f) * 1.0001f;
+    const auto peak = [](const Channels& channels) {
+        float result = 0.0f;
+        for (const std::vector<float>& channel : channels)
+            for (float sample : channel)
+                result = std::max(result, std::fabs(sample));
+        return result;
+    };
+    Channels rendered = stereoTestSignal();
+    render(*processor, rendered, 256);
+    CHECK(peak(rendered) <= ceiling);
+
+    // Live drops the lookahead without allocating; the limiter then clamps on arrival and
+    // still holds the ceiling. The delay change crossfades both ways, so a sine (limited by
+    // about 1 dB) steps no further at either switch than it does anywhere else.
+    p.driveDb = 0.0f;
+    p.outputGainDb = 6.0f;
+    auto switching = makeProcessor(p, 256);
+    constexpr int kFrames = 4 * kTestFrames;
+    constexpr int kToLive = 1024;
+    constexpr int kToRender = 4096;
+    Channels output = {sine(kFrames, 220.0, kTestSampleRate, 0.5f), sine(kFrames, 330.0, kTestSampleRate, 0.5f)};
+    {
+        ScopedAllocationCounter allocations;
+        for (int pos = 0; pos < kFrames; pos += 256) {
+            const float mode = static_cast<float>(pos == kToLive ? LatencyMode::Live : LatencyMode::Render);
+            const ParameterEvent change[] = {{0, ParamId::LatencyMode, mode}};
+            const bool switches = pos == kToLive || pos == kToRender;
+            switching->process(blockOf(output, pos, 256), {change, switches ? 1 : 0});
+            if (switches)
+                switching->waitForChains();
+            if (pos == kToLive) {
+                CHECK(switching->latency().contribution(LatencySource::Lookahead) == 0);
+                CHECK(switching->latencySamples() == 0);
+            }
+        }
+        CHECK(allocations.count() == 0);
+    }
+    CHECK(switching->latency().contribution(LatencySource::Lookahead) == lookahead);
+    CHECK(peak(output) <= ceiling);
+
+    const double steady = largestStep(output, 512, kToLive);
+    const double toLive = largestStep(output, kToLive, kToRender);
+    const double toRender = largestStep(output, kToRender, kFrames);
+    ctx.note("largest step " + std::to_string(steady) + " steady, " + std::to_string(toLive) + " to live, " +
+             std::to_string(toRender) + " back to render");
+    CHECK(toLive < 1.5 * steady);
+    CHECK(toRender < 1.5 * steady);
+}
+
+VILLAIN_TEST(processor_offline_renders_the_next_quality_step)
+{
+    Parameters p = characterParameters();
+    p.numBands = 3;
+    p.bandDriveDb = {3.0f, -2.0f, 6.0f};
+    p.latencyMode = LatencyMode::Live;
+
+    // Offline renders one oversampling stage higher, compensated, whatever the session says.
+    Parameters equivalent = p;
+    equivalent.oversamplingStages = p.oversamplingStages + 1;
+    equivalent.latencyMode = LatencyMode::Render;
+    auto realtime = makeProcessor(equivalent, 512);
+
+    auto offline = std::make_unique<VillainProcessor>();
+    offline->setParameters(p);
+    ProcessSpec spec{kTestSampleRate, 512, 2};
+    spec.offline = true;
+    offline->prepare(spec);
+    CHECK(offline->isOffline());
+    CHECK(offline->spec().maxBlockSize == VillainProcessor::kOfflineBlockSize);
+    CHECK(offline->latencySamples() == realtime->latencySamples());
+
+    Channels expected = stereoTestSignal();
+    render(*realtime, expected, 512);
+
+    // Channels run as separate chains offline, which must not change a single sample.
+    Channels rendered = stereoTestSignal();
+    {
+        ScopedAllocationCounter allocations;
+        render(*offline, rendered, VillainProcessor::kOfflineBlockSize);
+        CHECK(allocations.count() == 0);
+    }
+    ctx.expectNull("offline vs realtime at the next factor", rendered, expected, 0.0);
+}
+
+VILLAIN_TEST(processor_does_not_allocate_in_process)
+{
+    Parameters p = characterParameters();
+    p.oversamplingStages = 4;
+    p.oversamplingMode = dsp::OversamplingMode::LinearPhase;
+    auto processor = makeProcessor(p, 64);
+
+    Channels signal = stereoTestSignal();
+    const ParameterEvent events[] = {{10, ParamId::Drive, 6.0f},
+                                     {20, ParamId::Antialiasing, 2.0f},
+                                     {40, ParamId::OversamplingStages, 1.0f}};
+
+    ScopedAllocationCounter allocations;
+    processor->process(blockOf(signal, 0, 64), {events, 3});
+    processor->process(blockOf(signal, 64, 1000));
+    processor->parameters().set(ParamId::Mix, 0.3f);
+    processor->parameters().set(ParamId::Bands, 3.0f);
+    processor->process(blockOf(signal, 1064, 64));
+    CHECK(allocations.count() == 0);
+}
+
+VILLAIN_TEST(processor_cabinet_swaps_in_without_allocating)
+{
+    // A single 0.5 tap: the cabinet stage must scale the chain's output exactly, add no
+    // latency, and fade back to the bare chain at cab_mix 0.
+    dsp::ImpulseResponse half;
+    half.sampleRate = kTestSampleRate;
+    half.channels.assign(1, std::vector<float>(1, 0.5f));
+
+    auto bare = makeProcessor(characterParameters());
+    auto cabinet = makeProcessor(characterParameters());
+    Channels expected = stereoTestSignal();
+    Channels output = expected;
+    render(*bare, expected, 512);
+
+    cabinet->process(blockOf(output, 0, 512));
+    cabinet->setImpulseResponse(half);
+    CHECK(cabinet->hasImpulseResponse());
+    CHECK(cabinet->latencySamples() == bare->latencySamples());
+    {
+        ScopedAllocationCounter allocations;
+        for (int pos = 512; pos < kTestFrames; pos += 512)
+            cabinet->process(blockOf(output, pos, 512));
+        CHECK(allocations.count() == 0);
+    }
+    for (std::vector<float>& channel : expected)
+        for (std::size_t i = 512; i < channel.size(); ++i)
+            channel[i] *= 0.5f;
+    ctx.expectNull("cabinet 0.5 tap", output, expected, 0.0);
+
+    Parameters dry = characterParameters();
+    dry.cabinetMix = 0.0f;
+    auto unmixed = makeProcessor(dry);
+    unmixed->setImpulseResponse(half);
+    Channels reference = stereoTestSignal();
+    Channels mixed = reference;
+    render(*makeProcessor(dry), reference, 512);
+    render(*unmixed, mixed, 512);
+    ctx.expectNull("cabinet mix 0", mixed, reference, 0.0);
+}
+
+VILLAIN_TEST(processor_sidechain_ducks_drive)
+{
+    Parameters p = characterParameters();
+    p.driveDb = 24.0f;
+    p.sidechain = true;
+    p.sidechainDuckDb = 18.0f;
+
+    // A mono 60 Hz key at full scale, held by the ducker's release between peaks.
+    Channels key = {sine(kTestFrames, 60.0, kTestSampleRate, 1.0f)};
+    const Channels keyBefore = key;
+
+    auto keyed = makeProcessor(p);
+    Channels ducked = stereoTestSignal();
+    {
+        ScopedAllocationCounter allocations;
+        for (int pos = 0; pos < kTestFrames; pos += 512) {
+            const int length = std::min(512, kTestFrames - pos);
+            keyed->process(blockOf(ducked, pos, length), blockOf(key, pos, length));
+        }
+        CHECK(allocations.count() == 0);
+    }
+    ctx.expectNull("key untouched", key, keyBefore, 0.0);
+
+    // Without a key the same settings run the plain chain. Less drive comes out quieter,
+    // though by far less than the depth: the saturator flattens level differences.
+    Channels plain = stereoTestSignal();
+    render(*makeProcessor(p), plain, 512);
+    double duckedEnergy = 0.0;
+    double plainEnergy = 0.0;
+    for (std::size_t ch = 0; ch < plain.size(); ++ch) {
+        for (std::size_t i = 0; i < plain[ch].size(); ++i) {
+            duckedEnergy += static_cast<double>(ducked[ch][i]) * ducked[ch][i];
+            plainEnergy += static_cast<double>(plain[ch][i]) * plain[ch][i];
+        }
+    }
+    const double duckDb = 10.0 * std::log10(duckedEnergy / plainEnergy);
+    ctx.note("ducked by " + std::to_string(duckDb) + " dB");
+    CHECK(duckDb < -1.5);
+
+    // With the sidechain switched off, or no depth and no keyed dynamics, the key is ignored.
+    for (const bool enabled : {false, true}) {
+        Parameters q = p;
+        q.sidechain = enabled;
+        q.sidechainDuckDb = enabled ? 0.0f : 18.0f;
+        auto ignoring = makeProcessor(q);
+        Channels output = stereoTestSignal();
+        for (int pos = 0; pos < kTestFrames; pos += 512) {
+            const int length = std::min(512, kTestFrames - pos);
+            ignoring->process(blockOf(output, pos, length), blockOf(key, pos, length));
+        }
+        Channels reference = stereoTestSignal();
+        render(*makeProcessor(q), reference, 512);
+        ctx.expectNull(enabled ? "no depth" : "sidechain off", output, reference, 0.0);
+    }
+}
+
+VILLAIN_TEST(processor_modulation_is_block_size_invariant)
+{
+    Parameters p = characterParameters();
+    p.modulation[0] = {dsp::ModSource::Lfo, dsp::ModTarget::Drive, 0.5f};
+    p.modulation[1] = {dsp::ModSource::Random, dsp::ModTarget::Tone, 0.8f};
+    p.modulation[2] = {dsp::ModSource::Envelope, dsp::ModTarget::Mix, -0.5f};
+    p.lfoRateHz = 8.0f;
+    p.randomRateHz = 30.0f;
+
+    Channels reference = stereoTestSignal();
+    render(*makeProcessor(p, kTestFrames), reference, kTestFrames);
+
+    // Control steps sit on absolute sample time, so cuts off the step grid change nothing.
+    for (int blockSize : {1, 45, 512}) {
+        auto processor = makeProcessor(p, blockSize);
+        Channels output = stereoTestSignal();
+        {
+            ScopedAllocationCounter allocations;
+            render(*processor, output, blockSize);
+            CHECK(allocations.count() == 0);
+        }
+        ctx.expectNull("modulated, block " + std::to_string(blockSize), output, reference, 1e-4);
+    }
+
+    Channels plain = stereoTestSignal();
+    render(*makeProcessor(characterParameters()), plain, 512);
+    double difference = 0.0;
+    for (std::size_t i = 0; i < plain[0].size(); ++i)
+        difference = std::max(difference, static_cast<double>(std::fabs(plain[0][i] - reference[0][i])));
+    CHECK(difference > 0.01);
+}
+
+VILLAIN_TEST(processor_zero_depth_modulation_nulls)
+{
+    // Routed sources at zero depth leave the chain exactly as it was.
+    Parameters p = characterParameters();
+    p.modulation[0] = {dsp::ModSource::Lfo, dsp::ModTarget::Drive, 0.0f};
+    p.modulation[1] = {dsp::ModSource::Envelope, dsp::ModTarget::Tone, 0.0f};
+    p.modulation[3] = {dsp::ModSource::Random, dsp::ModTarget::Mix, 0.0f};
+    Channels output = stereoTestSignal();
+    render(*makeProcessor(p), output, 512);
+    Channels reference = stereoTestSignal();
+    render(*makeProcessor(characterParameters()), reference, 512);
+    ctx.expectNull("zero depth", output, reference, 0.0);
+}
+
+VILLAIN_TEST(processor_oversampling_change_crossfades_in_the_background)
+{
+    Parameters p = characterParameters();
+    p.oversamplingStages = 1;
+    p.oversamplingMode = dsp::OversamplingMode::LinearPhase;
+    Parameters target = p;
+    target.oversamplingStages = 3;
+    auto processor = makeProcessor(p, 256);
+    auto reference = makeProcessor(target, 256);
+
+    constexpr int kFrames = 4 * kTestFrames;
+    constexpr int kChange = 1024;
+    Channels output = {sine(kFrames, 220.0, kTestSampleRate, 0.3f), sine(kFrames, 330.0, kTestSampleRate, 0.3f)};
+    Channels expected = output;
+    render(*reference, expected, 256);
+    processor->takeLatencyChange();
+
+    {
+        // The event only asks the builder for new chains.
+        ScopedAllocationCounter allocations;
+        for (int pos = 0; pos < kChange; pos += 256)
+            processor->process(blockOf(output, pos, 256));
+        const ParameterEvent change[] = {{0, ParamId::OversamplingStages, 3.0f}};
+        processor->process(blockOf(output, kChange, 256), {change, 1});
+        CHECK(allocations.count() == 0);
+    }
+    processor->waitForChains();
+    CHECK(!processor->isBuildingChains());
+    {
+        ScopedAllocationCounter allocations;
+        for (int pos = kChange + 256; pos < kFrames; pos += 256)
+            processor->process(blockOf(output, pos, 256));
+        CHECK(allocations.count() == 0);
+    }
+    CHECK(processor->takeLatencyChange());
+    CHECK(processor->latencySamples() == reference->latencySamples());
+
+    // No step through the swap beyond what the signal itself has.
+    const double steady = largestStep(output, 512, kChange + 256);
+    const double swap = largestStep(output, kChange + 256, kChange + 2048);
+    ctx.note("largest step " + std::to_string(steady) + " steady, " + std::to_string(swap) + " through the swap");
+    CHECK(swap < 1.5 * steady);
+
+    // Once the fade and the old history are gone, the new chains are the ones a fresh
+    // processor at 8x would run.
+    ctx.expectNull("after the swap vs 8x from the start", tailOf(output, kChange + 4096), tailOf(expected, kChange + 4096), 1e-5);
+}
+
+VILLAIN_TEST(processor_band_count_change_crossfades)
+{
+    // A new band count reshapes every band's filters and, from one band, swaps the shaper
+    // for the multiband one. Either way it arrives in new chains, crossfaded in.
+    constexpr int kFrames = 4 * kTestFrames;
+    constexpr int kToThree = 1024;
+    constexpr int kToTwo = 4096;
+    const Channels input = {sine(kFrames, 220.0, kTestSampleRate, 0.3f), sine(kFrames, 330.0, kTestSampleRate, 0.3f)};
+    const auto renderWith = [&](int numBands) {
+        Parameters p = characterParameters();
+        p.numBands = numBands;
+        p.bandDriveDb[1] = 6.0f;
+        Channels signal = input;
+        render(*makeProcessor(p, 256), signal, 256);
+        return signal;
+    };
+    const Channels one = renderWith(1);
+    const Channels three = renderWith(3);
+    const Channels two = renderWith(2);
+
+    Parameters p = characterParameters();
+    p.bandDriveDb[1] = 6.0f;
+    auto processor = makeProcessor(p, 256);
+    Channels output = input;
+    {
+        ScopedAllocationCounter allocations;
+        for (int pos = 0; pos < kFrames; pos += 256) {
+            const ParameterEvent change[] = {{0, ParamId::Bands, pos == kToThree ? 3.0f : 2.0f}};
+            const bool switching = pos == kToThree || pos == kToTwo;
+            processor->process(blockOf(output, pos, 256), {change, switching ? 1 : 0});
+            if (switching)
+                processor->waitForChains();
+        }
+        CHECK(allocations.count() == 0);
+    }
+
+    // No step through either swap beyond what the signal has on both sides of it.
+    const double steadyThree = std::max(largestStep(one, 512, kToThree), largestStep(three, 512, kToTwo));
+    const double steadyTwo = std::max(largestStep(three, 512, kToTwo), largestStep(two, 512, kFrames));
+    const double toThree = largestStep(output, kToThree, kToTwo);
+    const double toTwo = largestStep(output, kToTwo, kFrames);
+    ctx.note("largest step " + std::to_string(toThree) + " to 3 bands (steady " + std::to_string(steadyThree) + "), " +
+             std::to_string(toTwo) + " to 2 bands (steady " + std::to_string(steadyTwo) + ")");
+    CHECK(toThree < 1.5 * steadyThree);
+    CHECK(toTwo < 1.5 * steadyTwo);
+
+    // Once each fade is over, the chains are those of a processor that had the new count
+    // from the start, up to the rounding a low split's float state carries from its history.
+    constexpr double kTolerance = 1e-3;
+    const auto between = [](const Channels& channels, int from, int to) {
+        Channels result;
+        for (const std::vector<float>& channel : channels)
+            result.emplace_back(channel.begin() + from, channel.begin() + to);
+        return result;
+    };
+    ctx.expectNull("3 bands after the swap", between(output, kToThree + 2048, kToTwo),
+                   between(three, kToThree + 2048, kToTwo), kTolerance);
+    ctx.expectNull("2 bands after the swap", tailOf(output, kToTwo + 2048), tailOf(two, kToTwo + 2048), kTolerance);
+}
+
+VILLAIN_TEST(processor_latency_mode_switch_is_click_free)
+{
+    // Live swaps the linear-phase stages for minimum-phase ones and drops the dry-path
+    // compensation; both happen in a new set of chains, crossfaded in.
+    Parameters p = characterParameters();
+    p.oversamplingStages = 2;
+    p.oversamplingMode = dsp::OversamplingMode::LinearPhase;
+    auto processor = makeProcessor(p, 256);
+
+    constexpr int kFrames = 4 * kTestFrames;
+    constexpr int kToLive = 1024;
+    constexpr int kToRender = 4096;
+    Channels output = {sine(kFrames, 220.0, kTestSampleRate, 0.3f), sine(kFrames, 330.0, kTestSampleRate, 0.3f)};
+    {
+        ScopedAllocationCounter allocations;
+        for (int pos = 0; pos < kFrames; pos += 256) {
+            const float mode = static_cast<float>(pos == kToLive ? LatencyMode::Live : LatencyMode::Render);
+            const ParameterEvent change[] = {{0, ParamId::LatencyMode, mode}};
+            const bool switching = pos == kToLive || pos == kToRender;
+            processor->process(blockOf(output, pos, 256), {change, switching ? 1 : 0});
+            // Each switch is swapped in at the next block.
+            if (switching)
+                processor->waitForChains();
+        }
+        CHECK(allocations.count() == 0);
+    }
+
+    const double steady = largestStep(output, 512, kToLive);
+    const double toLive = largestStep(output, kToLive, kToRender);
+    const double toRender = largestStep(output, kToRender, kFrames);
+    ctx.note("largest step " + std::to_string(steady) + " steady, " + std::to_string(toLive) + " to live, " +
+             std::to_string(toRender) + " back to render");
+    CHECK(toLive < 1.5 * steady);
+    CHECK(toRender < 1.5 * steady);
+}
+
+VILLAIN_TEST(processor_preset_load_crossfades_to_the_new_chains)
+{
+    Preset preset;
+    preset.parameters = characterParameters();
+    preset.parameters.driveDb = 24.0f;
+    preset.parameters.saturationModel = dsp::SaturationModel::HardClip;
+    preset.parameters.toneHz = 3000.0f;
+    preset.parameters.oversamplingMode = dsp::OversamplingMode::LinearPhase;
+
+    constexpr int kFrames = 4 * kTestFrames;
+    constexpr int kLoad = 1024;
+    const Channels input = {sine(kFrames, 220.0, kTestSampleRate, 0.3f), sine(kFrames, 330.0, kTestSampleRate, 0.3f)};
+    Channels unchanged = input;
+    Channels expected = input;
+    render(*makeProcessor(characterParameters(), 256), unchanged, 256);
+    render(*makeProcessor(preset.parameters, 256), expected, 256);
+
+    auto processor = makeProcessor(characterParameters(), 256);
+    Channels output = input;
+    for (int pos = 0; pos < kLoad; pos += 256)
+        processor->process(blockOf(output, pos, 256));
+    CHECK(processor->loadPreset(preset));
+    // A block that may or may not see the new chains, depending on how fast they build.
+    processor->process(blockOf(output, kLoad, 256));
+    processor->waitForChains();
+    {
+        ScopedAllocationCounter allocations;
+        for (int pos = kLoad + 256; pos < kFrames; pos += 256)
+            processor->process(blockOf(output, pos, 256));
+        CHECK(allocations.count() == 0);
+    }
+
+    // Until the swap the old chains play exactly as they were, with none of the preset's
+    // values applied in place. The fade starts from them at a block boundary.
+    int swap = kFrames;
+    for (std::size_t ch = 0; ch < output.size(); ++ch)
+        for (int i = 0; i < swap; ++i)
+            if (output[ch][static_cast<std::size_t>(i)] != unchanged[ch][static_cast<std::size_t>(i)])
+                swap = i;
+    ctx.note("first change at " + std::to_string(swap));
+    CHECK(swap > kLoad && swap <= kLoad + 512 && swap % 256 != 0);
+
+    const double steady = std::max(largestStep(unchanged, 512, kFrames), largestStep(expected, 512, kFrames));
+    CHECK(largestStep(output, kLoad, kLoad + 2048) < 1.5 * steady);
+    ctx.expectNull("after the fade vs the preset from the start", tailOf(output, kLoad + 4096), tailOf(expected, kLoad + 4096), 1e-5);
+}
+
+VILLAIN_TEST(processor_offline_rebuilds_are_exact)
+{
+    // Offline the audio thread waits for each build, so a render with a preset load and an
+    // oversampling change comes out the same every time.
+    ProcessSpec spec{kTestSampleRate, 512, 2};
+    spec.offline = true;
+    Preset preset;
+    preset.parameters = characterParameters();
+    preset.parameters.driveDb = 24.0f;
+    preset.parameters.saturationModel = dsp::SaturationModel::Tube;
+
+    const auto renderWithChanges = [&](bool change) {
+        auto processor = std::make_unique<VillainProcessor>();
+        processor->setParameters(characterParameters());
+        processor->prepare(spec);
+        Channels signal = stereoTestSignal(4096);
+        const ParameterEvent toFourTimes[] = {{300, ParamId::OversamplingStages, 2.0f}};
+        ScopedAllocationCounter allocations;
+        processor->process(blockOf(signal, 0, 1024));
+        processor->process(blockOf(signal, 1024, 1024), {toFourTimes, change ? 1 : 0});
+        CHECK(allocations.count() == 0);
+        if (change)
+            CHECK(processor->loadPreset(preset));
+        processor->process(blockOf(signal, 2048, 2048));
+        return signal;
+    };
+
+    const Channels first = renderWithChanges(true);
+    const Channels second = renderWithChanges(true);
+    const Channels unchanged = renderWithChanges(false);
+    ctx.expectNull("two offline renders", second, first, 0.0);
+    double difference = 0.0;
+    for (std::size_t i = 1024; i < first[0].size(); ++i)
+        difference = std::max(difference, static_cast<double>(std::fabs(first[0][i] - unchanged[0][i])));
+    CHECK(difference > 0.01);
+}
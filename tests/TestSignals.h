@@ -0,0 +1,64 @@
+#pragma once
+
+#include "TestFramework.h"
+
+#include "core/AudioBlock.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace villain::test {
+
+constexpr double kTestSampleRate = 48000.0;
+constexpr int kTestFrames = 2048;
+
+// Log sine sweep (20 Hz to 20 kHz) over white noise; deterministic for a given seed.
+inline std::vector<float> sweepWithNoise(int frames, double sampleRate, std::uint32_t seed, float amplitude = 0.5f)
+{
+    constexpr double kPi = 3.14159265358979323846;
+    std::vector<float> out(static_cast<std::size_t>(frames));
+    const double duration = frames / sampleRate;
+    const double f0 = 20.0;
+    const double k = std::log(20000.0 / f0);
+
+    std::uint32_t state = seed;
+    for (int i = 0; i < frames; ++i) {
+        const double t = i / sampleRate;
+        const double phase = 2.0 * kPi * f0 * duration / k * (std::exp(t / duration * k) - 1.0);
+        state = state * 1664525u + 1013904223u;
+        const double noise = static_cast<double>(state >> 8) / 8388608.0 - 1.0;
+        out[static_cast<std::size_t>(i)] = static_cast<float>(amplitude * (std::sin(phase) + 0.1 * noise));
+    }
+    return out;
+}
+
+inline Channels stereoTestSignal(int frames = kTestFrames, float amplitude = 0.5f)
+{
+    return {sweepWithNoise(frames, kTestSampleRate, 1u, amplitude), sweepWithNoise(frames, kTestSampleRate, 2u, amplitude)};
+}
+
+inline std::vector<float> sine(int frames, double frequency, double sampleRate, float amplitude = 0.5f)
+{
+    constexpr double kPi = 3.14159265358979323846;
+    std::vector<float> out(static_cast<std::size_t>(frames));
+    for (int i = 0; i < frames; ++i)
+        out[static_cast<std::size_t>(i)] = static_cast<float>(amplitude * std::sin(2.0 * kPi * frequency * i / sampleRate));
+    return out;
+}
+
+// Wraps test-owned channel vectors as an AudioBlock over [start, start + length).
+inline AudioBlock blockOf(Channels& channels, int start, int length)
+{
+    std::array<float*, kMaxChannels> pointers{};
+    for (std::size_t ch = 0; ch < channels.size(); ++ch)
+        pointers[ch] = channels[ch].data() + start;
+    return AudioBlock(pointers.data(), static_cast<int>(channels.size()), length);
+}
+
+inline AudioBlock blockOf(Channels& channels)
+{
+    return blockOf(channels, 0, static_cast<int>(channels[0].size()));
+}
+
+} // namespace villain::test
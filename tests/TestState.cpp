@@ -0,0 +1,268 @@
+#include "AllocationTracker.h"
+#include "TestFramework.h"
+#include "TestSignals.h"
+
+#include "plugin/StateFormat.h"
+#include "plugin/VillainProcessor.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+Parameters nonDefaultParameters()
+{
+    Parameters p;
+    p.inputGainDb = 3.5f;
+    p.driveDb = 17.25f;
+    p.toneHz = 3000.0f;
+    p.mix = 0.3f;
+    p.outputGainDb = -6.0f;
+    p.numBands = 4;
+    p.crossoverLowHz = 220.0f;
+    p.bandDriveDb[2] = 9.0f;
+    return p;
+}
+
+void putEntry(std::vector<std::uint8_t>& blob, std::size_t offset, std::uint32_t key, float value)
+{
+    std::memcpy(blob.data() + offset, &key, 4);
+    std::memcpy(blob.data() + offset + 4, &value, 4);
+}
+
+// Rewrites the header checksum after a test edits the entries on purpose.
+void reseal(std::vector<std::uint8_t>& blob, std::size_t headerSize)
+{
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = headerSize; i < blob.size(); ++i)
+        hash = (hash ^ blob[i]) * 16777619u;
+    std::memcpy(blob.data() + 16, &hash, 4);
+}
+
+} // namespace
+
+VILLAIN_TEST(state_round_trips_every_parameter)
+{
+    ParameterStore source;
+    source.setAll(nonDefaultParameters());
+
+    std::array<std::uint8_t, stateSize()> blob{};
+    {
+        ScopedAllocationCounter allocations;
+        CHECK(writeState(source, blob.data(), blob.size()) == stateSize());
+        CHECK(writeState(source, blob.data(), blob.size() - 1) == 0);
+        CHECK(allocations.count() == 0);
+    }
+
+    const StateReader reader(blob.data(), blob.size());
+    CHECK(reader.isValid());
+    CHECK(reader.version() == kStateVersion);
+    CHECK(reader.numEntries() == static_cast<std::uint32_t>(kNumParameters));
+
+    ParameterStore restored;
+    restored.takeChanges();
+    {
+        ScopedAllocationCounter allocations;
+        CHECK(loadState(restored, blob.data(), blob.size()));
+        CHECK(allocations.count() == 0);
+    }
+    for (int i = 0; i < kNumParameters; ++i)
+        CHECK(restored.get(static_cast<ParamId>(i)) == source.get(static_cast<ParamId>(i)));
+    // The audio thread sees the whole state as changed.
+    CHECK(restored.takeChanges() == (kNumParameters == 64 ? ~0ull : (1ull << kNumParameters) - 1));
+
+    CHECK(saveState(source) == std::vector<std::uint8_t>(blob.begin(), blob.end()));
+}
+
+VILLAIN_TEST(state_rejects_damaged_blobs)
+{
+    ParameterStore source;
+    source.setAll(nonDefaultParameters());
+    const std::vector<std::uint8_t> good = saveState(source);
+
+    ParameterStore target;
+    const float before = target.get(ParamId::Drive);
+
+    CHECK(!loadState(target, nullptr, 0));
+    CHECK(!loadState(target, good.data(), kStateHeaderSize - 1));
+    CHECK(!loadState(target, good.data(), good.size() - 1));
+
+    std::vector<std::uint8_t> badMagic = good;
+    badMagic[0] ^= 0xff;
+    CHECK(!loadState(target, badMagic.data(), badMagic.size()));
+
+    std::vector<std::uint8_t> flipped = good;
+    flipped[kStateHeaderSize + 13] ^= 0x01;
+    CHECK(!loadState(target, flipped.data(), flipped.size()));
+
+    std::vector<std::uint8_t> hugeCount = good;
+    hugeCount[15] = 0xff;
+    CHECK(!loadState(target, hugeCount.data(), hugeCount.size()));
+
+    CHECK(target.get(ParamId::Drive) == before);
+}
+
+VILLAIN_TEST(state_tolerates_other_versions)
+{
+    // A blob from a hypothetical later version: a 4-byte longer header, 12-byte entries,
+    // parameters in a different order, one id this build has never heard of and Mix missing.
+    constexpr std::size_t kHeader = kStateHeaderSize + 4;
+    constexpr std::size_t kEntry = 12;
+    std::vector<std::uint8_t> blob(kHeader + kEntry * 3, 0xab);
+    const std::uint32_t magic = kStateMagic;
+    const std::uint16_t version = kStateVersion + 1;
+    const std::uint16_t headerSize = kHeader;
+    const std::uint16_t entrySize = kEntry;
+    const std::uint32_t count = 3;
+    std::memcpy(blob.data(), &magic, 4);
+    std::memcpy(blob.data() + 4, &version, 2);
+    std::memcpy(blob.data() + 6, &headerSize, 2);
+    std::memcpy(blob.data() + 8, &entrySize, 2);
+    std::memcpy(blob.data() + 12, &count, 4);
+    putEntry(blob, kHeader, stateKey(ParamId::Tone), 2500.0f);
+    putEntry(blob, kHeader + kEntry, fnv1a("future_parameter"), 123.0f);
+    putEntry(blob, kHeader + 2 * kEntry, stateKey(ParamId::Drive), 90.0f);
+    reseal(blob, kHeader);
+
+    const StateReader reader(blob.data(), blob.size());
+    CHECK(reader.isValid());
+    CHECK(reader.version() == kStateVersion + 1);
+    float value = 0.0f;
+    CHECK(reader.find(ParamId::Drive, value) && value == 90.0f);
+    CHECK(!reader.find(ParamId::Mix, value));
+
+    ParameterStore target;
+    target.set(ParamId::Mix, 0.1f);
+    CHECK(loadState(target, blob.data(), blob.size()));
+    CHECK(target.get(ParamId::Tone) == 2500.0f);
+    CHECK(target.get(ParamId::Drive) == parameterInfo(ParamId::Drive).maxValue);
+    CHECK(target.get(ParamId::Mix) == parameterInfo(ParamId::Mix).defaultValue);
+}
+
+VILLAIN_TEST(state_ignores_non_finite_values)
+{
+    // A correctly sealed blob can still carry NaN or infinity; clamping would keep a NaN,
+    // and a discrete parameter would then be cast from it. The store refuses them, so those
+    // parameters keep their values.
+    ParameterStore source;
+    source.setAll(nonDefaultParameters());
+    std::vector<std::uint8_t> blob = saveState(source);
+    const auto poison = [&](ParamId id, float value) {
+        putEntry(blob, kStateHeaderSize + static_cast<std::size_t>(id) * kStateEntrySize, stateKey(id), value);
+    };
+    poison(ParamId::Bands, std::nanf(""));
+    poison(ParamId::Drive, INFINITY);
+    poison(ParamId::Tone, -INFINITY);
+    reseal(blob, kStateHeaderSize);
+
+    ParameterStore target;
+    CHECK(loadState(target, blob.data(), blob.size()));
+    for (ParamId id : {ParamId::Bands, ParamId::Drive, ParamId::Tone})
+        CHECK(target.get(id) == parameterInfo(id).defaultValue);
+    CHECK(target.get(ParamId::Mix) == source.get(ParamId::Mix));
+    CHECK(target.get(ParamId::CrossoverLow) == source.get(ParamId::CrossoverLow));
+
+    // The same goes for automation and typed writes.
+    target.set(ParamId::OversamplingStages, std::nanf(""));
+    target.set(ParamId::Mix, INFINITY);
+    Parameters p = nonDefaultParameters();
+    p.driveDb = std::nanf("");
+    target.setAll(p);
+    CHECK(target.get(ParamId::OversamplingStages) == parameterInfo(ParamId::OversamplingStages).defaultValue);
+    CHECK(target.get(ParamId::Mix) == p.mix);
+    CHECK(target.get(ParamId::Drive) == parameterInfo(ParamId::Drive).defaultValue);
+}
+
+VILLAIN_TEST(state_carries_asset_names)
+{
+    ParameterStore source;
+    source.setAll(nonDefaultParameters());
+    const StateAssets assets{"cab/4x12", "measured/tape"};
+
+    std::array<std::uint8_t, kMaxStateSize> blob{};
+    std::size_t size = 0;
+    {
+        ScopedAllocationCounter allocations;
+        size = writeState(source, assets, blob.data(), blob.size());
+        CHECK(size == stateSize(assets) && size <= kMaxStateSize);
+        CHECK(writeState(source, assets, blob.data(), size - 1) == 0);
+        CHECK(allocations.count() == 0);
+    }
+
+    const StateReader reader(blob.data(), size);
+    CHECK(reader.isValid() && reader.hasAssets());
+    CHECK(reader.assets().cabinet == assets.cabinet && reader.assets().curve == assets.curve);
+    float value = 0.0f;
+    CHECK(reader.find(ParamId::Drive, value) && value == source.get(ParamId::Drive));
+    // The entries and their checksum are those of a parameter-only blob, which is all a
+    // version 1 reader looks at.
+    const std::vector<std::uint8_t> parametersOnly = saveState(source);
+    CHECK(std::equal(parametersOnly.begin() + 12, parametersOnly.end(), blob.begin() + 12));
+    CHECK(!StateReader(parametersOnly.data(), parametersOnly.size()).hasAssets());
+
+    // No names still writes the section, so a load clears the stages.
+    const std::vector<std::uint8_t> none = saveState(source, {});
+    const StateReader noneReader(none.data(), none.size());
+    CHECK(noneReader.hasAssets() && noneReader.assets().cabinet.empty() && noneReader.assets().curve.empty());
+
+    ParameterStore target;
+    std::array<std::uint8_t, kMaxStateSize> damaged = blob;
+    damaged[stateSize() + 8] ^= 0x01;
+    CHECK(!loadState(target, damaged.data(), size));
+    CHECK(!loadState(target, blob.data(), size - 1));
+    CHECK(loadState(target, blob.data(), size) && target.get(ParamId::Drive) == source.get(ParamId::Drive));
+
+    const std::string tooLong(AssetPack::kMaxNameLength + 1, 'x');
+    CHECK(writeState(source, {tooLong, {}}, blob.data(), blob.size()) == 0);
+}
+
+VILLAIN_TEST(state_loads_while_audio_runs)
+{
+    VillainProcessor processor;
+    processor.prepare({kTestSampleRate, 256, 2});
+
+    ParameterStore a;
+    ParameterStore b;
+    b.setAll(nonDefaultParameters());
+    const std::vector<std::uint8_t> stateA = saveState(a);
+    const std::vector<std::uint8_t> stateB = saveState(b);
+
+    // The host's state thread hammers save/load while the audio thread keeps rendering.
+    std::atomic<bool> done{false};
+    std::atomic<int> loads{0};
+    std::thread host([&] {
+        std::array<std::uint8_t, stateSize()> scratch{};
+        for (int i = 0; !done.load(std::memory_order_relaxed); ++i) {
+            const std::vector<std::uint8_t>& next = (i & 1) != 0 ? stateA : stateB;
+            loadState(processor.parameters(), next.data(), next.size());
+            writeState(processor.parameters(), scratch.data(), scratch.size());
+            loads.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    Channels signal = stereoTestSignal();
+    bool finite = true;
+    for (int pass = 0; pass < 8 || loads.load(std::memory_order_relaxed) < 2; ++pass) {
+        for (int pos = 0; pos + 256 <= kTestFrames; pos += 256) {
+            Channels block = signal;
+            processor.process(blockOf(block, pos, 256));
+            for (float sample : block[0])
+                finite = finite && std::isfinite(sample);
+        }
+    }
+    done.store(true, std::memory_order_relaxed);
+    host.join();
+    CHECK(finite);
+
+    CHECK(loadState(processor.parameters(), stateB.data(), stateB.size()));
+    CHECK(saveState(processor.parameters()) == stateB);
+}
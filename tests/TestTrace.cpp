@@ -0,0 +1,134 @@
+#include "TestFramework.h"
+#include "TestSignals.h"
+
+#include "core/TraceRecorder.h"
+#include "core/TraceRing.h"
+#include "plugin/TraceStages.h"
+#include "plugin/VillainProcessor.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace villain;
+using namespace villain::test;
+
+VILLAIN_TEST(trace_ring_keeps_order_and_counts_drops)
+{
+    TraceRing ring;
+    ring.allocate(5);
+    CHECK(ring.capacity() == 8);
+
+    int pushed = 0;
+    for (std::uint64_t i = 0; i < 10; ++i)
+        pushed += ring.push({i, i + 1, 64, 1, 0}) ? 1 : 0;
+    CHECK(pushed == 8);
+    CHECK(ring.dropped() == 2);
+
+    TraceEvent event;
+    for (std::uint64_t i = 0; i < 8; ++i) {
+        CHECK(ring.pop(event));
+        CHECK(event.begin == i);
+    }
+    CHECK(!ring.pop(event));
+
+    // Slots are reusable once drained.
+    CHECK(ring.push({42, 43, 64, 1, 0}));
+    CHECK(ring.pop(event) && event.begin == 42);
+}
+
+VILLAIN_TEST(trace_ring_takes_concurrent_producers)
+{
+    constexpr int kProducers = 3;
+    constexpr int kEventsEach = 4000;
+    TraceRing ring;
+    ring.allocate(kProducers * kEventsEach);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&ring, p] {
+            for (int i = 0; i < kEventsEach; ++i)
+                ring.push({static_cast<std::uint64_t>(i), 0, 0, 0, static_cast<std::uint16_t>(p)});
+        });
+    }
+    for (std::thread& producer : producers)
+        producer.join();
+
+    // Every event arrives exactly once and each producer's events stay in order.
+    std::vector<std::uint64_t> next(kProducers, 0);
+    TraceEvent event;
+    int received = 0;
+    bool ordered = true;
+    while (ring.pop(event)) {
+        ordered = ordered && event.begin == next[event.track]++;
+        ++received;
+    }
+    CHECK(ordered);
+    CHECK(received == kProducers * kEventsEach);
+    CHECK(ring.dropped() == 0);
+}
+
+VILLAIN_TEST(trace_recorder_writes_chrome_trace)
+{
+    TraceRing ring;
+    ring.allocate(64);
+    TraceRecorder recorder;
+    recorder.start(ring);
+
+    // A 64-sample block is worth 1333 us at 48 kHz: one span well inside, one far outside.
+    const std::uint64_t t0 = traceTimestamp();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    const std::uint64_t t1 = traceTimestamp();
+    ring.push({t0, t0 + 1, 64, static_cast<std::uint16_t>(TraceStage::Block), 0});
+    ring.push({t0, t1, 64, static_cast<std::uint16_t>(TraceStage::Block), 0});
+    ring.push({t0, t0 + 1, 64, static_cast<std::uint16_t>(TraceStage::Saturate), 1});
+    recorder.stop();
+
+    CHECK(recorder.events().size() == 3);
+    CHECK(recorder.dropped() == 0);
+    CHECK(recorder.ticksPerMicrosecond() > 0.0);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "villain_trace_test.json").string();
+    CHECK(recorder.writeChromeTrace(path, traceFormat(48000.0)));
+
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    const std::string json = contents.str();
+    std::filesystem::remove(path);
+
+    CHECK(json.rfind("{\"displayTimeUnit\"", 0) == 0);
+    CHECK(json.find("\"name\":\"saturate\"") != std::string::npos);
+    CHECK(json.find("\"name\":\"block\",\"cat\":\"overrun\"") != std::string::npos);
+    CHECK(json.find("\"name\":\"block\",\"cat\":\"dsp\"") != std::string::npos);
+}
+
+VILLAIN_TEST(trace_processor_instrumentation_follows_build_flag)
+{
+    VillainProcessor processor;
+    Parameters p;
+    p.mix = 0.5f;
+    processor.setParameters(p);
+    processor.prepare({kTestSampleRate, 256, 2});
+
+    TraceRecorder recorder;
+    recorder.start(processor.trace());
+    Channels signal = stereoTestSignal();
+    for (int pos = 0; pos + 256 <= kTestFrames; pos += 256)
+        processor.process(blockOf(signal, pos, 256));
+    recorder.stop();
+
+#if VILLAIN_TRACE
+    std::vector<int> perStage(static_cast<std::size_t>(TraceStage::Count), 0);
+    for (const TraceEvent& event : recorder.events())
+        ++perStage[event.stage];
+    for (int count : perStage)
+        CHECK(count == kTestFrames / 256);
+#else
+    // Without the flag the hot path records nothing and the ring is never allocated.
+    CHECK(processor.trace().capacity() == 0);
+    CHECK(recorder.events().empty());
+#endif
+}
@@ -0,0 +1,69 @@
+#include "TestFramework.h"
+
+#include "core/WorkerPool.h"
+
+#include <array>
+#include <atomic>
+
+using namespace villain;
+using namespace villain::test;
+
+namespace {
+
+struct CountingJob {
+    std::array<std::atomic<int>, 64> runs{};
+
+    static void task(void* context, int index) noexcept
+    {
+        static_cast<CountingJob*>(context)->runs[static_cast<std::size_t>(index)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool eachRanExactly(int times, int numTasks) const
+    {
+        for (int i = 0; i < static_cast<int>(runs.size()); ++i) {
+            const int expected = i < numTasks ? times : 0;
+            if (runs[static_cast<std::size_t>(i)].load() != expected)
+                return false;
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+VILLAIN_TEST(worker_pool_runs_inline_without_workers)
+{
+    WorkerPool pool;
+    CountingJob job;
+    pool.run(7, &CountingJob::task, &job);
+    CHECK(pool.numWorkers() == 0);
+    CHECK(job.eachRanExactly(1, 7));
+}
+
+VILLAIN_TEST(worker_pool_runs_every_task_once_per_job)
+{
+    WorkerPool pool;
+    pool.start(3);
+    CHECK(pool.numWorkers() == 3);
+
+    // Back-to-back jobs of varying size catch workers mid-drain and asleep alike.
+    CountingJob job;
+    constexpr int kJobs = 2000;
+    for (int j = 0; j < kJobs; ++j)
+        pool.run(1 + j % 8, &CountingJob::task, &job);
+
+    int total = 0;
+    for (const auto& runs : job.runs)
+        total += runs.load();
+    int expected = 0;
+    for (int j = 0; j < kJobs; ++j)
+        expected += 1 + j % 8;
+    CHECK(total == expected);
+
+    CountingJob single;
+    pool.run(16, &CountingJob::task, &single);
+    CHECK(single.eachRanExactly(1, 16));
+
+    pool.stop();
+    CHECK(pool.numWorkers() == 0);
+}